@@ -31,7 +31,11 @@ extern "C" {
 #endif
 
 /** Static initializer for mbox objects */
+#ifdef MODULE_CORE_THREAD_FLAGS
+#define MBOX_INIT(queue, queue_size) {{0}, {0}, CIB_INIT(queue_size), queue, NULL}
+#else
 #define MBOX_INIT(queue, queue_size) {{0}, {0}, CIB_INIT(queue_size), queue}
+#endif
 
 /**
  * @brief Mailbox struct definition
@@ -41,6 +45,10 @@ typedef struct {
     list_node_t writers;    /**< list of threads waiting to send        */
     cib_t cib;              /**< cib for msg array                      */
     msg_t *msg_array;       /**< ptr to array of msg queue              */
+#ifdef MODULE_CORE_THREAD_FLAGS
+    struct _thread *notify; /**< thread to set THREAD_FLAG_MBOX_WAITING
+                                 for on queued messages                 */
+#endif
 } mbox_t;
 
 enum {
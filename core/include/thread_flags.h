@@ -42,9 +42,15 @@
  * Usually, if it is only of interest that an event occurred, but not how many
  * of them, thread flags should be considered.
  *
- * Note that some flags (currently the three most significant bits) are used by
+ * Note that some flags (currently the four most significant bits) are used by
  * core functions and should not be set by the user. They can be waited for.
  *
+ * With thread_flags_wait_ready() a thread can block on its message queue,
+ * any number of @ref core_mbox "mailboxes" and a set of flags at the same
+ * time. The message queue and mailboxes report new messages by setting the
+ * reserved flags @ref THREAD_FLAG_MSG_WAITING and
+ * @ref THREAD_FLAG_MBOX_WAITING.
+ *
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
  */
 #ifndef THREAD_FLAGS_H
@@ -52,6 +58,7 @@
 
 #include "kernel_types.h"
 #include "sched.h"  /* for thread_t typedef */
+#include "mbox.h"
 
 #ifdef __cplusplus
  extern "C" {
@@ -64,6 +71,15 @@
 #define THREAD_FLAG_MSG_WAITING      (0x1<<15)
 #define THREAD_FLAG_MUTEX_UNLOCKED   (0x1<<14)
 #define THREAD_FLAG_TIMEOUT          (0x1<<13)
+#define THREAD_FLAG_MBOX_WAITING     (0x1<<12)
+/** @} */
+
+/**
+ * @name return values of thread_flags_wait_ready()
+ * @{
+ */
+#define THREAD_FLAGS_READY_FLAGS     (-1)   /**< one of the flags was set */
+#define THREAD_FLAGS_READY_MSG       (-2)   /**< message queue not empty */
 /** @} */
 
 /**
@@ -132,6 +148,38 @@ thread_flags_t thread_flags_wait_all(thread_flags_t mask);
  */
 thread_flags_t thread_flags_wait_one(thread_flags_t mask);
 
+/**
+ * @brief Wait until a flag is set or a message is available (blocking)
+ *
+ * Blocks until any flag in @p mask is set, or, if @p mask contains
+ * @ref THREAD_FLAG_MSG_WAITING, a message can be received from the thread's
+ * message queue, or any of @p mboxes has a queued message.
+ *
+ * Messages are not taken, the caller fetches them with msg_try_receive() or
+ * mbox_try_get(). Only one thread may wait on a mailbox with this function
+ * at a time and it should be the mailbox' only reader.
+ *
+ * If several sources are ready, the message queue comes first, then the
+ * mailboxes in order of @p mboxes, then the flags. The flags stay set until
+ * they are returned, so e.g. a receive timeout signalled with
+ * @ref THREAD_FLAG_TIMEOUT never hides a message that is already queued.
+ *
+ * @param[in,out] mask      flags to wait for, optionally with
+ *                          @ref THREAD_FLAG_MSG_WAITING. When returning
+ *                          @ref THREAD_FLAGS_READY_FLAGS, the flags that
+ *                          were set. Those are cleared.
+ * @param[in] mboxes        mailboxes to wait for, may be NULL if
+ *                          @p mbox_numof is 0
+ * @param[in] mbox_numof    number of entries in @p mboxes
+ *
+ * @return  @ref THREAD_FLAGS_READY_FLAGS if any flag in @p mask was set
+ * @return  @ref THREAD_FLAGS_READY_MSG if a message is waiting in the thread's
+ *          message queue
+ * @return  index into @p mboxes of a mailbox holding a message
+ */
+int thread_flags_wait_ready(thread_flags_t *mask, mbox_t *const *mboxes,
+                            unsigned mbox_numof);
+
 /**
  * @brief Possibly Wake up thread waiting for flags
  *
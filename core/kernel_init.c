@@ -40,6 +40,10 @@
 #include <auto_init.h>
 #endif
 
+#ifdef MODULE_XTIMER_TICKLESS
+#include "xtimer.h"
+#endif
+
 extern int main(void);
 static void *main_trampoline(void *arg)
 {
@@ -65,6 +69,9 @@ static void *idle_thread(void *arg)
     (void) arg;
 
     while (1) {
+#ifdef MODULE_XTIMER_TICKLESS
+        xtimer_idle();
+#endif
         pm_set_lowest();
     }
 
@@ -24,6 +24,7 @@
 #include "irq.h"
 #include "sched.h"
 #include "thread.h"
+#include "thread_flags.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -85,6 +86,16 @@ int _mbox_put(mbox_t *mbox, msg_t *msg, int blocking)
         msg->sender_pid = sched_active_pid;
         /* copy msg into queue */
         mbox->msg_array[cib_put_unsafe(&mbox->cib)] = *msg;
+#ifdef MODULE_CORE_THREAD_FLAGS
+        if (mbox->notify) {
+            mbox->notify->flags |= THREAD_FLAG_MBOX_WAITING;
+            if (thread_flags_wake(mbox->notify)) {
+                irq_restore(irqstate);
+                thread_yield_higher();
+                return 1;
+            }
+        }
+#endif
         irq_restore(irqstate);
         return 1;
     }
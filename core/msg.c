@@ -36,6 +36,18 @@
 static int _msg_receive(msg_t *m, int block);
 static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned state);
 
+#ifdef MODULE_CORE_THREAD_FLAGS
+/* Signal a waiting message to thread_flags_wait_ready(). Must be called with
+ * interrupts disabled, returns 1 if @p target was woken up. */
+static inline int _flag_msg_waiting(thread_t *target)
+{
+    target->flags |= THREAD_FLAG_MSG_WAITING;
+    return thread_flags_wake(target);
+}
+#else
+#define _flag_msg_waiting(target)   (0)
+#endif
+
 static int queue_msg(thread_t *target, const msg_t *m)
 {
     int n = cib_put(&(target->msg_queue));
@@ -105,8 +117,9 @@ static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned sta
             DEBUG("msg_send() %s:%i: Target %" PRIkernel_pid
                   " has a msg_queue. Queueing message.\n", RIOT_FILE_RELATIVE,
                   __LINE__, target_pid);
+            int woken = _flag_msg_waiting(target);
             irq_restore(state);
-            if (me->status == STATUS_REPLY_BLOCKED) {
+            if (woken || (me->status == STATUS_REPLY_BLOCKED)) {
                 thread_yield_higher();
             }
             return 1;
@@ -136,6 +149,7 @@ static int _msg_send(msg_t *m, kernel_pid_t target_pid, bool block, unsigned sta
         sched_set_status((thread_t*) me, newstatus);
 
         thread_add_to_list(&(target->msg_waiters), me);
+        _flag_msg_waiting(target);
 
         irq_restore(state);
         thread_yield_higher();
@@ -165,6 +179,9 @@ int msg_send_to_self(msg_t *m)
 
     m->sender_pid = sched_active_pid;
     int res = queue_msg((thread_t *) sched_active_thread, m);
+    if (res) {
+        _flag_msg_waiting((thread_t *) sched_active_thread);
+    }
 
     irq_restore(state);
     return res;
@@ -201,7 +218,11 @@ int msg_send_int(msg_t *m, kernel_pid_t target_pid)
     }
     else {
         DEBUG("msg_send_int: Receiver not waiting.\n");
-        return (queue_msg(target, m));
+        int res = queue_msg(target, m);
+        if (res && _flag_msg_waiting(target)) {
+            sched_context_switch_request = 1;
+        }
+        return res;
     }
 }
 
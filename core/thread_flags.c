@@ -19,6 +19,8 @@
  */
 
 
+#include <assert.h>
+
 #include "thread_flags.h"
 #include "irq.h"
 #include "thread.h"
@@ -98,6 +100,80 @@ thread_flags_t thread_flags_wait_all(thread_flags_t mask)
     return _thread_flags_clear_atomic(me, mask);
 }
 
+#ifdef MODULE_CORE_MBOX
+static void _mbox_notify(mbox_t *const *mboxes, unsigned numof, thread_t *thread)
+{
+    unsigned state = irq_disable();
+    for (unsigned i = 0; i < numof; i++) {
+        assert((thread == NULL) || (mboxes[i]->notify == NULL) ||
+               (mboxes[i]->notify == thread));
+        mboxes[i]->notify = thread;
+    }
+    irq_restore(state);
+}
+#endif
+
+int thread_flags_wait_ready(thread_flags_t *mask, mbox_t *const *mboxes,
+                            unsigned mbox_numof)
+{
+    thread_t *me = (thread_t*) sched_active_thread;
+    thread_flags_t user = *mask & ~(THREAD_FLAG_MSG_WAITING | THREAD_FLAG_MBOX_WAITING);
+    thread_flags_t wait = *mask & ~THREAD_FLAG_MBOX_WAITING;
+    int res = THREAD_FLAGS_READY_FLAGS;
+
+#ifdef MODULE_CORE_MBOX
+    if (mbox_numof) {
+        wait |= THREAD_FLAG_MBOX_WAITING;
+        _mbox_notify(mboxes, mbox_numof, me);
+    }
+#else
+    (void)mboxes;
+    assert(mbox_numof == 0);
+#endif
+
+    while (1) {
+        /* Clear the notifications first: a message arriving after the checks
+         * below sets them again, so the wait can not miss it. */
+        _thread_flags_clear_atomic(me, THREAD_FLAG_MSG_WAITING | THREAD_FLAG_MBOX_WAITING);
+        /* Messages first: a flag like THREAD_FLAG_TIMEOUT must not hide a
+         * message that is already queued. */
+#ifdef MODULE_CORE_MSG
+        if ((wait & THREAD_FLAG_MSG_WAITING) &&
+            ((msg_avail() > 0) || (me->msg_waiters.next != NULL))) {
+            res = THREAD_FLAGS_READY_MSG;
+            break;
+        }
+#endif
+#ifdef MODULE_CORE_MBOX
+        unsigned i;
+        for (i = 0; i < mbox_numof; i++) {
+            if (cib_avail(&mboxes[i]->cib)) {
+                break;
+            }
+        }
+        if (i < mbox_numof) {
+            res = (int)i;
+            break;
+        }
+#endif
+        thread_flags_t set = _thread_flags_clear_atomic(me, user);
+        if (set) {
+            *mask = set;
+            break;
+        }
+        DEBUG("thread_flags_wait_ready(): pid %"PRIkernel_pid" waiting for %08x\n",
+              thread_getpid(), (unsigned)wait);
+        _thread_flags_wait_any(wait);
+    }
+
+#ifdef MODULE_CORE_MBOX
+    if (mbox_numof) {
+        _mbox_notify(mboxes, mbox_numof, NULL);
+    }
+#endif
+    return res;
+}
+
 inline int __attribute__((always_inline)) thread_flags_wake(thread_t *thread)
 {
     unsigned wakeup = 0;
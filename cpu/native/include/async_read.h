@@ -24,9 +24,11 @@ extern "C" {
 
 /**
  * @brief   Maximum number of file descriptors
+ *
+ * Enough for UART, tap, CAN and crypto accelerator.
  */
 #ifndef ASYNC_READ_NUMOF
-#define ASYNC_READ_NUMOF 2
+#define ASYNC_READ_NUMOF 4
 #endif
 
 /**
@@ -24,12 +24,57 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+
 #include "mtd.h"
 
-/** mtd native descriptor */
+/**
+ * @brief   Emulated latency, applied with xtimer_usleep() if module xtimer is
+ *          used
+ */
+typedef struct {
+    uint32_t read_us;           /**< per read operation */
+    uint32_t write_us;          /**< per page written to */
+    uint32_t erase_us;          /**< per sector erased */
+} mtd_native_timing_t;
+
+/**
+ * @brief   Operation counters
+ */
+typedef struct {
+    uint32_t reads;             /**< number of read operations */
+    uint32_t writes;            /**< number of write operations */
+    uint32_t erases;            /**< number of erased sectors */
+    uint64_t read_bytes;        /**< bytes read */
+    uint64_t write_bytes;       /**< bytes written */
+} mtd_native_stats_t;
+
+/**
+ * @brief   mtd native descriptor
+ *
+ * The backing file is mapped into memory by the init function and stays
+ * mapped, so reads and writes are plain memory accesses. Writes behave like
+ * NOR flash: they can only clear bits, erasing sets a whole sector to 0xff.
+ *
+ * Requests of module `mtd_async` are run by its worker thread with the
+ * blocking functions, so the emulated latency delays the worker instead of the
+ * submitter.
+ */
 typedef struct mtd_native_dev {
     mtd_dev_t dev;      /**< mtd generic device */
     const char *fname;  /**< filename to use for memory emulation */
+    const mtd_native_timing_t *timing;  /**< emulated latency, may be NULL */
+    uint32_t *wear;     /**< erase counter per sector, may be NULL */
+    uint32_t erase_limit;   /**< erase count after which a sector fails to
+                             *   erase with -EIO, 0 for no limit. Requires
+                             *   @p wear */
+    uint32_t power_cut; /**< simulated power loss at the n-th byte written
+                         *   or erased from now on, 0 to disable. The bytes
+                         *   before it are done, then all operations fail
+                         *   with -EIO until the next init, as after a
+                         *   reset */
+    mtd_native_stats_t stats;   /**< operation counters */
+    uint8_t *mem;       /**< mapped backing file, set by init */
 } mtd_native_dev_t;
 
 /**
@@ -110,6 +110,7 @@ extern int (*real_getifaddrs)(struct ifaddrs **ifap);
 extern int (*real_getpid)(void);
 extern int (*real_ioctl)(int fildes, int request, ...);
 extern int (*real_listen)(int socket, int backlog);
+extern off_t (*real_lseek)(int fd, off_t offset, int whence);
 extern int (*real_open)(const char *path, int oflag, ...);
 extern int (*real_pause)(void);
 extern int (*real_pipe)(int[2]);
@@ -131,6 +132,9 @@ extern int (*real_fputc)(int c, FILE *stream);
 extern int (*real_fgetc)(FILE *stream);
 extern mode_t (*real_umask)(mode_t cmask);
 extern ssize_t (*real_writev)(int fildes, const struct iovec *iov, int iovcnt);
+/* declared without pthread types, RIOT's pthread.h may shadow the host's */
+extern int (*real_pthread_create)(void *thread, const void *attr,
+                                  void *(*start_routine)(void *), void *arg);
 
 #ifdef __MACH__
 #else
@@ -27,6 +27,23 @@
 #define NATIVE_TIMER_MIN_RES 200
 /** @} */
 
+/**
+ * @name Crypto accelerator configuration
+ *
+ * The accelerator is emulated by a host thread, which delays each job by
+ * NATIVE_CRYPTO_LATENCY_US plus NATIVE_CRYPTO_US_PER_BLOCK per 16 bytes of
+ * input.
+ * @{
+ */
+#define CRYPTO_HW_NUMOF             (1U)
+#ifndef NATIVE_CRYPTO_LATENCY_US
+#define NATIVE_CRYPTO_LATENCY_US    (50U)
+#endif
+#ifndef NATIVE_CRYPTO_US_PER_BLOCK
+#define NATIVE_CRYPTO_US_PER_BLOCK  (1U)
+#endif
+/** @} */
+
 /**
  * @name Random Number Generator configuration
  * @{
@@ -41,6 +58,20 @@
 #define RTC_NUMOF (1)
 /** @} */
 
+/**
+ * @name Real Time Timer configuration
+ *
+ * The RTT is emulated with a POSIX per-process timer, which is not available
+ * on OS X.
+ * @{
+ */
+#ifndef __MACH__
+#define RTT_NUMOF           (1U)
+#define RTT_FREQUENCY       (32768U)
+#define RTT_MAX_VALUE       (0xffffffff)
+#endif
+/** @} */
+
 /**
  * @name Timer peripheral configuration
  * @{
@@ -48,6 +79,16 @@
 #define TIMER_NUMOF        (1U)
 #define TIMER_0_EN         1
 
+/**
+ * @brief   Counter width of the emulated timer
+ *
+ * Override with e.g. 0xffff to emulate the 16-bit timers found on many MCUs,
+ * xtimer then derives XTIMER_WIDTH from this value.
+ */
+#ifndef TIMER_0_MAX_VALUE
+#define TIMER_0_MAX_VALUE  (0xffffffff)
+#endif
+
 /**
  * @brief xtimer configuration
  * @{
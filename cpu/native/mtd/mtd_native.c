@@ -10,6 +10,10 @@
  * @{
  * @brief       mtd flash emulation for native
  *
+ * The backing file is kept open and mapped with mmap(), so the page cache of
+ * the host does the I/O. Programming ANDs the data into the mapping a word at
+ * a time, erasing is a memset().
+ *
  * @file
  *
  * @author      Vincent Dupont <vincent@otakeys.com>
@@ -19,58 +23,152 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "mtd.h"
 #include "mtd_native.h"
 
 #include "native_internal.h"
 
+#ifdef MODULE_XTIMER
+#include "xtimer.h"
+#endif
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+static inline size_t _size(const mtd_dev_t *dev)
+{
+    return (size_t)dev->sector_count * dev->pages_per_sector * dev->page_size;
+}
+
+static void _delay(uint32_t us)
+{
+#ifdef MODULE_XTIMER
+    if (us) {
+        xtimer_usleep(us);
+    }
+#else
+    (void)us;
+#endif
+}
+
+/* NOR flash programming can only clear bits */
+static void _program(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    while (len && ((uintptr_t)dst % sizeof(uint64_t))) {
+        *dst++ &= *src++;
+        len--;
+    }
+    for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t)) {
+        uint64_t s;
+        memcpy(&s, src, sizeof(s));
+        *(uint64_t *)dst &= s;
+        dst += sizeof(uint64_t);
+        src += sizeof(uint64_t);
+    }
+    while (len--) {
+        *dst++ &= *src++;
+    }
+}
+
+/* simulated power loss, returns how many of len bytes get done before it */
+static size_t _budget(mtd_native_dev_t *dev, size_t len)
+{
+    if (!dev->power_cut) {
+        return len;
+    }
+    if (len < dev->power_cut) {
+        dev->power_cut -= len;
+        return len;
+    }
+    len = dev->power_cut - 1;
+    dev->power_cut = 0;
+    return len;
+}
+
+static void _cut(mtd_native_dev_t *dev)
+{
+    DEBUG("mtd_native: power cut\n");
+    _native_syscall_enter();
+    munmap(dev->mem, _size(&dev->dev));
+    _native_syscall_leave();
+    dev->mem = NULL;
+}
+
 static int _init(mtd_dev_t *dev)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
+    size_t size = _size(dev);
+    int res = -EIO;
 
     DEBUG("mtd_native: init, filename=%s\n", _dev->fname);
 
-    FILE *f = real_fopen(_dev->fname, "r");
+    _native_syscall_enter();
+    if (_dev->mem) {
+        munmap(_dev->mem, size);
+        _dev->mem = NULL;
+    }
 
-    if (!f) {
-        DEBUG("mtd_native: init: creating file %s\n", name);
-        f = real_fopen(_dev->fname, "w+");
-        if (!f) {
-            return -EIO;
-        }
-        size_t size = dev->sector_count * dev->pages_per_sector * dev->page_size;
-        for (size_t i = 0; i < size; i++) {
-            real_fputc(0xff, f);
-        }
+    int fd = real_open(_dev->fname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        goto out;
+    }
+    off_t old_size = real_lseek(fd, 0, SEEK_END);
+    if ((old_size < 0) ||
+        (((size_t)old_size < size) && (ftruncate(fd, size) < 0))) {
+        real_close(fd);
+        goto out;
+    }
+
+    void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    /* the mapping stays valid without the descriptor */
+    real_close(fd);
+    if (mem == MAP_FAILED) {
+        goto out;
     }
+    _dev->mem = mem;
 
-    real_fclose(f);
+    /* new files and the part a short file grew by are erased flash */
+    if ((size_t)old_size < size) {
+        DEBUG("mtd_native: init: erasing %u bytes\n",
+              (unsigned)(size - old_size));
+        memset(_dev->mem + old_size, 0xff, size - old_size);
+    }
+    memset(&_dev->stats, 0, sizeof(_dev->stats));
+    res = 0;
 
-    return 0;
+out:
+    _native_syscall_leave();
+    return res;
 }
 
 static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: read from page %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (!_dev->mem) {
+        return -EIO;
+    }
+    if ((addr > _size(dev)) || (size > _size(dev) - addr)) {
         return -EOVERFLOW;
     }
+    if (size == 0) {
+        /* buff may be NULL */
+        return 0;
+    }
 
-    FILE *f = real_fopen(_dev->fname, "r");
-    if (!f) {
-        return -EIO;
+    memcpy(buff, _dev->mem + addr, size);
+    _dev->stats.reads++;
+    _dev->stats.read_bytes += size;
+    if (_dev->timing) {
+        _delay(_dev->timing->read_us);
     }
-    real_fseek(f, addr, SEEK_SET);
-    size = real_fread(buff, 1, size, f);
-    real_fclose(f);
 
     return size;
 }
@@ -78,29 +176,33 @@ static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
 static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
     size_t sector_size = dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: write from page %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (!_dev->mem) {
+        return -EIO;
+    }
+    if ((addr > _size(dev)) || (size > _size(dev) - addr)) {
         return -EOVERFLOW;
     }
     if (((addr % sector_size) + size) > sector_size) {
         return -EOVERFLOW;
     }
 
-    FILE *f = real_fopen(_dev->fname, "r+");
-    if (!f) {
+    size_t done = _budget(_dev, size);
+    _program(_dev->mem + addr, buff, done);
+    if (done < size) {
+        _cut(_dev);
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    for (size_t i = 0; i < size; i++) {
-        uint8_t c = real_fgetc(f);
-        real_fseek(f, -1, SEEK_CUR);
-        real_fputc(c & ((uint8_t*)buff)[i], f);
+    _dev->stats.writes++;
+    _dev->stats.write_bytes += size;
+    if (_dev->timing && size) {
+        uint32_t pages = (addr + size - 1) / dev->page_size -
+                         addr / dev->page_size + 1;
+        _delay(pages * _dev->timing->write_us);
     }
-    real_fclose(f);
 
     return size;
 }
@@ -108,27 +210,41 @@ static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size
 static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
     size_t sector_size = dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: erase from sector %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (!_dev->mem) {
+        return -EIO;
+    }
+    if ((addr > _size(dev)) || (size > _size(dev) - addr)) {
         return -EOVERFLOW;
     }
     if (((addr % sector_size) != 0) || ((size % sector_size) != 0)) {
         return -EOVERFLOW;
     }
 
-    FILE *f = real_fopen(_dev->fname, "r+");
-    if (!f) {
-        return -EIO;
-    }
-    real_fseek(f, addr, SEEK_SET);
-    for (size_t i = 0; i < size; i++) {
-        real_fputc(0xff, f);
+    for (uint32_t sector = addr / sector_size;
+         sector < (addr + size) / sector_size; sector++) {
+        if (_dev->wear) {
+            if (_dev->erase_limit &&
+                (_dev->wear[sector] >= _dev->erase_limit)) {
+                DEBUG("mtd_native: sector %" PRIu32 " worn out\n", sector);
+                return -EIO;
+            }
+            _dev->wear[sector]++;
+        }
+        size_t done = _budget(_dev, sector_size);
+        memset(_dev->mem + sector * sector_size, 0xff, done);
+        if (done < sector_size) {
+            _cut(_dev);
+            return -EIO;
+        }
+        _dev->stats.erases++;
+        if (_dev->timing) {
+            _delay(_dev->timing->erase_us);
+        }
     }
-    real_fclose(f);
 
     return 0;
 }
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @ingroup     drivers_periph_crypto
+ * @{
+ *
+ * @file
+ * @brief       Native CPU periph/crypto.h implementation
+ *
+ * A host thread plays the accelerator. Jobs travel to it through a request
+ * pipe. It sleeps for the emulated latency, computes the result with the
+ * software AES and SHA-256 and returns the job through a completion pipe,
+ * which raises SIGIO. The completion is handled in RIOT's interrupt context
+ * like the UART and tap interrupts.
+ *
+ * The host thread blocks all signals, so RIOT's signal handlers only ever run
+ * on the thread executing RIOT.
+ *
+ * @}
+ */
+
+#include <err.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include "periph_conf.h"
+#include "periph/crypto.h"
+#include "async_read.h"
+#include "native_internal.h"
+
+#include "crypto/aes.h"
+#include "hashes/sha256.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/**
+ * @brief   Message passed through both pipes, small enough to be written
+ *          atomically
+ */
+typedef struct {
+    crypto_hw_job_t *job;       /**< the job */
+    int status;                 /**< its result, on the way back */
+} _msg_t;
+
+static int _req_pipe[2];
+static int _done_pipe[2];
+/* pthread_t is an integer or a pointer on all supported hosts */
+static uintptr_t _worker_thread;
+
+static void _delay(const crypto_hw_job_t *job)
+{
+    size_t nblocks = (job->len + CRYPTO_HW_AES_BLOCK_SIZE - 1) /
+                     CRYPTO_HW_AES_BLOCK_SIZE;
+    uint64_t us = NATIVE_CRYPTO_LATENCY_US +
+                  (uint64_t)NATIVE_CRYPTO_US_PER_BLOCK * nblocks;
+    struct timeval tv = { .tv_sec = us / 1000000, .tv_usec = us % 1000000 };
+
+    if (us) {
+        real_select(0, NULL, NULL, NULL, &tv);
+    }
+}
+
+static void _ctr_inc(uint8_t *ctr)
+{
+    for (int i = CRYPTO_HW_AES_BLOCK_SIZE - 1; i >= 0; i--) {
+        if (++ctr[i]) {
+            break;
+        }
+    }
+}
+
+static int _run(crypto_hw_job_t *job)
+{
+    /* cipher_context_t is only large enough if the application defines
+     * CRYPTO_AES, so make room for the AES key schedules here */
+    union {
+        cipher_context_t cipher;
+        aes_context_t aes;
+    } ctx;
+    size_t nblocks = job->len / CRYPTO_HW_AES_BLOCK_SIZE;
+
+    if (job->op == CRYPTO_HW_SHA256) {
+        sha256(job->in, job->len, job->out);
+        return CRYPTO_HW_OK;
+    }
+
+    if (aes_init(&ctx.cipher, job->key, job->key_len) != CIPHER_INIT_SUCCESS) {
+        return CRYPTO_HW_NOTSUP;
+    }
+    switch (job->op) {
+        case CRYPTO_HW_AES_ECB_ENCRYPT:
+            aes_encrypt_blocks(&ctx.cipher, job->in, job->out, nblocks);
+            break;
+        case CRYPTO_HW_AES_ECB_DECRYPT:
+            aes_decrypt_blocks(&ctx.cipher, job->in, job->out, nblocks);
+            break;
+        case CRYPTO_HW_AES_CTR:
+            for (size_t pos = 0; pos < job->len;
+                 pos += CRYPTO_HW_AES_BLOCK_SIZE) {
+                uint8_t stream[CRYPTO_HW_AES_BLOCK_SIZE];
+                size_t n = job->len - pos;
+
+                if (n > CRYPTO_HW_AES_BLOCK_SIZE) {
+                    n = CRYPTO_HW_AES_BLOCK_SIZE;
+                }
+                aes_encrypt(&ctx.cipher, job->ctr, stream);
+                _ctr_inc(job->ctr);
+                for (size_t i = 0; i < n; i++) {
+                    job->out[pos + i] = job->in[pos + i] ^ stream[i];
+                }
+            }
+            break;
+        default:
+            return CRYPTO_HW_NOTSUP;
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    return CRYPTO_HW_OK;
+}
+
+static void *_worker(void *arg)
+{
+    _msg_t msg;
+
+    (void)arg;
+    while (real_read(_req_pipe[0], &msg, sizeof(msg)) == sizeof(msg)) {
+        _delay(msg.job);
+        msg.status = _run(msg.job);
+        if (real_write(_done_pipe[1], &msg, sizeof(msg)) != sizeof(msg)) {
+            err(EXIT_FAILURE, "crypto: write");
+        }
+    }
+    return NULL;
+}
+
+static void _done_isr(int fd, void *arg)
+{
+    _msg_t msg;
+
+    (void)arg;
+    while (real_read(fd, &msg, sizeof(msg)) == sizeof(msg)) {
+        DEBUG("crypto: job %p done (%d)\n", (void *)msg.job, msg.status);
+        crypto_hw_complete(msg.job, msg.status);
+    }
+    native_async_read_continue(fd);
+}
+
+void crypto_hw_init(void)
+{
+    sigset_t all, old;
+
+    _native_syscall_enter();
+    if ((real_pipe(_req_pipe) == -1) || (real_pipe(_done_pipe) == -1)) {
+        err(EXIT_FAILURE, "crypto_hw_init: pipe");
+    }
+    /* a full queue is reported to the submitter instead of blocking RIOT */
+    if (real_fcntl(_req_pipe[1], F_SETFL, O_NONBLOCK) == -1) {
+        err(EXIT_FAILURE, "crypto_hw_init: fcntl");
+    }
+    if (real_pthread_create == NULL) {
+        errx(EXIT_FAILURE, "crypto_hw_init: host has no pthread_create");
+    }
+    /* the thread inherits the signal mask of its creator */
+    sigfillset(&all);
+    sigprocmask(SIG_SETMASK, &all, &old);
+    int res = real_pthread_create(&_worker_thread, NULL, _worker, NULL);
+    sigprocmask(SIG_SETMASK, &old, NULL);
+    if (res != 0) {
+        errno = res;
+        err(EXIT_FAILURE, "crypto_hw_init: pthread_create");
+    }
+    _native_syscall_leave();
+
+    native_async_read_setup();
+    native_async_read_add_handler(_done_pipe[0], NULL, _done_isr);
+}
+
+int crypto_hw_submit(crypto_hw_job_t *job)
+{
+    _msg_t msg = { .job = job, .status = CRYPTO_HW_PENDING };
+
+    int res = crypto_hw_prepare(job);
+    if (res != CRYPTO_HW_OK) {
+        return res;
+    }
+
+    _native_syscall_enter();
+    ssize_t n = real_write(_req_pipe[1], &msg, sizeof(msg));
+    _native_syscall_leave();
+
+    if (n != sizeof(msg)) {
+        crypto_hw_reject(job, CRYPTO_HW_BUSY);
+        return CRYPTO_HW_BUSY;
+    }
+    return CRYPTO_HW_OK;
+}
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     native_cpu
+ * @ingroup     drivers_periph_rtt
+ * @{
+ *
+ * @file
+ * @brief       Native CPU periph/rtt.h implementation
+ *
+ * The counter is derived from the host's monotonic clock. Alarm and overflow
+ * interrupts are delivered through a POSIX per-process timer signalling
+ * SIGVTALRM, so the RTT is independent of the SIGALRM based periph/timer.
+ *
+ * @}
+ */
+
+#include <time.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <err.h>
+
+#include "cpu.h"
+#include "periph_conf.h"
+#include "periph/rtt.h"
+#include "native_internal.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+/* RTT is not available on OS X, which lacks POSIX per-process timers */
+#if RTT_NUMOF
+
+#define NATIVE_RTT_SIGNAL   (SIGVTALRM)
+#define NS_PER_SEC          (1000000000ULL)
+
+static timer_t _timer;
+static uint64_t _time_null;
+static uint32_t _offset;
+static int _powered;
+
+static uint32_t _alarm;
+static uint64_t _alarm_deadline;
+static rtt_cb_t _alarm_cb;
+static void *_alarm_arg;
+
+static uint64_t _overflow_deadline;
+static rtt_cb_t _overflow_cb;
+static void *_overflow_arg;
+
+static uint64_t _now_ns(void)
+{
+    struct timespec t;
+
+    _native_syscall_enter();
+    if (real_clock_gettime(CLOCK_MONOTONIC, &t) == -1) {
+        err(EXIT_FAILURE, "rtt: clock_gettime");
+    }
+    _native_syscall_leave();
+
+    return ((uint64_t)t.tv_sec * NS_PER_SEC) + t.tv_nsec;
+}
+
+static uint32_t _ticks(uint64_t ns)
+{
+    ns -= _time_null;
+    return (uint32_t)((ns / NS_PER_SEC) * RTT_FREQUENCY +
+                      ((ns % NS_PER_SEC) * RTT_FREQUENCY) / NS_PER_SEC);
+}
+
+/**
+ * @brief   returns the host time at which the counter will have advanced by
+ *          @p ticks (a value of 0 means one full counter period)
+ */
+static uint64_t _deadline(uint64_t now, uint32_t ticks)
+{
+    uint64_t delta = ticks ? ticks : ((uint64_t)RTT_MAX_VALUE + 1);
+    return now + ((delta * NS_PER_SEC) / RTT_FREQUENCY);
+}
+
+static void _arm(uint64_t now)
+{
+    struct itimerspec its;
+    uint64_t next = UINT64_MAX;
+
+    if (_alarm_cb) {
+        next = _alarm_deadline;
+    }
+    if (_overflow_cb && (_overflow_deadline < next)) {
+        next = _overflow_deadline;
+    }
+
+    memset(&its, 0, sizeof(its));
+    if (_powered && (next != UINT64_MAX)) {
+        /* a zero it_value disarms the timer, so fire at least 1ns later */
+        uint64_t delta = (next > now) ? (next - now) : 1;
+        its.it_value.tv_sec = delta / NS_PER_SEC;
+        its.it_value.tv_nsec = delta % NS_PER_SEC;
+    }
+
+    _native_syscall_enter();
+    if (timer_settime(_timer, 0, &its, NULL) == -1) {
+        err(EXIT_FAILURE, "rtt: timer_settime");
+    }
+    _native_syscall_leave();
+}
+
+static void _rtt_isr(void)
+{
+    uint64_t now = _now_ns();
+
+    DEBUG("%s\n", __func__);
+
+    if (_alarm_cb && (now >= _alarm_deadline)) {
+        rtt_cb_t cb = _alarm_cb;
+        _alarm_cb = NULL;
+        cb(_alarm_arg);
+    }
+    if (_overflow_cb && (now >= _overflow_deadline)) {
+        _overflow_deadline = _deadline(_overflow_deadline, 0);
+        _overflow_cb(_overflow_arg);
+    }
+
+    _arm(_now_ns());
+}
+
+void rtt_init(void)
+{
+    struct sigevent sev;
+
+    DEBUG("%s\n", __func__);
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = NATIVE_RTT_SIGNAL;
+
+    _native_syscall_enter();
+    if (timer_create(CLOCK_MONOTONIC, &sev, &_timer) == -1) {
+        err(EXIT_FAILURE, "rtt_init: timer_create");
+    }
+    _native_syscall_leave();
+
+    if (register_interrupt(NATIVE_RTT_SIGNAL, _rtt_isr) != 0) {
+        DEBUG("rtt_init: register_interrupt failed\n");
+    }
+
+    _time_null = _now_ns();
+    _offset = 0;
+    _alarm_cb = NULL;
+    _overflow_cb = NULL;
+
+    rtt_poweron();
+}
+
+void rtt_set_overflow_cb(rtt_cb_t cb, void *arg)
+{
+    uint64_t now = _now_ns();
+
+    _overflow_arg = arg;
+    _overflow_cb = cb;
+    _overflow_deadline = _deadline(now, (uint32_t)(0 - rtt_get_counter()));
+    _arm(now);
+}
+
+void rtt_clear_overflow_cb(void)
+{
+    _overflow_cb = NULL;
+    _arm(_now_ns());
+}
+
+uint32_t rtt_get_counter(void)
+{
+    return (_ticks(_now_ns()) + _offset) & RTT_MAX_VALUE;
+}
+
+void rtt_set_counter(uint32_t counter)
+{
+    uint64_t now = _now_ns();
+
+    _offset = counter - _ticks(now);
+    /* alarm and overflow are defined in counter values, so move them along */
+    _alarm_deadline = _deadline(now, (_alarm - counter) & RTT_MAX_VALUE);
+    _overflow_deadline = _deadline(now, (uint32_t)(0 - counter));
+    _arm(now);
+}
+
+void rtt_set_alarm(uint32_t alarm, rtt_cb_t cb, void *arg)
+{
+    uint64_t now = _now_ns();
+
+    _alarm = alarm & RTT_MAX_VALUE;
+    _alarm_arg = arg;
+    _alarm_cb = cb;
+    _alarm_deadline = _deadline(now, (_alarm - rtt_get_counter()) & RTT_MAX_VALUE);
+    _arm(now);
+}
+
+uint32_t rtt_get_alarm(void)
+{
+    return _alarm;
+}
+
+void rtt_clear_alarm(void)
+{
+    _alarm_cb = NULL;
+    _arm(_now_ns());
+}
+
+void rtt_poweron(void)
+{
+    _powered = 1;
+    _arm(_now_ns());
+}
+
+void rtt_poweroff(void)
+{
+    _powered = 0;
+    _arm(_now_ns());
+}
+
+#endif /* RTT_NUMOF */
@@ -147,7 +147,7 @@ int timer_set(tim_t dev, int channel, unsigned int offset)
 int timer_set_absolute(tim_t dev, int channel, unsigned int value)
 {
     uint32_t now = timer_read(dev);
-    return timer_set(dev, channel, value - now);
+    return timer_set(dev, channel, (value - now) & TIMER_0_MAX_VALUE);
 }
 
 int timer_clear(tim_t dev, int channel)
@@ -200,5 +200,5 @@ unsigned int timer_read(tim_t dev)
 #endif
     _native_syscall_leave();
 
-    return ts2ticks(&t) - time_null;
+    return (ts2ticks(&t) - time_null) & TIMER_0_MAX_VALUE;
 }
@@ -76,6 +76,7 @@ int (*real_fork)(void);
 int (*real_feof)(FILE *stream);
 int (*real_ferror)(FILE *stream);
 int (*real_listen)(int socket, int backlog);
+off_t (*real_lseek)(int fd, off_t offset, int whence);
 int (*real_ioctl)(int fildes, int request, ...);
 int (*real_open)(const char *path, int oflag, ...);
 int (*real_pause)(void);
@@ -96,6 +97,8 @@ int (*real_fputc)(int c, FILE *stream);
 int (*real_fgetc)(FILE *stream);
 mode_t (*real_umask)(mode_t cmask);
 ssize_t (*real_writev)(int fildes, const struct iovec *iov, int iovcnt);
+int (*real_pthread_create)(void *thread, const void *attr,
+                           void *(*start_routine)(void *), void *arg);
 
 #ifdef __MACH__
 #else
@@ -469,6 +472,7 @@ void _native_init_syscalls(void)
     *(void **)(&real_execve) = dlsym(RTLD_NEXT, "execve");
     *(void **)(&real_ioctl) = dlsym(RTLD_NEXT, "ioctl");
     *(void **)(&real_listen) = dlsym(RTLD_NEXT, "listen");
+    *(void **)(&real_lseek) = dlsym(RTLD_NEXT, "lseek");
     *(void **)(&real_open) = dlsym(RTLD_NEXT, "open");
     *(void **)(&real_pause) = dlsym(RTLD_NEXT, "pause");
     *(void **)(&real_fopen) = dlsym(RTLD_NEXT, "fopen");
@@ -482,6 +486,7 @@ void _native_init_syscalls(void)
     *(void **)(&real_fseek) = dlsym(RTLD_NEXT, "fseek");
     *(void **)(&real_fputc) = dlsym(RTLD_NEXT, "fputc");
     *(void **)(&real_fgetc) = dlsym(RTLD_NEXT, "fgetc");
+    *(void **)(&real_pthread_create) = dlsym(RTLD_NEXT, "pthread_create");
 #ifdef __MACH__
 #else
     *(void **)(&real_clock_gettime) = dlsym(RTLD_NEXT, "clock_gettime");
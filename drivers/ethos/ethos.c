@@ -89,16 +89,19 @@ static void _handle_char(ethos_t *dev, char c)
     switch (dev->frametype) {
         case ETHOS_FRAME_TYPE_DATA:
         case ETHOS_FRAME_TYPE_HELLO:
-        case ETHOS_FRAME_TYPE_HELLO_REPLY:
-             if (tsrb_add_one(&dev->inbuf, c) == 0) {
+        case ETHOS_FRAME_TYPE_HELLO_REPLY: {
+            /* the frame is only committed to inbuf once complete, so a
+             * dropped frame does not leave partial data behind */
+            char *pos;
+            if (tsrb_reserve(&dev->inbuf, dev->framesize, &pos)) {
+                *pos = c;
                 dev->framesize++;
             } else {
-                //puts("lost frame");
-                dev->inbuf.reads = 0;
-                dev->inbuf.writes = 0;
+                DEBUG("ethos: inbuf full, dropping frame\n");
                 _reset_state(dev);
             }
             break;
+        }
 #ifdef USE_ETHOS_FOR_STDIO
         case ETHOS_FRAME_TYPE_TEXT:
             dev->framesize++;
@@ -112,6 +115,7 @@ static void _end_of_frame(ethos_t *dev)
     switch(dev->frametype) {
         case ETHOS_FRAME_TYPE_DATA:
             if (dev->framesize) {
+                tsrb_commit(&dev->inbuf, dev->framesize);
                 dev->last_framesize = dev->framesize;
                 dev->netdev.event_callback((netdev_t*) dev, NETDEV_EVENT_ISR);
             }
@@ -121,7 +125,13 @@ static void _end_of_frame(ethos_t *dev)
             /* fall through */
         case ETHOS_FRAME_TYPE_HELLO_REPLY:
             if (dev->framesize == 6) {
-                tsrb_get(&dev->inbuf, (char*)dev->remote_mac_addr, 6);
+                /* read the address back from the reserved space, there may
+                 * still be an unread data frame in front of it */
+                for (unsigned i = 0; i < 6; i++) {
+                    char *pos;
+                    tsrb_reserve(&dev->inbuf, i, &pos);
+                    dev->remote_mac_addr[i] = *pos;
+                }
             }
             break;
     }
@@ -315,6 +325,13 @@ static int _recv(netdev_t *netdev, void *buf, size_t len, void* info)
 
         return (int)len;
     }
+    else if (len > 0) {
+        /* drop the frame, the next one starts right after it */
+        len = dev->last_framesize;
+        dev->last_framesize = 0;
+        tsrb_drop(&dev->inbuf, len);
+        return (int)len;
+    }
     else {
         return dev->last_framesize;
     }
@@ -27,6 +27,11 @@
 #if MODULE_VFS
 #include "vfs.h"
 #endif
+#if MODULE_MTD_ASYNC
+#include "kernel_types.h"
+#include "mutex.h"
+#include "thread.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +57,11 @@ enum mtd_power_state {
  */
 typedef struct mtd_desc mtd_desc_t;
 
+/**
+ * @brief MTD request, see @ref mtd_submit
+ */
+typedef struct mtd_req mtd_req_t;
+
 /**
  * @brief MTD device descriptor
  */
@@ -146,6 +156,34 @@ struct mtd_desc {
      * @return < 0 value on error
      */
     int (*power)(mtd_dev_t *dev, enum mtd_power_state power);
+
+    /**
+     * @brief Write buffered data to the Memory Technology Device (MTD)
+     *
+     * Optional, only needed by drivers that defer writes.
+     *
+     * @param[in] dev       Pointer to the selected driver
+     *
+     * @return 0 on success
+     * @return < 0 value on error
+     */
+    int (*flush)(mtd_dev_t *dev);
+
+    /**
+     * @brief Start or continue an asynchronous request
+     *
+     * Optional, used by module `mtd_async` instead of the blocking functions.
+     * Starts the next part of @p req and advances mtd_req_t::pos by its size,
+     * or checks whether the part started before is still in progress.
+     *
+     * @param[in] dev       Pointer to the selected driver
+     * @param[in,out] req   Request to process
+     *
+     * @return 0 when the request is complete
+     * @return > 0 time in microseconds after which to call again
+     * @return < 0 value on error
+     */
+    int (*async)(mtd_dev_t *dev, mtd_req_t *req);
 };
 
 /**
@@ -229,6 +267,106 @@ int mtd_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t count);
  */
 int mtd_power(mtd_dev_t *mtd, enum mtd_power_state power);
 
+/**
+ * @brief mtd_sync Write data buffered by a MTD device to the memory
+ * Does nothing for devices that write immediately.
+ * @param      mtd   the device to synchronize
+ * @return 0 if all data has been written
+ * @return < 0 if an error occured
+ * @return -ENODEV if @p mtd is not a valid device
+ * @return -EIO if I/O error occured
+ */
+int mtd_sync(mtd_dev_t *mtd);
+
+#if defined(MODULE_MTD_ASYNC) || defined(DOXYGEN)
+/**
+ * @name    Asynchronous requests (module `mtd_async`)
+ *
+ * Requests are queued and run one after the other by a worker thread, so the
+ * submitter can continue while e.g. a sector is erased. Drivers implementing
+ * mtd_desc::async start an operation and let the worker sleep until it is
+ * done, the blocking functions of other drivers are called by the worker.
+ *
+ * While requests for a device are pending, use the device only through the
+ * queue. The blocking functions would run concurrently with the worker, which
+ * the flash may not support. Drivers that serialize their blocking functions
+ * with requests say so, e.g. mtd_spi_nor waits for a pending request.
+ * @{
+ */
+
+/**
+ * @brief Operation of a request
+ */
+enum mtd_req_op {
+    MTD_REQ_READ,    /**< read @p count bytes */
+    MTD_REQ_WRITE,   /**< write @p count bytes, may span pages */
+    MTD_REQ_ERASE,   /**< erase, see mtd_erase() */
+};
+
+/**
+ * @brief Completion callback, called in the context of the worker thread
+ */
+typedef void (*mtd_req_cb_t)(mtd_req_t *req, void *arg);
+
+/**
+ * @brief MTD request
+ *
+ * Set the fields up to @p flags, the rest belongs to the worker.
+ */
+struct mtd_req {
+    mtd_dev_t *mtd;          /**< device */
+    enum mtd_req_op op;      /**< operation */
+    void *buf;               /**< data to write or buffer to read to */
+    uint32_t addr;           /**< start address */
+    uint32_t count;          /**< number of bytes */
+    mtd_req_cb_t cb;         /**< completion callback, may be NULL */
+    void *arg;               /**< argument of @p cb */
+#if defined(MODULE_CORE_THREAD_FLAGS) || defined(DOXYGEN)
+    thread_t *thread;        /**< thread to notify on completion, may be
+                              *   NULL */
+    thread_flags_t flags;    /**< thread flags to set on @p thread */
+#endif
+    mtd_req_t *next;         /**< worker internal queue */
+    mutex_t done;            /**< unlocked on completion */
+    uint32_t pos;            /**< bytes processed, for the driver */
+    int res;                 /**< result, as of the blocking function */
+};
+
+/**
+ * @brief Start the worker thread for asynchronous requests
+ *
+ * @param[in] stack       stack of the worker thread
+ * @param[in] stacksize   size of @p stack
+ * @param[in] priority    priority of the worker thread
+ *
+ * @return PID of the worker thread
+ * @return < 0 if the thread could not be created
+ */
+kernel_pid_t mtd_async_init(char *stack, int stacksize, char priority);
+
+/**
+ * @brief Queue a request. May be called from interrupt context.
+ *
+ * Requests complete in the order of submission. The request can be reused
+ * when mtd_wait() returned or the thread flags were set.
+ *
+ * @param[in,out] req     request to run, must stay valid until completion
+ */
+void mtd_submit(mtd_req_t *req);
+
+/**
+ * @brief Wait for a submitted request to complete
+ *
+ * @param[in] req         request passed to mtd_submit()
+ *
+ * @return number of bytes read or written, 0 for erase
+ * @return < 0 on errors, see mtd_read(), mtd_write() and mtd_erase()
+ */
+int mtd_wait(mtd_req_t *req);
+
+/** @} */
+#endif /* MODULE_MTD_ASYNC */
+
 #if defined(MODULE_VFS) || defined(DOXYGEN)
 /**
  * @brief MTD driver for VFS
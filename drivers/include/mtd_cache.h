@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_mtd_cache MTD page cache
+ * @ingroup     drivers_storage
+ * @brief       Write-back page cache stacked on another MTD
+ *
+ * File systems access the flash in small pieces: SPIFFS reads object
+ * headers and lookup entries a few bytes at a time. On serial flash each
+ * of these costs a full command and address phase. An mtd_cache_t is a MTD
+ * itself and keeps the most recently used pages of the MTD below it in RAM:
+ *
+ * - reads are served from cached pages, a miss loads the whole page,
+ * - writes are collected in cached pages and written back when the page is
+ *   evicted or on mtd_sync(),
+ * - a miss directly after the previous miss loads @ref mtd_cache_t::readahead
+ *   further pages with the same read,
+ * - reads of several whole uncached pages go directly to the caller's
+ *   buffer.
+ *
+ * The cache assumes NOR flash semantics like all MTD drivers: writes only
+ * clear bits. Data written to the cache is lost on a reset unless
+ * mtd_sync() was called.
+ *
+ * @code
+ * static mtd_cache_line_t lines[8];
+ * static uint8_t data[8 * 256];
+ * static mtd_cache_t cache = {
+ *     .base = { .driver = &mtd_cache_driver },
+ *     .parent = MTD_0,
+ *     .lines = lines,
+ *     .data = data,
+ *     .nlines = 8,
+ *     .readahead = 3,
+ * };
+ * @endcode
+ *
+ * `data` must hold `nlines` pages of the parent.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Interface definition for the MTD page cache
+ */
+
+#ifndef MTD_CACHE_H
+#define MTD_CACHE_H
+
+#include <stdint.h>
+
+#include "mtd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Cache statistics
+ */
+typedef struct {
+    uint32_t hits;          /**< page accesses served from the cache */
+    uint32_t misses;        /**< pages loaded on demand */
+    uint32_t prefetched;    /**< pages loaded by read-ahead */
+    uint32_t writebacks;    /**< dirty pages written to the parent */
+    uint32_t bypassed;      /**< pages read directly into the caller's
+                             *   buffer */
+} mtd_cache_stats_t;
+
+/**
+ * @brief   State of a cached page
+ */
+typedef struct {
+    uint32_t page;          /**< page number, UINT32_MAX if unused */
+    uint32_t used;          /**< time of the last access */
+    uint8_t dirty;          /**< not written to the parent yet */
+} mtd_cache_line_t;
+
+/**
+ * @brief   MTD page cache
+ */
+typedef struct {
+    mtd_dev_t base;             /**< mtd generic device, the geometry is
+                                 *   copied from @p parent by init */
+    mtd_dev_t *parent;          /**< the cached MTD */
+    mtd_cache_line_t *lines;    /**< @p nlines line descriptors */
+    uint8_t *data;              /**< @p nlines pages of @p parent */
+    unsigned nlines;            /**< number of cached pages */
+    unsigned readahead;         /**< pages loaded in addition on sequential
+                                 *   misses, less than @p nlines */
+    uint32_t next_miss;         /**< page following the last miss */
+    uint32_t clock;             /**< access counter for LRU */
+    mtd_cache_stats_t stats;    /**< statistics, reset by init */
+} mtd_cache_t;
+
+/**
+ * @brief   MTD page cache driver
+ */
+extern const mtd_desc_t mtd_cache_driver;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_CACHE_H */
+/** @} */
@@ -12,6 +12,10 @@
  * @ingroup     drivers_storage
  * @brief       Driver for serial NOR flash memory technology devices attached via SPI
  *
+ * With module `mtd_async`, the blocking functions may be called while
+ * requests for the device are pending, they wait until the requests and any
+ * program or erase in progress are done.
+ *
  * @{
  *
  * @file
@@ -30,6 +34,7 @@
 #include "periph/spi.h"
 #include "periph/gpio.h"
 #include "mtd.h"
+#include "mutex.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -122,6 +127,15 @@ typedef struct {
      * Computed by mtd_spi_nor_init, no need to touch outside the driver.
      */
     uint8_t sec_addr_shift;
+#if defined(MODULE_MTD_ASYNC) || defined(DOXYGEN)
+    /**
+     * @brief held by blocking calls and by asynchronous requests until they
+     *        complete
+     *
+     * Zero is the unlocked mutex, no need to touch outside the driver.
+     */
+    mutex_t lock;
+#endif
 } mtd_spi_nor_t;
 
 /**
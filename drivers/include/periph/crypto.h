@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_periph_crypto Crypto accelerator
+ * @ingroup     drivers_periph
+ * @brief       Asynchronous interface to crypto accelerators
+ *
+ * Many MCUs (e.g. cc2538, nrf52, sam0, stm32) contain an AES and SHA engine.
+ * This interface hands jobs to such an engine and notifies the submitter
+ * when a job is done, so a thread can keep e.g. the radio busy while a
+ * packet is encrypted or a firmware image is hashed.
+ *
+ * A job is described by a @ref crypto_hw_job_t in memory of the caller.
+ * After crypto_hw_submit() returned CRYPTO_HW_OK, the job and all buffers it
+ * points to belong to the driver until the job is completed. Completion is
+ * signalled, in this order, by
+ * - calling the job's callback (in interrupt context),
+ * - setting thread flags of the job's thread (with module
+ *   `core_thread_flags`),
+ * - waking up a thread blocked in crypto_hw_wait().
+ *
+ * A callback may submit its job again, e.g. with the next part of a stream.
+ * The job is then only signalled to threads once that submission is done.
+ *
+ * Jobs are processed in the order of submission. Each job is self-contained:
+ * SHA-256 jobs hash a whole message, AES-CTR jobs advance the counter block
+ * they were given, so a stream can be split into several jobs.
+ *
+ * On `native`, a host thread stands in for the accelerator. It delays every
+ * job by NATIVE_CRYPTO_LATENCY_US plus NATIVE_CRYPTO_US_PER_BLOCK per 16
+ * bytes of input and computes the result with the software implementations
+ * of `crypto` and `hashes`.
+ *
+ * @{
+ * @file
+ * @brief       Crypto accelerator peripheral driver interface definition
+ */
+
+#ifndef PERIPH_CRYPTO_H
+#define PERIPH_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mutex.h"
+#ifdef MODULE_CORE_THREAD_FLAGS
+#include "thread_flags.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of blocks and counter blocks of AES jobs
+ */
+#define CRYPTO_HW_AES_BLOCK_SIZE        (16U)
+
+/**
+ * @brief   Size of AES keys, only AES-128 is supported
+ */
+#define CRYPTO_HW_AES_KEY_SIZE          (16U)
+
+/**
+ * @brief   Size of the result of SHA-256 jobs
+ */
+#define CRYPTO_HW_SHA256_DIGEST_SIZE    (32U)
+
+/**
+ * @brief   Return values and job status
+ */
+enum {
+    CRYPTO_HW_OK        =  0,   /**< job submitted or done */
+    CRYPTO_HW_PENDING   =  1,   /**< job submitted and not done yet */
+    CRYPTO_HW_NOTSUP    = -1,   /**< operation not supported */
+    CRYPTO_HW_INVAL     = -2,   /**< invalid parameters */
+    CRYPTO_HW_BUSY      = -3,   /**< job queue is full */
+};
+
+/**
+ * @brief   Operations
+ */
+typedef enum {
+    CRYPTO_HW_AES_ECB_ENCRYPT,  /**< AES-128 encryption of whole blocks */
+    CRYPTO_HW_AES_ECB_DECRYPT,  /**< AES-128 decryption of whole blocks */
+    CRYPTO_HW_AES_CTR,          /**< AES-128 in counter mode */
+    CRYPTO_HW_SHA256,           /**< SHA-256 digest */
+} crypto_hw_op_t;
+
+/**
+ * @brief   Forward declaration of a job
+ */
+typedef struct crypto_hw_job crypto_hw_job_t;
+
+/**
+ * @brief   Signature of completion callbacks
+ *
+ * @param[in] job   the completed job, job->status holds the result
+ * @param[in] arg   the job's callback argument
+ */
+typedef void (*crypto_hw_cb_t)(crypto_hw_job_t *job, void *arg);
+
+/**
+ * @brief   Crypto job
+ *
+ * Set the public fields and leave the rest to crypto_hw_submit().
+ */
+struct crypto_hw_job {
+    crypto_hw_job_t *next;      /**< driver internal queue */
+    crypto_hw_op_t op;          /**< operation */
+    const uint8_t *key;         /**< AES key, unused for SHA-256 */
+    size_t key_len;             /**< length of @p key, must be
+                                 *   CRYPTO_HW_AES_KEY_SIZE */
+    uint8_t *ctr;               /**< counter block, AES-CTR only. Advanced
+                                 *   by the number of blocks processed */
+    const uint8_t *in;          /**< input data */
+    uint8_t *out;               /**< output, @p len bytes for AES and
+                                 *   CRYPTO_HW_SHA256_DIGEST_SIZE bytes for
+                                 *   SHA-256. May equal @p in for AES */
+    size_t len;                 /**< length of the input, a multiple of
+                                 *   CRYPTO_HW_AES_BLOCK_SIZE for AES-ECB */
+    crypto_hw_cb_t cb;          /**< completion callback, may be NULL */
+    void *arg;                  /**< argument of @p cb */
+#if defined(MODULE_CORE_THREAD_FLAGS) || defined(DOXYGEN)
+    thread_t *thread;           /**< thread to notify, may be NULL */
+    thread_flags_t flags;       /**< flags to set on @p thread */
+#endif
+    mutex_t done;               /**< unlocked on completion */
+    volatile int status;        /**< CRYPTO_HW_PENDING or the result */
+};
+
+/**
+ * @brief   Initialize the crypto accelerator
+ *
+ * Must be called once before the first job is submitted.
+ */
+void crypto_hw_init(void);
+
+/**
+ * @brief   Submit a job
+ *
+ * May be called from interrupt context, e.g. from the completion callback
+ * of a previous job.
+ *
+ * @param[in,out] job   job to run
+ *
+ * @return  CRYPTO_HW_OK if the job was queued
+ * @return  CRYPTO_HW_NOTSUP if the operation is not supported
+ * @return  CRYPTO_HW_INVAL if the parameters of the job are invalid
+ * @return  CRYPTO_HW_BUSY if the driver cannot take another job right now
+ */
+int crypto_hw_submit(crypto_hw_job_t *job);
+
+/**
+ * @brief   Wait until a submitted job is done
+ *
+ * Only one thread may wait for a job.
+ *
+ * @param[in] job   job submitted with crypto_hw_submit()
+ *
+ * @return  CRYPTO_HW_OK or an error of the accelerator
+ */
+int crypto_hw_wait(crypto_hw_job_t *job);
+
+/**
+ * @brief   Check parameters of a job and mark it pending
+ *
+ * For drivers, to be called by crypto_hw_submit() before queueing @p job.
+ *
+ * @param[in,out] job   job to check
+ *
+ * @return  CRYPTO_HW_OK if @p job may be queued
+ * @return  CRYPTO_HW_NOTSUP if the operation or the key length is not
+ *          supported
+ * @return  CRYPTO_HW_INVAL if the parameters of @p job are invalid
+ */
+int crypto_hw_prepare(crypto_hw_job_t *job);
+
+/**
+ * @brief   Give up a prepared job that cannot be queued
+ *
+ * For drivers, to be called by crypto_hw_submit() if a job that passed
+ * crypto_hw_prepare() cannot be queued. Unless the job was submitted again by
+ * its completion callback, crypto_hw_wait() returns @p status right away.
+ *
+ * @param[in,out] job       job that is not queued
+ * @param[in]     status    error returned by crypto_hw_submit()
+ */
+void crypto_hw_reject(crypto_hw_job_t *job, int status);
+
+/**
+ * @brief   Complete a job
+ *
+ * For drivers, to be called once a job is done, usually from interrupt
+ * context. Notifies the submitter of @p job as described above.
+ *
+ * @param[in,out] job       job that is done
+ * @param[in]     status    CRYPTO_HW_OK or an error
+ */
+void crypto_hw_complete(crypto_hw_job_t *job, int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERIPH_CRYPTO_H */
+/** @} */
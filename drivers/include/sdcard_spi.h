@@ -28,6 +28,10 @@ extern "C" {
 #include "periph/spi.h"
 #include "periph/gpio.h"
 #include "stdbool.h"
+#ifdef MODULE_SDCARD_SPI_ASYNC
+#include "mutex.h"
+#include "kernel_types.h"
+#endif
 
 #define SD_HC_BLOCK_SIZE      (512)  /**< size of a single block on SDHC cards */
 #define SDCARD_SPI_INIT_ERROR (-1)   /**< returned on failed init */
@@ -255,6 +259,20 @@ int sdcard_spi_read_blocks(sdcard_spi_t *card, int blockaddr, char *data, int bl
 int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, char *data, int blocksize,
                             int nblocks, sd_rw_response_t *state);
 
+/**
+ * @brief                 Waits until the card finished programming written data.
+ *
+ * sdcard_spi_write_blocks() returns as soon as the card accepted the last block, the card
+ * programs it while the caller goes on. The next command waits for the card, so calling this
+ * is only needed before the card is powered off or removed.
+ *
+ * @param[in] card        Initialized sd-card struct
+ *
+ * @return                SD_RW_OK if the card is ready
+ * @return                SD_RW_TIMEOUT if the card stayed busy
+ */
+sd_rw_response_t sdcard_spi_sync(sdcard_spi_t *card);
+
 /**
  * @brief                 Gets the capacity of the card.
  *
@@ -264,6 +282,76 @@ int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, char *data, int b
  */
 uint64_t sdcard_spi_get_capacity(sdcard_spi_t *card);
 
+#if defined(MODULE_SDCARD_SPI_ASYNC) || defined(DOXYGEN)
+/**
+ * @name    Asynchronous block transfers (module `sdcard_spi_async`)
+ *
+ * Requests are queued and run one after the other by a worker thread, so the
+ * submitter can prepare the next request while the current one is in flight.
+ * @{
+ */
+
+/**
+ * @brief   Forward declaration of a request
+ */
+typedef struct sdcard_spi_req sdcard_spi_req_t;
+
+/**
+ * @brief   Completion callback, called in the context of the worker thread
+ */
+typedef void (*sdcard_spi_cb_t)(sdcard_spi_req_t *req, void *arg);
+
+/**
+ * @brief   Block transfer request
+ *
+ * Set the fields up to @p arg, the rest belongs to the driver.
+ */
+struct sdcard_spi_req {
+    sdcard_spi_t *card;         /**< initialized sd-card struct */
+    int blockaddr;              /**< first block, see sdcard_spi_read_blocks() */
+    char *data;                 /**< @p nblocks * SD_HC_BLOCK_SIZE bytes of data */
+    int nblocks;                /**< number of blocks to transfer */
+    bool write;                 /**< write to the card instead of reading */
+    sdcard_spi_cb_t cb;         /**< completion callback, may be NULL */
+    void *arg;                  /**< argument of @p cb */
+    sdcard_spi_req_t *next;     /**< driver internal queue */
+    mutex_t done;               /**< unlocked on completion */
+    int blocks;                 /**< number of blocks transferred */
+    sd_rw_response_t state;     /**< result of the transfer */
+};
+
+/**
+ * @brief                 Starts the worker thread for asynchronous requests.
+ *
+ * @param[in] stack       stack of the worker thread
+ * @param[in] stacksize   size of @p stack
+ * @param[in] priority    priority of the worker thread
+ *
+ * @return                PID of the worker thread
+ * @return                < 0 if the thread could not be created
+ */
+kernel_pid_t sdcard_spi_async_init(char *stack, int stacksize, char priority);
+
+/**
+ * @brief                 Queues a request. May be called from interrupt context.
+ *
+ * @param[in,out] req     request to run, must stay valid until completion
+ */
+void sdcard_spi_submit(sdcard_spi_req_t *req);
+
+/**
+ * @brief                 Waits for a submitted request to complete.
+ *
+ * @param[in] req         request passed to sdcard_spi_submit()
+ * @param[out] state      result of the transfer, may be NULL
+ *
+ * @return                number of successfully transferred blocks
+ */
+int sdcard_spi_wait(sdcard_spi_req_t *req, sd_rw_response_t *state);
+
+/** @} */
+#endif /* MODULE_SDCARD_SPI_ASYNC */
+
 #ifdef __cplusplus
 }
 #endif
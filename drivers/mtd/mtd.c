@@ -92,4 +92,18 @@ int mtd_power(mtd_dev_t *mtd, enum mtd_power_state power)
     }
 }
 
+int mtd_sync(mtd_dev_t *mtd)
+{
+    if (!mtd || !mtd->driver) {
+        return -ENODEV;
+    }
+
+    if (mtd->driver->flush) {
+        return mtd->driver->flush(mtd);
+    }
+    else {
+        return 0;
+    }
+}
+
 /** @} */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd
+ * @{
+ *
+ * @file
+ * @brief       Request queue for asynchronous MTD operations
+ *
+ * @}
+ */
+
+#ifdef MODULE_MTD_ASYNC
+
+#include <errno.h>
+
+#include "irq.h"
+#include "mtd.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static mtd_req_t *_head;
+static mtd_req_t *_tail;
+
+/* unlocked whenever the queue might not be empty */
+static mutex_t _pending = MUTEX_INIT_LOCKED;
+
+static mtd_req_t *_pop(void)
+{
+    unsigned state = irq_disable();
+    mtd_req_t *req = _head;
+
+    if (req) {
+        _head = req->next;
+        if (!_head) {
+            _tail = NULL;
+        }
+    }
+    irq_restore(state);
+    return req;
+}
+
+/* runs the request with the blocking functions of the driver */
+static int _run(mtd_req_t *req)
+{
+    mtd_dev_t *mtd = req->mtd;
+    uint8_t *buf = req->buf;
+
+    if (req->op == MTD_REQ_ERASE) {
+        return mtd_erase(mtd, req->addr, req->count);
+    }
+    while (req->pos < req->count) {
+        uint32_t addr = req->addr + req->pos;
+        uint32_t count = req->count - req->pos;
+        int res;
+
+        if (req->op == MTD_REQ_READ) {
+            res = mtd_read(mtd, buf + req->pos, addr, count);
+        }
+        else {
+            if (count > mtd->page_size - (addr % mtd->page_size)) {
+                count = mtd->page_size - (addr % mtd->page_size);
+            }
+            res = mtd_write(mtd, buf + req->pos, addr, count);
+        }
+        if (res < 0) {
+            return res;
+        }
+        if (res == 0) {
+            return -EIO;
+        }
+        req->pos += res;
+    }
+    return req->count;
+}
+
+static void *_worker(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        mtd_req_t *req = _pop();
+        int res;
+
+        if (!req) {
+            mutex_lock(&_pending);
+            continue;
+        }
+
+        DEBUG("mtd_async: op %d at 0x%lx, %lu bytes\n", (int)req->op,
+              (unsigned long)req->addr, (unsigned long)req->count);
+        req->pos = 0;
+        if (!req->mtd || !req->mtd->driver) {
+            res = -ENODEV;
+        }
+        else if (req->mtd->driver->async) {
+            /* sleep while the device is busy instead of polling it */
+            while ((res = req->mtd->driver->async(req->mtd, req)) > 0) {
+                xtimer_usleep(res);
+            }
+            if ((res == 0) && (req->op != MTD_REQ_ERASE)) {
+                res = req->count;
+            }
+        }
+        else {
+            res = _run(req);
+        }
+        req->res = res;
+
+#ifdef MODULE_CORE_THREAD_FLAGS
+        /* the request may be reused as soon as it is unlocked */
+        thread_t *thread = req->thread;
+        thread_flags_t flags = req->flags;
+#endif
+        if (req->cb) {
+            req->cb(req, req->arg);
+        }
+        mutex_unlock(&req->done);
+#ifdef MODULE_CORE_THREAD_FLAGS
+        if (thread) {
+            thread_flags_set(thread, flags);
+        }
+#endif
+    }
+
+    return NULL;
+}
+
+kernel_pid_t mtd_async_init(char *stack, int stacksize, char priority)
+{
+    return thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _worker, NULL, "mtd_async");
+}
+
+void mtd_submit(mtd_req_t *req)
+{
+    req->done = (mutex_t)MUTEX_INIT_LOCKED;
+    req->next = NULL;
+
+    unsigned state = irq_disable();
+    if (_tail) {
+        _tail->next = req;
+    }
+    else {
+        _head = req;
+    }
+    _tail = req;
+    irq_restore(state);
+
+    mutex_unlock(&_pending);
+}
+
+int mtd_wait(mtd_req_t *req)
+{
+    mutex_lock(&req->done);
+    return req->res;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_MTD_ASYNC */
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd_cache
+ * @{
+ *
+ * @file
+ * @brief       MTD page cache implementation
+ *
+ * Lines are looked up linearly, caches are expected to hold a few dozen
+ * pages at most. Read-ahead needs its pages in consecutive lines, so
+ * eviction picks a run of lines whose most recently used member is the
+ * least recently used one.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mtd.h"
+#include "mtd_cache.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define NO_PAGE     (UINT32_MAX)
+
+static inline uint32_t _sector_size(const mtd_dev_t *dev)
+{
+    return dev->pages_per_sector * dev->page_size;
+}
+
+static inline uint32_t _pages(const mtd_dev_t *dev)
+{
+    return dev->sector_count * dev->pages_per_sector;
+}
+
+static inline uint8_t *_data(const mtd_cache_t *cache, unsigned line)
+{
+    return cache->data + (size_t)line * cache->base.page_size;
+}
+
+static int _find(const mtd_cache_t *cache, uint32_t page)
+{
+    for (unsigned i = 0; i < cache->nlines; i++) {
+        if (cache->lines[i].page == page) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int _writeback(mtd_cache_t *cache, unsigned line)
+{
+    mtd_cache_line_t *l = &cache->lines[line];
+
+    if (!l->dirty) {
+        return 0;
+    }
+    DEBUG("mtd_cache: write back page %lu\n", (unsigned long)l->page);
+    int res = mtd_write(cache->parent, _data(cache, line),
+                        l->page * cache->base.page_size, cache->base.page_size);
+    if (res < 0) {
+        return res;
+    }
+    l->dirty = 0;
+    cache->stats.writebacks++;
+    return 0;
+}
+
+/* frees the least recently used run of n lines */
+static int _evict(mtd_cache_t *cache, unsigned n)
+{
+    unsigned best = 0;
+    uint32_t best_age = 0;
+
+    for (unsigned first = 0; first + n <= cache->nlines; first++) {
+        uint32_t age = UINT32_MAX;
+        for (unsigned i = first; i < first + n; i++) {
+            const mtd_cache_line_t *l = &cache->lines[i];
+            uint32_t a = (l->page == NO_PAGE) ? UINT32_MAX
+                                              : cache->clock - l->used;
+            if (a < age) {
+                age = a;
+            }
+        }
+        if ((first == 0) || (age > best_age)) {
+            best = first;
+            best_age = age;
+        }
+    }
+
+    for (unsigned i = best; i < best + n; i++) {
+        int res = _writeback(cache, i);
+        if (res < 0) {
+            return res;
+        }
+        cache->lines[i].page = NO_PAGE;
+    }
+    return best;
+}
+
+static int _load(mtd_cache_t *cache, uint32_t page)
+{
+    unsigned n = 1;
+
+    if (page == cache->next_miss) {
+        /* sequential access: load the following pages with the same read,
+         * unless they are cached already */
+        while ((n <= cache->readahead) && (n < cache->nlines) &&
+               (page + n < _pages(&cache->base)) &&
+               (_find(cache, page + n) < 0)) {
+            n++;
+        }
+    }
+
+    int first = _evict(cache, n);
+    if (first < 0) {
+        return first;
+    }
+    int res = mtd_read(cache->parent, _data(cache, first),
+                       page * cache->base.page_size, n * cache->base.page_size);
+    if (res < 0) {
+        return res;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        mtd_cache_line_t *l = &cache->lines[first + i];
+        l->page = page + i;
+        l->used = cache->clock;
+        l->dirty = 0;
+    }
+    cache->stats.misses++;
+    cache->stats.prefetched += n - 1;
+    cache->next_miss = page + n;
+    return first;
+}
+
+static int _get(mtd_cache_t *cache, uint32_t page)
+{
+    int line = _find(cache, page);
+
+    if (line >= 0) {
+        cache->stats.hits++;
+    }
+    else {
+        line = _load(cache, page);
+        if (line < 0) {
+            return line;
+        }
+    }
+    cache->lines[line].used = ++cache->clock;
+    return line;
+}
+
+static int _flush(mtd_dev_t *dev)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+
+    /* in ascending order, flash is fastest programmed sequentially */
+    for (;;) {
+        int next = -1;
+        for (unsigned i = 0; i < cache->nlines; i++) {
+            if (cache->lines[i].dirty &&
+                ((next < 0) ||
+                 (cache->lines[i].page < cache->lines[next].page))) {
+                next = i;
+            }
+        }
+        if (next < 0) {
+            return 0;
+        }
+        int res = _writeback(cache, next);
+        if (res < 0) {
+            return res;
+        }
+    }
+}
+
+static int _init(mtd_dev_t *dev)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+
+    /* don't lose data when initialized again, e.g. by a remount */
+    if (dev->page_size) {
+        int res = _flush(dev);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    int res = mtd_init(cache->parent);
+    if (res < 0) {
+        return res;
+    }
+    dev->sector_count = cache->parent->sector_count;
+    dev->pages_per_sector = cache->parent->pages_per_sector;
+    dev->page_size = cache->parent->page_size;
+
+    for (unsigned i = 0; i < cache->nlines; i++) {
+        cache->lines[i].page = NO_PAGE;
+        cache->lines[i].dirty = 0;
+    }
+    cache->next_miss = NO_PAGE;
+    cache->clock = 0;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+
+    return 0;
+}
+
+static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t page_size = dev->page_size;
+    uint32_t total = _pages(dev) * page_size;
+    uint8_t *dst = buff;
+    uint32_t left = size;
+
+    if ((addr > total) || (size > total - addr)) {
+        return -EOVERFLOW;
+    }
+
+    while (left) {
+        uint32_t page = addr / page_size;
+        uint32_t off = addr % page_size;
+        uint32_t n;
+
+        if (off == 0) {
+            /* several whole uncached pages: no point in caching them */
+            for (n = 0; ((n + 1) * page_size <= left) &&
+                        (_find(cache, page + n) < 0); n++) {}
+            if (n > 1) {
+                int res = mtd_read(cache->parent, dst, addr, n * page_size);
+                if (res < 0) {
+                    return res;
+                }
+                cache->stats.bypassed += n;
+                n *= page_size;
+                goto next;
+            }
+        }
+
+        int line = _get(cache, page);
+        if (line < 0) {
+            return line;
+        }
+        n = page_size - off;
+        if (n > left) {
+            n = left;
+        }
+        memcpy(dst, _data(cache, line) + off, n);
+next:
+        dst += n;
+        addr += n;
+        left -= n;
+    }
+
+    return size;
+}
+
+static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t page_size = dev->page_size;
+    uint32_t total = _pages(dev) * page_size;
+    const uint8_t *src = buff;
+    uint32_t left = size;
+
+    if ((addr > total) || (size > total - addr)) {
+        return -EOVERFLOW;
+    }
+    if (((addr % _sector_size(dev)) + size) > _sector_size(dev)) {
+        return -EOVERFLOW;
+    }
+
+    while (left) {
+        uint32_t off = addr % page_size;
+        uint32_t n = page_size - off;
+        int line = _get(cache, addr / page_size);
+
+        if (line < 0) {
+            return line;
+        }
+        if (n > left) {
+            n = left;
+        }
+        /* like the flash: writing clears bits only */
+        uint8_t *dst = _data(cache, line) + off;
+        for (uint32_t i = 0; i < n; i++) {
+            dst[i] &= src[i];
+        }
+        cache->lines[line].dirty = 1;
+        src += n;
+        addr += n;
+        left -= n;
+    }
+
+    return size;
+}
+
+static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t total = _pages(dev) * dev->page_size;
+
+    if ((addr > total) || (size > total - addr) ||
+        (addr % _sector_size(dev)) || (size % _sector_size(dev))) {
+        return -EOVERFLOW;
+    }
+
+    /* cached pages of the sectors, dirty or not, are obsolete */
+    uint32_t first = addr / dev->page_size;
+    uint32_t end = first + size / dev->page_size;
+    for (unsigned i = 0; i < cache->nlines; i++) {
+        mtd_cache_line_t *l = &cache->lines[i];
+        if ((l->page != NO_PAGE) && (l->page >= first) && (l->page < end)) {
+            l->page = NO_PAGE;
+            l->dirty = 0;
+        }
+    }
+
+    return mtd_erase(cache->parent, addr, size);
+}
+
+static int _power(mtd_dev_t *dev, enum mtd_power_state power)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+
+    if (power == MTD_POWER_DOWN) {
+        int res = _flush(dev);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return mtd_power(cache->parent, power);
+}
+
+const mtd_desc_t mtd_cache_driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+    .power = _power,
+    .flush = _flush,
+};
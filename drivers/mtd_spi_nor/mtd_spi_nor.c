@@ -48,11 +48,26 @@
 #define MTD_SPI_NOR_WRITE_WAIT_US (50 * US_PER_MS)
 #endif
 
+#ifndef MTD_SPI_NOR_ASYNC_PROGRAM_US
+/* poll interval of asynchronous requests while a page is programmed */
+#define MTD_SPI_NOR_ASYNC_PROGRAM_US    (200)
+#endif
+
+#ifndef MTD_SPI_NOR_ASYNC_ERASE_US
+/* poll interval of asynchronous requests while erasing */
+#define MTD_SPI_NOR_ASYNC_ERASE_US      (5000)
+#endif
+
+#define STATUS_WIP  (0x01)  /* write in progress */
+
 static int mtd_spi_nor_init(mtd_dev_t *mtd);
 static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t size);
 static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t size);
 static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size);
 static int mtd_spi_nor_power(mtd_dev_t *mtd, enum mtd_power_state power);
+#ifdef MODULE_MTD_ASYNC
+static int mtd_spi_nor_async(mtd_dev_t *mtd, mtd_req_t *req);
+#endif
 
 const mtd_desc_t mtd_spi_nor_driver = {
     .init = mtd_spi_nor_init,
@@ -60,6 +75,9 @@ const mtd_desc_t mtd_spi_nor_driver = {
     .write = mtd_spi_nor_write,
     .erase = mtd_spi_nor_erase,
     .power = mtd_spi_nor_power,
+#ifdef MODULE_MTD_ASYNC
+    .async = mtd_spi_nor_async,
+#endif
 };
 
 /**
@@ -290,7 +308,7 @@ static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
         mtd_spi_cmd_read(dev, dev->opcode->rdsr, &status, sizeof(status));
 
         TRACE("mtd_spi_nor: wait device status = 0x%02x\n", (unsigned int)status);
-        if ((status & 1) == 0) { /* TODO magic number */
+        if ((status & STATUS_WIP) == 0) {
             break;
         }
 #if MODULE_XTIMER
@@ -301,6 +319,30 @@ static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
     } while (1);
 }
 
+/**
+ * @internal
+ * @brief Get exclusive access to the device for a blocking call
+ *
+ * Waits for pending asynchronous requests and for a program or erase still
+ * in progress, the device ignores commands until then.
+ */
+static void mtd_spi_nor_acquire(mtd_spi_nor_t *dev)
+{
+#ifdef MODULE_MTD_ASYNC
+    mutex_lock(&dev->lock);
+#endif
+    wait_for_write_complete(dev);
+}
+
+static inline void mtd_spi_nor_release(mtd_spi_nor_t *dev)
+{
+#ifdef MODULE_MTD_ASYNC
+    mutex_unlock(&dev->lock);
+#else
+    (void)dev;
+#endif
+}
+
 static int mtd_spi_nor_init(mtd_dev_t *mtd)
 {
     DEBUG("mtd_spi_nor_init: %p\n", (void *)mtd);
@@ -373,7 +415,11 @@ static int mtd_spi_nor_init(mtd_dev_t *mtd)
     return 0;
 }
 
-static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t size)
+/**
+ * @internal
+ * @brief Read up to the end of a page, the device must be acquired
+ */
+static int mtd_spi_nor_read_page(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t size)
 {
     DEBUG("mtd_spi_nor_read: %p, %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
         (void *)mtd, dest, addr, size);
@@ -402,6 +448,16 @@ static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t
     return size;
 }
 
+static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t size)
+{
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+
+    mtd_spi_nor_acquire(dev);
+    int res = mtd_spi_nor_read_page(mtd, dest, addr, size);
+    mtd_spi_nor_release(dev);
+    return res;
+}
+
 static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t size)
 {
     uint32_t total_size = mtd->page_size * mtd->pages_per_sector * mtd->sector_count;
@@ -410,7 +466,7 @@ static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uin
     if (size == 0) {
         return 0;
     }
-    const mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
     if (size > mtd->page_size) {
         DEBUG("mtd_spi_nor_write: ERR: page program >1 page (%" PRIu32 ")!\n", mtd->page_size);
         return -EOVERFLOW;
@@ -425,6 +481,8 @@ static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uin
     }
     be_uint32_t addr_be = byteorder_htonl(addr);
 
+    mtd_spi_nor_acquire(dev);
+
     /* write enable */
     mtd_spi_cmd(dev, dev->opcode->wren);
 
@@ -433,14 +491,13 @@ static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uin
 
     /* waiting for the command to complete before returning */
     wait_for_write_complete(dev);
+    mtd_spi_nor_release(dev);
     return size;
 }
 
-static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
+static int mtd_spi_nor_erase_check(const mtd_spi_nor_t *dev, uint32_t addr, uint32_t size)
 {
-    DEBUG("mtd_spi_nor_erase: %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
-        (void *)mtd, addr, size);
-    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+    const mtd_dev_t *mtd = &dev->base;
     uint32_t sector_size = mtd->page_size * mtd->pages_per_sector;
     uint32_t total_size = sector_size * mtd->sector_count;
 
@@ -456,37 +513,146 @@ static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
     if (addr + size > total_size) {
         return -EOVERFLOW;
     }
+    if ((size != total_size) &&
+        !((dev->flag & SPI_NOR_F_SECT_4K) && size == 4096) &&
+        !((dev->flag & SPI_NOR_F_SECT_32K) && size == 32768) &&
+        (size % sector_size != 0)) {
+        return -EOVERFLOW;
+    }
+    return 0;
+}
+
+/**
+ * @internal
+ * @brief Start erasing the first part of a checked range
+ *
+ * @return number of bytes the erase command covers
+ */
+static uint32_t mtd_spi_nor_erase_start(const mtd_spi_nor_t *dev, uint32_t addr, uint32_t size)
+{
+    const mtd_dev_t *mtd = &dev->base;
+    uint32_t sector_size = mtd->page_size * mtd->pages_per_sector;
     be_uint32_t addr_be = byteorder_htonl(addr);
 
     /* write enable */
     mtd_spi_cmd(dev, dev->opcode->wren);
 
-    if (size == total_size) {
+    if (size == sector_size * mtd->sector_count) {
         mtd_spi_cmd_addr_write(dev, dev->opcode->chip_erase, addr_be, NULL, 0);
+        return size;
     }
     else if ((dev->flag & SPI_NOR_F_SECT_4K) && size == 4096) {
         /* 4 KiO sectors can be erased with sector erase command */
         mtd_spi_cmd_addr_write(dev, dev->opcode->sector_erase, addr_be, NULL, 0);
+        return size;
     }
     else if ((dev->flag & SPI_NOR_F_SECT_32K) && size == 32768) {
         /* 32 KiO sectors can be erased with sector erase command */
         mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase_32k, addr_be, NULL, 0);
+        return size;
     }
-    else if (size % sector_size != 0) {
-        return -EOVERFLOW;
+    mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase, addr_be, NULL, 0);
+    return sector_size;
+}
+
+static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
+{
+    DEBUG("mtd_spi_nor_erase: %p, 0x%" PRIx32 ", 0x%" PRIx32 "\n",
+        (void *)mtd, addr, size);
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+
+    int res = mtd_spi_nor_erase_check(dev, addr, size);
+    if (res < 0) {
+        return res;
+    }
+
+    mtd_spi_nor_acquire(dev);
+    while (size) {
+        uint32_t done = mtd_spi_nor_erase_start(dev, addr, size);
+        /* waiting for the command to complete before the next one */
+        wait_for_write_complete(dev);
+        addr += done;
+        size -= done;
     }
-    else {
-        for (size_t i = 0; i < size / sector_size; i++) {
-            mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase, addr_be, NULL, 0);
-            addr += sector_size;
-            addr_be = byteorder_htonl(addr);
+    mtd_spi_nor_release(dev);
+    return 0;
+}
+
+#ifdef MODULE_MTD_ASYNC
+static int mtd_spi_nor_async_step(mtd_dev_t *mtd, mtd_req_t *req)
+{
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+    uint32_t addr = req->addr + req->pos;
+    uint32_t size = req->count - req->pos;
+    uint8_t *buf = req->buf;
+    uint8_t status;
+    int res;
+
+    if (req->pos) {
+        /* the device is busy until the last part is done */
+        mtd_spi_cmd_read(dev, dev->opcode->rdsr, &status, sizeof(status));
+        TRACE("mtd_spi_nor: async status = 0x%02x\n", (unsigned int)status);
+        if (status & STATUS_WIP) {
+            return (req->op == MTD_REQ_ERASE) ? MTD_SPI_NOR_ASYNC_ERASE_US
+                                              : MTD_SPI_NOR_ASYNC_PROGRAM_US;
         }
     }
+    if (!size) {
+        return 0;
+    }
 
-    /* waiting for the command to complete before returning */
-    wait_for_write_complete(dev);
-    return 0;
+    switch (req->op) {
+        case MTD_REQ_READ:
+            /* nothing to wait for */
+            while (req->pos < req->count) {
+                res = mtd_spi_nor_read_page(mtd, buf + req->pos, req->addr + req->pos,
+                                            req->count - req->pos);
+                if (res <= 0) {
+                    return (res < 0) ? res : -EOVERFLOW;
+                }
+                req->pos += res;
+            }
+            return 0;
+        case MTD_REQ_WRITE:
+            if (size > mtd->page_size - (addr % mtd->page_size)) {
+                size = mtd->page_size - (addr % mtd->page_size);
+            }
+            if (addr + size > mtd->page_size * mtd->pages_per_sector * mtd->sector_count) {
+                return -EOVERFLOW;
+            }
+            mtd_spi_cmd(dev, dev->opcode->wren);
+            mtd_spi_cmd_addr_write(dev, dev->opcode->page_program,
+                                   byteorder_htonl(addr), buf + req->pos, size);
+            req->pos += size;
+            return MTD_SPI_NOR_ASYNC_PROGRAM_US;
+        case MTD_REQ_ERASE:
+            if (!req->pos) {
+                res = mtd_spi_nor_erase_check(dev, addr, size);
+                if (res < 0) {
+                    return res;
+                }
+            }
+            req->pos += mtd_spi_nor_erase_start(dev, addr, size);
+            return MTD_SPI_NOR_ASYNC_ERASE_US;
+    }
+    return -EINVAL;
+}
+
+static int mtd_spi_nor_async(mtd_dev_t *mtd, mtd_req_t *req)
+{
+    mtd_spi_nor_t *dev = (mtd_spi_nor_t *)mtd;
+
+    if (!req->pos) {
+        /* blocking calls wait until the request completes */
+        mutex_lock(&dev->lock);
+    }
+    int res = mtd_spi_nor_async_step(mtd, req);
+    if (res <= 0) {
+        mutex_unlock(&dev->lock);
+    }
+    return res;
 }
+#endif
 
 static int mtd_spi_nor_power(mtd_dev_t *mtd, enum mtd_power_state power)
 {
@@ -494,12 +660,18 @@ static int mtd_spi_nor_power(mtd_dev_t *mtd, enum mtd_power_state power)
 
     switch (power) {
         case MTD_POWER_UP:
+            /* the status can not be read in deep power down */
+#ifdef MODULE_MTD_ASYNC
+            mutex_lock(&dev->lock);
+#endif
             mtd_spi_cmd(dev, dev->opcode->wake);
             break;
         case MTD_POWER_DOWN:
+            mtd_spi_nor_acquire(dev);
             mtd_spi_cmd(dev, dev->opcode->sleep);
             break;
     }
+    mtd_spi_nor_release(dev);
 
     return 0;
 }
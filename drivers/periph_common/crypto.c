@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_periph_crypto
+ * @{
+ *
+ * @file
+ * @brief       Job handling shared by all crypto accelerator drivers
+ *
+ * @}
+ */
+
+#include "board.h"
+#include "cpu.h"
+#include "periph_conf.h"
+#include "periph/crypto.h"
+
+#ifdef CRYPTO_HW_NUMOF
+
+/* job whose callback is running: if the callback submits it again, a thread
+ * may already wait on job->done, which must stay intact */
+static crypto_hw_job_t *_completing;
+
+int crypto_hw_prepare(crypto_hw_job_t *job)
+{
+    switch (job->op) {
+        case CRYPTO_HW_AES_ECB_ENCRYPT:
+        case CRYPTO_HW_AES_ECB_DECRYPT:
+            if (job->len % CRYPTO_HW_AES_BLOCK_SIZE) {
+                return CRYPTO_HW_INVAL;
+            }
+            /* fall through */
+        case CRYPTO_HW_AES_CTR:
+            if ((job->key == NULL) ||
+                ((job->op == CRYPTO_HW_AES_CTR) && (job->ctr == NULL))) {
+                return CRYPTO_HW_INVAL;
+            }
+            if (job->key_len != CRYPTO_HW_AES_KEY_SIZE) {
+                return CRYPTO_HW_NOTSUP;
+            }
+            break;
+        case CRYPTO_HW_SHA256:
+            break;
+        default:
+            return CRYPTO_HW_NOTSUP;
+    }
+    if ((job->len && (job->in == NULL)) || (job->out == NULL)) {
+        return CRYPTO_HW_INVAL;
+    }
+
+    job->next = NULL;
+    job->status = CRYPTO_HW_PENDING;
+    if (job != _completing) {
+        /* locked without mutex_lock(), submitting from interrupts is fine */
+        job->done = (mutex_t)MUTEX_INIT_LOCKED;
+    }
+    return CRYPTO_HW_OK;
+}
+
+void crypto_hw_reject(crypto_hw_job_t *job, int status)
+{
+    job->status = status;
+    if (job != _completing) {
+        /* crypto_hw_complete() notifies waiters of a resubmitted job */
+        mutex_unlock(&job->done);
+    }
+}
+
+int crypto_hw_wait(crypto_hw_job_t *job)
+{
+    mutex_lock(&job->done);
+    return job->status;
+}
+
+void crypto_hw_complete(crypto_hw_job_t *job, int status)
+{
+    job->status = status;
+    if (job->cb) {
+        /* completions of other jobs may interrupt the callback */
+        crypto_hw_job_t *prev = _completing;
+
+        _completing = job;
+        job->cb(job, job->arg);
+        _completing = prev;
+        if (job->status == CRYPTO_HW_PENDING) {
+            /* resubmitted by the callback, notify when that is done */
+            return;
+        }
+    }
+#ifdef MODULE_CORE_THREAD_FLAGS
+    if (job->thread) {
+        thread_flags_set(job->thread, job->flags);
+    }
+#endif
+    /* last: a woken up waiter may reuse the job right away */
+    mutex_unlock(&job->done);
+}
+
+#endif /* CRYPTO_HW_NUMOF */
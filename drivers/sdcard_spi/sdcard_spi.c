@@ -25,6 +25,7 @@
 #include "periph/spi.h"
 #include "periph/gpio.h"
 #include "xtimer.h"
+#include "checksum/crc16_ccitt.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -45,10 +46,11 @@ static sd_rw_response_t _write_data_packet(sdcard_spi_t *card, char token, char
 /* CRC-7 (polynomial: x^7 + x^3 + 1) LSB of CRC-7 in a 8-bit variable is always 1*/
 static char _crc_7(const char *data, int n);
 
-/* CRC-16 (CRC-CCITT) (polynomial: x^16 + x^12 + x^5 + x^1) */
-static uint16_t _crc_16(const char *data, size_t n);
+/* CRC-16 (CRC-CCITT) (polynomial: x^16 + x^12 + x^5 + x^1) with start value 0 */
+static inline uint16_t _crc_16(const char *data, size_t n);
 
-/* use this transfer method instead of _transfer_bytes to force the use of 0xFF as dummy bytes */
+/* use this transfer method instead of spi_transfer_bytes to force the use of 0xFF as dummy
+   bytes, whole blocks are transferred with a single spi_transfer_bytes call once in HW SPI mode */
 static inline int _transfer_bytes(sdcard_spi_t *card, char *out, char *in, unsigned int length);
 
 /* uses bitbanging for spi communication which allows to enable pull-up on the miso pin for
@@ -410,18 +412,9 @@ static char _crc_7(const char *data, int n)
     return (crc << 1) | 1;
 }
 
-static uint16_t _crc_16(const char *data, size_t n)
+static inline uint16_t _crc_16(const char *data, size_t n)
 {
-    uint16_t crc = 0;
-
-    for (size_t i = 0; i < n; i++) {
-        crc = (uint8_t)(crc >> 8) | (crc << 8);
-        crc ^= data[i];
-        crc ^= (uint8_t)(crc & 0xFF) >> 4;
-        crc ^= crc << 12;
-        crc ^= (crc & 0xFF) << 5;
-    }
-    return crc;
+    return crc16_ccitt_update(0, (const unsigned char *)data, n);
 }
 
 char sdcard_spi_send_cmd(sdcard_spi_t *card, char sd_cmd_idx, uint32_t argument, int32_t max_retry)
@@ -581,6 +574,17 @@ static inline int _transfer_bytes(sdcard_spi_t *card, char *out, char *in, unsig
     unsigned trans_bytes = 0;
     char in_temp;
 
+    if ((_dyn_spi_rxtx_byte == &_hw_spi_rxtx_byte) && ((out != NULL) || (in != NULL))) {
+        if (out == NULL) {
+            /* the card expects MOSI to stay high while it sends data, SPI drivers clock out
+               the whole out buffer byte by byte so sending from the input buffer is fine */
+            memset(in, SD_CARD_DUMMY_BYTE, length);
+            out = in;
+        }
+        spi_transfer_bytes(card->params.spi_dev, GPIO_UNDEF, true, out, in, length);
+        return length;
+    }
+
     for (trans_bytes = 0; trans_bytes < length; trans_bytes++) {
         if (out != NULL) {
             trans_ret = _dyn_spi_rxtx_byte(card, out[trans_bytes], &in_temp);
@@ -620,7 +624,7 @@ static sd_rw_response_t _read_data_packet(sdcard_spi_t *card, char token, char *
 
         char crc_bytes[2];
         if (_transfer_bytes(card, 0, crc_bytes, sizeof(crc_bytes)) == sizeof(crc_bytes)) {
-            uint16_t data__crc_16 = (crc_bytes[0] << 8) | crc_bytes[1];
+            uint16_t data__crc_16 = ((uint8_t)crc_bytes[0] << 8) | (uint8_t)crc_bytes[1];
 
             if (_crc_16(data, size) == data__crc_16) {
                 DEBUG("_read_data_packet: [OK]\n");
@@ -764,6 +768,15 @@ static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, ch
     _select_card_spi(card);
     int written = 0;
 
+    /* let the card pre-erase the blocks of a multi-block write (ACMD23). This is only a hint,
+       MMC cards don't support it and the write works without it */
+    if ((cmd_idx == SD_CMD_25) && (card->card_type != MMC_V3)) {
+        char acmd_r1 = sdcard_spi_send_acmd(card, SD_CMD_23, nbl & SD_ACMD_23_ARG_MASK, 0);
+        if (!R1_VALID(acmd_r1) || R1_ERROR(acmd_r1)) {
+            DEBUG("_write_blocks: ACMD23: [FAILED] (ignored)\n");
+        }
+    }
+
     uint32_t addr = card->use_block_addr ? bladdr : (bladdr * SD_HC_BLOCK_SIZE);
     char cmd_r1_resu = sdcard_spi_send_cmd(card, cmd_idx, addr, SD_BLOCK_WRITE_CMD_RETRIES);
 
@@ -779,6 +792,13 @@ static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, ch
         }
 
         for (int i = 0; i < nbl; i++) {
+            /* the card is busy programming the previous block */
+            if ((i > 0) && !_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+                DEBUG("_write_blocks: _wait_for_not_busy: [FAILED]\n");
+                _unselect_card_spi(card);
+                *state = SD_RW_TIMEOUT;
+                return written;
+            }
             sd_rw_response_t write_resu = _write_data_packet(card, token, &(data[i * blsz]), blsz);
             if (write_resu != SD_RW_OK) {
                 DEBUG("_write_blocks: _write_data_packet: [FAILED]\n");
@@ -786,32 +806,29 @@ static inline int _write_blocks(sdcard_spi_t *card, char cmd_idx, int bladdr, ch
                 *state = write_resu;
                 return written;
             }
-            if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
-                DEBUG("_write_blocks: _wait_for_not_busy: [FAILED]\n");
-                _unselect_card_spi(card);
-                *state = SD_RW_TIMEOUT;
-                return written;
-            }
             written++;
         }
 
         /* if this is a multi-block write it is needed to issue a stop command*/
         if (cmd_idx == SD_CMD_25) {
-            spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF, true,
-                              SD_DATA_TOKEN_CMD_25_STOP);
-            DEBUG("_write_blocks: write multi (%d) blocks: [OK]\n", nbl);
-
-            _send_dummy_byte(card); //sd card needs dummy byte before we can wait for not-busy state
             if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
+                DEBUG("_write_blocks: _wait_for_not_busy: [FAILED]\n");
                 _unselect_card_spi(card);
                 *state = SD_RW_TIMEOUT;
+                return written;
             }
+            spi_transfer_byte(card->params.spi_dev, GPIO_UNDEF, true,
+                              SD_DATA_TOKEN_CMD_25_STOP);
+            _send_dummy_byte(card); //sd card needs dummy byte before it signals busy state
+            DEBUG("_write_blocks: write multi (%d) blocks: [OK]\n", nbl);
         }
         else {
             DEBUG("_write_blocks: write single block: [OK]\n");
-            *state = SD_RW_OK;
         }
 
+        /* don't wait for the card to finish programming: the next command waits for the
+           not-busy state before it is sent, see sdcard_spi_sync() */
+        *state = SD_RW_OK;
         _unselect_card_spi(card);
         return written;
     }
@@ -834,6 +851,15 @@ int sdcard_spi_write_blocks(sdcard_spi_t *card, int blockaddr, char *data, int b
     }
 }
 
+sd_rw_response_t sdcard_spi_sync(sdcard_spi_t *card)
+{
+    _select_card_spi(card);
+    bool ready = _wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT);
+    _unselect_card_spi(card);
+
+    return ready ? SD_RW_OK : SD_RW_TIMEOUT;
+}
+
 sd_rw_response_t _read_cid(sdcard_spi_t *card)
 {
     char cid_raw_data[SD_SIZE_OF_CID_AND_CSD_REG];
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_sdcard_spi
+ * @{
+ *
+ * @file
+ * @brief       Request queue for asynchronous block transfers
+ *
+ * @}
+ */
+
+#ifdef MODULE_SDCARD_SPI_ASYNC
+
+#include "irq.h"
+#include "mutex.h"
+#include "thread.h"
+#include "sdcard_spi.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static sdcard_spi_req_t *_head;
+static sdcard_spi_req_t *_tail;
+
+/* unlocked whenever the queue might not be empty */
+static mutex_t _pending = MUTEX_INIT_LOCKED;
+
+static sdcard_spi_req_t *_pop(void)
+{
+    unsigned state = irq_disable();
+    sdcard_spi_req_t *req = _head;
+
+    if (req) {
+        _head = req->next;
+        if (!_head) {
+            _tail = NULL;
+        }
+    }
+    irq_restore(state);
+    return req;
+}
+
+static void *_worker(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        sdcard_spi_req_t *req = _pop();
+
+        if (!req) {
+            mutex_lock(&_pending);
+            continue;
+        }
+
+        DEBUG("sdcard_spi_async: %s %d blocks at %d\n", req->write ? "write" : "read",
+              req->nblocks, req->blockaddr);
+        if (req->write) {
+            req->blocks = sdcard_spi_write_blocks(req->card, req->blockaddr, req->data,
+                                                  SD_HC_BLOCK_SIZE, req->nblocks, &req->state);
+        }
+        else {
+            req->blocks = sdcard_spi_read_blocks(req->card, req->blockaddr, req->data,
+                                                 SD_HC_BLOCK_SIZE, req->nblocks, &req->state);
+        }
+
+        if (req->cb) {
+            req->cb(req, req->arg);
+        }
+        mutex_unlock(&req->done);
+    }
+
+    return NULL;
+}
+
+kernel_pid_t sdcard_spi_async_init(char *stack, int stacksize, char priority)
+{
+    return thread_create(stack, stacksize, priority, THREAD_CREATE_STACKTEST,
+                         _worker, NULL, "sdcard_spi");
+}
+
+void sdcard_spi_submit(sdcard_spi_req_t *req)
+{
+    req->done = (mutex_t)MUTEX_INIT_LOCKED;
+    req->next = NULL;
+
+    unsigned state = irq_disable();
+    if (_tail) {
+        _tail->next = req;
+    }
+    else {
+        _head = req;
+    }
+    _tail = req;
+    irq_restore(state);
+
+    mutex_unlock(&_pending);
+}
+
+int sdcard_spi_wait(sdcard_spi_req_t *req, sd_rw_response_t *state)
+{
+    mutex_lock(&req->done);
+    if (state) {
+        *state = req->state;
+    }
+    return req->blocks;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_SDCARD_SPI_ASYNC */
@@ -160,15 +160,19 @@ DRESULT disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
  */
 DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
 {
-    #if (_USE_MKFS == 1)
+    #if (_USE_MKFS == 1) || (_FS_READONLY == 0)
     sdcard_spi_t *card = get_sd_card(pdrv);
     #endif
 
     switch (cmd) {
         #if (_FS_READONLY == 0)
         case CTRL_SYNC:
-            /* r/w is always finished within r/w-functions of sdcard_spi */
-            return RES_OK;
+            /* writes return before the card finished programming the data */
+            if ((card != NULL) && card->init_done &&
+                (sdcard_spi_sync(card) == SD_RW_OK)) {
+                return RES_OK;
+            }
+            return RES_ERROR;
         #endif
 
         #if (_USE_MKFS == 1)
@@ -120,6 +120,16 @@ void spiffs_unlock(struct spiffs_t *fs)
     mutex_unlock(&fs_desc->lock);
 }
 
+static mtd_dev_t *_mtd(spiffs_desc_t *fs_desc)
+{
+#if SPIFFS_HAL_CALLBACK_EXTRA == 1
+    return fs_desc->dev;
+#else
+    (void)fs_desc;
+    return SPIFFS_MTD_DEV;
+#endif
+}
+
 static int _mount(vfs_mount_t *mountp)
 {
     spiffs_desc_t *fs_desc = mountp->private_data;
@@ -199,7 +209,7 @@ static int _umount(vfs_mount_t *mountp)
 
     SPIFFS_unmount(&fs_desc->fs);
 
-    return 0;
+    return mtd_sync(_mtd(fs_desc));
 }
 
 static int _unlink(vfs_mount_t *mountp, const char *name)
@@ -266,7 +276,13 @@ static int _close(vfs_file_t *filp)
 {
     spiffs_desc_t *fs_desc = filp->mp->private_data;
 
-    return spiffs_err_to_errno(SPIFFS_close(&fs_desc->fs, filp->private_data.value));
+    int res = spiffs_err_to_errno(SPIFFS_close(&fs_desc->fs,
+                                                filp->private_data.value));
+    if (res < 0) {
+        return res;
+    }
+    /* closed files must survive a reset, even with a caching mtd */
+    return mtd_sync(_mtd(fs_desc));
 }
 
 static ssize_t _write(vfs_file_t *filp, const void *src, size_t nbytes)
@@ -19,6 +19,7 @@
 
 #include "bloom.h"
 #include "bitfield.h"
+#include "bloom_hash.h"
 #include "string.h"
 
 #define ROUND(size) ((size + CHAR_BIT - 1) / CHAR_BIT)
@@ -29,6 +30,25 @@ void bloom_init(bloom_t *bloom, size_t size, uint8_t *bitfield, hashfp_t *hashes
     bloom->a = bitfield;
     bloom->hash = hashes;
     bloom->k = hashes_numof;
+    bloom->hash64 = NULL;
+    bloom->key = NULL;
+}
+
+void bloom_init_hash64(bloom_t *bloom, size_t size, uint8_t *bitfield,
+                       hash64fp_t hash, const void *key, int k)
+{
+    bloom->m = size;
+    bloom->a = bitfield;
+    bloom->hash = NULL;
+    bloom->k = k;
+    bloom->hash64 = hash;
+    bloom->key = key;
+}
+
+/* position of the n-th bit of a string whose 64 bit hash is h */
+static inline size_t _pos64(const bloom_t *bloom, uint64_t h, size_t n)
+{
+    return bloom_hash_pos(h, n) % bloom->m;
 }
 
 void bloom_del(bloom_t *bloom)
@@ -40,10 +60,19 @@ void bloom_del(bloom_t *bloom)
     bloom->m = 0;
     bloom->hash = NULL;
     bloom->k = 0;
+    bloom->hash64 = NULL;
+    bloom->key = NULL;
 }
 
 void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len)
 {
+    if (bloom->hash64) {
+        uint64_t h = bloom->hash64(bloom->key, buf, len);
+        for (size_t n = 0; n < bloom->k; n++) {
+            bf_set(bloom->a, _pos64(bloom, h, n));
+        }
+        return;
+    }
     for (size_t n = 0; n < bloom->k; n++) {
         uint32_t hash = bloom->hash[n](buf, len);
         bf_set(bloom->a, (hash % bloom->m));
@@ -52,6 +81,16 @@ void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len)
 
 bool bloom_check(bloom_t *bloom, const uint8_t *buf, size_t len)
 {
+    if (bloom->hash64) {
+        uint64_t h = bloom->hash64(bloom->key, buf, len);
+        for (size_t n = 0; n < bloom->k; n++) {
+            if (!(bf_isset(bloom->a, _pos64(bloom, h, n)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     for (size_t n = 0; n < bloom->k; n++) {
         uint32_t hash = bloom->hash[n](buf, len);
 
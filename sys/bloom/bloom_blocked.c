@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_bloom
+ * @{
+ *
+ * @file
+ * @brief       Blocked and counting Bloom filters
+ *
+ * The upper half of the hash picks the block. All k positions within the
+ * block are derived from the whole hash with bloom_hash_pos(). The blocked
+ * filter first collects them in a mask of the block's size and then tests
+ * or sets the mask word by word, which compilers turn into vector
+ * instructions where available.
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "bloom.h"
+#include "bloom_hash.h"
+
+#define BLOCK_WORDS     (BLOOM_BLOCK_SIZE / sizeof(uint32_t))
+/* log2 of the number of bits in a block */
+#define BLOCK_BITS_LOG2     (9U)
+/* log2 of the number of 4 bit counters in a block */
+#define BLOCK_CTRS_LOG2     (BLOCK_BITS_LOG2 - 2)
+#define CTR_MAX         (0xfU)
+
+static inline bloom_block_t *_block(const bloom_blocked_t *bloom, uint64_t h)
+{
+    /* upper half of the hash scaled to [0, nblocks) without a division */
+    return &bloom->blocks[((h >> 32) * bloom->nblocks) >> 32];
+}
+
+static void _mask(uint32_t *mask, uint64_t h, unsigned k)
+{
+    memset(mask, 0, BLOOM_BLOCK_SIZE);
+    for (unsigned n = 0; n < k; n++) {
+        uint32_t pos = bloom_hash_pos(h, n) >> (32 - BLOCK_BITS_LOG2);
+        mask[pos / 32] |= 1UL << (pos % 32);
+    }
+}
+
+static bool _contains(const bloom_block_t *block, const uint32_t *mask)
+{
+    uint32_t missing = 0;
+
+    for (unsigned i = 0; i < BLOCK_WORDS; i++) {
+        missing |= mask[i] & ~block->word[i];
+    }
+    return (missing == 0);
+}
+
+void bloom_blocked_init(bloom_blocked_t *bloom, bloom_block_t *blocks,
+                        size_t nblocks, hash64fp_t hash, const void *key,
+                        unsigned k)
+{
+    bloom->blocks = blocks;
+    bloom->nblocks = nblocks;
+    bloom->hash = hash;
+    bloom->key = key;
+    bloom->k = k;
+    bloom_blocked_clear(bloom);
+}
+
+void bloom_blocked_clear(bloom_blocked_t *bloom)
+{
+    memset(bloom->blocks, 0, bloom->nblocks * sizeof(bloom_block_t));
+}
+
+void bloom_blocked_add(bloom_blocked_t *bloom, const uint8_t *buf,
+                       size_t len)
+{
+    bloom_blocked_check_add(bloom, buf, len);
+}
+
+bool bloom_blocked_check(const bloom_blocked_t *bloom, const uint8_t *buf,
+                         size_t len)
+{
+    uint32_t mask[BLOCK_WORDS];
+    uint64_t h = bloom->hash(bloom->key, buf, len);
+
+    _mask(mask, h, bloom->k);
+    return _contains(_block(bloom, h), mask);
+}
+
+bool bloom_blocked_check_add(bloom_blocked_t *bloom, const uint8_t *buf,
+                             size_t len)
+{
+    uint32_t mask[BLOCK_WORDS];
+    uint64_t h = bloom->hash(bloom->key, buf, len);
+    bloom_block_t *block = _block(bloom, h);
+
+    _mask(mask, h, bloom->k);
+    bool found = _contains(block, mask);
+    for (unsigned i = 0; i < BLOCK_WORDS; i++) {
+        block->word[i] |= mask[i];
+    }
+    return found;
+}
+
+/* counter n of a block: 8 counters per word */
+static inline unsigned _ctr_get(const bloom_block_t *block, uint32_t n)
+{
+    return (block->word[n / 8] >> ((n % 8) * 4)) & CTR_MAX;
+}
+
+static inline void _ctr_add(bloom_block_t *block, uint32_t n, int delta)
+{
+    block->word[n / 8] += (uint32_t)delta << ((n % 8) * 4);
+}
+
+static inline uint32_t _ctr_pos(uint64_t h, unsigned n)
+{
+    return bloom_hash_pos(h, n) >> (32 - BLOCK_CTRS_LOG2);
+}
+
+void bloom_counting_init(bloom_counting_t *bloom, bloom_block_t *blocks,
+                         size_t nblocks, hash64fp_t hash, const void *key,
+                         unsigned k)
+{
+    bloom_blocked_init(bloom, blocks, nblocks, hash, key, k);
+}
+
+void bloom_counting_add(bloom_counting_t *bloom, const uint8_t *buf,
+                        size_t len)
+{
+    uint64_t h = bloom->hash(bloom->key, buf, len);
+    bloom_block_t *block = _block(bloom, h);
+
+    for (unsigned n = 0; n < bloom->k; n++) {
+        uint32_t pos = _ctr_pos(h, n);
+        if (_ctr_get(block, pos) < CTR_MAX) {
+            _ctr_add(block, pos, 1);
+        }
+    }
+}
+
+bool bloom_counting_check(const bloom_counting_t *bloom, const uint8_t *buf,
+                          size_t len)
+{
+    uint64_t h = bloom->hash(bloom->key, buf, len);
+    const bloom_block_t *block = _block(bloom, h);
+
+    for (unsigned n = 0; n < bloom->k; n++) {
+        if (_ctr_get(block, _ctr_pos(h, n)) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool bloom_counting_remove(bloom_counting_t *bloom, const uint8_t *buf,
+                           size_t len)
+{
+    uint64_t h = bloom->hash(bloom->key, buf, len);
+    bloom_block_t *block = _block(bloom, h);
+
+    for (unsigned n = 0; n < bloom->k; n++) {
+        if (_ctr_get(block, _ctr_pos(h, n)) == 0) {
+            return false;
+        }
+    }
+    for (unsigned n = 0; n < bloom->k; n++) {
+        uint32_t pos = _ctr_pos(h, n);
+        unsigned ctr = _ctr_get(block, pos);
+        /* saturated counters lost track of their count */
+        if ((ctr > 0) && (ctr < CTR_MAX)) {
+            _ctr_add(block, pos, -1);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_bloom
+ * @{
+ *
+ * @file
+ * @brief       Bit positions derived from a single 64 bit hash
+ *
+ * @}
+ */
+
+#ifndef BLOOM_HASH_H
+#define BLOOM_HASH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   32 random bits for the @p n-th position of a string hashed to @p h
+ *
+ * Double hashing (h1 + n * h2, Kirsch and Mitzenmacher), mixed once more:
+ * strings sharing h2 would otherwise map to shifted copies of the same
+ * progression, which raises the false positive rate of small filters. The
+ * high bits of the result are the best ones.
+ */
+static inline uint32_t bloom_hash_pos(uint64_t h, unsigned n)
+{
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 32) | 1;
+    uint32_t x = h1 + (uint32_t)n * h2;
+
+    x ^= x >> 16;
+    x *= 0x85ebca6bU;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35U;
+    x ^= x >> 16;
+    return x;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLOOM_HASH_H */
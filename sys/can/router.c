@@ -22,13 +22,13 @@
 
 #include "kernel_defines.h"
 
-#include "net/gnrc/pktbuf.h"
 
 #include "can/router.h"
 #include "can/pkt.h"
 #include "can/device.h"
 #include "utlist.h"
 #include "mutex.h"
+#include "mempool.h"
 #include "assert.h"
 
 #ifdef MODULE_CAN_MBOX
@@ -50,14 +50,33 @@ typedef struct filter_el {
     canid_t can_id;          /**< CAN ID of the element */
     canid_t mask;            /**< Mask of the element */
     void *data;              /**< Private data */
-    gnrc_pktsnip_t *snip;    /**< Pointer to the allocated snip */
 } filter_el_t;
 
 /**
- * This table contains @p CAN_ROUTER_APP_MAX lists of CAN IDs per interface
+ * Filters of an interface
+ *
+ * Filters whose mask covers the standard ID bits only match frames with these
+ * bits equal to their CAN ID, they are kept in a hash table indexed by them.
+ * This holds for SFF and EFF masks with or without the flag bits alike. All
+ * other filters are kept in the @p masked list, which is walked for every
+ * frame.
  */
-static can_reg_entry_t *table[CAN_DLL_NUMOF];
+typedef struct {
+    can_reg_entry_t *exact[CAN_ROUTER_HASH_SIZE];   /**< ID mask filters */
+    can_reg_entry_t *masked;                        /**< all other filters */
+} filter_table_t;
+
+#define FULL_MASK   ((canid_t)~0U)
+
+static filter_table_t table[CAN_DLL_NUMOF];
+
+static filter_el_t _filter_els[CAN_ROUTER_FILTER_NUMOF];
+static mempool_t _filter_pool = MEMPOOL_INIT("can_filter", _filter_els);
 
+/* rx data handed to the subscribers, they all point to the frame of the
+ * same packet */
+static can_rx_data_t _rx_data[CAN_ROUTER_RX_DATA_NUMOF];
+static mempool_t _rx_data_pool = MEMPOOL_INIT("can_rx_data", _rx_data);
 
 static mutex_t lock = MUTEX_INIT;
 
@@ -67,17 +86,36 @@ static void _insert_to_list(can_reg_entry_t **list, filter_el_t *el);
 static filter_el_t *_find_filter_el(can_reg_entry_t *list, can_reg_entry_t *entry, canid_t can_id, canid_t mask, void *data);
 static int _filter_is_used(unsigned int ifnum, canid_t can_id, canid_t mask);
 
+/* the list of interface @p ifnum which holds the filters for @p can_id and
+ * @p mask */
+static can_reg_entry_t **_get_list(unsigned int ifnum, canid_t can_id, canid_t mask)
+{
+    if ((mask & CAN_SFF_MASK) == CAN_SFF_MASK) {
+        uint32_t h = (can_id & CAN_SFF_MASK) * 2654435761U;
+        return &table[ifnum].exact[(h >> 24) % CAN_ROUTER_HASH_SIZE];
+    }
+    return &table[ifnum].masked;
+}
+
 #if ENABLE_DEBUG
+static void _print_list(can_reg_entry_t *list)
+{
+    can_reg_entry_t *entry;
+    LL_FOREACH(list, entry) {
+        filter_el_t *el = container_of(entry, filter_el_t, entry);
+        DEBUG("App pid=%" PRIkernel_pid ", el=%p, can_id=0x%" PRIx32 ", mask=0x%" PRIx32 ", data=%p\n",
+              el->entry.target.pid, (void*)el, el->can_id, el->mask, el->data);
+    }
+}
+
 static void _print_filters(void)
 {
     for (int i = 0; i < (int)CAN_DLL_NUMOF; i++) {
         DEBUG("--- Ifnum: %d ---\n", i);
-        can_reg_entry_t *entry;
-        LL_FOREACH(table[i], entry) {
-            filter_el_t *el = container_of(entry, filter_el_t, entry);
-            DEBUG("App pid=%" PRIkernel_pid ", el=%p, can_id=0x%" PRIx32 ", mask=0x%" PRIx32 ", data=%p\n",
-                  el->entry.target.pid, (void*)el, el->can_id, el->mask, el->data);
+        for (unsigned j = 0; j < CAN_ROUTER_HASH_SIZE; j++) {
+            _print_list(table[i].exact[j]);
         }
+        _print_list(table[i].masked);
     }
 }
 
@@ -88,19 +126,16 @@ static void _print_filters(void)
 
 static filter_el_t *_alloc_filter_el(canid_t can_id, canid_t mask, void *data)
 {
-    filter_el_t *el;
-    gnrc_pktsnip_t *snip = gnrc_pktbuf_add(NULL, NULL, sizeof(*el), GNRC_NETTYPE_UNDEF);
-    if (!snip) {
+    filter_el_t *el = mempool_alloc(&_filter_pool);
+    if (!el) {
         DEBUG("can_router: _alloc_canid_el: out of memory\n");
         return NULL;
     }
 
-    el = snip->data;
     el->can_id = can_id;
     el->mask = mask;
     el->data = data;
     el->entry.next = NULL;
-    el->snip = snip;
     DEBUG("_alloc_canid_el: el allocated with can_id=0x%" PRIx32 ", mask=0x%" PRIx32
           ", data=%p\n", can_id, mask, data);
     return el;
@@ -111,7 +146,7 @@ static void _free_filter_el(filter_el_t *el)
     DEBUG("_free_canid_el: el freed with can_id=0x%" PRIx32 ", mask=0x%" PRIx32
           ", data=%p\n", el->can_id, el->mask, el->data);
 
-    gnrc_pktbuf_release(el->snip);
+    mempool_free(&_filter_pool, el);
 }
 
 /* Insert to the list in a sorted way
@@ -179,7 +214,7 @@ static filter_el_t *_find_filter_el(can_reg_entry_t *list, can_reg_entry_t *entr
 
 static int _filter_is_used(unsigned int ifnum, canid_t can_id, canid_t mask)
 {
-    filter_el_t *el = container_of(table[ifnum], filter_el_t, entry);
+    filter_el_t *el = container_of(*_get_list(ifnum, can_id, mask), filter_el_t, entry);
     if (!el) {
         DEBUG("_filter_is_used: empty list\n");
         return 0;
@@ -238,7 +273,7 @@ int can_router_register(can_reg_entry_t *entry, canid_t can_id, canid_t mask, vo
     filter->entry.target.pid = entry->target.pid;
 #endif
     filter->entry.ifnum = entry->ifnum;
-    _insert_to_list(&table[entry->ifnum], filter);
+    _insert_to_list(_get_list(entry->ifnum, can_id, mask), filter);
     mutex_unlock(&lock);
 
     PRINT_FILTERS();
@@ -250,6 +285,7 @@ int can_router_register(can_reg_entry_t *entry, canid_t can_id, canid_t mask, vo
 int can_router_unregister(can_reg_entry_t *entry, canid_t can_id,
                           canid_t mask, void *param)
 {
+    can_reg_entry_t **list;
     filter_el_t *el;
     int ret;
 
@@ -264,12 +300,13 @@ int can_router_unregister(can_reg_entry_t *entry, canid_t can_id,
 #endif
 
     mutex_lock(&lock);
-    el = _find_filter_el(table[entry->ifnum], entry, can_id, mask, param);
+    list = _get_list(entry->ifnum, can_id, mask);
+    el = _find_filter_el(*list, entry, can_id, mask, param);
     if (!el) {
         mutex_unlock(&lock);
         return -EINVAL;
     }
-    LL_DELETE(table[entry->ifnum], &el->entry);
+    LL_DELETE(*list, &el->entry);
     _free_filter_el(el);
     ret = _filter_is_used(entry->ifnum, can_id, mask);
     mutex_unlock(&lock);
@@ -296,57 +333,72 @@ static int _send_msg(msg_t *msg, can_reg_entry_t *entry)
 #endif
 }
 
-/* send received pkt to all interested users */
-int can_router_dispatch_rx_indic(can_pkt_t *pkt)
+/* send received pkt to the users of the filters in @p list which match it */
+static int _dispatch_list(can_pkt_t *pkt, can_reg_entry_t *list)
 {
-    if (!pkt) {
-        DEBUG("can_router_dispatch_rx_indic: invalid pkt\n");
-        return -EINVAL;
-    }
-
     int res = 0;
     msg_t msg;
     msg.type = CAN_MSG_RX_INDICATION;
-#if ENABLE_DEBUG
-    int msg_cnt = 0;
-#endif
-    DEBUG("can_router_dispatch_rx_indic: pkt=%p, ifnum=%d, can_id=%" PRIx32 "\n",
-          (void *)pkt, pkt->entry.ifnum, pkt->frame.can_id);
-
-    mutex_lock(&lock);
     can_reg_entry_t *entry;
     filter_el_t *el;
-    LL_FOREACH(table[pkt->entry.ifnum], entry) {
+
+    LL_FOREACH(list, entry) {
         el = container_of(entry, filter_el_t, entry);
         if ((pkt->frame.can_id & el->mask) == el->can_id) {
             DEBUG("can_router_dispatch_rx_indic: found el=%p, data=%p\n",
                   (void *)el, (void *)el->data);
             DEBUG("can_router_dispatch_rx_indic: rx_ind to pid: %"
                   PRIkernel_pid "\n", entry->target.pid);
+            can_rx_data_t *rx = mempool_alloc_irq(&_rx_data_pool);
+            if (!rx) {
+                DEBUG("can_router_dispatch_rx_indic: out of rx data\n");
+                res = -EBUSY;
+                continue;
+            }
+            rx->data.iov_base = &pkt->frame;
+            rx->data.iov_len = sizeof(pkt->frame);
+            rx->arg = el->data;
+            rx->snip = NULL;
+            msg.content.ptr = rx;
             atomic_fetch_add(&pkt->ref_count, 1);
-            msg.content.ptr = can_pkt_alloc_rx_data(&pkt->frame, sizeof(pkt->frame), el->data);
-#if ENABLE_DEBUG
-            msg_cnt++;
-#endif
-            if (!msg.content.ptr || (_send_msg(&msg, entry) <= 0)) {
-                can_pkt_free_rx_data(msg.content.ptr);
+            if (_send_msg(&msg, entry) <= 0) {
+                mempool_free_irq(&_rx_data_pool, rx);
                 atomic_fetch_sub(&pkt->ref_count, 1);
                 DEBUG("can_router_dispatch_rx_indic: failed to send msg to "
                       "pid=%" PRIkernel_pid "\n", entry->target.pid);
                 res = -EBUSY;
-                break;
             }
         }
     }
+    return res;
+}
+
+/* send received pkt to all interested users */
+int can_router_dispatch_rx_indic(can_pkt_t *pkt)
+{
+    if (!pkt) {
+        DEBUG("can_router_dispatch_rx_indic: invalid pkt\n");
+        return -EINVAL;
+    }
+
+    int res, res_masked;
+    DEBUG("can_router_dispatch_rx_indic: pkt=%p, ifnum=%d, can_id=%" PRIx32 "\n",
+          (void *)pkt, pkt->entry.ifnum, pkt->frame.can_id);
+
+    /* the reference of the dispatcher keeps the packet alive while users which
+     * already got it release it */
+    atomic_store(&pkt->ref_count, 1);
+    mutex_lock(&lock);
+    res = _dispatch_list(pkt, *_get_list(pkt->entry.ifnum, pkt->frame.can_id, FULL_MASK));
+    res_masked = _dispatch_list(pkt, table[pkt->entry.ifnum].masked);
     mutex_unlock(&lock);
-#if ENABLE_DEBUG
-    DEBUG("can_router_dispatch_rx: msg send to %d threads\n", msg_cnt);
-#endif
-    if (atomic_load(&pkt->ref_count) == 0) {
+    DEBUG("can_router_dispatch_rx: msg send to %u users\n",
+          (unsigned)atomic_load(&pkt->ref_count) - 1);
+    if (atomic_fetch_sub(&pkt->ref_count, 1) == 1) {
         can_pkt_free(pkt);
     }
 
-    return res;
+    return (res < 0) ? res : res_masked;
 }
 
 int can_router_dispatch_tx_conf(can_pkt_t *pkt)
@@ -393,10 +445,17 @@ int can_router_free_frame(struct can_frame *frame)
         return -1;
     }
 
-    atomic_fetch_sub(&pkt->ref_count, 1);
-
-    if (atomic_load(&pkt->ref_count) == 0) {
+    if (atomic_fetch_sub(&pkt->ref_count, 1) == 1) {
         can_pkt_free(pkt);
     }
     return 0;
 }
+
+int can_router_free_rx_data(can_rx_data_t *data)
+{
+    int res = can_router_free_frame(data->data.iov_base);
+
+    mempool_free_irq(&_rx_data_pool, data);
+
+    return res;
+}
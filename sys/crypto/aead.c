@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Algorithm independent part of the AEAD interface
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "crypto/aead.h"
+#include "net/gnrc/pkt.h"
+
+int aead_init(aead_t *aead, aead_id_t id, const uint8_t *key, size_t key_len)
+{
+    aead->interface = id;
+    aead->ad_left = 0;
+    aead->msg_left = 0;
+    return id->init(&aead->ctx, key, key_len);
+}
+
+int aead_start(aead_t *aead, aead_dir_t dir, const uint8_t *nonce,
+               size_t nonce_len, size_t ad_len, size_t msg_len,
+               size_t tag_len)
+{
+    if ((nonce_len > 15) || !(aead->interface->nonce_sizes & (1U << nonce_len))) {
+        return AEAD_ERR_INVALID_NONCE;
+    }
+    if ((tag_len > AEAD_MAX_TAG_SIZE) ||
+        !(aead->interface->tag_sizes & (1UL << tag_len))) {
+        return AEAD_ERR_INVALID_TAG_SIZE;
+    }
+
+    aead->dir = dir;
+    aead->tag_len = tag_len;
+    aead->ad_left = ad_len;
+    aead->msg_left = msg_len;
+    return aead->interface->start(&aead->ctx, nonce, nonce_len, ad_len,
+                                  msg_len, tag_len);
+}
+
+int aead_update_ad(aead_t *aead, const void *ad, size_t len)
+{
+    if (len > aead->ad_left) {
+        return AEAD_ERR_INVALID_LENGTH;
+    }
+    aead->ad_left -= len;
+    aead->interface->update_ad(&aead->ctx, ad, len);
+    return AEAD_OK;
+}
+
+int aead_update(aead_t *aead, const void *in, void *out, size_t len)
+{
+    if (aead->ad_left || (len > aead->msg_left)) {
+        return AEAD_ERR_INVALID_LENGTH;
+    }
+    aead->msg_left -= len;
+    return aead->interface->update(&aead->ctx, aead->dir, in, out, len);
+}
+
+int aead_update_pkt(aead_t *aead, gnrc_pktsnip_t *pkt)
+{
+    for (; pkt != NULL; pkt = pkt->next) {
+        /* the data is overwritten, so no one else may hold the snip */
+        assert(pkt->users <= 1);
+        int res = aead_update(aead, pkt->data, pkt->data, pkt->size);
+        if (res != AEAD_OK) {
+            return res;
+        }
+    }
+    return AEAD_OK;
+}
+
+int aead_finish(aead_t *aead, uint8_t *tag)
+{
+    uint8_t full[AEAD_MAX_TAG_SIZE];
+    uint8_t diff = 0;
+    int res;
+
+    if (aead->ad_left || aead->msg_left) {
+        return AEAD_ERR_INVALID_LENGTH;
+    }
+    res = aead->interface->finish(&aead->ctx, full);
+    if (res != AEAD_OK) {
+        return res;
+    }
+
+    if (aead->dir == AEAD_ENCRYPT) {
+        memcpy(tag, full, aead->tag_len);
+        return AEAD_OK;
+    }
+    /* compare in constant time */
+    for (unsigned i = 0; i < aead->tag_len; i++) {
+        diff |= full[i] ^ tag[i];
+    }
+    return diff ? AEAD_ERR_AUTH : AEAD_OK;
+}
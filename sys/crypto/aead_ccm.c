@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Single-pass AES-CCM as specified in RFC 3610
+ *
+ * Unlike crypto/modes/ccm.h, the CBC-MAC and the counter mode run
+ * interleaved over the data, so it is only read once and can arrive in
+ * pieces. The CBC-MAC block is encrypted lazily, together with the next
+ * counter block, so that most calls to the block cipher handle two blocks
+ * at once.
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "crypto/aead.h"
+#include "crypto/aes.h"
+#include "crypto/helper.h"
+
+#define BLOCK_SIZE  (16U)
+
+static int _init(aead_context_t *actx, const uint8_t *key, size_t key_len)
+{
+    int res;
+
+    if (key_len != AES_KEY_SIZE) {
+        return AEAD_ERR_INVALID_KEY_SIZE;
+    }
+    res = cipher_init(&actx->ccm.cipher, CIPHER_AES_128, key, key_len);
+    return (res == CIPHER_INIT_SUCCESS) ? AEAD_OK : AEAD_ERR_CIPHER;
+}
+
+/* encrypt the pending CBC-MAC block, optionally with the next counter */
+static int _encrypt(aead_ccm_t *ctx, int with_ctr)
+{
+    uint8_t blocks[2 * BLOCK_SIZE];
+    unsigned n = 0;
+    uint8_t *stream = blocks;
+
+    if (ctx->mac_pending) {
+        memcpy(blocks, ctx->mac, BLOCK_SIZE);
+        stream += BLOCK_SIZE;
+        n++;
+    }
+    if (with_ctr) {
+        memcpy(stream, ctx->ctr, BLOCK_SIZE);
+        crypto_block_inc_ctr(ctx->ctr, ctx->l);
+        n++;
+    }
+    if (n == 0) {
+        return AEAD_OK;
+    }
+    if (cipher_encrypt_blocks(&ctx->cipher, blocks, blocks, n) != 1) {
+        return AEAD_ERR_CIPHER;
+    }
+    if (ctx->mac_pending) {
+        memcpy(ctx->mac, blocks, BLOCK_SIZE);
+        ctx->mac_pending = 0;
+    }
+    if (with_ctr) {
+        memcpy(ctx->stream, stream, BLOCK_SIZE);
+    }
+    return AEAD_OK;
+}
+
+/* XOR data into the CBC-MAC, encrypting it whenever a block is full */
+static void _absorb(aead_ccm_t *ctx, const uint8_t *data, size_t len)
+{
+    while (len--) {
+        if (ctx->pos == 0) {
+            _encrypt(ctx, 0);
+        }
+        ctx->mac[ctx->pos++] ^= *data++;
+        if (ctx->pos == BLOCK_SIZE) {
+            ctx->mac_pending = 1;
+            ctx->pos = 0;
+        }
+    }
+}
+
+static int _start(aead_context_t *actx, const uint8_t *nonce, size_t nonce_len,
+                  size_t ad_len, size_t msg_len, size_t tag_len)
+{
+    aead_ccm_t *ctx = &actx->ccm;
+    uint8_t l = 15 - nonce_len;
+    uint8_t hdr[6];
+    size_t hdr_len = 0;
+
+    if ((l < sizeof(size_t)) && (msg_len >> (8 * l))) {
+        return AEAD_ERR_INVALID_LENGTH;
+    }
+    ctx->l = l;
+
+    /* B_0 = flags | nonce | message length */
+    ctx->mac[0] = ((ad_len > 0) << 6) | (((tag_len - 2) / 2) << 3) | (l - 1);
+    memcpy(&ctx->mac[1], nonce, nonce_len);
+    for (unsigned i = 0; i < l; i++) {
+        ctx->mac[15 - i] = (i < sizeof(size_t)) ? (uint8_t)(msg_len >> (8 * i)) : 0;
+    }
+
+    /* A_0 = flags | nonce | 0 */
+    memset(ctx->ctr, 0, BLOCK_SIZE);
+    ctx->ctr[0] = l - 1;
+    memcpy(&ctx->ctr[1], nonce, nonce_len);
+
+    /* MAC of B_0 and S_0 = E(A_0) in one go */
+    ctx->mac_pending = 1;
+    ctx->pos = 0;
+    ctx->in_msg = 0;
+    if (_encrypt(ctx, 1) != AEAD_OK) {
+        return AEAD_ERR_CIPHER;
+    }
+    memcpy(ctx->s0, ctx->stream, BLOCK_SIZE);
+
+    /* the associated data starts with its encoded length */
+    if (ad_len == 0) {
+        return AEAD_OK;
+    }
+    if (ad_len < 0xff00) {
+        hdr[0] = ad_len >> 8;
+        hdr[1] = ad_len;
+        hdr_len = 2;
+    }
+    else {
+        hdr[0] = 0xff;
+        hdr[1] = 0xfe;
+        for (unsigned i = 0; i < 4; i++) {
+            hdr[2 + i] = (uint8_t)((uint32_t)ad_len >> (24 - 8 * i));
+        }
+        hdr_len = 6;
+    }
+    _absorb(ctx, hdr, hdr_len);
+    return AEAD_OK;
+}
+
+static void _update_ad(aead_context_t *actx, const uint8_t *ad, size_t len)
+{
+    _absorb(&actx->ccm, ad, len);
+}
+
+/* a partial block is padded with zeros, which leaves the MAC unchanged */
+static void _end_block(aead_ccm_t *ctx)
+{
+    if (ctx->pos) {
+        ctx->mac_pending = 1;
+        ctx->pos = 0;
+    }
+}
+
+static int _update(aead_context_t *actx, aead_dir_t dir, const uint8_t *in,
+                   uint8_t *out, size_t len)
+{
+    aead_ccm_t *ctx = &actx->ccm;
+
+    /* the message starts at a block boundary after the associated data */
+    if (!ctx->in_msg) {
+        _end_block(ctx);
+        ctx->in_msg = 1;
+    }
+
+    while (len) {
+        unsigned pos = ctx->pos;
+        if (pos == 0) {
+            if (_encrypt(ctx, 1) != AEAD_OK) {
+                return AEAD_ERR_CIPHER;
+            }
+        }
+        size_t n = BLOCK_SIZE - pos;
+        if (n > len) {
+            n = len;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint8_t c = in[i] ^ ctx->stream[pos + i];
+            ctx->mac[pos + i] ^= (dir == AEAD_ENCRYPT) ? in[i] : c;
+            out[i] = c;
+        }
+        pos += n;
+        if (pos == BLOCK_SIZE) {
+            ctx->mac_pending = 1;
+            pos = 0;
+        }
+        ctx->pos = pos;
+        in += n;
+        out += n;
+        len -= n;
+    }
+    return AEAD_OK;
+}
+
+static int _finish(aead_context_t *actx, uint8_t *tag)
+{
+    aead_ccm_t *ctx = &actx->ccm;
+
+    _end_block(ctx);
+    if (_encrypt(ctx, 0) != AEAD_OK) {
+        return AEAD_ERR_CIPHER;
+    }
+    for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+        tag[i] = ctx->mac[i] ^ ctx->s0[i];
+    }
+
+    memset(ctx->stream, 0, sizeof(ctx->stream));
+    memset(ctx->s0, 0, sizeof(ctx->s0));
+    return AEAD_OK;
+}
+
+static const aead_interface_t _ccm = {
+    /* 7 to 13 bytes, leaving 2 to 8 bytes for the length */
+    .nonce_sizes = 0x3f80,
+    /* even lengths from 4 to 16 */
+    .tag_sizes = 0x15550,
+    .init = _init,
+    .start = _start,
+    .update_ad = _update_ad,
+    .update = _update,
+    .finish = _finish,
+};
+
+const aead_id_t AEAD_AES_128_CCM = &_ccm;
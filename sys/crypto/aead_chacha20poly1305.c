@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       ChaCha20-Poly1305 AEAD as specified in RFC 8439
+ *
+ * RFC 8439 uses a 32 bit block counter and a 96 bit nonce, so the nonce
+ * overwrites the upper half of the 64 bit counter of chacha.c. Messages are
+ * therefore limited to 2^32 blocks (256 GiB).
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "crypto/aead.h"
+
+static const uint8_t _zeros[16];
+
+static int _init(aead_context_t *actx, const uint8_t *key, size_t key_len)
+{
+    aead_chacha20poly1305_t *ctx = &actx->chacha20poly1305;
+    static const uint8_t nonce[8];
+
+    if (key_len != 32) {
+        return AEAD_ERR_INVALID_KEY_SIZE;
+    }
+    /* only copies the key, counter and nonce are set by _start() */
+    chacha_init(&ctx->chacha, 20, key, key_len, nonce);
+    return AEAD_OK;
+}
+
+static int _start(aead_context_t *actx, const uint8_t *nonce, size_t nonce_len,
+                  size_t ad_len, size_t msg_len, size_t tag_len)
+{
+    aead_chacha20poly1305_t *ctx = &actx->chacha20poly1305;
+
+    (void)nonce_len;
+    (void)tag_len;
+
+    /* chacha.c is little endian only, so the words can be copied */
+    ctx->chacha.state[12] = 0;
+    memcpy(&ctx->chacha.state[13], nonce, 12);
+
+    /* the first 32 bytes of key stream block 0 are the Poly1305 key */
+    chacha_keystream_bytes(&ctx->chacha, ctx->stream);
+    poly1305_init(&ctx->poly, ctx->stream);
+
+    ctx->stream_pos = sizeof(ctx->stream);
+    ctx->ad_len = ad_len;
+    ctx->msg_len = msg_len;
+    ctx->ad_padded = 0;
+    return AEAD_OK;
+}
+
+static void _pad16(poly1305_ctx_t *poly, size_t len)
+{
+    if (len & 15) {
+        poly1305_update(poly, _zeros, 16 - (len & 15));
+    }
+}
+
+static void _update_ad(aead_context_t *actx, const uint8_t *ad, size_t len)
+{
+    poly1305_update(&actx->chacha20poly1305.poly, ad, len);
+}
+
+static int _update(aead_context_t *actx, aead_dir_t dir, const uint8_t *in,
+                   uint8_t *out, size_t len)
+{
+    aead_chacha20poly1305_t *ctx = &actx->chacha20poly1305;
+
+    if (!ctx->ad_padded) {
+        _pad16(&ctx->poly, ctx->ad_len);
+        ctx->ad_padded = 1;
+    }
+    /* the tag covers the ciphertext */
+    if (dir == AEAD_DECRYPT) {
+        poly1305_update(&ctx->poly, in, len);
+    }
+
+    size_t pos = 0;
+    while (pos < len) {
+        if (ctx->stream_pos == sizeof(ctx->stream)) {
+            chacha_keystream_bytes(&ctx->chacha, ctx->stream);
+            ctx->stream_pos = 0;
+        }
+        size_t n = sizeof(ctx->stream) - ctx->stream_pos;
+        if (n > len - pos) {
+            n = len - pos;
+        }
+        const uint8_t *ks = &ctx->stream[ctx->stream_pos];
+        for (size_t i = 0; i < n; i++) {
+            out[pos + i] = in[pos + i] ^ ks[i];
+        }
+        ctx->stream_pos += n;
+        pos += n;
+    }
+
+    if (dir == AEAD_ENCRYPT) {
+        poly1305_update(&ctx->poly, out, len);
+    }
+    return AEAD_OK;
+}
+
+static void _put_le64(uint8_t *p, uint64_t v)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static int _finish(aead_context_t *actx, uint8_t *tag)
+{
+    aead_chacha20poly1305_t *ctx = &actx->chacha20poly1305;
+    uint8_t lens[16];
+
+    if (!ctx->ad_padded) {
+        _pad16(&ctx->poly, ctx->ad_len);
+    }
+    _pad16(&ctx->poly, ctx->msg_len);
+    _put_le64(&lens[0], ctx->ad_len);
+    _put_le64(&lens[8], ctx->msg_len);
+    poly1305_update(&ctx->poly, lens, sizeof(lens));
+    poly1305_finish(&ctx->poly, tag);
+
+    /* don't leave key stream behind */
+    memset(ctx->stream, 0, sizeof(ctx->stream));
+    return AEAD_OK;
+}
+
+static const aead_interface_t _chacha20poly1305 = {
+    .nonce_sizes = (1U << 12),
+    .tag_sizes = (1UL << 16),
+    .init = _init,
+    .start = _start,
+    .update_ad = _update_ad,
+    .update = _update,
+    .finish = _finish,
+};
+
+const aead_id_t AEAD_CHACHA20_POLY1305 = &_chacha20poly1305;
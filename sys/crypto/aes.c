@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include "crypto/aes.h"
 #include "crypto/ciphers.h"
+#include "aes_backend.h"
 
 /**
  * Interface to the aes cipher
@@ -45,10 +46,96 @@ static const cipher_interface_t aes_interface = {
     AES_KEY_SIZE,
     aes_init,
     aes_encrypt,
-    aes_decrypt
+    aes_decrypt,
+    aes_encrypt_blocks
 };
 const cipher_id_t CIPHER_AES_128 = &aes_interface;
 
+/**
+ * Backend used for all contexts, chosen by the first call to aes_init()
+ */
+static const aes_backend_t *_backend;
+
+static const aes_backend_t *_select_backend(void)
+{
+#ifdef AES_BACKEND_NI
+    if (aes_ni_supported()) {
+        return &aes_backend_ni;
+    }
+#endif
+#ifdef MODULE_CRYPTO_AES_CT
+    return &aes_backend_ct;
+#else
+    return &aes_backend_tables;
+#endif
+}
+
+int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
+{
+    uint8_t i;
+    uint8_t user_key[AES_KEY_SIZE];
+    aes_context_t *ctx = (aes_context_t *)context->context;
+
+    // Make sure that context is large enough. If this is not the case,
+    // you should build with -DCRYPTO_AES
+    if (CIPHER_MAX_CONTEXT_SIZE < sizeof(aes_context_t)) {
+        return CIPHER_ERR_BAD_CONTEXT_SIZE;
+    }
+
+    if (keySize == 0) {
+        return CIPHER_ERR_INVALID_KEY_SIZE;
+    }
+
+    //key must be at least AES_KEY_SIZE Bytes long
+    //fill up by concatenating key to as long as needed
+    for (i = 0; i < AES_KEY_SIZE; i++) {
+        user_key[i] = key[(i % keySize)];
+    }
+
+    if (_backend == NULL) {
+        _backend = _select_backend();
+    }
+    /* expand the key schedules once, instead of for every block */
+    _backend->set_key(ctx, user_key);
+
+    return CIPHER_INIT_SUCCESS;
+}
+
+int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
+                uint8_t *cipher_block)
+{
+    _backend->encrypt((const aes_context_t *)context->context, plain_block,
+                      cipher_block, 1);
+    return 1;
+}
+
+int aes_decrypt(const cipher_context_t *context, const uint8_t *cipher_block,
+                uint8_t *plain_block)
+{
+    _backend->decrypt((const aes_context_t *)context->context, cipher_block,
+                      plain_block, 1);
+    return 1;
+}
+
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t nblocks)
+{
+    _backend->encrypt((const aes_context_t *)context->context, input, output,
+                      nblocks);
+    return 1;
+}
+
+int aes_decrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t nblocks)
+{
+    _backend->decrypt((const aes_context_t *)context->context, input, output,
+                      nblocks);
+    return 1;
+}
+
+#ifndef MODULE_CRYPTO_AES_CT
+/* T-table backend, not built if the constant-time backend replaces it */
+
 static const u32 Te0[256] = {
     0xc66363a5U, 0xf87c7c84U, 0xee777799U, 0xf67b7b8dU,
     0xfff2f20dU, 0xd66b6bbdU, 0xde6f6fb1U, 0x91c5c554U,
@@ -720,32 +807,6 @@ static const u32 rcon[] = {
 };
 
 
-int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize)
-{
-    uint8_t i;
-
-    // Make sure that context is large enough. If this is not the case,
-    // you should build with -DAES
-    if(CIPHER_MAX_CONTEXT_SIZE < AES_KEY_SIZE) {
-        return CIPHER_ERR_BAD_CONTEXT_SIZE;
-    }
-
-    //key must be at least CIPHERS_MAX_KEY_SIZE Bytes long
-    if (keySize < CIPHERS_MAX_KEY_SIZE) {
-        //fill up by concatenating key to as long as needed
-        for (i = 0; i < CIPHERS_MAX_KEY_SIZE; i++) {
-            context->context[i] = key[(i % keySize)];
-        }
-    }
-    else {
-        for (i = 0; i < CIPHERS_MAX_KEY_SIZE; i++) {
-            context->context[i] = key[i];
-        }
-    }
-
-    return CIPHER_INIT_SUCCESS;
-}
-
 /**
  * Expand the cipher key into the encryption key schedule.
  */
@@ -931,31 +992,34 @@ static int aes_set_decrypt_key(const unsigned char *userKey, const int bits,
     return 0;
 }
 
+static void _tables_set_key(aes_context_t *ctx,
+                            const uint8_t key[AES_KEY_SIZE])
+{
+    AES_KEY aeskey;
+
+    aes_set_encrypt_key(key, AES_KEY_SIZE * 8, &aeskey);
+    memcpy(ctx->enc_key, aeskey.rd_key, sizeof(ctx->enc_key));
+
+    aes_set_decrypt_key(key, AES_KEY_SIZE * 8, &aeskey);
+    memcpy(ctx->dec_key, aeskey.rd_key, sizeof(ctx->dec_key));
+}
+
 #ifndef AES_ASM
 /*
  * Encrypt a single block
  * in and out can overlap
  */
-int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
-                uint8_t *cipherBlock)
+static void _tables_encrypt_block(const aes_context_t *ctx,
+                                  const uint8_t *plainBlock,
+                                  uint8_t *cipherBlock)
 {
-    //setup AES_KEY
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-    res = aes_set_encrypt_key((unsigned char *)context->context,
-                                   AES_KEY_SIZE * 8, &aeskey);
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef FULL_UNROLL
     int r;
 #endif /* ?FULL_UNROLL */
 
-    rk = key->rd_key;
+    rk = ctx->enc_key;
 
     /*
      * map byte array block to cipher state
@@ -1048,7 +1112,7 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
     t3 = Te0[s3 >> 24] ^ Te1[(s0 >> 16) & 0xff] ^ Te2[(s1 >>  8) & 0xff] ^
          Te3[s2 & 0xff] ^ rk[39];
 
-    if (key->rounds > 10) {
+    if (AES_ROUNDS > 10) {
         /* round 10: */
         s0 = Te0[t0 >> 24] ^ Te1[(t1 >> 16) & 0xff] ^ Te2[(t2 >>  8) & 0xff] ^
              Te3[t3 & 0xff] ^ rk[40];
@@ -1068,7 +1132,7 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         t3 = Te0[s3 >> 24] ^ Te1[(s0 >> 16) & 0xff] ^ Te2[(s1 >>  8) & 0xff] ^
              Te3[s2 & 0xff] ^ rk[47];
 
-        if (key->rounds > 12) {
+        if (AES_ROUNDS > 12) {
             /* round 12: */
             s0 = Te0[t0 >> 24] ^ Te1[(t1 >> 16) & 0xff] ^ Te2[(t2 >>  8) &
                     0xff] ^ Te3[t3 & 0xff] ^ rk[48];
@@ -1090,12 +1154,12 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         }
     }
 
-    rk += key->rounds << 2;
+    rk += AES_ROUNDS << 2;
 #else  /* !FULL_UNROLL */
     /*
      * Nr - 1 full rounds:
      */
-    r = key->rounds >> 1;
+    r = AES_ROUNDS >> 1;
 
     while (1) {
         t0 =
@@ -1188,34 +1252,23 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plainBlock,
         (Te4[(t2) & 0xff]       & 0x000000ff) ^
         rk[3];
     PUTU32(cipherBlock + 12, s3);
-    return 1;
 }
 
 /*
  * Decrypt a single block
  * in and out can overlap
  */
-int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
-                uint8_t *plainBlock)
+static void _tables_decrypt_block(const aes_context_t *ctx,
+                                  const uint8_t *cipherBlock,
+                                  uint8_t *plainBlock)
 {
-    //setup AES_KEY
-    int res;
-    AES_KEY aeskey;
-    const AES_KEY *key = &aeskey;
-    res = aes_set_decrypt_key((unsigned char *)context->context,
-                              AES_KEY_SIZE * 8, &aeskey);
-
-    if (res < 0) {
-        return res;
-    }
-
     const u32 *rk;
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
 #ifndef FULL_UNROLL
     int r;
 #endif /* ?FULL_UNROLL */
 
-    rk = key->rd_key;
+    rk = ctx->dec_key;
 
     /*
      * map byte array block to cipher state
@@ -1308,7 +1361,7 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
     t3 = Td0[s3 >> 24] ^ Td1[(s2 >> 16) & 0xff] ^ Td2[(s1 >>  8) & 0xff] ^
          Td3[s0 & 0xff] ^ rk[39];
 
-    if (key->rounds > 10) {
+    if (AES_ROUNDS > 10) {
         /* round 10: */
         s0 = Td0[t0 >> 24] ^ Td1[(t3 >> 16) & 0xff] ^ Td2[(t2 >>  8) & 0xff] ^
              Td3[t1 & 0xff] ^ rk[40];
@@ -1328,7 +1381,7 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
         t3 = Td0[s3 >> 24] ^ Td1[(s2 >> 16) & 0xff] ^ Td2[(s1 >>  8) & 0xff] ^
              Td3[s0 & 0xff] ^ rk[47];
 
-        if (key->rounds > 12) {
+        if (AES_ROUNDS > 12) {
             /* round 12: */
             s0 = Td0[t0 >> 24] ^ Td1[(t3 >> 16) & 0xff] ^ Td2[(t2 >>  8) & 0xff]
                  ^ Td3[t1 & 0xff] ^ rk[48];
@@ -1350,12 +1403,12 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
         }
     }
 
-    rk += key->rounds << 2;
+    rk += AES_ROUNDS << 2;
 #else  /* !FULL_UNROLL */
     /*
      * Nr - 1 full rounds:
      */
-    r = key->rounds >> 1;
+    r = AES_ROUNDS >> 1;
 
     while (1) {
         t0 =
@@ -1448,7 +1501,32 @@ int aes_decrypt(const cipher_context_t *context, const uint8_t *cipherBlock,
         (Td4[(t0) & 0xff]       & 0x000000ff) ^
         rk[3];
     PUTU32(plainBlock + 12, s3);
-    return 1;
 }
 
 #endif /* AES_ASM */
+
+static void _tables_encrypt(const aes_context_t *ctx, const uint8_t *in,
+                            uint8_t *out, size_t nblocks)
+{
+    for (size_t i = 0; i < nblocks; i++) {
+        _tables_encrypt_block(ctx, in + i * AES_BLOCK_SIZE,
+                              out + i * AES_BLOCK_SIZE);
+    }
+}
+
+static void _tables_decrypt(const aes_context_t *ctx, const uint8_t *in,
+                            uint8_t *out, size_t nblocks)
+{
+    for (size_t i = 0; i < nblocks; i++) {
+        _tables_decrypt_block(ctx, in + i * AES_BLOCK_SIZE,
+                              out + i * AES_BLOCK_SIZE);
+    }
+}
+
+const aes_backend_t aes_backend_tables = {
+    .set_key = _tables_set_key,
+    .encrypt = _tables_encrypt,
+    .decrypt = _tables_decrypt,
+};
+
+#endif /* MODULE_CRYPTO_AES_CT */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Interface between the AES front-end and its implementations
+ *
+ * aes.c implements the public AES API on top of one of these backends:
+ *
+ * - the T-table implementation in aes.c (default)
+ * - a bitsliced, constant-time implementation (module `crypto_aes_ct`)
+ * - the AES-NI instructions on x86 hosts (module `crypto_aes_ni`), which
+ *   falls back to one of the above if the CPU lacks them
+ *
+ * All backends work on aes_context_t, but the layout of the key schedules
+ * stored in it is private to the backend that expanded the key.
+ *
+ * @}
+ */
+
+#ifndef AES_BACKEND_H
+#define AES_BACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto/aes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   AES-128 implementation
+ */
+typedef struct {
+    /**
+     * @brief   Expand @p key into the key schedules of @p ctx
+     */
+    void (*set_key)(aes_context_t *ctx, const uint8_t key[AES_KEY_SIZE]);
+    /**
+     * @brief   Encrypt @p nblocks consecutive blocks, @p in may equal @p out
+     */
+    void (*encrypt)(const aes_context_t *ctx, const uint8_t *in, uint8_t *out,
+                    size_t nblocks);
+    /**
+     * @brief   Decrypt @p nblocks consecutive blocks, @p in may equal @p out
+     */
+    void (*decrypt)(const aes_context_t *ctx, const uint8_t *in, uint8_t *out,
+                    size_t nblocks);
+} aes_backend_t;
+
+#ifdef MODULE_CRYPTO_AES_CT
+/**
+ * @brief   Bitsliced constant-time backend, see aes_ct.c
+ */
+extern const aes_backend_t aes_backend_ct;
+#else
+/**
+ * @brief   T-table backend, see aes.c
+ */
+extern const aes_backend_t aes_backend_tables;
+#endif
+
+/**
+ * @brief   Defined if the AES-NI backend is built in
+ */
+#if defined(MODULE_CRYPTO_AES_NI) && (defined(__i386__) || defined(__x86_64__))
+#define AES_BACKEND_NI
+#endif
+
+#ifdef AES_BACKEND_NI
+/**
+ * @brief   AES-NI backend, see aes_ni.c
+ */
+extern const aes_backend_t aes_backend_ni;
+
+/**
+ * @brief   Check if the host CPU supports the AES-NI instructions
+ *
+ * @return  1 if aes_backend_ni can be used, 0 otherwise
+ */
+int aes_ni_supported(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AES_BACKEND_H */
@@ -0,0 +1,476 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Bitsliced constant-time AES-128
+ *
+ * Up to AES_CT_PARALLEL blocks are transposed into eight 64 bit words, word
+ * b holding bit b of every byte. Bit 16 * k + j of each word belongs to byte
+ * j of block k, j counting the AES state column by column. SubBytes is then
+ * evaluated as a boolean circuit on the eight words (the circuit by Boyar and
+ * Peralta, as used by BearSSL), ShiftRows and MixColumns become fixed shifts
+ * and masks within the 16 bit lanes. Neither memory accesses nor branches
+ * depend on the key or the data.
+ *
+ * The key schedule keeps each round key as eight 16 bit planes, packed two
+ * per word into aes_context_t::enc_key. aes_context_t::dec_key is unused.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "aes_backend.h"
+
+#ifdef MODULE_CRYPTO_AES_CT
+
+/**
+ * @brief   Number of blocks processed in parallel
+ */
+#define AES_CT_PARALLEL     (4U)
+
+/* replicate a 16 bit pattern into all four lanes */
+#define LANES(x)            ((uint64_t)(x) * 0x0001000100010001ULL)
+
+static void _sbox(uint64_t *q)
+{
+    uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint64_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint64_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint64_t y20, y21;
+    uint64_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint64_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint64_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint64_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint64_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint64_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint64_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint64_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/**
+ * @brief   Inverse of the S-box affine transformation, including the
+ *          constant 0x63
+ */
+static void _inv_affine(uint64_t *q)
+{
+    uint64_t y[8];
+
+    for (unsigned i = 0; i < 8; i++) {
+        y[i] = (0x63 & (1 << i)) ? ~q[i] : q[i];
+    }
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] = y[(i + 2) & 7] ^ y[(i + 5) & 7] ^ y[(i + 7) & 7];
+    }
+}
+
+/* InvSubBytes(y) = A^-1(SubBytes(A^-1(y))), as SubBytes(x) = A(x^-1) */
+static void _inv_sbox(uint64_t *q)
+{
+    _inv_affine(q);
+    _sbox(q);
+    _inv_affine(q);
+}
+
+/* rotate each 16 bit lane of x right by n bits */
+static inline uint64_t _rotr_lanes(uint64_t x, unsigned n)
+{
+    uint64_t lo = LANES(0xffff >> n);
+    return ((x >> n) & lo) | ((x << (16 - n)) & ~lo);
+}
+
+static void _shift_rows(uint64_t *q)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & LANES(0x1111))
+               | _rotr_lanes(x & LANES(0x2222), 4)
+               | _rotr_lanes(x & LANES(0x4444), 8)
+               | _rotr_lanes(x & LANES(0x8888), 12);
+    }
+}
+
+static void _inv_shift_rows(uint64_t *q)
+{
+    for (unsigned i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & LANES(0x1111))
+               | _rotr_lanes(x & LANES(0x2222), 12)
+               | _rotr_lanes(x & LANES(0x4444), 8)
+               | _rotr_lanes(x & LANES(0x8888), 4);
+    }
+}
+
+/* move row r + n of every column to row r */
+static inline uint64_t _rot_rows(uint64_t x, unsigned n)
+{
+    uint64_t lo = LANES(0x1111 * (0xf >> n));
+    return ((x >> n) & lo) | ((x << (4 - n)) & ~lo);
+}
+
+/* multiply each byte by x in GF(2^8) */
+static void _xtime(uint64_t *q)
+{
+    uint64_t hi = q[7];
+
+    q[7] = q[6];
+    q[6] = q[5];
+    q[5] = q[4];
+    q[4] = q[3] ^ hi;
+    q[3] = q[2] ^ hi;
+    q[2] = q[1];
+    q[1] = q[0] ^ hi;
+    q[0] = hi;
+}
+
+static void _mix_columns(uint64_t *q)
+{
+    uint64_t t[8];
+
+    /* 2 * a[r] + 3 * a[r + 1] + a[r + 2] + a[r + 3]
+     * = 2 * (a[r] + a[r + 1]) + a[r + 1] + (a[r + 2] + a[r + 3]) */
+    for (unsigned i = 0; i < 8; i++) {
+        t[i] = q[i] ^ _rot_rows(q[i], 1);
+    }
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] = _rot_rows(q[i], 1) ^ _rot_rows(t[i], 2);
+    }
+    _xtime(t);
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] ^= t[i];
+    }
+}
+
+static void _inv_mix_columns(uint64_t *q)
+{
+    uint64_t t[8];
+
+    /* InvMixColumns = MixColumns * (5 + 4 * rot2) */
+    for (unsigned i = 0; i < 8; i++) {
+        t[i] = q[i] ^ _rot_rows(q[i], 2);
+    }
+    _xtime(t);
+    _xtime(t);
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] ^= t[i];
+    }
+    _mix_columns(q);
+}
+
+/* transpose the 8x8 bit matrix in x (bit 8 * i + j <-> bit 8 * j + i) */
+static inline uint64_t _transpose8(uint64_t x)
+{
+    uint64_t t;
+
+    t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaULL;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000cccc0000ccccULL;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ULL;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+static void _load(uint64_t *q, const uint8_t *in, size_t len)
+{
+    memset(q, 0, 8 * sizeof(uint64_t));
+    for (unsigned pos = 0; pos < len; pos += 8) {
+        uint64_t x = 0;
+        for (unsigned i = 0; i < 8; i++) {
+            x |= (uint64_t)in[pos + i] << (8 * i);
+        }
+        x = _transpose8(x);
+        for (unsigned b = 0; b < 8; b++) {
+            q[b] |= ((x >> (8 * b)) & 0xff) << pos;
+        }
+    }
+}
+
+static void _store(const uint64_t *q, uint8_t *out, size_t len)
+{
+    for (unsigned pos = 0; pos < len; pos += 8) {
+        uint64_t x = 0;
+        for (unsigned b = 0; b < 8; b++) {
+            x |= ((q[b] >> pos) & 0xff) << (8 * b);
+        }
+        x = _transpose8(x);
+        for (unsigned i = 0; i < 8; i++) {
+            out[pos + i] = (uint8_t)(x >> (8 * i));
+        }
+    }
+}
+
+static void _add_round_key(uint64_t *q, const aes_context_t *ctx,
+                           unsigned round)
+{
+    const uint32_t *rk = &ctx->enc_key[4 * round];
+
+    for (unsigned i = 0; i < 8; i++) {
+        q[i] ^= LANES((rk[i / 2] >> (16 * (i & 1))) & 0xffff);
+    }
+}
+
+static uint32_t _sub_word(uint32_t w)
+{
+    uint64_t q[8];
+    uint8_t b[8] = { (uint8_t)w, (uint8_t)(w >> 8), (uint8_t)(w >> 16),
+                     (uint8_t)(w >> 24) };
+
+    _load(q, b, sizeof(b));
+    _sbox(q);
+    _store(q, b, sizeof(b));
+    return b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) |
+           ((uint32_t)b[3] << 24);
+}
+
+static void _set_key(aes_context_t *ctx, const uint8_t key[AES_KEY_SIZE])
+{
+    /* words of the expanded key, byte 0 of the word in bits 0..7 */
+    uint32_t w[4 * (AES_ROUNDS + 1)];
+    uint32_t rcon = 1;
+
+    for (unsigned i = 0; i < 4; i++) {
+        w[i] = key[4 * i] | ((uint32_t)key[4 * i + 1] << 8) |
+               ((uint32_t)key[4 * i + 2] << 16) |
+               ((uint32_t)key[4 * i + 3] << 24);
+    }
+    for (unsigned i = 4; i < 4 * (AES_ROUNDS + 1); i++) {
+        uint32_t tmp = w[i - 1];
+        if ((i % 4) == 0) {
+            tmp = _sub_word((tmp >> 8) | (tmp << 24)) ^ rcon;
+            rcon = (rcon << 1) ^ (0x11b & -(rcon >> 7));
+        }
+        w[i] = w[i - 4] ^ tmp;
+    }
+
+    /* bitslice the round keys */
+    for (unsigned r = 0; r <= AES_ROUNDS; r++) {
+        uint16_t plane[8] = { 0 };
+        for (unsigned j = 0; j < 16; j++) {
+            unsigned byte = (w[4 * r + j / 4] >> (8 * (j % 4))) & 0xff;
+            for (unsigned b = 0; b < 8; b++) {
+                plane[b] |= ((byte >> b) & 1) << j;
+            }
+        }
+        for (unsigned i = 0; i < 4; i++) {
+            ctx->enc_key[4 * r + i] = plane[2 * i] |
+                                      ((uint32_t)plane[2 * i + 1] << 16);
+        }
+    }
+    memset(ctx->dec_key, 0, sizeof(ctx->dec_key));
+}
+
+static void _encrypt(const aes_context_t *ctx, const uint8_t *in,
+                     uint8_t *out, size_t nblocks)
+{
+    uint64_t q[8];
+
+    while (nblocks) {
+        size_t n = (nblocks < AES_CT_PARALLEL) ? nblocks : AES_CT_PARALLEL;
+
+        _load(q, in, n * AES_BLOCK_SIZE);
+        _add_round_key(q, ctx, 0);
+        for (unsigned r = 1; r < AES_ROUNDS; r++) {
+            _sbox(q);
+            _shift_rows(q);
+            _mix_columns(q);
+            _add_round_key(q, ctx, r);
+        }
+        _sbox(q);
+        _shift_rows(q);
+        _add_round_key(q, ctx, AES_ROUNDS);
+        _store(q, out, n * AES_BLOCK_SIZE);
+
+        in += n * AES_BLOCK_SIZE;
+        out += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+}
+
+static void _decrypt(const aes_context_t *ctx, const uint8_t *in,
+                     uint8_t *out, size_t nblocks)
+{
+    uint64_t q[8];
+
+    while (nblocks) {
+        size_t n = (nblocks < AES_CT_PARALLEL) ? nblocks : AES_CT_PARALLEL;
+
+        _load(q, in, n * AES_BLOCK_SIZE);
+        _add_round_key(q, ctx, AES_ROUNDS);
+        for (unsigned r = AES_ROUNDS - 1; r > 0; r--) {
+            _inv_shift_rows(q);
+            _inv_sbox(q);
+            _add_round_key(q, ctx, r);
+            _inv_mix_columns(q);
+        }
+        _inv_shift_rows(q);
+        _inv_sbox(q);
+        _add_round_key(q, ctx, 0);
+        _store(q, out, n * AES_BLOCK_SIZE);
+
+        in += n * AES_BLOCK_SIZE;
+        out += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+}
+
+const aes_backend_t aes_backend_ct = {
+    .set_key = _set_key,
+    .encrypt = _encrypt,
+    .decrypt = _decrypt,
+};
+
+#endif /* MODULE_CRYPTO_AES_CT */
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       AES-128 using the x86 AES-NI instructions
+ *
+ * Used on the native board if the host CPU supports it. The round keys are
+ * stored as plain byte arrays in aes_context_t::enc_key and
+ * aes_context_t::dec_key (already passed through AESIMC) and loaded
+ * unaligned, as cipher_context_t only guarantees word alignment.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "aes_backend.h"
+
+#ifdef AES_BACKEND_NI
+
+#include <cpuid.h>
+#include <wmmintrin.h>
+
+/**
+ * @brief   Number of blocks kept in flight to hide the AESENC latency
+ */
+#define AES_NI_PARALLEL     (4U)
+
+#define AES_NI_TARGET       __attribute__((target("aes,sse2")))
+
+int aes_ni_supported(void)
+{
+    unsigned eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ecx & bit_AES) ? 1 : 0;
+}
+
+static inline AES_NI_TARGET __m128i _expand(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+/* the round constant must be an immediate */
+#define EXPAND(rk, i, rcon) \
+    rk[i] = _expand(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+static AES_NI_TARGET void _set_key(aes_context_t *ctx,
+                                   const uint8_t key[AES_KEY_SIZE])
+{
+    __m128i rk[AES_ROUNDS + 1];
+    __m128i *enc = (__m128i *)ctx->enc_key;
+    __m128i *dec = (__m128i *)ctx->dec_key;
+
+    rk[0] = _mm_loadu_si128((const __m128i *)key);
+    EXPAND(rk, 1, 0x01);
+    EXPAND(rk, 2, 0x02);
+    EXPAND(rk, 3, 0x04);
+    EXPAND(rk, 4, 0x08);
+    EXPAND(rk, 5, 0x10);
+    EXPAND(rk, 6, 0x20);
+    EXPAND(rk, 7, 0x40);
+    EXPAND(rk, 8, 0x80);
+    EXPAND(rk, 9, 0x1b);
+    EXPAND(rk, 10, 0x36);
+
+    for (unsigned i = 0; i <= AES_ROUNDS; i++) {
+        _mm_storeu_si128(&enc[i], rk[i]);
+    }
+    /* equivalent inverse cipher: reversed order, inner keys through AESIMC */
+    _mm_storeu_si128(&dec[0], rk[AES_ROUNDS]);
+    for (unsigned i = 1; i < AES_ROUNDS; i++) {
+        _mm_storeu_si128(&dec[i], _mm_aesimc_si128(rk[AES_ROUNDS - i]));
+    }
+    _mm_storeu_si128(&dec[AES_ROUNDS], rk[0]);
+}
+
+static AES_NI_TARGET void _encrypt(const aes_context_t *ctx,
+                                   const uint8_t *in, uint8_t *out,
+                                   size_t nblocks)
+{
+    const __m128i *rk = (const __m128i *)ctx->enc_key;
+    __m128i b[AES_NI_PARALLEL];
+
+    while (nblocks) {
+        unsigned n = (nblocks < AES_NI_PARALLEL) ? nblocks : AES_NI_PARALLEL;
+        __m128i k = _mm_loadu_si128(&rk[0]);
+
+        for (unsigned i = 0; i < n; i++) {
+            b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + i), k);
+        }
+        for (unsigned r = 1; r < AES_ROUNDS; r++) {
+            k = _mm_loadu_si128(&rk[r]);
+            for (unsigned i = 0; i < n; i++) {
+                b[i] = _mm_aesenc_si128(b[i], k);
+            }
+        }
+        k = _mm_loadu_si128(&rk[AES_ROUNDS]);
+        for (unsigned i = 0; i < n; i++) {
+            _mm_storeu_si128((__m128i *)out + i, _mm_aesenclast_si128(b[i], k));
+        }
+
+        in += n * AES_BLOCK_SIZE;
+        out += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+}
+
+static AES_NI_TARGET void _decrypt(const aes_context_t *ctx,
+                                   const uint8_t *in, uint8_t *out,
+                                   size_t nblocks)
+{
+    const __m128i *rk = (const __m128i *)ctx->dec_key;
+    __m128i b[AES_NI_PARALLEL];
+
+    while (nblocks) {
+        unsigned n = (nblocks < AES_NI_PARALLEL) ? nblocks : AES_NI_PARALLEL;
+        __m128i k = _mm_loadu_si128(&rk[0]);
+
+        for (unsigned i = 0; i < n; i++) {
+            b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + i), k);
+        }
+        for (unsigned r = 1; r < AES_ROUNDS; r++) {
+            k = _mm_loadu_si128(&rk[r]);
+            for (unsigned i = 0; i < n; i++) {
+                b[i] = _mm_aesdec_si128(b[i], k);
+            }
+        }
+        k = _mm_loadu_si128(&rk[AES_ROUNDS]);
+        for (unsigned i = 0; i < n; i++) {
+            _mm_storeu_si128((__m128i *)out + i, _mm_aesdeclast_si128(b[i], k));
+        }
+
+        in += n * AES_BLOCK_SIZE;
+        out += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+}
+
+const aes_backend_t aes_backend_ni = {
+    .set_key = _set_key,
+    .encrypt = _encrypt,
+    .decrypt = _decrypt,
+};
+
+#endif /* AES_BACKEND_NI */
@@ -38,6 +38,29 @@ int cipher_encrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output
 }
 
 
+int cipher_encrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t nblocks)
+{
+    uint8_t block_size = cipher->interface->block_size;
+
+    if (cipher->interface->encrypt_blocks) {
+        return cipher->interface->encrypt_blocks(&cipher->context, input,
+                                                 output, nblocks);
+    }
+
+    while (nblocks--) {
+        int res = cipher->interface->encrypt(&cipher->context, input, output);
+        if (res != 1) {
+            return res;
+        }
+        input += block_size;
+        output += block_size;
+    }
+
+    return 1;
+}
+
+
 int cipher_decrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output)
 {
     return cipher->interface->decrypt(&cipher->context, input, output);
@@ -18,32 +18,51 @@
 * @}
 */
 
+#include <string.h>
+
 #include "crypto/helper.h"
 #include "crypto/modes/ctr.h"
 
+/**
+ * @brief   Number of key stream blocks generated with one call to
+ *          cipher_encrypt_blocks()
+ */
+#ifndef CTR_STREAM_BLOCKS
+#define CTR_STREAM_BLOCKS   (4U)
+#endif
+
 int cipher_encrypt_ctr(cipher_t* cipher, uint8_t nonce_counter[16],
                        uint8_t nonce_len, uint8_t* input, size_t length,
                        uint8_t* output)
 {
     size_t offset = 0;
-    uint8_t stream_block[16] = {0}, block_size;
+    uint8_t stream[CTR_STREAM_BLOCKS * CIPHER_MAX_BLOCK_SIZE], block_size;
 
     block_size = cipher_get_block_size(cipher);
     do {
-        uint8_t block_size_input;
+        size_t stream_len = 0;
+        unsigned nblocks = 0;
 
-        if (cipher_encrypt(cipher, nonce_counter, stream_block) != 1) {
+        /* lay out the next counter blocks and encrypt them in one go */
+        while ((nblocks < CTR_STREAM_BLOCKS) &&
+               ((nblocks == 0) || (offset + stream_len < length))) {
+            memcpy(&stream[stream_len], nonce_counter, block_size);
+            crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+            stream_len += block_size;
+            nblocks++;
+        }
+        if (cipher_encrypt_blocks(cipher, stream, stream, nblocks) != 1) {
             return CIPHER_ERR_ENC_FAILED;
         }
 
-        block_size_input = (length - offset > block_size) ?
-                           block_size : length - offset;
-        for (uint8_t i = 0; i < block_size_input; ++i) {
-            output[offset + i] = stream_block[i] ^ input[offset + i];
+        if (stream_len > length - offset) {
+            stream_len = length - offset;
+        }
+        for (size_t i = 0; i < stream_len; ++i) {
+            output[offset + i] = stream[i] ^ input[offset + i];
         }
 
-        offset += block_size_input;
-        crypto_block_inc_ctr(nonce_counter, block_size - nonce_len);
+        offset += stream_len;
     } while (offset < length);
 
     return offset;
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Poly1305 implementation with 26 bit limbs
+ *
+ * The accumulator is kept in five 26 bit limbs, so all products fit into
+ * 64 bit and only 32x32 bit multiplications are needed. This follows the
+ * public domain poly1305-donna 32 bit code.
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "crypto/poly1305.h"
+
+#define MASK26  (0x3ffffff)
+
+static inline uint32_t _le32(const uint8_t *p)
+{
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static inline void _put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+void poly1305_init(poly1305_ctx_t *ctx, const uint8_t *key)
+{
+    /* r &= 0xffffffc0ffffffc0ffffffc0fffffff */
+    ctx->r[0] = (_le32(&key[0])) & 0x3ffffff;
+    ctx->r[1] = (_le32(&key[3]) >> 2) & 0x3ffff03;
+    ctx->r[2] = (_le32(&key[6]) >> 4) & 0x3ffc0ff;
+    ctx->r[3] = (_le32(&key[9]) >> 6) & 0x3f03fff;
+    ctx->r[4] = (_le32(&key[12]) >> 8) & 0x00fffff;
+
+    for (unsigned i = 0; i < 4; i++) {
+        ctx->pad[i] = _le32(&key[16 + 4 * i]);
+    }
+    memset(ctx->h, 0, sizeof(ctx->h));
+    ctx->buf_len = 0;
+}
+
+/* hibit is 2^128 for full blocks and 0 for the padded last block */
+static void _blocks(poly1305_ctx_t *ctx, const uint8_t *m, size_t len,
+                    uint32_t hibit)
+{
+    const uint32_t r0 = ctx->r[0], r1 = ctx->r[1], r2 = ctx->r[2],
+                   r3 = ctx->r[3], r4 = ctx->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2],
+             h3 = ctx->h[3], h4 = ctx->h[4];
+
+    while (len >= 16) {
+        uint64_t d0, d1, d2, d3, d4;
+        uint32_t c;
+
+        /* h += m */
+        h0 += (_le32(&m[0])) & MASK26;
+        h1 += (_le32(&m[3]) >> 2) & MASK26;
+        h2 += (_le32(&m[6]) >> 4) & MASK26;
+        h3 += (_le32(&m[9]) >> 6) & MASK26;
+        h4 += (_le32(&m[12]) >> 8) | hibit;
+
+        /* h *= r */
+        d0 = ((uint64_t)h0 * r0) + ((uint64_t)h1 * s4) + ((uint64_t)h2 * s3) +
+             ((uint64_t)h3 * s2) + ((uint64_t)h4 * s1);
+        d1 = ((uint64_t)h0 * r1) + ((uint64_t)h1 * r0) + ((uint64_t)h2 * s4) +
+             ((uint64_t)h3 * s3) + ((uint64_t)h4 * s2);
+        d2 = ((uint64_t)h0 * r2) + ((uint64_t)h1 * r1) + ((uint64_t)h2 * r0) +
+             ((uint64_t)h3 * s4) + ((uint64_t)h4 * s3);
+        d3 = ((uint64_t)h0 * r3) + ((uint64_t)h1 * r2) + ((uint64_t)h2 * r1) +
+             ((uint64_t)h3 * r0) + ((uint64_t)h4 * s4);
+        d4 = ((uint64_t)h0 * r4) + ((uint64_t)h1 * r3) + ((uint64_t)h2 * r2) +
+             ((uint64_t)h3 * r1) + ((uint64_t)h4 * r0);
+
+        /* partial reduction mod 2^130 - 5 */
+        c = (uint32_t)(d0 >> 26);
+        h0 = (uint32_t)d0 & MASK26;
+        d1 += c;
+        c = (uint32_t)(d1 >> 26);
+        h1 = (uint32_t)d1 & MASK26;
+        d2 += c;
+        c = (uint32_t)(d2 >> 26);
+        h2 = (uint32_t)d2 & MASK26;
+        d3 += c;
+        c = (uint32_t)(d3 >> 26);
+        h3 = (uint32_t)d3 & MASK26;
+        d4 += c;
+        c = (uint32_t)(d4 >> 26);
+        h4 = (uint32_t)d4 & MASK26;
+        h0 += c * 5;
+        c = h0 >> 26;
+        h0 &= MASK26;
+        h1 += c;
+
+        m += 16;
+        len -= 16;
+    }
+
+    ctx->h[0] = h0;
+    ctx->h[1] = h1;
+    ctx->h[2] = h2;
+    ctx->h[3] = h3;
+    ctx->h[4] = h4;
+}
+
+void poly1305_update(poly1305_ctx_t *ctx, const void *data, size_t len)
+{
+    const uint8_t *m = data;
+
+    if (ctx->buf_len) {
+        size_t n = sizeof(ctx->buf) - ctx->buf_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&ctx->buf[ctx->buf_len], m, n);
+        ctx->buf_len += n;
+        m += n;
+        len -= n;
+        if (ctx->buf_len < sizeof(ctx->buf)) {
+            return;
+        }
+        _blocks(ctx, ctx->buf, sizeof(ctx->buf), 1UL << 24);
+        ctx->buf_len = 0;
+    }
+
+    _blocks(ctx, m, len & ~(size_t)15, 1UL << 24);
+    m += len & ~(size_t)15;
+    len &= 15;
+
+    memcpy(ctx->buf, m, len);
+    ctx->buf_len = len;
+}
+
+void poly1305_finish(poly1305_ctx_t *ctx, uint8_t *tag)
+{
+    uint32_t h0, h1, h2, h3, h4, c;
+    uint32_t g0, g1, g2, g3, g4, mask;
+    uint64_t f;
+
+    if (ctx->buf_len) {
+        /* the last block is terminated by a 1 byte instead of 2^128 */
+        ctx->buf[ctx->buf_len] = 1;
+        memset(&ctx->buf[ctx->buf_len + 1], 0,
+               sizeof(ctx->buf) - ctx->buf_len - 1);
+        _blocks(ctx, ctx->buf, sizeof(ctx->buf), 0);
+    }
+
+    /* fully carry h */
+    h0 = ctx->h[0];
+    h1 = ctx->h[1];
+    h2 = ctx->h[2];
+    h3 = ctx->h[3];
+    h4 = ctx->h[4];
+    c = h1 >> 26;
+    h1 &= MASK26;
+    h2 += c;
+    c = h2 >> 26;
+    h2 &= MASK26;
+    h3 += c;
+    c = h3 >> 26;
+    h3 &= MASK26;
+    h4 += c;
+    c = h4 >> 26;
+    h4 &= MASK26;
+    h0 += c * 5;
+    c = h0 >> 26;
+    h0 &= MASK26;
+    h1 += c;
+
+    /* g = h + -p, select g if h >= p without branching */
+    g0 = h0 + 5;
+    c = g0 >> 26;
+    g0 &= MASK26;
+    g1 = h1 + c;
+    c = g1 >> 26;
+    g1 &= MASK26;
+    g2 = h2 + c;
+    c = g2 >> 26;
+    g2 &= MASK26;
+    g3 = h3 + c;
+    c = g3 >> 26;
+    g3 &= MASK26;
+    g4 = h4 + c - (1UL << 26);
+
+    mask = (g4 >> 31) - 1;
+    g0 &= mask;
+    g1 &= mask;
+    g2 &= mask;
+    g3 &= mask;
+    g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    /* h = h % 2^128 in 32 bit words */
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    /* tag = (h + pad) % 2^128 */
+    f = (uint64_t)h0 + ctx->pad[0];
+    _put_le32(&tag[0], (uint32_t)f);
+    f = (uint64_t)h1 + ctx->pad[1] + (f >> 32);
+    _put_le32(&tag[4], (uint32_t)f);
+    f = (uint64_t)h2 + ctx->pad[2] + (f >> 32);
+    _put_le32(&tag[8], (uint32_t)f);
+    f = (uint64_t)h3 + ctx->pad[3] + (f >> 32);
+    _put_le32(&tag[12], (uint32_t)f);
+
+    memset(ctx, 0, sizeof(*ctx));
+}
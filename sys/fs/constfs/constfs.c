@@ -46,6 +46,7 @@ static off_t constfs_lseek(vfs_file_t *filp, off_t off, int whence);
 static int constfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mode, const char *abs_path);
 static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes);
 static ssize_t constfs_write(vfs_file_t *filp, const void *src, size_t nbytes);
+static ssize_t constfs_map(vfs_file_t *filp, const void **data, size_t nbytes);
 
 /* Directory operations */
 static int constfs_opendir(vfs_DIR *dirp, const char *dirname, const char *abs_path);
@@ -67,6 +68,7 @@ static const vfs_file_ops_t constfs_file_ops = {
     .open  = constfs_open,
     .read  = constfs_read,
     .write = constfs_write,
+    .map   = constfs_map,
 };
 
 static const vfs_dir_ops_t constfs_dir_ops = {
@@ -246,6 +248,22 @@ static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes)
     return nbytes;
 }
 
+static ssize_t constfs_map(vfs_file_t *filp, const void **data, size_t nbytes)
+{
+    constfs_file_t *fp = filp->private_data.ptr;
+    DEBUG("constfs_map: %p, %lu\n", (void *)filp, (unsigned long)nbytes);
+    if ((size_t)filp->pos >= fp->size) {
+        /* Current offset is at or beyond end of file */
+        return 0;
+    }
+
+    if (nbytes > (fp->size - filp->pos)) {
+        nbytes = fp->size - filp->pos;
+    }
+    *data = fp->data + filp->pos;
+    return nbytes;
+}
+
 static ssize_t constfs_write(vfs_file_t *filp, const void *src, size_t nbytes)
 {
     DEBUG("constfs_write: %p, %p, %lu\n", (void *)filp, src, (unsigned long)nbytes);
@@ -50,76 +50,108 @@ static uint32_t sha1_rol32(uint32_t number, uint8_t bits)
     return ((number << bits) | (number >> (32 - bits)));
 }
 
-static void sha1_hash_block(sha1_context *s)
+static inline uint32_t sha1_load_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | p[3];
+}
+
+/* the message schedule is expanded in place in w */
+#define SHA1_W(i) (w[(i) & 15] = sha1_rol32(w[((i) + 13) & 15] ^ \
+                                            w[((i) + 8) & 15] ^   \
+                                            w[((i) + 2) & 15] ^   \
+                                            w[(i) & 15], 1))
+
+#define SHA1_ROUND(f, k, wi) do {                          \
+        t = sha1_rol32(a, 5) + (f) + e + (k) + (wi);       \
+        e = d;                                             \
+        d = c;                                             \
+        c = sha1_rol32(b, 30);                             \
+        b = a;                                             \
+        a = t;                                             \
+} while (0)
+
+static void sha1_hash_block(uint32_t *state, const uint8_t *block)
 {
     uint8_t i;
     uint32_t a, b, c, d, e, t;
+    uint32_t w[16];
 
-    a = s->state[0];
-    b = s->state[1];
-    c = s->state[2];
-    d = s->state[3];
-    e = s->state[4];
-    for (i = 0; i < 80; i++) {
-        if (i >= 16) {
-            t = s->buffer[(i + 13) & 15] ^ s->buffer[(i + 8) & 15] ^
-                s->buffer[(i + 2) & 15] ^ s->buffer[i & 15];
-            s->buffer[i & 15] = sha1_rol32(t, 1);
-        }
-        if (i < 20) {
-            t = (d ^ (b & (c ^ d))) + SHA1_K0;
-        }
-        else if (i < 40) {
-            t = (b ^ c ^ d) + SHA1_K20;
-        }
-        else if (i < 60) {
-            t = ((b & c) | (d & (b | c))) + SHA1_K40;
-        }
-        else {
-            t = (b ^ c ^ d) + SHA1_K60;
-        }
-        t += sha1_rol32(a, 5) + e + s->buffer[i & 15];
-        e = d;
-        d = c;
-        c = sha1_rol32(b, 30);
-        b = a;
-        a = t;
+    for (i = 0; i < 16; i++) {
+        w[i] = sha1_load_be32(&block[4 * i]);
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    for (i = 0; i < 16; i++) {
+        SHA1_ROUND(d ^ (b & (c ^ d)), SHA1_K0, w[i]);
     }
-    s->state[0] += a;
-    s->state[1] += b;
-    s->state[2] += c;
-    s->state[3] += d;
-    s->state[4] += e;
+    for (; i < 20; i++) {
+        SHA1_ROUND(d ^ (b & (c ^ d)), SHA1_K0, SHA1_W(i));
+    }
+    for (; i < 40; i++) {
+        SHA1_ROUND(b ^ c ^ d, SHA1_K20, SHA1_W(i));
+    }
+    for (; i < 60; i++) {
+        SHA1_ROUND((b & c) | (d & (b | c)), SHA1_K40, SHA1_W(i));
+    }
+    for (; i < 80; i++) {
+        SHA1_ROUND(b ^ c ^ d, SHA1_K60, SHA1_W(i));
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
 }
 
 static void sha1_add_uncounted(sha1_context *s, uint8_t data)
 {
     uint8_t *const b = (uint8_t *) s->buffer;
 
-#ifdef __BIG_ENDIAN__
-    b[s->buffer_offset] = data;
-#else
-    b[s->buffer_offset ^ 3] = data;
-#endif
-    s->buffer_offset++;
+    b[s->buffer_offset++] = data;
     if (s->buffer_offset == SHA1_BLOCK_LENGTH) {
-        sha1_hash_block(s);
+        sha1_hash_block(s->state, b);
         s->buffer_offset = 0;
     }
 }
 
-static void sha1_update_byte(sha1_context *ctx, uint8_t data)
-{
-    ++ctx->byte_count;
-    sha1_add_uncounted(ctx, data);
-}
-
 void sha1_update(sha1_context *ctx, const void *data, size_t len)
 {
+    uint8_t *const b = (uint8_t *) ctx->buffer;
     const uint8_t *d = data;
-    while (len--) {
-        sha1_update_byte(ctx, *(d++));
+
+    ctx->byte_count += len;
+
+    /* complete a block left over from the previous call */
+    if (ctx->buffer_offset) {
+        size_t n = SHA1_BLOCK_LENGTH - ctx->buffer_offset;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&b[ctx->buffer_offset], d, n);
+        ctx->buffer_offset += n;
+        d += n;
+        len -= n;
+        if (ctx->buffer_offset < SHA1_BLOCK_LENGTH) {
+            return;
+        }
+        sha1_hash_block(ctx->state, b);
+        ctx->buffer_offset = 0;
+    }
+
+    /* hash full blocks straight from the input */
+    while (len >= SHA1_BLOCK_LENGTH) {
+        sha1_hash_block(ctx->state, d);
+        d += SHA1_BLOCK_LENGTH;
+        len -= SHA1_BLOCK_LENGTH;
     }
+
+    memcpy(b, d, len);
+    ctx->buffer_offset = len;
 }
 
 static void sha1_pad(sha1_context *s)
@@ -173,18 +205,25 @@ void sha1(void *digest, const void *data, size_t len)
 #define HMAC_IPAD 0x36
 #define HMAC_OPAD 0x5c
 
-void sha1_init_hmac(sha1_context *ctx, const void *key, size_t key_length)
+/* hash the key XORed with pad as the first block of a new hash */
+static void sha1_start_hmac(sha1_context *ctx, uint8_t pad)
 {
-    uint8_t i;
-    const uint8_t *k = key;
+    uint8_t block[SHA1_BLOCK_LENGTH];
+
+    for (uint8_t i = 0; i < SHA1_BLOCK_LENGTH; i++) {
+        block[i] = ctx->key_buffer[i] ^ pad;
+    }
+    sha1_init(ctx);
+    sha1_update(ctx, block, SHA1_BLOCK_LENGTH);
+}
 
+void sha1_init_hmac(sha1_context *ctx, const void *key, size_t key_length)
+{
     memset(ctx->key_buffer, 0, SHA1_BLOCK_LENGTH);
     if (key_length > SHA1_BLOCK_LENGTH) {
         /* Hash long keys */
         sha1_init(ctx);
-        while (key_length--) {
-            sha1_update_byte(ctx, *k++);
-        }
+        sha1_update(ctx, key, key_length);
         sha1_final(ctx, ctx->key_buffer);
     }
     else {
@@ -192,26 +231,16 @@ void sha1_init_hmac(sha1_context *ctx, const void *key, size_t key_length)
         memcpy(ctx->key_buffer, key, key_length);
     }
     /* Start inner hash */
-    sha1_init(ctx);
-    for (i = 0; i < SHA1_BLOCK_LENGTH; i++) {
-        sha1_update_byte(ctx, ctx->key_buffer[i] ^ HMAC_IPAD);
-    }
+    sha1_start_hmac(ctx, HMAC_IPAD);
 }
 
 void sha1_final_hmac(sha1_context *ctx, void *digest)
 {
-    uint8_t i;
-
     /* Complete inner hash */
     sha1_final(ctx, ctx->inner_hash);
     /* Calculate outer hash */
-    sha1_init(ctx);
-    for (i = 0; i < SHA1_BLOCK_LENGTH; i++) {
-        sha1_update_byte(ctx, ctx->key_buffer[i] ^ HMAC_OPAD);
-    }
-    for (i = 0; i < SHA1_DIGEST_LENGTH; i++) {
-        sha1_update_byte(ctx, ctx->inner_hash[i]);
-    }
+    sha1_start_hmac(ctx, HMAC_OPAD);
+    sha1_update(ctx, ctx->inner_hash, SHA1_DIGEST_LENGTH);
 
     sha1_final(ctx, digest);
 }
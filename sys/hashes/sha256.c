@@ -49,6 +49,7 @@
 #include <assert.h>
 
 #include "hashes/sha256.h"
+#include "sha256_ni.h"
 
 #ifdef __BIG_ENDIAN__
 /* Copy a vector of big-endian uint32_t into a vector of bytes */
@@ -160,6 +161,27 @@ static void sha256_transform(uint32_t *state, const unsigned char block[64])
     }
 }
 
+/* Hash nblocks consecutive blocks, using the SHA extensions if available */
+static void sha256_transform_blocks(uint32_t *state, const unsigned char *data,
+                                    size_t nblocks)
+{
+#ifdef SHA256_BACKEND_NI
+    static int8_t have_ni = -1;
+
+    if (have_ni < 0) {
+        have_ni = sha256_ni_supported();
+    }
+    if (have_ni) {
+        sha256_ni_transform(state, data, nblocks);
+        return;
+    }
+#endif
+    while (nblocks--) {
+        sha256_transform(state, data);
+        data += 64;
+    }
+}
+
 static unsigned char PAD[64] = {
     0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -231,16 +253,14 @@ void sha256_update(sha256_context_t *ctx, const void *data, size_t len)
     const unsigned char *src = data;
 
     memcpy(&ctx->buf[r], src, 64 - r);
-    sha256_transform(ctx->state, ctx->buf);
+    sha256_transform_blocks(ctx->state, ctx->buf, 1);
     src += 64 - r;
     len -= 64 - r;
 
     /* Perform complete blocks */
-    while (len >= 64) {
-        sha256_transform(ctx->state, src);
-        src += 64;
-        len -= 64;
-    }
+    sha256_transform_blocks(ctx->state, src, len / 64);
+    src += len & ~(size_t)0x3f;
+    len &= 0x3f;
 
     /* Copy left over data into buffer */
     memcpy(ctx->buf, src, len);
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_hashes
+ * @{
+ *
+ * @file
+ * @brief       SHA-256 block function using the x86 SHA extensions
+ *
+ * The state is kept in two registers as ABEF and CDGH, the layout
+ * SHA256RNDS2 expects. Each SHA256RNDS2 performs two rounds, the message
+ * schedule is computed four words at a time with SHA256MSG1/SHA256MSG2.
+ *
+ * @}
+ */
+
+#include <stdint.h>
+
+#include "sha256_ni.h"
+
+#ifdef SHA256_BACKEND_NI
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define SHA256_NI_TARGET    __attribute__((target("sha,sse4.1,ssse3")))
+
+static const uint32_t K[64] __attribute__((aligned(16))) = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+int sha256_ni_supported(void)
+{
+    unsigned eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+        !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) {
+        return 0;
+    }
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return 0;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 29)) ? 1 : 0;
+}
+
+SHA256_NI_TARGET void sha256_ni_transform(uint32_t *state,
+                                          const unsigned char *data,
+                                          size_t nblocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL);
+    __m128i abef, cdgh, tmp;
+
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xb1);
+    cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1b);
+    abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    while (nblocks--) {
+        __m128i abef_save = abef, cdgh_save = cdgh;
+        __m128i w[4];
+
+        for (unsigned i = 0; i < 16; i++) {
+            __m128i msg;
+
+            if (i < 4) {
+                w[i] = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)&data[16 * i]), bswap);
+            }
+            else {
+                /* W[t] = s1(W[t-2]) + W[t-7] + s0(W[t-15]) + W[t-16] */
+                tmp = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+                tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(w[(i + 3) & 3],
+                                                         w[(i + 2) & 3], 4));
+                w[i & 3] = _mm_sha256msg2_epu32(tmp, w[(i + 3) & 3]);
+            }
+
+            msg = _mm_add_epi32(w[i & 3],
+                                _mm_load_si128((const __m128i *)&K[4 * i]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0e);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, msg);
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+        data += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+#endif /* SHA256_BACKEND_NI */
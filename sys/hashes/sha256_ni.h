@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_hashes
+ * @{
+ *
+ * @file
+ * @brief       SHA-256 block function using the x86 SHA extensions
+ *
+ * @}
+ */
+
+#ifndef SHA256_NI_H
+#define SHA256_NI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Defined if the SHA-NI block function is built in
+ */
+#if defined(MODULE_HASHES_SHA256_NI) && (defined(__i386__) || defined(__x86_64__))
+#define SHA256_BACKEND_NI
+#endif
+
+#ifdef SHA256_BACKEND_NI
+/**
+ * @brief   Check if the host CPU has the SHA extensions
+ *
+ * @return  1 if sha256_ni_transform() can be used, 0 otherwise
+ */
+int sha256_ni_supported(void);
+
+/**
+ * @brief   Hash @p nblocks consecutive 64 byte blocks into @p state
+ *
+ * @param[in,out] state     SHA-256 state (8 words)
+ * @param[in] data          input blocks
+ * @param[in] nblocks       number of blocks
+ */
+void sha256_ni_transform(uint32_t *state, const unsigned char *data,
+                         size_t nblocks);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHA256_NI_H */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_hashes_siphash
+ * @{
+ *
+ * @file
+ * @brief       SipHash-2-4 implementation
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "hashes/siphash.h"
+
+static inline uint64_t _rotl64(uint64_t x, unsigned r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t _read64(const uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+#define SIPROUND \
+    do { \
+        v0 += v1; v1 = _rotl64(v1, 13); v1 ^= v0; v0 = _rotl64(v0, 32); \
+        v2 += v3; v3 = _rotl64(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = _rotl64(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = _rotl64(v1, 17); v1 ^= v2; v2 = _rotl64(v2, 32); \
+    } while (0)
+
+uint64_t siphash24(const void *key, const void *buf, size_t len)
+{
+    const uint8_t *k = key;
+    const uint8_t *p = buf;
+    const uint8_t *end = p + (len & ~(size_t)7);
+    uint64_t k0 = _read64(k);
+    uint64_t k1 = _read64(k + 8);
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+    uint64_t m;
+
+    for (; p < end; p += 8) {
+        m = _read64(p);
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    /* last block: remaining bytes and the length in the top byte */
+    m = (uint64_t)len << 56;
+    for (unsigned i = 0; i < (len & 7); i++) {
+        m |= (uint64_t)p[i] << (8 * i);
+    }
+    v3 ^= m;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= m;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    return v0 ^ v1 ^ v2 ^ v3;
+}
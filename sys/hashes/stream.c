@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_hashes_stream
+ * @{
+ *
+ * @file
+ * @brief       Streaming input for hashes
+ *
+ * @}
+ */
+
+#include "hashes/stream.h"
+#include "net/gnrc/pkt.h"
+
+#ifdef MODULE_VFS
+#include <fcntl.h>
+
+#include "vfs.h"
+#endif
+
+size_t hashes_update_pkt(hashes_update_t update, void *ctx,
+                         const struct gnrc_pktsnip *pkt)
+{
+    size_t len = 0;
+
+    for (; pkt != NULL; pkt = pkt->next) {
+        update(ctx, pkt->data, pkt->size);
+        len += pkt->size;
+    }
+    return len;
+}
+
+#ifdef MODULE_VFS
+ssize_t hashes_update_fd(hashes_update_t update, void *ctx, int fd,
+                         void *buf, size_t chunk)
+{
+    ssize_t len = 0;
+
+    while (1) {
+        ssize_t res = vfs_read(fd, buf, chunk);
+        if (res < 0) {
+            return res;
+        }
+        if (res == 0) {
+            return len;
+        }
+        update(ctx, buf, res);
+        len += res;
+    }
+}
+
+ssize_t hashes_update_file(hashes_update_t update, void *ctx,
+                           const char *path, void *buf, size_t chunk)
+{
+    int fd = vfs_open(path, O_RDONLY, 0);
+
+    if (fd < 0) {
+        return fd;
+    }
+    ssize_t res = hashes_update_fd(update, ctx, fd, buf, chunk);
+    vfs_close(fd);
+    return res;
+}
+#endif /* MODULE_VFS */
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_hashes_xxhash
+ * @{
+ *
+ * @file
+ * @brief       xxHash implementation
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "hashes/xxhash.h"
+
+#define PRIME32_1   (0x9E3779B1U)
+#define PRIME32_2   (0x85EBCA77U)
+#define PRIME32_3   (0xC2B2AE3DU)
+#define PRIME32_4   (0x27D4EB2FU)
+#define PRIME32_5   (0x165667B1U)
+
+#define PRIME64_1   (0x9E3779B185EBCA87ULL)
+#define PRIME64_2   (0xC2B2AE3D27D4EB4FULL)
+#define PRIME64_3   (0x165667B19E3779F9ULL)
+#define PRIME64_4   (0x85EBCA77C2B2AE63ULL)
+#define PRIME64_5   (0x27D4EB2F165667C5ULL)
+
+static inline uint32_t _rotl32(uint32_t x, unsigned r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint64_t _rotl64(uint64_t x, unsigned r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+/* memcpy() compiles to a single load where unaligned access is allowed */
+static inline uint32_t _read32(const uint8_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+static inline uint64_t _read64(const uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint32_t _round32(uint32_t acc, uint32_t input)
+{
+    acc += input * PRIME32_2;
+    acc = _rotl32(acc, 13);
+    return acc * PRIME32_1;
+}
+
+static inline uint64_t _round64(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME64_2;
+    acc = _rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t _merge64(uint64_t acc, uint64_t val)
+{
+    acc ^= _round64(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint32_t xxh32(const void *buf, size_t len, uint32_t seed)
+{
+    const uint8_t *p = buf;
+    const uint8_t *end = p + len;
+    uint32_t h;
+
+    if (len >= 16) {
+        uint32_t v1 = seed + PRIME32_1 + PRIME32_2;
+        uint32_t v2 = seed + PRIME32_2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - PRIME32_1;
+
+        do {
+            v1 = _round32(v1, _read32(p));
+            v2 = _round32(v2, _read32(p + 4));
+            v3 = _round32(v3, _read32(p + 8));
+            v4 = _round32(v4, _read32(p + 12));
+            p += 16;
+        } while (p <= end - 16);
+
+        h = _rotl32(v1, 1) + _rotl32(v2, 7) + _rotl32(v3, 12) +
+            _rotl32(v4, 18);
+    }
+    else {
+        h = seed + PRIME32_5;
+    }
+
+    h += (uint32_t)len;
+
+    for (; p + 4 <= end; p += 4) {
+        h += _read32(p) * PRIME32_3;
+        h = _rotl32(h, 17) * PRIME32_4;
+    }
+    for (; p < end; p++) {
+        h += *p * PRIME32_5;
+        h = _rotl32(h, 11) * PRIME32_1;
+    }
+
+    h ^= h >> 15;
+    h *= PRIME32_2;
+    h ^= h >> 13;
+    h *= PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+uint64_t xxh64(const void *buf, size_t len, uint64_t seed)
+{
+    const uint8_t *p = buf;
+    const uint8_t *end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+
+        do {
+            v1 = _round64(v1, _read64(p));
+            v2 = _round64(v2, _read64(p + 8));
+            v3 = _round64(v3, _read64(p + 16));
+            v4 = _round64(v4, _read64(p + 24));
+            p += 32;
+        } while (p <= end - 32);
+
+        h = _rotl64(v1, 1) + _rotl64(v2, 7) + _rotl64(v3, 12) +
+            _rotl64(v4, 18);
+        h = _merge64(h, v1);
+        h = _merge64(h, v2);
+        h = _merge64(h, v3);
+        h = _merge64(h, v4);
+    }
+    else {
+        h = seed + PRIME64_5;
+    }
+
+    h += (uint64_t)len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= _round64(0, _read64(p));
+        h = _rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= (uint64_t)_read32(p) * PRIME64_1;
+        h = _rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= *p * PRIME64_5;
+        h = _rotl64(h, 11) * PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t xxh64_hash64(const void *seed, const void *buf, size_t len)
+{
+    uint64_t s = 0;
+
+    if (seed != NULL) {
+        memcpy(&s, seed, sizeof(s));
+    }
+    return xxh64(buf, len, s);
+}
@@ -127,6 +127,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "hashes.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -148,6 +150,10 @@ typedef struct {
     uint8_t *a;
     /** the hash functions */
     hashfp_t *hash;
+    /** single 64 bit hash the k positions are derived from, or NULL */
+    hash64fp_t hash64;
+    /** seed or key passed to hash64 */
+    const void *key;
 } bloom_t;
 
 /**
@@ -165,6 +171,26 @@ typedef struct {
  */
 void bloom_init(bloom_t *bloom, size_t size, uint8_t *bitfield, hashfp_t *hashes, int hashes_numof);
 
+/**
+ * @brief Initialize a Bloom filter using one 64 bit hash function.
+ *
+ * Instead of running @p k hash functions over the input, the input is
+ * hashed once and the k bit positions are derived from the two halves of
+ * the result (h1 + i * h2, Kirsch and Mitzenmacher, with the sum mixed
+ * again), which leaves the false positive rate unchanged. Use siphash24()
+ * with a random key if an attacker can choose the strings added or checked.
+ *
+ * @param bloom             bloom_t to initialize
+ * @param size              size of the bloom filter in bits
+ * @param bitfield          underlying bitfield of the bloom filter
+ * @param hash              64 bit hash function, e.g. xxh64_hash64()
+ * @param key               seed or key passed to @p hash
+ * @param k                 number of bits set per string
+ * @pre     @p bitfield MUST be large enough to hold @p size bits.
+ */
+void bloom_init_hash64(bloom_t *bloom, size_t size, uint8_t *bitfield,
+                       hash64fp_t hash, const void *key, int k);
+
 /**
  * @brief Delete a Bloom filter.
  *
@@ -228,6 +254,182 @@ void bloom_add(bloom_t *bloom, const uint8_t *buf, size_t len);
  */
 bool bloom_check(bloom_t *bloom, const uint8_t *buf, size_t len);
 
+/**
+ * @name    Blocked Bloom filter
+ *
+ * A Bloom filter that sets all k bits of a string within one block of
+ * BLOOM_BLOCK_SIZE bytes, which is chosen by the hash. A query then touches
+ * one cache line instead of k, and the string is hashed only once. For the
+ * same size the false positive rate is slightly higher than that of
+ * bloom_t, e.g. about 1.0 % instead of 0.8 % at 10 bits per string and
+ * k = 6.
+ *
+ * Declare the storage with bloom_block_t, which is aligned to its size:
+ *
+ * @code
+ * static bloom_block_t blocks[16];
+ * static bloom_blocked_t filter;
+ *
+ * bloom_blocked_init(&filter, blocks, 16, siphash24, key, 6);
+ * @endcode
+ * @{
+ */
+
+/**
+ * @brief   Size of a block in bytes, the cache line size of most CPUs
+ */
+#define BLOOM_BLOCK_SIZE    (64U)
+
+/**
+ * @brief   One block of a bloom_blocked_t or bloom_counting_t
+ */
+typedef struct {
+    /** bits, or 4 bit counters */
+    uint32_t word[BLOOM_BLOCK_SIZE / sizeof(uint32_t)];
+} __attribute__((aligned(BLOOM_BLOCK_SIZE))) bloom_block_t;
+
+/**
+ * @brief   Blocked Bloom filter
+ */
+typedef struct {
+    bloom_block_t *blocks;  /**< storage */
+    size_t nblocks;         /**< number of blocks */
+    hash64fp_t hash;        /**< hash function */
+    const void *key;        /**< seed or key passed to hash */
+    unsigned k;             /**< number of bits set per string */
+} bloom_blocked_t;
+
+/**
+ * @brief   Initialize and clear a blocked Bloom filter
+ *
+ * @param[out] bloom    filter to initialize
+ * @param[in] blocks    storage, cleared by this function
+ * @param[in] nblocks   number of blocks in @p blocks
+ * @param[in] hash      64 bit hash function, e.g. siphash24()
+ * @param[in] key       seed or key passed to @p hash
+ * @param[in] k         number of bits set per string
+ */
+void bloom_blocked_init(bloom_blocked_t *bloom, bloom_block_t *blocks,
+                        size_t nblocks, hash64fp_t hash, const void *key,
+                        unsigned k);
+
+/**
+ * @brief   Remove all strings from a blocked Bloom filter
+ *
+ * @param[in,out] bloom filter
+ */
+void bloom_blocked_clear(bloom_blocked_t *bloom);
+
+/**
+ * @brief   Add a string to a blocked Bloom filter
+ *
+ * @param[in,out] bloom filter
+ * @param[in] buf       string to add
+ * @param[in] len       length of @p buf
+ */
+void bloom_blocked_add(bloom_blocked_t *bloom, const uint8_t *buf,
+                       size_t len);
+
+/**
+ * @brief   Check if a string may be in a blocked Bloom filter
+ *
+ * @param[in] bloom     filter
+ * @param[in] buf       string to check
+ * @param[in] len       length of @p buf
+ *
+ * @return  false if the string is not in the filter
+ * @return  true if the string may be in the filter
+ */
+bool bloom_blocked_check(const bloom_blocked_t *bloom, const uint8_t *buf,
+                         size_t len);
+
+/**
+ * @brief   Add a string and tell if it may have been in the filter before
+ *
+ * Hashes the string once, e.g. to suppress duplicate packets.
+ *
+ * @param[in,out] bloom filter
+ * @param[in] buf       string to add
+ * @param[in] len       length of @p buf
+ *
+ * @return  false if the string was not in the filter
+ * @return  true if the string may have been in the filter
+ */
+bool bloom_blocked_check_add(bloom_blocked_t *bloom, const uint8_t *buf,
+                             size_t len);
+/** @} */
+
+/**
+ * @name    Counting Bloom filter
+ *
+ * A blocked Bloom filter with a 4 bit counter instead of a bit, so strings
+ * can be removed again. A block holds BLOOM_BLOCK_SIZE * 2 counters, so it
+ * needs four times the memory of a bloom_blocked_t with the same number of
+ * cells, and still has a somewhat higher false positive rate (1.3 % instead
+ * of 1.0 % in the example above). A counter that reached 15 stays there, so
+ * that removing strings never causes false negatives.
+ * @{
+ */
+
+/**
+ * @brief   Counting Bloom filter
+ */
+typedef bloom_blocked_t bloom_counting_t;
+
+/**
+ * @brief   Initialize and clear a counting Bloom filter
+ *
+ * @param[out] bloom    filter to initialize
+ * @param[in] blocks    storage, cleared by this function
+ * @param[in] nblocks   number of blocks in @p blocks
+ * @param[in] hash      64 bit hash function, e.g. siphash24()
+ * @param[in] key       seed or key passed to @p hash
+ * @param[in] k         number of counters incremented per string
+ */
+void bloom_counting_init(bloom_counting_t *bloom, bloom_block_t *blocks,
+                         size_t nblocks, hash64fp_t hash, const void *key,
+                         unsigned k);
+
+/**
+ * @brief   Add a string to a counting Bloom filter
+ *
+ * @param[in,out] bloom filter
+ * @param[in] buf       string to add
+ * @param[in] len       length of @p buf
+ */
+void bloom_counting_add(bloom_counting_t *bloom, const uint8_t *buf,
+                        size_t len);
+
+/**
+ * @brief   Check if a string may be in a counting Bloom filter
+ *
+ * @param[in] bloom     filter
+ * @param[in] buf       string to check
+ * @param[in] len       length of @p buf
+ *
+ * @return  false if the string is not in the filter
+ * @return  true if the string may be in the filter
+ */
+bool bloom_counting_check(const bloom_counting_t *bloom, const uint8_t *buf,
+                          size_t len);
+
+/**
+ * @brief   Remove a string from a counting Bloom filter
+ *
+ * Only remove strings that were added before. Removing any other string
+ * that happens to be a false positive causes false negatives later.
+ *
+ * @param[in,out] bloom filter
+ * @param[in] buf       string to remove
+ * @param[in] len       length of @p buf
+ *
+ * @return  true if the string was removed
+ * @return  false if the string was not in the filter (nothing changed)
+ */
+bool bloom_counting_remove(bloom_counting_t *bloom, const uint8_t *buf,
+                           size_t len);
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
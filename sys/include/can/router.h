@@ -29,6 +29,36 @@ extern "C" {
 #include "can/can.h"
 #include "can/pkt.h"
 
+/**
+ * @brief   Maximum number of filters registered at the same time, for all
+ *          interfaces
+ */
+#ifndef CAN_ROUTER_FILTER_NUMOF
+#define CAN_ROUTER_FILTER_NUMOF (16U)
+#endif
+
+/**
+ * @brief   Number of hash buckets per interface for filters with an ID mask
+ *
+ * Filters whose mask covers the whole standard ID (@ref CAN_SFF_MASK, so also
+ * @ref CAN_EFF_MASK and a full mask) are looked up by the CAN ID of the
+ * received frame, all other filters are compared with every frame.
+ */
+#ifndef CAN_ROUTER_HASH_SIZE
+#define CAN_ROUTER_HASH_SIZE (8U)
+#endif
+
+/**
+ * @brief   Maximum number of received frames delivered to subscribers and not
+ *          freed yet, for all interfaces
+ *
+ * Each subscriber gets a @ref can_rx_data_t pointing to the frame of the
+ * packet shared by all subscribers.
+ */
+#ifndef CAN_ROUTER_RX_DATA_NUMOF
+#define CAN_ROUTER_RX_DATA_NUMOF (2 * CAN_ROUTER_FILTER_NUMOF)
+#endif
+
 /**
  * @brief Register a user @p entry to receive a frame @p can_id
  *
@@ -72,12 +102,27 @@ int can_router_unregister(can_reg_entry_t *entry, canid_t can_id, canid_t mask,
  */
 int can_router_free_frame(struct can_frame *frame);
 
+/**
+ * @brief Free rx data received from the router
+ *
+ * This function frees the frame of @p data with can_router_free_frame() and
+ * releases @p data itself.
+ *
+ * @param[in] data     the rx data to free, it must be received in a
+ *                     @ref CAN_MSG_RX_INDICATION from the router
+ *
+ * @return 0 on success
+ * @return < 0 on error
+ */
+int can_router_free_rx_data(can_rx_data_t *data);
+
 /**
  * @brief Dispatch a RX indication to subscribers threads
  *
- * This function goes through the list of subscribed filters to send a message to each
- * subscriber's thread. If all the subscriber's threads cannot receive message,
- * the packet is freed.
+ * This function looks up the filters matching the packet to send a message to each
+ * subscriber's thread. All subscribers share the packet, which is freed once the
+ * last one released it with can_router_free_rx_data(). If no subscriber's thread
+ * can receive the message, the packet is freed.
  *
  * @param[in] pkt   the packet to dispatch
  *
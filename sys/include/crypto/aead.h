@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Authenticated encryption with associated data (AEAD)
+ *
+ * One interface for ChaCha20-Poly1305 (RFC 8439) and AES-128-CCM
+ * (RFC 3610). Both encrypt and authenticate in a single pass. The
+ * associated data and the message can be passed in pieces of any size,
+ * e.g. the snips of a packet, and the message can be processed in place:
+ *
+ * @code
+ * aead_t aead;
+ *
+ * aead_init(&aead, AEAD_CHACHA20_POLY1305, key, 32);
+ * aead_start(&aead, AEAD_ENCRYPT, nonce, 12, ad_len, msg_len, 16);
+ * aead_update_ad(&aead, hdr, ad_len);
+ * aead_update_pkt(&aead, pkt->next);
+ * aead_finish(&aead, tag);
+ * @endcode
+ *
+ * A key can be used for many messages after one call to aead_init(), but
+ * every message needs its own nonce.
+ *
+ * @warning When decrypting, the plaintext is written before the tag is
+ *          checked. It must be discarded if aead_finish() fails.
+ */
+
+#ifndef CRYPTO_AEAD_H
+#define CRYPTO_AEAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto/chacha.h"
+#include "crypto/ciphers.h"
+#include "crypto/poly1305.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct gnrc_pktsnip;
+
+/**
+ * @name    Return codes
+ * @{
+ */
+#define AEAD_OK                     (0)
+#define AEAD_ERR_INVALID_KEY_SIZE   (-1)    /**< key size not supported */
+#define AEAD_ERR_INVALID_NONCE      (-2)    /**< nonce length not supported */
+#define AEAD_ERR_INVALID_TAG_SIZE   (-3)    /**< tag length not supported */
+#define AEAD_ERR_INVALID_LENGTH     (-4)    /**< data length does not match */
+#define AEAD_ERR_CIPHER             (-5)    /**< underlying cipher failed */
+#define AEAD_ERR_AUTH               (-6)    /**< tag does not match */
+/** @} */
+
+/**
+ * @brief   Maximum length of an authentication tag
+ */
+#define AEAD_MAX_TAG_SIZE           (16U)
+
+/**
+ * @brief   Direction of an AEAD operation
+ */
+typedef enum {
+    AEAD_ENCRYPT,                   /**< encrypt and compute the tag */
+    AEAD_DECRYPT,                   /**< decrypt and verify the tag */
+} aead_dir_t;
+
+/**
+ * @brief   ChaCha20-Poly1305 state
+ * @note    All members are private.
+ */
+typedef struct {
+    chacha_ctx chacha;              /**< cipher, holds key and nonce */
+    poly1305_ctx_t poly;            /**< authenticator of this message */
+    uint8_t stream[64];             /**< current key stream block */
+    size_t ad_len;                  /**< length of the associated data */
+    size_t msg_len;                 /**< length of the message */
+    uint8_t stream_pos;             /**< used bytes of stream */
+    uint8_t ad_padded;              /**< associated data was padded */
+} aead_chacha20poly1305_t;
+
+/**
+ * @brief   AES-CCM state
+ * @note    All members are private.
+ */
+typedef struct {
+    cipher_t cipher;                /**< block cipher with expanded key */
+    uint8_t mac[16];                /**< CBC-MAC state */
+    uint8_t ctr[16];                /**< next counter block */
+    uint8_t s0[16];                 /**< encrypted counter block 0 */
+    uint8_t stream[16];             /**< current key stream block */
+    uint8_t pos;                    /**< position within the current block */
+    uint8_t mac_pending;            /**< mac absorbed a block, not encrypted */
+    uint8_t in_msg;                 /**< associated data is complete */
+    uint8_t l;                      /**< size of the length field */
+} aead_ccm_t;
+
+/**
+ * @brief   Context of any AEAD algorithm
+ */
+typedef union {
+    aead_chacha20poly1305_t chacha20poly1305;   /**< ChaCha20-Poly1305 */
+    aead_ccm_t ccm;                             /**< AES-CCM */
+} aead_context_t;
+
+/**
+ * @brief   AEAD algorithm
+ */
+typedef struct aead_interface {
+    /** Valid nonce lengths, as bit mask (bit n: n bytes) */
+    uint16_t nonce_sizes;
+    /** Valid tag lengths, as bit mask (bit n: n bytes) */
+    uint32_t tag_sizes;
+    /** set the key */
+    int (*init)(aead_context_t *ctx, const uint8_t *key, size_t key_len);
+    /** start a message */
+    int (*start)(aead_context_t *ctx, const uint8_t *nonce, size_t nonce_len,
+                 size_t ad_len, size_t msg_len, size_t tag_len);
+    /** absorb associated data */
+    void (*update_ad)(aead_context_t *ctx, const uint8_t *ad, size_t len);
+    /** en- or decrypt message data */
+    int (*update)(aead_context_t *ctx, aead_dir_t dir, const uint8_t *in,
+                  uint8_t *out, size_t len);
+    /** compute the full length tag */
+    int (*finish)(aead_context_t *ctx, uint8_t *tag);
+} aead_interface_t;
+
+/**
+ * @brief   Identifies an AEAD algorithm
+ */
+typedef const aead_interface_t *aead_id_t;
+
+/**
+ * @brief   ChaCha20-Poly1305 with 32 byte key, 12 byte nonce, 16 byte tag
+ */
+extern const aead_id_t AEAD_CHACHA20_POLY1305;
+
+/**
+ * @brief   AES-128-CCM with 7 to 13 byte nonce and 4 to 16 byte tag
+ *
+ * Needs USEMODULE += crypto_aes (or CFLAGS += -DCRYPTO_AES).
+ */
+extern const aead_id_t AEAD_AES_128_CCM;
+
+/**
+ * @brief   AEAD operation
+ */
+typedef struct {
+    const aead_interface_t *interface;  /**< algorithm */
+    aead_context_t ctx;                 /**< algorithm state */
+    size_t ad_left;                     /**< associated data still expected */
+    size_t msg_left;                    /**< message data still expected */
+    uint8_t tag_len;                    /**< length of the tag */
+    uint8_t dir;                        /**< an aead_dir_t */
+} aead_t;
+
+/**
+ * @brief   Set the algorithm and the key
+ *
+ * @param[out] aead     operation to initialize
+ * @param[in] id        algorithm
+ * @param[in] key       key
+ * @param[in] key_len   length of @p key
+ *
+ * @return  AEAD_OK on success
+ * @return  AEAD_ERR_INVALID_KEY_SIZE or AEAD_ERR_CIPHER on error
+ */
+int aead_init(aead_t *aead, aead_id_t id, const uint8_t *key, size_t key_len);
+
+/**
+ * @brief   Start a message
+ *
+ * The amount of associated data and message data has to be known in
+ * advance, as CCM authenticates the lengths first.
+ *
+ * @param[in,out] aead      operation initialized with aead_init()
+ * @param[in] dir           encrypt or decrypt
+ * @param[in] nonce         nonce, must not repeat for the same key
+ * @param[in] nonce_len     length of @p nonce
+ * @param[in] ad_len        total length of the associated data
+ * @param[in] msg_len       total length of the message
+ * @param[in] tag_len       length of the tag
+ *
+ * @return  AEAD_OK on success
+ * @return  negative AEAD_ERR_* on invalid parameters
+ */
+int aead_start(aead_t *aead, aead_dir_t dir, const uint8_t *nonce,
+               size_t nonce_len, size_t ad_len, size_t msg_len,
+               size_t tag_len);
+
+/**
+ * @brief   Authenticate associated data
+ *
+ * Must be called before the first call to aead_update().
+ *
+ * @param[in,out] aead  operation
+ * @param[in] ad        associated data
+ * @param[in] len       length of @p ad
+ *
+ * @return  AEAD_OK on success
+ * @return  AEAD_ERR_INVALID_LENGTH if this exceeds the announced length
+ */
+int aead_update_ad(aead_t *aead, const void *ad, size_t len);
+
+/**
+ * @brief   En- or decrypt a piece of the message
+ *
+ * @param[in,out] aead  operation
+ * @param[in] in        input
+ * @param[out] out      output, may be equal to @p in
+ * @param[in] len       length of @p in
+ *
+ * @return  AEAD_OK on success
+ * @return  AEAD_ERR_INVALID_LENGTH if this exceeds the announced length
+ * @return  AEAD_ERR_CIPHER if the block cipher failed
+ */
+int aead_update(aead_t *aead, const void *in, void *out, size_t len);
+
+/**
+ * @brief   En- or decrypt all snips of a packet in place
+ *
+ * Processes @p pkt and all snips following it, without copying the packet
+ * into a contiguous buffer.
+ *
+ * @pre     The caller owns all snips exclusively (`users <= 1`), as their
+ *          data is overwritten. Make shared snips writable with
+ *          gnrc_pktbuf_start_write() before passing them in.
+ *
+ * @param[in,out] aead  operation
+ * @param[in,out] pkt   first snip to process
+ *
+ * @return  see aead_update()
+ */
+int aead_update_pkt(aead_t *aead, struct gnrc_pktsnip *pkt);
+
+/**
+ * @brief   Finish the message
+ *
+ * @param[in,out] aead  operation, can be restarted with aead_start()
+ * @param[in,out] tag   tag output when encrypting, received tag when
+ *                      decrypting
+ *
+ * @return  AEAD_OK on success
+ * @return  AEAD_ERR_INVALID_LENGTH if less data than announced was passed
+ * @return  AEAD_ERR_AUTH if decrypting and the tag does not match
+ */
+int aead_finish(aead_t *aead, uint8_t *tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+#endif /* CRYPTO_AEAD_H */
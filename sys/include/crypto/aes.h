@@ -50,6 +50,7 @@ typedef uint8_t u8;
 #define AES_MAXNR         14
 #define AES_BLOCK_SIZE    16
 #define AES_KEY_SIZE      16
+#define AES_ROUNDS        10    /**< number of rounds for AES_KEY_SIZE */
 
 /**
  * @brief AES key
@@ -66,10 +67,18 @@ typedef struct aes_key_st AES_KEY;
 
 /**
  * @brief the cipher_context_t-struct adapted for AES
+ *
+ * The key schedules are expanded once by aes_init(), so encrypting or
+ * decrypting a block does not have to derive the round keys again. How the
+ * round keys are laid out depends on the AES implementation in use: the
+ * default T-table code, the bitsliced constant-time code (module
+ * `crypto_aes_ct`) or AES-NI on x86 hosts (module `crypto_aes_ni`).
  */
 typedef struct {
-    /** context data buffer */
-    uint32_t context[(4 * (AES_MAXNR + 1)) + 1];
+    /** encryption key schedule */
+    uint32_t enc_key[4 * (AES_ROUNDS + 1)];
+    /** decryption key schedule */
+    uint32_t dec_key[4 * (AES_ROUNDS + 1)];
 } aes_context_t;
 
 /**
@@ -99,7 +108,7 @@ int aes_init(cipher_context_t *context, const uint8_t *key, uint8_t keySize);
  * @param       cipher_block  a pointer to the place where the ciphertext will
  *                            be stored
  *
- * @return  1 or result of aes_set_encrypt_key if it failed
+ * @return  1
  */
 int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
                 uint8_t *cipher_block);
@@ -117,12 +126,45 @@ int aes_encrypt(const cipher_context_t *context, const uint8_t *plain_block,
  * @param       plain_block   a pointer to the place where the decrypted
  *                            plaintext will be stored
  *
- * @return  1 or negative value if cipher key cannot be expanded into
- *          decryption key schedule
+ * @return  1
  */
 int aes_decrypt(const cipher_context_t *context, const uint8_t *cipher_block,
                 uint8_t *plain_block);
 
+/**
+ * @brief   encrypts @p nblocks consecutive blocks
+ *
+ * The bitsliced and the AES-NI implementations process several blocks in
+ * parallel, so this is considerably faster than calling aes_encrypt() for
+ * each block.
+ *
+ * @param       context   the cipher_context_t-struct to use for this
+ *                        encryption
+ * @param       input     @p nblocks plaintext blocks
+ * @param       output    memory for @p nblocks ciphertext blocks, may be
+ *                        equal to @p input
+ * @param       nblocks   number of blocks
+ *
+ * @return  1
+ */
+int aes_encrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t nblocks);
+
+/**
+ * @brief   decrypts @p nblocks consecutive blocks
+ *
+ * @param       context   the cipher_context_t-struct to use for this
+ *                        decryption
+ * @param       input     @p nblocks ciphertext blocks
+ * @param       output    memory for @p nblocks plaintext blocks, may be
+ *                        equal to @p input
+ * @param       nblocks   number of blocks
+ *
+ * @return  1
+ */
+int aes_decrypt_blocks(const cipher_context_t *context, const uint8_t *input,
+                       uint8_t *output, size_t nblocks);
+
 #ifdef __cplusplus
 }
 #endif
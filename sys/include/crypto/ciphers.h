@@ -22,6 +22,7 @@
 #ifndef CRYPTO_CIPHERS_H
 #define CRYPTO_CIPHERS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -36,6 +37,11 @@ extern "C" {
 // #define CRYPTO_THREEDES
 // #define CRYPTO_AES
 
+/* the crypto_aes pseudomodule selects AES without touching CFLAGS */
+#if defined(MODULE_CRYPTO_AES) && !defined(CRYPTO_AES)
+#define CRYPTO_AES
+#endif
+
 /** @brief the length of keys in bytes */
 #define CIPHERS_MAX_KEY_SIZE 20
 #define CIPHER_MAX_BLOCK_SIZE 16
@@ -45,13 +51,13 @@ extern "C" {
  * Context sizes needed for the different ciphers.
  * Always order by number of bytes descending!!! <br><br>
  *
+ * aes          needs 352 bytes (encryption and decryption key schedules) <br>
  * threedes     needs 24  bytes                           <br>
- * aes          needs CIPHERS_MAX_KEY_SIZE bytes          <br>
  */
-#if defined(CRYPTO_THREEDES)
+#if defined(CRYPTO_AES)
+    #define CIPHER_MAX_CONTEXT_SIZE 352
+#elif defined(CRYPTO_THREEDES)
     #define CIPHER_MAX_CONTEXT_SIZE 24
-#elif defined(CRYPTO_AES)
-    #define CIPHER_MAX_CONTEXT_SIZE CIPHERS_MAX_KEY_SIZE
 #else
     // 0 is not a possibility because 0-sized arrays are not allowed in ISO C
     #define CIPHER_MAX_CONTEXT_SIZE 1
@@ -72,7 +78,8 @@ extern "C" {
  * @brief   the context for cipher-operations
  */
 typedef struct {
-    uint8_t context[CIPHER_MAX_CONTEXT_SIZE];  /**< buffer for cipher operations */
+    /** buffer for cipher operations, aligned for word-wise key schedules */
+    uint8_t context[CIPHER_MAX_CONTEXT_SIZE] __attribute__((aligned(4)));
 } cipher_context_t;
 
 
@@ -96,6 +103,11 @@ typedef struct cipher_interface_st {
     /** the decrypt function */
     int (*decrypt)(const cipher_context_t* ctx, const uint8_t* cipher_block,
                    uint8_t* plain_block);
+
+    /** encrypt several consecutive blocks, NULL if the cipher has no faster
+     *  way than calling encrypt for each of them */
+    int (*encrypt_blocks)(const cipher_context_t* ctx, const uint8_t* input,
+                          uint8_t* output, size_t nblocks);
 } cipher_interface_t;
 
 
@@ -144,6 +156,25 @@ int cipher_init(cipher_t* cipher, cipher_id_t cipher_id, const uint8_t* key,
 int cipher_encrypt(const cipher_t* cipher, const uint8_t* input, uint8_t* output);
 
 
+/**
+ * @brief Encrypt @p nblocks consecutive blocks of BLOCK_SIZE length
+ *
+ * Same as calling cipher_encrypt() for each block, but lets the modes of
+ * operation hand over as many blocks as they have at once.
+ *
+ * @param cipher     Already initialized cipher struct
+ * @param input      pointer to @p nblocks blocks of input data to encrypt
+ * @param output     pointer to allocated memory for @p nblocks encrypted
+ *                   blocks. May be equal to @p input.
+ * @param nblocks    number of blocks to encrypt
+ *
+ * @return  1 on success
+ * @return  the error returned by the cipher otherwise
+ */
+int cipher_encrypt_blocks(const cipher_t* cipher, const uint8_t* input,
+                          uint8_t* output, size_t nblocks);
+
+
 /**
  * @brief Decrypt data of BLOCK_SIZE length
  * *
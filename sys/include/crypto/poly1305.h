@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_crypto
+ * @{
+ *
+ * @file
+ * @brief       Poly1305 one-time authenticator (RFC 8439)
+ *
+ * A key must only be used for a single message. Use it through the
+ * ChaCha20-Poly1305 AEAD (see crypto/aead.h) unless you derive one-time keys
+ * yourself.
+ */
+
+#ifndef CRYPTO_POLY1305_H
+#define CRYPTO_POLY1305_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Length of the key in bytes
+ */
+#define POLY1305_KEY_SIZE   (32U)
+
+/**
+ * @brief   Length of the authentication tag in bytes
+ */
+#define POLY1305_TAG_SIZE   (16U)
+
+/**
+ * @brief   Poly1305 context
+ * @note    All members are private.
+ */
+typedef struct {
+    uint32_t r[5];              /**< clamped key r in 26 bit limbs */
+    uint32_t h[5];              /**< accumulator in 26 bit limbs */
+    uint32_t pad[4];            /**< key s */
+    uint8_t buf[16];            /**< partial block */
+    uint8_t buf_len;            /**< number of bytes in buf */
+} poly1305_ctx_t;
+
+/**
+ * @brief   Initialize a Poly1305 context
+ *
+ * @param[out] ctx  context to initialize
+ * @param[in]  key  one-time key of POLY1305_KEY_SIZE bytes
+ */
+void poly1305_init(poly1305_ctx_t *ctx, const uint8_t *key);
+
+/**
+ * @brief   Authenticate more data
+ *
+ * @param[in,out] ctx   context
+ * @param[in]     data  message data
+ * @param[in]     len   length of @p data
+ */
+void poly1305_update(poly1305_ctx_t *ctx, const void *data, size_t len);
+
+/**
+ * @brief   Finish the computation and write the tag
+ *
+ * @param[in,out] ctx   context, must be initialized again before reuse
+ * @param[out]    tag   POLY1305_TAG_SIZE bytes
+ */
+void poly1305_finish(poly1305_ctx_t *ctx, uint8_t *tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+#endif /* CRYPTO_POLY1305_H */
@@ -27,6 +27,19 @@
 extern "C" {
 #endif
 
+/**
+ * @brief   Seeded or keyed 64 bit hash function
+ *
+ * Common interface of the word-at-a-time hashes xxh64_hash64() and
+ * siphash24(), e.g. for bloom_init_hash64().
+ *
+ * @param key   seed or key, its format depends on the function
+ * @param buf   input buffer to hash
+ * @param len   length of buffer
+ * @return 64 bit sized hash
+ */
+typedef uint64_t (*hash64fp_t)(const void *key, const void *buf, size_t len);
+
 /**
  * @brief djb2
  *
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_hashes_siphash SipHash
+ * @ingroup     sys_hashes
+ * @brief       Keyed hash function SipHash-2-4
+ *
+ * SipHash is a pseudo random function keyed with 128 bits. Without the key
+ * an attacker cannot predict which inputs collide, so tables indexed by
+ * data from the network (addresses, message IDs) cannot be flooded with
+ * colliding entries. Pick the key at random, e.g. with random_bytes(), when
+ * the table is created.
+ *
+ * Specified in "SipHash: a fast short-input PRF" by Jean-Philippe Aumasson
+ * and Daniel J. Bernstein.
+ *
+ * @{
+ *
+ * @file
+ * @brief       SipHash interface definition
+ */
+
+#ifndef HASHES_SIPHASH_H
+#define HASHES_SIPHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of a SipHash key in bytes
+ */
+#define SIPHASH_KEY_SIZE    (16U)
+
+/**
+ * @brief   Compute SipHash-2-4 of a buffer
+ *
+ * The signature matches hash64fp_t.
+ *
+ * @param[in] key   SIPHASH_KEY_SIZE bytes of key
+ * @param[in] buf   input data
+ * @param[in] len   length of @p buf
+ *
+ * @return  64 bit hash
+ */
+uint64_t siphash24(const void *key, const void *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASHES_SIPHASH_H */
+/** @} */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_hashes_stream Streaming input
+ * @ingroup     sys_hashes
+ * @brief       Feed packets and files into a hash without copying them
+ *
+ * The hashes only offer `*_update()` functions on flat memory. These helpers
+ * feed them from a gnrc_pktsnip_t chain, where every snip is hashed where it
+ * is, or from a VFS file, which is read in chunks through a buffer supplied
+ * by the caller. Neither needs a buffer as large as the input.
+ *
+ * @code
+ * sha256_context_t ctx;
+ * uint8_t buf[64];
+ *
+ * sha256_init(&ctx);
+ * hashes_update_file(hashes_sha256_update, &ctx, "/nvm/image.bin",
+ *                    buf, sizeof(buf));
+ * sha256_final(&ctx, digest);
+ * @endcode
+ *
+ * @{
+ *
+ * @file
+ * @brief       Streaming input for hashes
+ */
+
+#ifndef HASHES_STREAM_H
+#define HASHES_STREAM_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "hashes/md5.h"
+#include "hashes/sha1.h"
+#include "hashes/sha256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct gnrc_pktsnip;
+
+/**
+ * @brief   Adds @p len bytes of @p data to the hash context @p ctx
+ */
+typedef void (*hashes_update_t)(void *ctx, const void *data, size_t len);
+
+/**
+ * @brief   hashes_update_t for md5_ctx_t
+ */
+static inline void hashes_md5_update(void *ctx, const void *data, size_t len)
+{
+    md5_update(ctx, data, len);
+}
+
+/**
+ * @brief   hashes_update_t for sha1_context
+ */
+static inline void hashes_sha1_update(void *ctx, const void *data, size_t len)
+{
+    sha1_update(ctx, data, len);
+}
+
+/**
+ * @brief   hashes_update_t for sha256_context_t
+ */
+static inline void hashes_sha256_update(void *ctx, const void *data,
+                                        size_t len)
+{
+    sha256_update(ctx, data, len);
+}
+
+/**
+ * @brief   hashes_update_t for hmac_context_t (HMAC-SHA-256)
+ */
+static inline void hashes_hmac_sha256_update(void *ctx, const void *data,
+                                             size_t len)
+{
+    hmac_sha256_update(ctx, data, len);
+}
+
+/**
+ * @brief   Hash all snips of a packet
+ *
+ * @param[in] update    update function of the hash
+ * @param[in,out] ctx   hash context
+ * @param[in] pkt       first snip, all snips following it are hashed too
+ *
+ * @return  number of bytes hashed
+ */
+size_t hashes_update_pkt(hashes_update_t update, void *ctx,
+                         const struct gnrc_pktsnip *pkt);
+
+/**
+ * @brief   Hash an open file from its current position to its end
+ *
+ * Needs the module `vfs`.
+ *
+ * @param[in] update    update function of the hash
+ * @param[in,out] ctx   hash context
+ * @param[in] fd        file descriptor returned by vfs_open()
+ * @param[in] buf       buffer the file is read through
+ * @param[in] chunk     size of @p buf, the amount read per vfs_read()
+ *
+ * @return  number of bytes hashed
+ * @return  negative errno returned by vfs_read() on error
+ */
+ssize_t hashes_update_fd(hashes_update_t update, void *ctx, int fd,
+                         void *buf, size_t chunk);
+
+/**
+ * @brief   Hash a file
+ *
+ * Needs the module `vfs`.
+ *
+ * @param[in] update    update function of the hash
+ * @param[in,out] ctx   hash context
+ * @param[in] path      absolute path of the file
+ * @param[in] buf       buffer the file is read through
+ * @param[in] chunk     size of @p buf, the amount read per vfs_read()
+ *
+ * @return  number of bytes hashed
+ * @return  negative errno returned by vfs_open() or vfs_read() on error
+ */
+ssize_t hashes_update_file(hashes_update_t update, void *ctx,
+                           const char *path, void *buf, size_t chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASHES_STREAM_H */
+/** @} */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_hashes_xxhash xxHash
+ * @ingroup     sys_hashes
+ * @brief       Fast non-cryptographic hash functions XXH32 and XXH64
+ *
+ * xxHash consumes the input four (XXH32) or eight (XXH64) bytes at a time
+ * and distributes well enough for hash tables and Bloom filters. It is not
+ * keyed: if an attacker chooses the input, e.g. addresses taken from
+ * received packets, use SipHash (hashes/siphash.h) instead.
+ *
+ * The results equal those of the reference implementation, which is found
+ * at https://github.com/Cyan4973/xxHash
+ *
+ * On 8 and 16 bit platforms XXH32 is usually faster than XXH64.
+ *
+ * @{
+ *
+ * @file
+ * @brief       xxHash interface definition
+ */
+
+#ifndef HASHES_XXHASH_H
+#define HASHES_XXHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Compute the 32 bit xxHash of a buffer
+ *
+ * @param[in] buf   input data
+ * @param[in] len   length of @p buf
+ * @param[in] seed  seed, different seeds give independent hash functions
+ *
+ * @return  32 bit hash
+ */
+uint32_t xxh32(const void *buf, size_t len, uint32_t seed);
+
+/**
+ * @brief   Compute the 64 bit xxHash of a buffer
+ *
+ * @param[in] buf   input data
+ * @param[in] len   length of @p buf
+ * @param[in] seed  seed, different seeds give independent hash functions
+ *
+ * @return  64 bit hash
+ */
+uint64_t xxh64(const void *buf, size_t len, uint64_t seed);
+
+/**
+ * @brief   xxh64() as hash64fp_t
+ *
+ * @param[in] seed  pointer to a uint64_t seed, NULL for 0
+ * @param[in] buf   input data
+ * @param[in] len   length of @p buf
+ *
+ * @return  64 bit hash
+ */
+uint64_t xxh64_hash64(const void *seed, const void *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASHES_XXHASH_H */
+/** @} */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_kvstore Key-value store
+ * @ingroup     sys
+ * @brief       Log-structured key-value store on a MTD
+ *
+ * Small values like configuration and counters are appended to a log on the
+ * flash instead of being rewritten in place. Each write programs only the
+ * bytes of the new record, a sector is erased only after all data still
+ * needed from it was copied.
+ *
+ * On the flash, every sector starts with a header holding its erase count
+ * and a sequence number which orders the sectors of the log. The sequence
+ * number is stored with its complement, so an interrupted write of it is
+ * recognized. Records follow the header:
+ *
+ * | flags | key length | value length | transaction | CRC | key | value |
+ *
+ * The CRC-16 over the header and the data detects records which were
+ * interrupted by a power loss. Records of a transaction are written into
+ * the same sector, only the last record carries the commit flag. At mount,
+ * records without a following commit are ignored, so a transaction takes
+ * effect completely or not at all.
+ *
+ * An index of all keys is kept in RAM and rebuilt at mount. It holds the
+ * hash of the key and the location of the newest record, a lookup reads the
+ * key from the flash only to resolve collisions.
+ *
+ * When the log runs out of erased sectors, the oldest sector is compacted:
+ * its records still referenced by the index are copied to the head of the
+ * log and it is erased. One erased sector is always kept in reserve for
+ * this. kvstore_compact() does the same ahead of time, e.g. from a low
+ * priority thread. New sectors are taken in the order of their erase count
+ * and the oldest data keeps moving, so all sectors wear evenly.
+ *
+ * @code
+ * static kvstore_entry_t index[32];
+ * static kvstore_t kvs = {
+ *     .dev = MTD_0,
+ *     .index = index,
+ *     .index_size = 32,
+ * };
+ *
+ * if (kvstore_mount(&kvs) == -ENODEV) {
+ *     kvstore_format(&kvs);
+ *     kvstore_mount(&kvs);
+ * }
+ * kvstore_set(&kvs, "boot_count", &count, sizeof(count));
+ * @endcode
+ *
+ * @{
+ *
+ * @file
+ * @brief       Key-value store interface
+ */
+
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "mtd.h"
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef KVSTORE_KEY_MAX
+/**
+ * @brief   Maximum length of a key
+ */
+#define KVSTORE_KEY_MAX     (32U)
+#endif
+
+#ifndef KVSTORE_TXN_MAX
+/**
+ * @brief   Maximum number of operations in a transaction
+ */
+#define KVSTORE_TXN_MAX     (8U)
+#endif
+
+#ifndef KVSTORE_COMPACT_FREE
+/**
+ * @brief   kvstore_compact() compacts while fewer sectors are erased
+ */
+#define KVSTORE_COMPACT_FREE    (3U)
+#endif
+
+/**
+ * @brief   Index entry
+ */
+typedef struct {
+    uint32_t hash;          /**< hash of the key */
+    uint32_t addr;          /**< address of the newest record of the key,
+                             *   UINT32_MAX if unused */
+} kvstore_entry_t;
+
+/**
+ * @brief   Operation of a transaction
+ */
+typedef struct {
+    const char *key;        /**< null-terminated key */
+    const void *value;      /**< value, NULL to delete the key */
+    size_t len;             /**< length of @p value */
+} kvstore_op_t;
+
+/**
+ * @brief   Key-value store
+ *
+ * @p dev, @p index and @p index_size are set by the user, the rest by
+ * kvstore_mount().
+ */
+typedef struct {
+    mtd_dev_t *dev;             /**< MTD holding the log, the whole device is
+                                 *   used */
+    kvstore_entry_t *index;     /**< index, one entry per key */
+    unsigned index_size;        /**< number of entries in @p index, one more
+                                 *   than the number of keys to store */
+    unsigned keys;              /**< number of keys stored */
+    mutex_t lock;               /**< serializes all operations */
+    uint32_t sector_size;       /**< size of a sector in bytes */
+    uint32_t head;              /**< sector records are appended to */
+    uint32_t offset;            /**< offset of the next record in @p head */
+    uint32_t seq;               /**< sequence number of @p head */
+    uint16_t txn;               /**< number of the last transaction */
+} kvstore_t;
+
+/**
+ * @brief   Erase the device and prepare it for the store
+ *
+ * Erase counts of sectors which were formatted before are kept.
+ *
+ * @param[in]   kvs     store, only @p dev needs to be set
+ *
+ * @return  0 on success
+ * @return  <0 on MTD errors
+ */
+int kvstore_format(kvstore_t *kvs);
+
+/**
+ * @brief   Mount the store and build the index
+ *
+ * Repairs sectors whose erase or activation was interrupted. An interrupted
+ * compaction is rolled back, the next write compacts again.
+ *
+ * @param[in]   kvs     store
+ *
+ * @return  0 on success
+ * @return  -ENODEV if the device is not formatted
+ * @return  -ENOMEM if the index is too small
+ * @return  <0 on MTD errors
+ */
+int kvstore_mount(kvstore_t *kvs);
+
+/**
+ * @brief   Read the value of a key
+ *
+ * @param[in]   kvs     store
+ * @param[in]   key     key
+ * @param[out]  value   buffer for the value
+ * @param[in]   len     size of @p value, the value is truncated to it
+ *
+ * @return  length of the value on success
+ * @return  -EINVAL if the key is empty or too long
+ * @return  -ENOENT if the key is not stored
+ * @return  <0 on MTD errors
+ */
+ssize_t kvstore_get(kvstore_t *kvs, const char *key, void *value, size_t len);
+
+/**
+ * @brief   Store a value
+ *
+ * @param[in]   kvs     store
+ * @param[in]   key     key, at most @ref KVSTORE_KEY_MAX characters
+ * @param[in]   value   value
+ * @param[in]   len     length of @p value
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the key or value is too long
+ * @return  -ENOMEM if the index is full
+ * @return  -ENOSPC if the device is full
+ * @return  -EOVERFLOW if the sequence numbers of the log are exhausted
+ * @return  <0 on MTD errors
+ */
+int kvstore_set(kvstore_t *kvs, const char *key, const void *value, size_t len);
+
+/**
+ * @brief   Delete a key
+ *
+ * @param[in]   kvs     store
+ * @param[in]   key     key
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the key is empty or too long
+ * @return  -ENOENT if the key is not stored
+ * @return  <0 on errors, see kvstore_set()
+ */
+int kvstore_delete(kvstore_t *kvs, const char *key);
+
+/**
+ * @brief   Apply several operations atomically
+ *
+ * After a power loss either all or none of the operations are found by
+ * kvstore_mount(). The records of all operations must fit into one sector.
+ *
+ * @param[in]   kvs     store
+ * @param[in]   ops     operations, applied in order
+ * @param[in]   n       number of operations, at most @ref KVSTORE_TXN_MAX
+ *
+ * @return  0 on success
+ * @return  <0 on errors, see kvstore_set()
+ */
+int kvstore_commit(kvstore_t *kvs, const kvstore_op_t *ops, unsigned n);
+
+/**
+ * @brief   Compact the oldest sector if erased sectors run low
+ *
+ * Moves the work of compaction out of kvstore_set() and friends. Compacts
+ * one sector per call while fewer than @ref KVSTORE_COMPACT_FREE sectors are
+ * erased.
+ *
+ * @param[in]   kvs     store
+ *
+ * @return  1 if a sector was compacted
+ * @return  0 if there was nothing to do
+ * @return  <0 on MTD errors
+ */
+int kvstore_compact(kvstore_t *kvs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KVSTORE_H */
+/** @} */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_mempool Fixed-size block pool
+ * @ingroup     sys
+ * @brief       Constant-time allocator for blocks of one fixed size
+ *
+ * A pool hands out the elements of a caller supplied array. Released blocks
+ * are kept on an intrusive free list (the link is stored inside the free
+ * block itself), blocks that were never handed out are taken in order from
+ * the start of the array. Both allocation and release are therefore O(1) and the pool
+ * needs no initialization loop, so pools can be defined statically with
+ * @ref MEMPOOL_INIT.
+ *
+ * The plain functions do no locking: users that only allocate from one
+ * thread or that already hold a lock can call them directly. The `_irq`
+ * variants disable interrupts and may be used from ISRs and threads
+ * concurrently.
+ *
+ * Each pool counts the blocks in use, the high-water mark and the number of
+ * failed allocations. All pools that were used are listed by the `ps` shell
+ * command.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Fixed-size block pool interface definition
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Fixed-size block pool
+ *
+ * @note    All members are private, use the functions below.
+ */
+typedef struct mempool {
+    struct mempool *next;   /**< next pool in the list of known pools */
+    const char *name;       /**< name shown by ps, may be NULL */
+    void *free;             /**< list of released blocks */
+    uint8_t *unused;        /**< first block that was never handed out */
+    uint8_t *end;           /**< end of the backing array */
+    size_t block_size;      /**< size of one block in bytes */
+    unsigned num;           /**< number of blocks in the pool */
+    unsigned used;          /**< number of blocks currently handed out */
+    unsigned high_water;    /**< maximum of mempool_t::used */
+    unsigned failed;        /**< number of failed allocations */
+    bool listed;            /**< pool was added to the list of known pools */
+} mempool_t;
+
+/**
+ * @brief   Static initializer for a pool over the array @p buf
+ *
+ * The build fails if the elements of @p buf can not hold the link of the
+ * free list, see the preconditions of @ref mempool_init().
+ *
+ * @param[in] n     name of the pool (may be NULL)
+ * @param[in] buf   array of blocks, must be an array and not a pointer
+ */
+#define MEMPOOL_INIT(n, buf)  { \
+        .name = (n), \
+        .unused = (uint8_t *)(buf), \
+        .end = (uint8_t *)(buf) + sizeof(buf), \
+        .block_size = sizeof((buf)[0]) + MEMPOOL_CHECK_BLOCK(sizeof((buf)[0])), \
+        .num = sizeof(buf) / sizeof((buf)[0]), \
+    }
+
+/**
+ * @brief   Evaluates to 0, or fails to compile if @p size is not a valid
+ *          block size
+ *
+ * @internal
+ */
+#define MEMPOOL_CHECK_BLOCK(size) \
+    (0 * sizeof(char[(((size) >= sizeof(void *)) && \
+                      (((size) % sizeof(void *)) == 0)) ? 1 : -1]))
+
+/**
+ * @brief   Initialize a pool at run-time
+ *
+ * @pre     @p buf is aligned for a pointer and @p block_size is a non-zero
+ *          multiple of `sizeof(void *)`. Both hold for any array of a struct
+ *          containing a pointer.
+ *
+ * @param[out] pool         pool to initialize
+ * @param[in] name          name shown by ps (may be NULL)
+ * @param[in] buf           backing memory of @p num * @p block_size bytes
+ * @param[in] block_size    size of one block
+ * @param[in] num           number of blocks in @p buf
+ */
+void mempool_init(mempool_t *pool, const char *name, void *buf,
+                  size_t block_size, unsigned num);
+
+/**
+ * @brief   Allocate a block
+ *
+ * @param[in] pool  pool to allocate from
+ *
+ * @return  pointer to a block of mempool_t::block_size bytes.
+ *          The content is undefined.
+ * @return  NULL if the pool is exhausted
+ */
+void *mempool_alloc(mempool_t *pool);
+
+/**
+ * @brief   Release a block
+ *
+ * @param[in] pool  pool @p block was allocated from
+ * @param[in] block block to release, may be NULL
+ */
+void mempool_free(mempool_t *pool, void *block);
+
+/**
+ * @brief   Interrupt safe version of @ref mempool_alloc()
+ *
+ * @param[in] pool  pool to allocate from
+ *
+ * @return  pointer to a block, NULL if the pool is exhausted
+ */
+void *mempool_alloc_irq(mempool_t *pool);
+
+/**
+ * @brief   Interrupt safe version of @ref mempool_free()
+ *
+ * @param[in] pool  pool @p block was allocated from
+ * @param[in] block block to release, may be NULL
+ */
+void mempool_free_irq(mempool_t *pool, void *block);
+
+/**
+ * @brief   Get the number of blocks that can still be allocated
+ *
+ * @param[in] pool  a pool
+ *
+ * @return  number of free blocks
+ */
+static inline unsigned mempool_avail(const mempool_t *pool)
+{
+    return pool->num - pool->used;
+}
+
+/**
+ * @brief   Check if @p ptr is a block of @p pool
+ *
+ * @param[in] pool  a pool
+ * @param[in] ptr   pointer to check
+ *
+ * @return  true, if @p ptr points into the backing memory of @p pool
+ */
+static inline bool mempool_contains(const mempool_t *pool, const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    return (p >= pool->end - (pool->num * pool->block_size)) && (p < pool->end);
+}
+
+/**
+ * @brief   Print usage statistics of all pools that were used so far
+ */
+void mempool_print_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEMPOOL_H */
+/** @} */
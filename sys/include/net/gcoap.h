@@ -298,11 +298,6 @@ extern "C" {
 #define GCOAP_MEMO_ERR          (4)     /**< Error processing response packet */
 /** @} */
 
-/**
- * @brief   Time in usec that the event loop waits for an incoming CoAP message
- */
-#define GCOAP_RECV_TIMEOUT      (1 * US_PER_SEC)
-
 /**
  * @brief   Default time to wait for a non-confirmable response [in usec]
  *
@@ -315,14 +310,6 @@ extern "C" {
  */
 #define GCOAP_MSG_TYPE_TIMEOUT  (0x1501)
 
-/**
- * @brief   Identifies a request to interrupt listening for an incoming message
- *          on a sock
- *
- * Allows the event loop to process IPC messages.
- */
-#define GCOAP_MSG_TYPE_INTR     (0x1502)
-
 /**
  * @brief   Maximum number of Observe clients; use 2 if not defined
  */
@@ -51,6 +51,59 @@ extern "C" {
 #define GNRC_IPV6_NC_L2_ADDR_MAX    (8)
 #endif
 
+#if defined(MODULE_GNRC_IPV6_NC_ETX) || defined(DOXYGEN)
+/**
+ * @name    Link estimation
+ *
+ * The expected transmission count (ETX) of the link to a neighbor is
+ * estimated passively from the acknowledgements of the unicast frames sent to
+ * it, see gnrc_ipv6_nc_etx_update(). It is an exponentially weighted moving
+ * average in units of 1 / @ref GNRC_IPV6_NC_ETX_DIVISOR.
+ *
+ * The estimates are kept by link layer address in a table of their own,
+ * which is updated by the interface threads and not by the IPv6 thread.
+ * When the table is full, the estimate updated least recently is replaced.
+ * @{
+ */
+/**
+ * @brief   ETX of a perfect link
+ */
+#define GNRC_IPV6_NC_ETX_DIVISOR    (128U)
+
+#ifndef GNRC_IPV6_NC_ETX_NUMOF
+/**
+ * @brief   Number of neighbors with an ETX estimate
+ */
+#define GNRC_IPV6_NC_ETX_NUMOF      (GNRC_IPV6_NC_SIZE)
+#endif
+
+#ifndef GNRC_IPV6_NC_ETX_INIT
+/**
+ * @brief   ETX assumed for a neighbor before the first sample
+ */
+#define GNRC_IPV6_NC_ETX_INIT       (2U * GNRC_IPV6_NC_ETX_DIVISOR)
+#endif
+
+#ifndef GNRC_IPV6_NC_ETX_NOACK
+/**
+ * @brief   ETX sample of a frame that was not acknowledged
+ *
+ * The frame was sent up to the number of MAC retransmissions, so a
+ * successful transmission would have taken more than that.
+ */
+#define GNRC_IPV6_NC_ETX_NOACK      (8U * GNRC_IPV6_NC_ETX_DIVISOR)
+#endif
+
+#ifndef GNRC_IPV6_NC_ETX_SHIFT
+/**
+ * @brief   Weight of a new ETX sample as a power of two, a sample counts for
+ *          1 / 2^GNRC_IPV6_NC_ETX_SHIFT
+ */
+#define GNRC_IPV6_NC_ETX_SHIFT      (3U)
+#endif
+/** @} */
+#endif /* MODULE_GNRC_IPV6_NC_ETX */
+
 /**
  * @{
  * @name Flag definitions for gnrc_ipv6_nc_t
@@ -309,6 +362,51 @@ gnrc_ipv6_nc_t *gnrc_ipv6_nc_still_reachable(const ipv6_addr_t *ipv6_addr);
 kernel_pid_t gnrc_ipv6_nc_get_l2_addr(uint8_t *l2_addr, uint8_t *l2_addr_len,
                                       const gnrc_ipv6_nc_t *entry);
 
+#if defined(MODULE_GNRC_IPV6_NC_ETX) || defined(DOXYGEN)
+/**
+ * @brief   Removes all ETX estimates
+ *
+ * Called by gnrc_ipv6_nc_init().
+ */
+void gnrc_ipv6_nc_etx_init(void);
+
+/**
+ * @brief   Adds an ETX sample to the neighbor with the link layer address
+ *          @p l2_addr
+ *
+ * Called on the transmission result of a unicast frame. The neighbor cache is
+ * not touched, neighbors get an estimate whether they are in it or not.
+ *
+ * @param[in] iface         PID to the interface the frame was sent on.
+ * @param[in] l2_addr       Link layer destination of the frame.
+ * @param[in] l2_addr_len   Length of @p l2_addr.
+ * @param[in] acked         true, if the frame was acknowledged.
+ *
+ * @return  The new ETX in units of 1 / @ref GNRC_IPV6_NC_ETX_DIVISOR.
+ * @return  0, if @p l2_addr_len is longer than @ref GNRC_IPV6_NC_L2_ADDR_MAX.
+ */
+uint16_t gnrc_ipv6_nc_etx_update(kernel_pid_t iface, const uint8_t *l2_addr,
+                                 size_t l2_addr_len, bool acked);
+
+/**
+ * @brief   Gets the ETX of the link to a neighbor
+ *
+ * The neighbor is found by the interface identifier of @p ipv6_addr, derived
+ * from the IEEE 802.15.4 addresses of the estimates, or else by its link
+ * layer address in the neighbor cache.
+ *
+ * @param[in] iface         PID to the interface where the neighbor is. If it
+ *                          is KERNEL_PID_UNDEF it will be searched on all
+ *                          interfaces.
+ * @param[in] ipv6_addr     IPv6 address of the neighbor
+ *
+ * @return  The ETX in units of 1 / @ref GNRC_IPV6_NC_ETX_DIVISOR.
+ * @return  @ref GNRC_IPV6_NC_ETX_INIT, if there is no estimate for the
+ *          neighbor.
+ */
+uint16_t gnrc_ipv6_nc_get_etx(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
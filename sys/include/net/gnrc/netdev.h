@@ -161,6 +161,19 @@ typedef struct gnrc_netdev {
 #endif
 
 #endif /* MODULE_GNRC_MAC */
+
+#if defined(MODULE_GNRC_IPV6_NC_ETX) || defined(DOXYGEN)
+    /**
+     * @brief link layer destination of the last unicast frame sent, the
+     *        transmission result is accounted to it
+     */
+    uint8_t tx_dst[GNRC_NETIF_HDR_L2ADDR_MAX_LEN];
+
+    /**
+     * @brief length of gnrc_netdev_t::tx_dst, 0 after a broadcast
+     */
+    uint8_t tx_dst_len;
+#endif
 } gnrc_netdev_t;
 
 #ifdef MODULE_GNRC_MAC
@@ -110,11 +110,16 @@
 #include "net/fib.h"
 #include "xtimer.h"
 #include "trickle.h"
+#include "evtimer_msg.h"
 
 #ifdef MODULE_NETSTATS_RPL
 #include "net/rpl/rpl_netstats.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+#include "net/gnrc/rpl/sr_table.h"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -151,7 +156,7 @@ extern "C" {
 #define GNRC_RPL_ALL_NODES_ADDR {{ 0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x1a }}
 
 /**
- * @brief   Message type for lifetime updates
+ * @brief   Message type for lifetime updates of P2P-RPL
  */
 #define GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE     (0x0900)
 
@@ -165,6 +170,21 @@ extern "C" {
  */
 #define GNRC_RPL_MSG_TYPE_DAO_HANDLE  (0x0903)
 
+/**
+ * @brief   Message type for parent timeouts
+ */
+#define GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT    (0x0904)
+
+/**
+ * @brief   Message type for instance cleanup
+ */
+#define GNRC_RPL_MSG_TYPE_INSTANCE_CLEANUP  (0x0905)
+
+/**
+ * @brief   Message type for expired source routes
+ */
+#define GNRC_RPL_MSG_TYPE_SR_TABLE_TIMEOUT  (0x0906)
+
 /**
  * @brief   Infinite rank
  * @see <a href="https://tools.ietf.org/html/rfc6550#section-17">
@@ -193,12 +213,23 @@ extern "C" {
 /**
  * @brief   Number of implemented Objective Functions
  */
+#ifdef MODULE_GNRC_RPL_MRHOF
+#define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (2)
+#else
 #define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (1)
+#endif
 
 /**
- * @brief   Default Objective Code Point (OF0)
+ * @brief   Default Objective Code Point (MRHOF if the module gnrc_rpl_mrhof is
+ *          used, OF0 otherwise)
  */
+#ifndef GNRC_RPL_DEFAULT_OCP
+#ifdef MODULE_GNRC_RPL_MRHOF
+#define GNRC_RPL_DEFAULT_OCP (1)
+#else
 #define GNRC_RPL_DEFAULT_OCP (0)
+#endif
+#endif
 
 /**
  * @brief   Default Instance ID
@@ -344,6 +375,14 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
  */
 #define GNRC_RPL_CLEANUP_TIME (5)
 
+/**
+ * @brief Time in seconds before a parent expires at which it is probed with
+ *        a DIS
+ */
+#ifndef GNRC_RPL_PARENT_PROBE_TIME
+#define GNRC_RPL_PARENT_PROBE_TIME (4)
+#endif
+
 /**
  * @name Node Status
  * @{
@@ -411,7 +450,10 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
 #define GNRC_RPL_ICMPV6_CODE_DAO_ACK (0x03)
 
 /**
- * @brief Update interval of the lifetime update function
+ * @brief Update interval of the lifetime update function of P2P-RPL
+ *
+ * All other timeouts are kept in @ref gnrc_rpl_evtimer and wake the RPL
+ * thread only when they are due.
  */
 #define GNRC_RPL_LIFETIME_UPDATE_STEP (2)
 
@@ -446,6 +488,11 @@ extern kernel_pid_t gnrc_rpl_pid;
  */
 extern const ipv6_addr_t ipv6_addr_all_rpl_nodes;
 
+/**
+ * @brief Timeouts of parents, DAOs and instances
+ */
+extern evtimer_msg_t gnrc_rpl_evtimer;
+
 #ifdef MODULE_NETSTATS_RPL
 /**
  * @brief Statistics for RPL control messages
@@ -453,6 +500,14 @@ extern const ipv6_addr_t ipv6_addr_all_rpl_nodes;
 extern netstats_rpl_t gnrc_rpl_netstats;
 #endif
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+/**
+ * @brief Source routes of the DODAG, if this node is a root in non-storing
+ *        mode
+ */
+extern gnrc_rpl_sr_table_t gnrc_rpl_sr_table;
+#endif
+
 /**
  * @brief Initialization of the RPL thread.
  *
@@ -575,6 +630,43 @@ void gnrc_rpl_delay_dao(gnrc_rpl_dodag_t *dodag);
  */
 void gnrc_rpl_long_delay_dao(gnrc_rpl_dodag_t *dodag);
 
+/**
+ * @brief   (Re)schedule a timeout of the RPL thread
+ *
+ * @param[in] event     The event of the timeout
+ * @param[in] type      Message type sent to the RPL thread on timeout
+ * @param[in] ptr       Content of the message
+ * @param[in] offset    Timeout in milliseconds
+ */
+void gnrc_rpl_evtimer_set(evtimer_msg_event_t *event, uint16_t type, void *ptr,
+                          uint32_t offset);
+
+/**
+ * @brief   Get the time used for RPL timeouts
+ *
+ * @return  seconds since boot
+ */
+static inline uint32_t gnrc_rpl_now(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+#if defined(MODULE_GNRC_RPL_SR_TABLE) || defined(DOXYGEN)
+/**
+ * @brief   Apply a DAO to @ref gnrc_rpl_sr_table and schedule its expiry
+ *
+ * @param[in] target    Target of the DAO
+ * @param[in] parent    Parent address of the transit information
+ * @param[in] path_seq  Path sequence of the transit information
+ * @param[in] lifetime  Path lifetime in seconds, 0 for a No-Path DAO
+ *
+ * @return  0 on success
+ * @return  -ENOMEM if the table is full
+ */
+int gnrc_rpl_sr_dao(const ipv6_addr_t *target, const ipv6_addr_t *parent,
+                    uint8_t path_seq, uint32_t lifetime);
+#endif
+
 /**
  * @brief Create a new RPL instance and RPL DODAG.
  *
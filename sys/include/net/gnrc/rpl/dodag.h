@@ -156,6 +156,14 @@ void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent);
  */
 void gnrc_rpl_local_repair(gnrc_rpl_dodag_t *dodag);
 
+/**
+ * @brief   Remove the instance of the @p dodag after
+ *          @ref GNRC_RPL_CLEANUP_TIME seconds, unless it found a parent again.
+ *
+ * @param[in] dodag     Pointer to the DODAG
+ */
+void gnrc_rpl_cleanup_start(gnrc_rpl_dodag_t *dodag);
+
 /**
  * @brief   Operate as leaf.
  *
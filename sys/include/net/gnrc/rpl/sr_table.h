@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_gnrc_rpl_sr_table RPL non-storing mode source routes
+ * @ingroup     net_gnrc_rpl
+ * @brief       Source routing table of a RPL root in non-storing mode
+ * @see <a href="https://tools.ietf.org/html/rfc6550#section-9.7">
+ *          RFC 6550, section 9.7, Non-Storing Mode
+ *      </a>
+ *
+ * In non-storing mode every node reports its DAO parent to the root. The
+ * root keeps these reports as a tree of parent pointers: each node is an
+ * entry of a fixed array, addressed by its index (the node ID), holding the
+ * index of its parent. A hash over the addresses maps a DAO target to its
+ * node ID.
+ *
+ * A DAO is applied in constant time, it only sets the parent index of its
+ * target. A source route is built by following the parent indices from the
+ * destination to the root, so it takes time proportional to the depth of the
+ * destination and is written directly into a @ref gnrc_rpl_srh_t provided
+ * by the caller. Loops are detected while walking and never corrupt the
+ * table.
+ *
+ * Freeing nodes which expired or are no longer referenced needs a pass over
+ * the whole table. It is batched: it runs once every
+ * @ref GNRC_RPL_SR_TABLE_BATCH DAOs, on gnrc_rpl_sr_table_update() and when
+ * no free node is left.
+ *
+ * The table has no clock of its own: expiry times are absolute times in
+ * seconds on a clock of the caller, which calls gnrc_rpl_sr_table_update()
+ * when the next route expires.
+ *
+ * The IPv6 layer does not insert source routing headers yet, so the root
+ * also keeps adding the DAO targets to the FIB.
+ *
+ * @{
+ *
+ * @file
+ * @brief       RPL non-storing mode source routing table
+ */
+#ifndef NET_GNRC_RPL_SR_TABLE_H
+#define NET_GNRC_RPL_SR_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mutex.h"
+#include "net/ipv6/addr.h"
+#include "net/gnrc/rpl/srh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of nodes of the table of the RPL root
+ */
+#ifndef GNRC_RPL_SR_TABLE_NUMOF
+#define GNRC_RPL_SR_TABLE_NUMOF     (32)
+#endif
+
+/**
+ * @brief   Maximum number of hops of a source route
+ */
+#ifndef GNRC_RPL_SR_TABLE_DEPTH_MAX
+#define GNRC_RPL_SR_TABLE_DEPTH_MAX (16)
+#endif
+
+/**
+ * @brief   Number of DAOs applied before unused nodes are freed
+ */
+#ifndef GNRC_RPL_SR_TABLE_BATCH
+#define GNRC_RPL_SR_TABLE_BATCH     (16)
+#endif
+
+/**
+ * @brief   Maximum size of a source routing header built by the table
+ */
+#define GNRC_RPL_SR_TABLE_SRH_MAX   (sizeof(gnrc_rpl_srh_t) + \
+                                     ((GNRC_RPL_SR_TABLE_DEPTH_MAX - 1) * \
+                                      sizeof(ipv6_addr_t)))
+
+/**
+ * @name    Special node IDs
+ * @{
+ */
+#define GNRC_RPL_SR_TABLE_NONE      (UINT16_MAX)        /**< no node */
+#define GNRC_RPL_SR_TABLE_ROOT      (UINT16_MAX - 1)    /**< the root */
+/** @} */
+
+/**
+ * @brief   A node of the table
+ */
+typedef struct {
+    ipv6_addr_t addr;           /**< address of the node */
+    uint32_t expires;           /**< time in seconds at which the route to
+                                 *   the node expires, 0 if it has none */
+    uint16_t parent;            /**< ID of the DAO parent,
+                                 *   @ref GNRC_RPL_SR_TABLE_NONE if unknown */
+    uint16_t next;              /**< next node in the same hash bucket or in
+                                 *   the free list */
+    uint16_t bucket;            /**< first node of the hash bucket with the
+                                 *   ID of this node */
+    uint8_t path_seq;           /**< path sequence of the last DAO */
+    uint8_t flags;              /**< state of the node */
+} gnrc_rpl_sr_node_t;
+
+/**
+ * @brief   Source routing table
+ */
+typedef struct {
+    gnrc_rpl_sr_node_t *nodes;  /**< nodes, indexed by node ID */
+    mutex_t lock;               /**< serializes all operations */
+    ipv6_addr_t root;           /**< address of the root */
+    uint16_t numof;             /**< number of entries in @p nodes */
+    uint16_t free;              /**< first free node */
+    uint16_t pending;           /**< DAOs since the last cleanup */
+} gnrc_rpl_sr_table_t;
+
+/**
+ * @brief   Initialize an empty table
+ *
+ * @param[out]  table   the table
+ * @param[in]   nodes   storage for the nodes
+ * @param[in]   numof   number of entries in @p nodes, less than
+ *                      @ref GNRC_RPL_SR_TABLE_ROOT
+ * @param[in]   root    address of the root, DAOs with this parent address
+ *                      attach their target to the root
+ */
+void gnrc_rpl_sr_table_init(gnrc_rpl_sr_table_t *table, gnrc_rpl_sr_node_t *nodes,
+                            uint16_t numof, const ipv6_addr_t *root);
+
+/**
+ * @brief   Apply the target and transit information of a DAO
+ *
+ * A DAO with a path sequence older than the one of the last DAO for
+ * @p target is ignored.
+ *
+ * @param[in]   table       the table
+ * @param[in]   target      target of the DAO
+ * @param[in]   parent      parent address of the transit information
+ * @param[in]   path_seq    path sequence of the transit information
+ * @param[in]   expires     time in seconds at which the route expires, 0 for
+ *                          a No-Path DAO
+ *
+ * @return  0 on success
+ * @return  -ENOMEM if the table is full
+ */
+int gnrc_rpl_sr_table_dao(gnrc_rpl_sr_table_t *table, const ipv6_addr_t *target,
+                          const ipv6_addr_t *parent, uint8_t path_seq,
+                          uint32_t expires);
+
+/**
+ * @brief   Expire routes and free the unused nodes
+ *
+ * @param[in]   table       the table
+ * @param[in]   now         current time in seconds
+ *
+ * @return  time in seconds at which the next route expires
+ * @return  0 if no route expires
+ */
+uint32_t gnrc_rpl_sr_table_update(gnrc_rpl_sr_table_t *table, uint32_t now);
+
+/**
+ * @brief   Build the source route to a destination
+ *
+ * Writes a source routing header for the hops after @p next_hop, including
+ * @p dst, to @p srh. The addresses are compressed against @p next_hop, which
+ * has to become the destination of the IPv6 header. The next header field
+ * of @p srh is left to the caller.
+ *
+ * @param[in]   table       the table
+ * @param[in]   dst         destination
+ * @param[out]  next_hop    first hop of the route
+ * @param[out]  srh         the source routing header
+ * @param[in]   len         size of @p srh in bytes
+ *
+ * @return  size of the source routing header in bytes
+ * @return  0 if @p dst is a child of the root and needs no header
+ * @return  -EHOSTUNREACH if there is no route to @p dst
+ * @return  -ELOOP if the route loops or has more than
+ *          @ref GNRC_RPL_SR_TABLE_DEPTH_MAX hops
+ * @return  -ENOBUFS if @p len is too small
+ */
+int gnrc_rpl_sr_table_route(gnrc_rpl_sr_table_t *table, const ipv6_addr_t *dst,
+                            ipv6_addr_t *next_hop, gnrc_rpl_srh_t *srh, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_GNRC_RPL_SR_TABLE_H */
+/** @} */
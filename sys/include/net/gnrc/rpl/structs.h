@@ -31,6 +31,7 @@ extern "C" {
 #include "net/ipv6/addr.h"
 #include "xtimer.h"
 #include "trickle.h"
+#include "evtimer_msg.h"
 
 /**
  * @name Option lengths
@@ -224,7 +225,10 @@ struct gnrc_rpl_parent {
     uint8_t dtsn;                   /**< last seen dtsn of this parent */
     uint16_t rank;                  /**< rank of the parent */
     gnrc_rpl_dodag_t *dodag;        /**< DODAG the parent belongs to */
-    uint32_t lifetime;              /**< lifetime of this parent in seconds */
+    uint32_t lifetime;              /**< time in seconds at which this parent
+                                         expires, see gnrc_rpl_now() */
+    evtimer_msg_event_t timeout_event;  /**< probes the parent before it
+                                             expires and removes it */
     double  link_metric;            /**< metric of the link */
     uint8_t link_metric_type;       /**< type of the metric */
 };
@@ -271,7 +275,7 @@ struct gnrc_rpl_dodag {
     bool dao_ack_received;          /**< flag to check for DAO-ACK */
     uint8_t dio_opts;               /**< options in the next DIO
                                          (see @ref GNRC_RPL_REQ_DIO_OPTS "DIO Options") */
-    uint8_t dao_time;               /**< time to schedule a DAO in seconds */
+    evtimer_msg_event_t dao_event;  /**< sends the next DAO */
     trickle_t trickle;              /**< trickle representation */
 };
 
@@ -283,7 +287,10 @@ struct gnrc_rpl_instance {
     gnrc_rpl_of_t *of;              /**< configured Objective Function */
     uint16_t min_hop_rank_inc;      /**< minimum hop rank increase */
     uint16_t max_rank_inc;          /**< max increase in the rank */
-    int8_t cleanup;                 /**< cleanup time in seconds */
+    uint32_t cleanup;               /**< time in seconds at which the
+                                         instance is removed if it has no
+                                         parents, 0 if not scheduled */
+    evtimer_msg_event_t cleanup_event;  /**< removes the instance */
 };
 /**
  * @endcond
@@ -28,20 +28,22 @@
 
 #include "net/gnrc.h"
 #include "periph/uart.h"
-#include "ringbuffer.h"
+#include "tsrb.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
- * @brief   UART buffer size used for TX and RX buffers
+ * @brief   UART buffer size used for the RX buffer
  *
  * Reduce this value if your expected traffic does not include full IPv6 MTU
- * sized packets
+ * sized packets.
+ *
+ * @attention   Must be a power of two.
  */
 #ifndef GNRC_SLIP_BUFSIZE
-#define GNRC_SLIP_BUFSIZE       (1500U)
+#define GNRC_SLIP_BUFSIZE       (2048U)
 #endif
 
 /**
@@ -49,12 +51,12 @@ extern "C" {
  */
 typedef struct {
     uart_t uart;                    /**< the UART interface */
-    ringbuffer_t in_buf;            /**< RX buffer */
-    ringbuffer_t out_buf;           /**< TX buffer */
+    tsrb_t in_buf;                  /**< RX buffer */
     char rx_mem[GNRC_SLIP_BUFSIZE]; /**< memory used by RX buffer */
     uint32_t in_bytes;              /**< the number of bytes received of a
                                      *   currently incoming packet */
     uint16_t in_esc;                /**< receiver is in escape mode */
+    uint16_t in_drop;               /**< receiver drops the current packet */
     kernel_pid_t slip_pid;          /**< PID of the device thread */
 } gnrc_slip_dev_t;
 
@@ -67,6 +67,10 @@ typedef struct {
     uint32_t dao_ack_tx_ucast_bytes;    /**< unicast dao_ack sent in bytes */
     uint32_t dao_ack_tx_mcast_count;    /**< multicast dao_ack sent in packets */
     uint32_t dao_ack_tx_mcast_bytes;    /**< multicast dao_ack sent in bytes*/
+    /* timers */
+    uint32_t timer_wakeups;             /**< wakeups of the RPL thread by its timers */
+    uint32_t timer_wakeups_saved;       /**< wakeups saved compared to an update
+                                             every GNRC_RPL_LIFETIME_UPDATE_STEP */
 } netstats_rpl_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_tsdb Time-series store
+ * @ingroup     sys
+ * @brief       Circular store for sensor samples on a MTD
+ *
+ * Samples (@ref phydat_t values with a timestamp) are appended to a ring of
+ * flash sectors. When the ring is full, the oldest sector is erased and
+ * reused, so the store always holds the most recent samples.
+ *
+ * Every sector starts with a header holding a sequence number and the time
+ * of its first sample. Samples follow as compact records, each one encoded
+ * relative to the previous sample in the same sector:
+ *
+ * | control | [unit | scale] | time delta | value deltas... |
+ *
+ * The control byte holds the number of dimensions and whether unit and scale
+ * changed. The time delta and the zig-zag encoded value deltas are varints,
+ * so slowly changing values take a few bytes per sample. The first record of
+ * a sector is encoded against zero values, so every sector can be decoded on
+ * its own and a time-range query seeks by a binary search over the sector
+ * headers.
+ *
+ * Appending encodes into a buffer of one page, which is programmed when it is
+ * full or on tsdb_flush(). Samples still in the buffer are returned by the
+ * iterator but lost on a reset.
+ *
+ * Timestamps are 32 bit in a unit chosen by the user, e.g. seconds. They must
+ * not decrease.
+ *
+ * @code
+ * static uint8_t page[256];
+ * static tsdb_t db = { .dev = MTD_0, .page = page };
+ *
+ * tsdb_init(&db);
+ * tsdb_append_saul(&db, now, saul_reg_find_type(SAUL_SENSE_TEMP));
+ * ...
+ * tsdb_iter_t it;
+ * tsdb_iter_init(&db, &it, last_upload, UINT32_MAX);
+ * while ((n = tsdb_export_cbor(&it, &stream)) > 0) {
+ *     upload(stream.data, stream.pos);
+ *     cbor_clear(&stream);
+ * }
+ * @endcode
+ *
+ * @{
+ *
+ * @file
+ * @brief       Time-series store interface
+ */
+
+#ifndef TSDB_H
+#define TSDB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cbor.h"
+#include "mtd.h"
+#include "mutex.h"
+#include "phydat.h"
+#ifdef MODULE_SAUL_REG
+#include "saul_reg.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Maximum size of an encoded sample in bytes
+ */
+#define TSDB_RECORD_MAX     (1 + 2 + 5 + PHYDAT_DIM * 3)
+
+/**
+ * @brief   A sample
+ */
+typedef struct {
+    uint32_t time;              /**< timestamp */
+    phydat_t data;              /**< value */
+    uint8_t dim;                /**< number of dimensions used in @p data */
+} tsdb_sample_t;
+
+/**
+ * @brief   Time-series store
+ *
+ * @p dev and @p page are set by the user, the rest by tsdb_init().
+ */
+typedef struct {
+    mtd_dev_t *dev;             /**< MTD holding the ring, the whole device is
+                                 *   used */
+    uint8_t *page;              /**< buffer of one page of @p dev */
+    mutex_t lock;               /**< serializes all operations */
+    uint32_t sector_size;       /**< size of a sector in bytes */
+    uint32_t used;              /**< number of sectors holding samples */
+    uint32_t tail;              /**< oldest sector */
+    uint32_t head;              /**< sector samples are appended to */
+    uint32_t seq;               /**< sequence number of @p head */
+    uint32_t offset;            /**< offset of the next record in @p head */
+    uint32_t flushed;           /**< offset up to which @p head is
+                                 *   programmed */
+    tsdb_sample_t last;         /**< last sample, base of the next record */
+} tsdb_t;
+
+/**
+ * @brief   Iterator over a time range
+ */
+typedef struct {
+    tsdb_t *db;                 /**< store */
+    uint32_t to;                /**< end of the range, inclusive */
+    uint32_t from;              /**< start of the range */
+    uint32_t sector;            /**< current sector */
+    uint32_t seq;               /**< sequence number of @p sector */
+    uint32_t offset;            /**< offset of the next record */
+    tsdb_sample_t last;         /**< last sample decoded */
+} tsdb_iter_t;
+
+/**
+ * @brief   Initialize the store from the content of the device
+ *
+ * An erased device is an empty store. A sample which was interrupted by a
+ * power loss ends its sector, appending continues in the next one.
+ *
+ * @param[in]   db      store
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the device has less than two sectors or is too small
+ *          for a sector header
+ * @return  <0 on MTD errors
+ */
+int tsdb_init(tsdb_t *db);
+
+/**
+ * @brief   Erase all samples
+ *
+ * @param[in]   db      store
+ *
+ * @return  0 on success
+ * @return  <0 on MTD errors
+ */
+int tsdb_clear(tsdb_t *db);
+
+/**
+ * @brief   Append a sample
+ *
+ * Takes constant time: the sample is encoded into the page buffer, at most
+ * one page is programmed and at most one sector is erased.
+ *
+ * @param[in]   db      store
+ * @param[in]   time    timestamp, not less than the one of the last sample
+ * @param[in]   data    value
+ * @param[in]   dim     number of dimensions used in @p data, 1 to
+ *                      @ref PHYDAT_DIM
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p time or @p dim is invalid
+ * @return  <0 on MTD errors
+ */
+int tsdb_append(tsdb_t *db, uint32_t time, const phydat_t *data, uint8_t dim);
+
+#if defined(MODULE_SAUL_REG) || defined(DOXYGEN)
+/**
+ * @brief   Read a SAUL device and append its value
+ *
+ * @param[in]   db      store
+ * @param[in]   time    timestamp, see tsdb_append()
+ * @param[in]   dev     device to read
+ *
+ * @return  0 on success
+ * @return  -ENODEV if @p dev is NULL
+ * @return  <0 on errors of saul_reg_read() or tsdb_append()
+ */
+int tsdb_append_saul(tsdb_t *db, uint32_t time, saul_reg_t *dev);
+#endif
+
+/**
+ * @brief   Program the samples in the page buffer
+ *
+ * @param[in]   db      store
+ *
+ * @return  0 on success
+ * @return  <0 on MTD errors
+ */
+int tsdb_flush(tsdb_t *db);
+
+/**
+ * @brief   Start iterating over the samples in a time range
+ *
+ * @param[in]   db      store
+ * @param[out]  it      iterator
+ * @param[in]   from    first timestamp to return
+ * @param[in]   to      last timestamp to return
+ *
+ * @return  0 on success
+ * @return  <0 on MTD errors
+ */
+int tsdb_iter_init(tsdb_t *db, tsdb_iter_t *it, uint32_t from, uint32_t to);
+
+/**
+ * @brief   Get the next sample
+ *
+ * At the end of the store, the iterator stays valid and returns samples
+ * appended later. If the sector of the iterator was erased to make space, it
+ * continues with the oldest sample.
+ *
+ * @param[in]   it      iterator
+ * @param[out]  sample  the sample
+ *
+ * @return  1 if a sample was returned
+ * @return  0 at the end of the range or of the store
+ * @return  <0 on MTD errors
+ */
+int tsdb_iter_next(tsdb_iter_t *it, tsdb_sample_t *sample);
+
+/**
+ * @brief   Export the next samples as CBOR
+ *
+ * Appends an indefinite length array to @p stream, holding one array
+ * [time, unit, scale, values...] per sample. As many samples are exported as
+ * fit into the stream, the iterator is advanced past them.
+ *
+ * @param[in]   it      iterator
+ * @param[in]   stream  stream to append to
+ *
+ * @return  number of samples exported, 0 at the end of the range or of the
+ *          store
+ * @return  -ENOSPC if @p stream has no space for a sample
+ * @return  <0 on MTD errors
+ */
+int tsdb_export_cbor(tsdb_iter_t *it, cbor_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TSDB_H */
+/** @} */
@@ -18,6 +18,15 @@
  * @note        This ringbuffer implementation can be used without locking if
  *              there's only one producer and one consumer.
  *
+ * The read and write counters are updated with C11 atomics (acquire/release),
+ * so a producer in ISR context and a consumer in thread context (or the other
+ * way around) need no interrupt locking. Bulk operations copy the at most two
+ * contiguous segments of the buffer with memcpy.
+ *
+ * For zero-copy producers, e.g. a DMA engine or a framing decoder that has to
+ * drop incomplete frames, @ref tsrb_reserve() hands out free space that is
+ * only made visible to the consumer by @ref tsrb_commit().
+ *
  * @attention   Buffer size must be a power of two!
  *
  * @author      Kaspar Schleiser <kaspar@schleiser.de>
@@ -28,6 +37,19 @@
 
 #include <assert.h>
 #include <stddef.h>
+/* The stdatomic.h in GCC gives compilation errors with C++
+ * see: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=60932
+ */
+#ifdef __cplusplus
+#include <atomic>
+/* Make the C11 atomics available without namespace specifier */
+using std::atomic_uint;
+using std::atomic_init;
+using std::atomic_load_explicit;
+using std::memory_order_acquire;
+#else
+#include <stdatomic.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,14 +61,15 @@ extern "C" {
 typedef struct tsrb {
     char *buf;                  /**< Buffer to operate on. */
     unsigned int size;          /**< Size of buf. */
-    volatile unsigned reads;    /**< total number of reads */
-    volatile unsigned writes;   /**< total number of writes */
+    atomic_uint reads;          /**< total number of reads */
+    atomic_uint writes;         /**< total number of writes */
 } tsrb_t;
 
 /**
  * @brief Static initializer
  */
-#define TSRB_INIT(BUF) { (BUF), sizeof (BUF), 0, 0 }
+#define TSRB_INIT(BUF) { (BUF), sizeof (BUF), ATOMIC_VAR_INIT(0), \
+                         ATOMIC_VAR_INIT(0) }
 
 /**
  * @brief        Initialize a tsrb.
@@ -63,8 +86,8 @@ static inline void tsrb_init(tsrb_t *rb, char *buffer, unsigned bufsize)
 
     rb->buf = buffer;
     rb->size = bufsize;
-    rb->reads = 0;
-    rb->writes = 0;
+    atomic_init(&rb->reads, 0);
+    atomic_init(&rb->writes, 0);
 }
 
 /**
@@ -75,7 +98,8 @@ static inline void tsrb_init(tsrb_t *rb, char *buffer, unsigned bufsize)
  */
 static inline int tsrb_empty(const tsrb_t *rb)
 {
-    return (rb->reads == rb->writes);
+    return (atomic_load_explicit(&rb->reads, memory_order_acquire) ==
+            atomic_load_explicit(&rb->writes, memory_order_acquire));
 }
 
 
@@ -86,7 +110,8 @@ static inline int tsrb_empty(const tsrb_t *rb)
  */
 static inline unsigned int tsrb_avail(const tsrb_t *rb)
 {
-    return (rb->writes - rb->reads);
+    return (atomic_load_explicit(&rb->writes, memory_order_acquire) -
+            atomic_load_explicit(&rb->reads, memory_order_acquire));
 }
 
 /**
@@ -97,7 +122,7 @@ static inline unsigned int tsrb_avail(const tsrb_t *rb)
  */
 static inline int tsrb_full(const tsrb_t *rb)
 {
-    return (rb->writes - rb->reads) == rb->size;
+    return tsrb_avail(rb) == rb->size;
 }
 
 /**
@@ -107,13 +132,13 @@ static inline int tsrb_full(const tsrb_t *rb)
  */
 static inline unsigned int tsrb_free(const tsrb_t *rb)
 {
-    return (rb->size - rb->writes + rb->reads);
+    return (rb->size - tsrb_avail(rb));
 }
 
 /**
  * @brief       Get a byte from ringbuffer
  * @param[in]   rb  Ringbuffer to operate on
- * @return      >=0 byte that has been read
+ * @return      >=0 byte that has been read (as unsigned char)
  * @return      -1  if no byte available
  */
 int tsrb_get_one(tsrb_t *rb);
@@ -127,6 +152,14 @@ int tsrb_get_one(tsrb_t *rb);
  */
 int tsrb_get(tsrb_t *rb, char *dst, size_t n);
 
+/**
+ * @brief       Drop bytes from ringbuffer
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   max number of bytes to drop
+ * @return      nr of bytes dropped
+ */
+int tsrb_drop(tsrb_t *rb, size_t n);
+
 /**
  * @brief       Add a byte to ringbuffer
  * @param[in]   rb  Ringbuffer to operate on
@@ -145,6 +178,32 @@ int tsrb_add_one(tsrb_t *rb, char c);
  */
 int tsrb_add(tsrb_t *rb, const char *src, size_t n);
 
+/**
+ * @brief       Get free space for writing without copying
+ *
+ * Returns the contiguous free space following the first @p offset free bytes.
+ * Bytes written there are not visible to the consumer until they are
+ * published with @ref tsrb_commit(). The producer may use @p offset to keep
+ * track of bytes it has written, but not committed yet.
+ *
+ * @param[in]   rb      Ringbuffer to operate on
+ * @param[in]   offset  nr of already reserved, uncommitted bytes
+ * @param[out]  dst     start of the free space
+ * @return      nr of contiguous bytes that can be written to @p dst
+ * @return      0 if the ringbuffer has no space left after @p offset
+ */
+size_t tsrb_reserve(const tsrb_t *rb, size_t offset, char **dst);
+
+/**
+ * @brief       Publish bytes written to space returned by @ref tsrb_reserve()
+ *
+ * @pre         @p n bytes have been reserved
+ *
+ * @param[in]   rb  Ringbuffer to operate on
+ * @param[in]   n   nr of bytes to make visible to the consumer
+ */
+void tsrb_commit(tsrb_t *rb, size_t n);
+
 #ifdef __cplusplus
 }
 #endif
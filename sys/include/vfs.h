@@ -67,6 +67,7 @@ using std::atomic_int;
 #include <sys/stat.h> /* for struct stat */
 #include <sys/types.h> /* for off_t etc. */
 #include <sys/statvfs.h> /* for struct statvfs */
+#include <sys/uio.h> /* for struct iovec */
 
 #include "kernel_types.h"
 #include "clist.h"
@@ -88,6 +89,26 @@ extern "C" {
 #define VFS_MAX_OPEN_FILES (16)
 #endif
 
+#ifndef VFS_LOOKUP_CACHE_SIZE
+/**
+ * @brief Number of directories whose mount point is remembered
+ *
+ * Path lookups start at the mount remembered for the directory of the path
+ * instead of at the top of the mount tree. Set to 0 to disable the cache.
+ */
+#define VFS_LOOKUP_CACHE_SIZE (4)
+#endif
+
+#ifndef VFS_SENDFILE_BUFFER_SIZE
+/**
+ * @brief Size of the stack buffer used by vfs_sendfile()
+ *
+ * Only used if neither the source nor the destination of the transfer lets
+ * vfs_sendfile() avoid the intermediate copy.
+ */
+#define VFS_SENDFILE_BUFFER_SIZE (64)
+#endif
+
 #ifndef VFS_DIR_BUFFER_SIZE
 /**
  * @brief Size of buffer space in vfs_DIR
@@ -176,6 +197,9 @@ struct vfs_mount_struct {
     size_t mount_point_len;      /**< Length of mount_point string (set by vfs_mount) */
     atomic_int open_files;       /**< Number of currently open files */
     void *private_data;          /**< File system driver private data, implementation defined */
+    vfs_mount_t *parent;         /**< Closest mount containing this one (set by vfs_mount) */
+    vfs_mount_t *children;       /**< First mount contained in this one (set by vfs_mount) */
+    vfs_mount_t *sibling;        /**< Next mount with the same parent (set by vfs_mount) */
 };
 
 /**
@@ -346,6 +370,75 @@ struct vfs_file_ops {
      * @return <0 on error
      */
     ssize_t (*write) (vfs_file_t *filp, const void *src, size_t nbytes);
+
+    /**
+     * @brief Read bytes from an open file into several buffers
+     *
+     * Optional, vfs_readv() calls @c read for each buffer if NULL.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  iov      destination buffers, filled in order
+     * @param[in]  iovcnt   number of elements in @p iov
+     *
+     * @return number of bytes read on success
+     * @return <0 on error
+     */
+    ssize_t (*readv) (vfs_file_t *filp, const struct iovec *iov, int iovcnt);
+
+    /**
+     * @brief Write bytes from several buffers to an open file
+     *
+     * Optional, vfs_writev() calls @c write for each buffer if NULL. Drivers
+     * where the number of write calls matters, e.g. datagram sockets, should
+     * implement it.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  iov      source buffers, written in order
+     * @param[in]  iovcnt   number of elements in @p iov
+     *
+     * @return number of bytes written on success
+     * @return <0 on error
+     */
+    ssize_t (*writev) (vfs_file_t *filp, const struct iovec *iov, int iovcnt);
+
+    /**
+     * @brief Get the file contents at the current position without copying
+     *
+     * Optional, for file systems which keep their files in memory. The file
+     * position is not changed, vfs_sendfile() advances it with @c lseek by the
+     * number of bytes it consumed.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[out] data     pointer to the contents at the current position
+     * @param[in]  nbytes   maximum number of bytes wanted
+     *
+     * @return number of bytes available at @p data, 0 at the end of the file
+     * @return <0 on error
+     */
+    ssize_t (*map) (vfs_file_t *filp, const void **data, size_t nbytes);
+
+    /**
+     * @brief Write bytes read from another open file
+     *
+     * Optional, lets the driver read from @p in directly into its own
+     * buffers, e.g. a socket into the packet it sends. Used by vfs_sendfile()
+     * on the destination file.
+     *
+     * @param[in]  filp     pointer to open file to write to
+     * @param[in]  in       pointer to open file to read from, starting at its
+     *                      current position
+     * @param[in]  nbytes   maximum number of bytes to transfer, the driver may
+     *                      transfer less
+     *
+     * The driver may read more from @p in than it transfers, vfs_sendfile()
+     * sets the position of @p in to just after the bytes transferred.
+     *
+     * @return number of bytes transferred on success, 0 at the end of @p in
+     * @return -ENOTSUP if @p filp can't take the data this way, vfs_sendfile()
+     *         uses @c write instead
+     * @return <0 on error
+     */
+    ssize_t (*sendfile) (vfs_file_t *filp, vfs_file_t *in, size_t nbytes);
 };
 
 /**
@@ -626,6 +719,53 @@ ssize_t vfs_read(int fd, void *dest, size_t count);
  */
 ssize_t vfs_write(int fd, const void *src, size_t count);
 
+/**
+ * @brief Read bytes from an open file into several buffers
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  iov      destination buffers, filled in order
+ * @param[in]  iovcnt   number of elements in @p iov
+ *
+ * @return number of bytes read on success
+ * @return <0 on error
+ */
+ssize_t vfs_readv(int fd, const struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Write bytes from several buffers to an open file
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  iov      source buffers, written in order
+ * @param[in]  iovcnt   number of elements in @p iov
+ *
+ * @return number of bytes written on success
+ * @return <0 on error
+ */
+ssize_t vfs_writev(int fd, const struct iovec *iov, int iovcnt);
+
+/**
+ * @brief Copy bytes from one open file to another
+ *
+ * The data is passed from @p in_fd to @p out_fd directly if one of the
+ * drivers allows it, see vfs_file_ops::map and vfs_file_ops::sendfile, and
+ * through a buffer of @ref VFS_SENDFILE_BUFFER_SIZE bytes on the stack
+ * otherwise.
+ *
+ * @param[in]     out_fd    fd number open for writing
+ * @param[in]     in_fd     fd number open for reading
+ * @param[in,out] offset    position in @p in_fd to start at, updated to the
+ *                          position after the last byte transferred. The
+ *                          file position of @p in_fd is not changed.
+ *                          If NULL, the transfer starts at, and advances, the
+ *                          file position of @p in_fd.
+ * @param[in]     count     maximum number of bytes to transfer
+ *
+ * @return number of bytes transferred on success, less than @p count at the
+ *         end of @p in_fd or if @p out_fd is full
+ * @return <0 on error
+ */
+ssize_t vfs_sendfile(int out_fd, int in_fd, off_t *offset, size_t count);
+
 /**
  * @brief Open a directory for reading with readdir
  *
@@ -20,6 +20,18 @@
  * number of active timers.  The reason for this is that multiplexing is
  * realized by next-first singly linked lists.
  *
+ * By default, xtimer takes an interrupt on every overflow of the low-level
+ * timer to keep track of the time.  With a 16-bit timer at 1 MHz, that is
+ * about 15 wakeups per second even if no timer is set.  The `xtimer_tickless`
+ * module suppresses these wakeups whenever no timer expires within the next
+ * few low-level timer periods and uses the RTT to wake up ahead of long
+ * timers instead.  The time is resynchronized from the RTT when xtimer is
+ * used again.  The module requires `periph_rtt` and takes exclusive use of
+ * the RTT alarm.
+ *
+ * The `xtimer_stats` module counts low-level timer interrupts by cause, see
+ * @ref xtimer_get_stats().
+ *
  * @{
  * @file
  * @brief   xtimer interface definitions
@@ -439,6 +451,68 @@ static inline bool xtimer_less64(xtimer_ticks64_t a, xtimer_ticks64_t b);
  */
 int xtimer_mutex_lock_timeout(mutex_t *mutex, uint64_t us);
 
+#if defined(MODULE_XTIMER_STATS) || DOXYGEN
+/**
+ * @brief   xtimer wakeup statistics
+ */
+typedef struct {
+    uint32_t timer;         /**< low-level timer IRQs that fired a timer */
+    uint32_t overflow;      /**< low-level timer IRQs for a period overflow */
+    uint32_t spurious;      /**< low-level timer IRQs with nothing to do */
+    uint32_t rtt;           /**< RTT alarms ending a tickless sleep */
+    uint32_t suspended;     /**< times the overflow tick was suspended */
+} xtimer_stats_t;
+
+/**
+ * @brief   Get the wakeup statistics collected since boot or the last reset
+ *
+ * @note    this requires the `xtimer_stats` module
+ *
+ * @param[out] stats    the statistics are copied here
+ */
+void xtimer_get_stats(xtimer_stats_t *stats);
+
+/**
+ * @brief   Reset the wakeup statistics
+ *
+ * @note    this requires the `xtimer_stats` module
+ */
+void xtimer_reset_stats(void);
+#endif
+
+#if defined(MODULE_XTIMER_TICKLESS) || DOXYGEN
+/**
+ * @brief   Bring the low-level timer up to date before going idle
+ *
+ * To save reprogramming the low-level timer whenever the first timer is
+ * removed, xtimer leaves the (now too early) compare value in place.
+ * This function, called by the idle thread, programs the timer for the
+ * actual next event or suspends the overflow tick if possible.
+ *
+ * @note    this requires the `xtimer_tickless` module
+ */
+void xtimer_idle(void);
+
+#ifndef XTIMER_TICKLESS_MIN_PERIODS
+/**
+ * @brief   Minimal number of low-level timer periods without any expiring
+ *          timer for xtimer to suspend the overflow tick
+ */
+#define XTIMER_TICKLESS_MIN_PERIODS (2U)
+#endif
+
+#ifndef XTIMER_TICKLESS_MAX_PERIODS
+/**
+ * @brief   Maximal number of low-level timer periods to stay suspended
+ *
+ * When suspended, the number of elapsed periods is derived from the RTT.
+ * With a combined drift of 100ppm between RTT and timer clock, sleeping
+ * 2500 periods keeps the error below a quarter period.
+ */
+#define XTIMER_TICKLESS_MAX_PERIODS (2500U)
+#endif
+#endif
+
 /**
  * @brief xtimer backoff value
  *
@@ -33,6 +33,17 @@ extern "C" {
 extern volatile uint32_t _xtimer_high_cnt;
 #endif
 
+#ifdef MODULE_XTIMER_TICKLESS
+extern volatile int _xtimer_tickless_suspended;
+
+/**
+ * @brief recover the timer period counters from the RTT while the overflow
+ *        tick is suspended
+ * @internal
+ */
+void _xtimer_tickless_sync(void);
+#endif
+
 /**
  * @brief IPC message type for xtimer msg callback
  */
@@ -92,6 +103,11 @@ void _xtimer_tsleep(uint32_t offset, uint32_t long_offset);
 
 static inline uint32_t _xtimer_now(void)
 {
+#ifdef MODULE_XTIMER_TICKLESS
+    if (_xtimer_tickless_suspended) {
+        _xtimer_tickless_sync();
+    }
+#endif
 #if XTIMER_MASK
     uint32_t latched_high_cnt, now;
 
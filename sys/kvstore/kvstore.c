@@ -0,0 +1,894 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_kvstore
+ * @{
+ *
+ * @file
+ * @brief       Key-value store implementation
+ *
+ * The index uses open addressing with linear probing, deleted entries are
+ * closed by moving the following entries back.
+ *
+ * A sector header is programmed in three steps: the erase count and the
+ * magic after the erase, the sequence number and its complement when the
+ * sector joins the log. A sector whose magic is wrong or whose sequence
+ * number does not match the complement is erased again at mount. The latter
+ * was interrupted before any record was written to it.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "checksum/crc16_ccitt.h"
+#include "kvstore.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define MAGIC           (0x3153564bUL)  /* "KVS1" */
+#define FREE_SEQ        (UINT32_MAX)
+#define SEQ_MAX         (FREE_SEQ - 1)
+#define NO_ADDR         (UINT32_MAX)
+
+#define FLAGS_MASK      (0xf0)
+#define FLAGS_VALID     (0xa0)
+#define FLAG_COMMIT     (0x01)
+#define FLAG_DELETE     (0x02)
+
+#define ALIGN           (4U)
+#define CHUNK_SIZE      (64U)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t erase_count;
+    uint32_t seq;
+    uint32_t seq_inv;       /* complement of seq */
+} sector_hdr_t;
+
+typedef struct {
+    uint8_t flags;
+    uint8_t key_len;
+    uint16_t val_len;
+    uint16_t txn;
+    uint16_t crc;           /* over the fields above, key and value */
+} rec_hdr_t;
+
+#define SECTOR_HDR      (sizeof(sector_hdr_t))
+#define REC_HDR         (sizeof(rec_hdr_t))
+#define CRC_LEN         (offsetof(rec_hdr_t, crc))
+
+static inline uint32_t _align(uint32_t size)
+{
+    return (size + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+static inline uint32_t _rec_size(const rec_hdr_t *hdr)
+{
+    return _align(REC_HDR + hdr->key_len + hdr->val_len);
+}
+
+static inline uint32_t _sector_addr(const kvstore_t *kvs, uint32_t sector)
+{
+    return sector * kvs->sector_size;
+}
+
+static inline uint32_t _sector_of(const kvstore_t *kvs, uint32_t addr)
+{
+    return addr / kvs->sector_size;
+}
+
+/* FNV-1a */
+static uint32_t _hash(const char *key, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+
+    while (len--) {
+        hash = (hash ^ (uint8_t)*key++) * 16777619UL;
+    }
+    return hash;
+}
+
+static void _geometry(kvstore_t *kvs)
+{
+    kvs->sector_size = kvs->dev->pages_per_sector * kvs->dev->page_size;
+}
+
+static int _read(kvstore_t *kvs, void *buf, uint32_t addr, uint32_t len)
+{
+    int res = mtd_read(kvs->dev, buf, addr, len);
+    return (res < 0) ? res : 0;
+}
+
+/* writes may not cross page boundaries */
+static int _program(kvstore_t *kvs, const void *data, uint32_t addr, uint32_t len)
+{
+    const uint8_t *src = data;
+    uint32_t page_size = kvs->dev->page_size;
+
+    while (len) {
+        uint32_t n = page_size - (addr % page_size);
+        if (n > len) {
+            n = len;
+        }
+        int res = mtd_write(kvs->dev, src, addr, n);
+        if (res < 0) {
+            return res;
+        }
+        src += n;
+        addr += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static inline bool _is_free(const sector_hdr_t *hdr)
+{
+    return (hdr->magic == MAGIC) && (hdr->seq == FREE_SEQ) &&
+           (hdr->seq_inv == FREE_SEQ);
+}
+
+static inline bool _is_used(const sector_hdr_t *hdr)
+{
+    return (hdr->magic == MAGIC) && (hdr->seq != FREE_SEQ) &&
+           (hdr->seq_inv == (uint32_t)~hdr->seq);
+}
+
+static int _read_sector_hdr(kvstore_t *kvs, uint32_t sector, sector_hdr_t *hdr)
+{
+    return _read(kvs, hdr, _sector_addr(kvs, sector), SECTOR_HDR);
+}
+
+static int _format_sector(kvstore_t *kvs, uint32_t sector, uint32_t erase_count)
+{
+    uint32_t addr = _sector_addr(kvs, sector);
+    uint32_t magic = MAGIC;
+
+    DEBUG("kvstore: format sector %lu\n", (unsigned long)sector);
+    int res = mtd_erase(kvs->dev, addr, kvs->sector_size);
+    if (res < 0) {
+        return res;
+    }
+    res = _program(kvs, &erase_count, addr + offsetof(sector_hdr_t, erase_count),
+                   sizeof(erase_count));
+    if (res < 0) {
+        return res;
+    }
+    return _program(kvs, &magic, addr, sizeof(magic));
+}
+
+/* finds the erased sector with the lowest erase count, returns the number of
+ * erased sectors */
+static int _find_free(kvstore_t *kvs, uint32_t *sector)
+{
+    uint32_t best = UINT32_MAX;
+    int count = 0;
+
+    for (uint32_t i = 0; i < kvs->dev->sector_count; i++) {
+        sector_hdr_t hdr;
+        int res = _read_sector_hdr(kvs, i, &hdr);
+        if (res < 0) {
+            return res;
+        }
+        if (_is_free(&hdr)) {
+            if ((count == 0) || (hdr.erase_count < best)) {
+                best = hdr.erase_count;
+                *sector = i;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/* finds the used sector with the lowest sequence number above seq */
+static int _find_next(kvstore_t *kvs, uint32_t seq, uint32_t *sector,
+                      uint32_t *sector_seq)
+{
+    bool found = false;
+
+    for (uint32_t i = 0; i < kvs->dev->sector_count; i++) {
+        sector_hdr_t hdr;
+        int res = _read_sector_hdr(kvs, i, &hdr);
+        if (res < 0) {
+            return res;
+        }
+        if (_is_used(&hdr) && (hdr.seq > seq) &&
+            (!found || (hdr.seq < *sector_seq))) {
+            *sector = i;
+            *sector_seq = hdr.seq;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/* returns 1 if the sector is erased behind the header */
+static int _is_erased(kvstore_t *kvs, uint32_t sector)
+{
+    uint32_t addr = _sector_addr(kvs, sector);
+    uint8_t buf[CHUNK_SIZE];
+
+    for (uint32_t off = SECTOR_HDR; off < kvs->sector_size; off += sizeof(buf)) {
+        uint32_t n = kvs->sector_size - off;
+        if (n > sizeof(buf)) {
+            n = sizeof(buf);
+        }
+        int res = _read(kvs, buf, addr + off, n);
+        if (res < 0) {
+            return res;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (buf[i] != 0xff) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/* makes an erased sector the head of the log */
+static int _activate(kvstore_t *kvs, uint32_t sector)
+{
+    uint32_t addr = _sector_addr(kvs, sector);
+
+    if (kvs->seq >= SEQ_MAX) {
+        return -EOVERFLOW;
+    }
+
+    /* an interrupted erase may have left the header intact */
+    int res = _is_erased(kvs, sector);
+    if (res == 0) {
+        sector_hdr_t hdr;
+        if ((res = _read_sector_hdr(kvs, sector, &hdr)) == 0) {
+            res = _format_sector(kvs, sector, hdr.erase_count + 1);
+        }
+    }
+    if (res < 0) {
+        return res;
+    }
+
+    /* a torn write leaves seq and seq_inv mismatched */
+    uint32_t seq[2] = { kvs->seq + 1, ~(kvs->seq + 1) };
+    res = _program(kvs, seq, addr + offsetof(sector_hdr_t, seq), sizeof(seq));
+    if (res < 0) {
+        return res;
+    }
+    DEBUG("kvstore: sector %lu is head, seq %lu\n", (unsigned long)sector,
+          (unsigned long)seq[0]);
+    kvs->seq = seq[0];
+    kvs->head = sector;
+    kvs->offset = SECTOR_HDR;
+    return 0;
+}
+
+static uint16_t _crc_flash(kvstore_t *kvs, uint16_t crc, uint32_t addr,
+                           uint32_t len, int *res)
+{
+    uint8_t buf[CHUNK_SIZE];
+
+    while (len) {
+        uint32_t n = (len < sizeof(buf)) ? len : sizeof(buf);
+        if ((*res = _read(kvs, buf, addr, n)) < 0) {
+            return crc;
+        }
+        crc = crc16_ccitt_update(crc, buf, n);
+        addr += n;
+        len -= n;
+    }
+    return crc;
+}
+
+/* returns 1 if the record at addr holds key */
+static int _key_equals(kvstore_t *kvs, uint32_t addr, const char *key, size_t len)
+{
+    uint8_t buf[KVSTORE_KEY_MAX];
+    rec_hdr_t hdr;
+
+    int res = _read(kvs, &hdr, addr, REC_HDR);
+    if ((res < 0) || (hdr.key_len != len)) {
+        return res;
+    }
+    if ((res = _read(kvs, buf, addr + REC_HDR, len)) < 0) {
+        return res;
+    }
+    return memcmp(buf, key, len) == 0;
+}
+
+/* returns 1 and the slot of key if it is stored, 0 and the empty slot to
+ * insert it to otherwise */
+static int _index_find(kvstore_t *kvs, const char *key, size_t len,
+                       uint32_t hash, unsigned *slot)
+{
+    unsigned i = hash % kvs->index_size;
+
+    while (kvs->index[i].addr != NO_ADDR) {
+        if (kvs->index[i].hash == hash) {
+            int res = _key_equals(kvs, kvs->index[i].addr, key, len);
+            if (res != 0) {
+                *slot = i;
+                return res;
+            }
+        }
+        i = (i + 1) % kvs->index_size;
+    }
+    *slot = i;
+    return 0;
+}
+
+static void _index_remove(kvstore_t *kvs, unsigned slot)
+{
+    unsigned size = kvs->index_size;
+    unsigned i = slot;
+
+    for (unsigned j = (i + 1) % size; kvs->index[j].addr != NO_ADDR;
+         j = (j + 1) % size) {
+        unsigned home = kvs->index[j].hash % size;
+        /* j can fill the gap unless its home lies cyclically in (i, j] */
+        if ((j > i) ? ((home <= i) || (home > j)) : ((home <= i) && (home > j))) {
+            kvs->index[i] = kvs->index[j];
+            i = j;
+        }
+    }
+    kvs->index[i].addr = NO_ADDR;
+    kvs->keys--;
+}
+
+static int _index_update(kvstore_t *kvs, const char *key, size_t len,
+                         uint32_t addr, bool del)
+{
+    uint32_t hash = _hash(key, len);
+    unsigned slot;
+    int res = _index_find(kvs, key, len, hash, &slot);
+
+    if (res < 0) {
+        return res;
+    }
+    if (del) {
+        if (res) {
+            _index_remove(kvs, slot);
+        }
+        return 0;
+    }
+    if (!res) {
+        if (kvs->keys + 1 >= kvs->index_size) {
+            return -ENOMEM;
+        }
+        kvs->index[slot].hash = hash;
+        kvs->keys++;
+    }
+    kvs->index[slot].addr = addr;
+    return 0;
+}
+
+/* applies a record on the flash to the index */
+static int _index_apply(kvstore_t *kvs, uint32_t addr)
+{
+    uint8_t buf[REC_HDR + KVSTORE_KEY_MAX];
+    rec_hdr_t hdr;
+
+    int res = _read(kvs, &hdr, addr, REC_HDR);
+    if (res < 0) {
+        return res;
+    }
+    if ((res = _read(kvs, buf, addr + REC_HDR, hdr.key_len)) < 0) {
+        return res;
+    }
+    return _index_update(kvs, (char *)buf, hdr.key_len, addr,
+                         hdr.flags & FLAG_DELETE);
+}
+
+/* checks the record at addr, returns 1 if valid, 0 if erased and -EILSEQ if
+ * damaged */
+static int _check(kvstore_t *kvs, uint32_t addr, uint32_t end, rec_hdr_t *hdr)
+{
+    static const uint8_t erased[REC_HDR] = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    };
+    int res = _read(kvs, hdr, addr, REC_HDR);
+
+    if (res < 0) {
+        return res;
+    }
+    if (memcmp(hdr, erased, REC_HDR) == 0) {
+        return 0;
+    }
+    if (((hdr->flags & FLAGS_MASK) != FLAGS_VALID) || (hdr->key_len == 0) ||
+        (hdr->key_len > KVSTORE_KEY_MAX) || (_rec_size(hdr) > end - addr)) {
+        return -EILSEQ;
+    }
+    uint16_t crc = crc16_ccitt_update(0, (const uint8_t *)hdr, CRC_LEN);
+    crc = _crc_flash(kvs, crc, addr + REC_HDR, hdr->key_len + hdr->val_len, &res);
+    if (res < 0) {
+        return res;
+    }
+    return (crc == hdr->crc) ? 1 : -EILSEQ;
+}
+
+/* replays the records of a sector, returns the offset after the last one */
+static int _scan(kvstore_t *kvs, uint32_t sector, uint32_t *offset)
+{
+    uint32_t base = _sector_addr(kvs, sector);
+    uint32_t end = base + kvs->sector_size;
+    uint32_t pending[KVSTORE_TXN_MAX];
+    unsigned npending = 0;
+    uint32_t addr = base + SECTOR_HDR;
+
+    while (addr + REC_HDR <= end) {
+        rec_hdr_t hdr;
+        int res = _check(kvs, addr, end, &hdr);
+        if (res == -EILSEQ) {
+            /* interrupted write, nothing may be appended behind it */
+            DEBUG("kvstore: damaged record at 0x%lx\n", (unsigned long)addr);
+            addr = end;
+            break;
+        }
+        if (res <= 0) {
+            if (res < 0) {
+                return res;
+            }
+            break;
+        }
+
+        if (npending && (hdr.txn != kvs->txn)) {
+            /* transaction without commit */
+            npending = 0;
+        }
+        kvs->txn = hdr.txn;
+        if (hdr.flags & FLAG_COMMIT) {
+            for (unsigned i = 0; i < npending; i++) {
+                if ((res = _index_apply(kvs, pending[i])) < 0) {
+                    return res;
+                }
+            }
+            npending = 0;
+            if ((res = _index_apply(kvs, addr)) < 0) {
+                return res;
+            }
+        }
+        else if (npending < KVSTORE_TXN_MAX) {
+            pending[npending++] = addr;
+        }
+        addr += _rec_size(&hdr);
+    }
+
+    *offset = addr - base;
+    return 0;
+}
+
+/* appends a record to the head, space must be reserved */
+static int _append(kvstore_t *kvs, uint8_t flags, const char *key, size_t key_len,
+                   const void *value, size_t val_len, uint32_t *addr)
+{
+    rec_hdr_t hdr = {
+        .flags = FLAGS_VALID | flags,
+        .key_len = key_len,
+        .val_len = val_len,
+        .txn = kvs->txn,
+    };
+    hdr.crc = crc16_ccitt_update(0, (const uint8_t *)&hdr, CRC_LEN);
+    hdr.crc = crc16_ccitt_update(hdr.crc, (const uint8_t *)key, key_len);
+    hdr.crc = crc16_ccitt_update(hdr.crc, value, val_len);
+
+    *addr = _sector_addr(kvs, kvs->head) + kvs->offset;
+    /* the header goes first, a damaged record is always recognizable */
+    int res = _program(kvs, &hdr, *addr, REC_HDR);
+    if ((res == 0) &&
+        ((res = _program(kvs, key, *addr + REC_HDR, key_len)) == 0)) {
+        res = _program(kvs, value, *addr + REC_HDR + key_len, val_len);
+    }
+    kvs->offset += _rec_size(&hdr);
+    return res;
+}
+
+/* copies a record to the head, space must be reserved */
+static int _copy(kvstore_t *kvs, uint32_t src, uint32_t *addr)
+{
+    rec_hdr_t hdr;
+    uint8_t buf[CHUNK_SIZE];
+    int res = _read(kvs, &hdr, src, REC_HDR);
+
+    if (res < 0) {
+        return res;
+    }
+    uint32_t len = hdr.key_len + hdr.val_len;
+    hdr.flags = FLAGS_VALID | FLAG_COMMIT;
+    hdr.txn = ++kvs->txn;
+    hdr.crc = crc16_ccitt_update(0, (const uint8_t *)&hdr, CRC_LEN);
+    hdr.crc = _crc_flash(kvs, hdr.crc, src + REC_HDR, len, &res);
+    if (res < 0) {
+        return res;
+    }
+
+    *addr = _sector_addr(kvs, kvs->head) + kvs->offset;
+    kvs->offset += _rec_size(&hdr);
+    if ((res = _program(kvs, &hdr, *addr, REC_HDR)) < 0) {
+        return res;
+    }
+    for (uint32_t off = REC_HDR; off < REC_HDR + len; off += sizeof(buf)) {
+        uint32_t n = REC_HDR + len - off;
+        if (n > sizeof(buf)) {
+            n = sizeof(buf);
+        }
+        if (((res = _read(kvs, buf, src + off, n)) < 0) ||
+            ((res = _program(kvs, buf, *addr + off, n)) < 0)) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+/* moves the live records of the oldest sector to the head and erases it,
+ * returns 1 on success and 0 if the head is the only sector in use */
+static int _compact(kvstore_t *kvs)
+{
+    uint32_t victim, seq;
+    int res = _find_next(kvs, 0, &victim, &seq);
+
+    if (res <= 0) {
+        return res;
+    }
+    if (victim == kvs->head) {
+        return 0;
+    }
+
+    uint32_t live = 0;
+    for (unsigned i = 0; i < kvs->index_size; i++) {
+        uint32_t addr = kvs->index[i].addr;
+        if ((addr != NO_ADDR) && (_sector_of(kvs, addr) == victim)) {
+            rec_hdr_t hdr;
+            if ((res = _read(kvs, &hdr, addr, REC_HDR)) < 0) {
+                return res;
+            }
+            live += _rec_size(&hdr);
+        }
+    }
+    DEBUG("kvstore: compact sector %lu, %lu bytes live\n",
+          (unsigned long)victim, (unsigned long)live);
+
+    if (kvs->offset + live > kvs->sector_size) {
+        /* take the reserve */
+        uint32_t sector;
+        res = _find_free(kvs, &sector);
+        if (res <= 0) {
+            return (res < 0) ? res : -ENOSPC;
+        }
+        if ((res = _activate(kvs, sector)) < 0) {
+            return res;
+        }
+    }
+
+    for (unsigned i = 0; i < kvs->index_size; i++) {
+        uint32_t addr = kvs->index[i].addr;
+        if ((addr != NO_ADDR) && (_sector_of(kvs, addr) == victim)) {
+            if ((res = _copy(kvs, addr, &kvs->index[i].addr)) < 0) {
+                kvs->offset = kvs->sector_size;
+                return res;
+            }
+        }
+    }
+
+    sector_hdr_t hdr;
+    if (((res = _read_sector_hdr(kvs, victim, &hdr)) < 0) ||
+        ((res = _format_sector(kvs, victim, hdr.erase_count + 1)) < 0)) {
+        return res;
+    }
+    return 1;
+}
+
+/* makes room for size bytes at the head */
+static int _reserve(kvstore_t *kvs, uint32_t size)
+{
+    if (size > kvs->sector_size - SECTOR_HDR) {
+        return -ENOSPC;
+    }
+
+    for (unsigned tries = 0; kvs->offset + size > kvs->sector_size; tries++) {
+        uint32_t sector;
+        int res;
+
+        if (tries > kvs->dev->sector_count) {
+            return -ENOSPC;
+        }
+        res = _find_free(kvs, &sector);
+        if (res > 1) {
+            res = _activate(kvs, sector);
+        }
+        else if (res >= 0) {
+            /* the last erased sector is the reserve for compaction */
+            res = _compact(kvs);
+            if (res == 0) {
+                return -ENOSPC;
+            }
+        }
+        if (res < 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+static int _commit(kvstore_t *kvs, const kvstore_op_t *ops, unsigned n)
+{
+    uint32_t addrs[KVSTORE_TXN_MAX];
+    uint32_t total = 0;
+    unsigned added = 0;
+    int res;
+
+    if (n > KVSTORE_TXN_MAX) {
+        return -EINVAL;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        size_t key_len = strlen(ops[i].key);
+        size_t val_len = ops[i].value ? ops[i].len : 0;
+        if ((key_len == 0) || (key_len > KVSTORE_KEY_MAX) ||
+            (val_len > UINT16_MAX)) {
+            return -EINVAL;
+        }
+        total += _align(REC_HDR + key_len + val_len);
+
+        if (ops[i].value) {
+            unsigned slot;
+            res = _index_find(kvs, ops[i].key, key_len,
+                              _hash(ops[i].key, key_len), &slot);
+            if (res < 0) {
+                return res;
+            }
+            added += !res;
+        }
+    }
+    if (kvs->keys + added >= kvs->index_size) {
+        return -ENOMEM;
+    }
+    if ((res = _reserve(kvs, total)) < 0) {
+        return res;
+    }
+
+    kvs->txn++;
+    for (unsigned i = 0; i < n; i++) {
+        uint8_t flags = (i == n - 1) ? FLAG_COMMIT : 0;
+        if (!ops[i].value) {
+            flags |= FLAG_DELETE;
+        }
+        res = _append(kvs, flags, ops[i].key, strlen(ops[i].key),
+                      ops[i].value, ops[i].value ? ops[i].len : 0, &addrs[i]);
+        if (res < 0) {
+            kvs->offset = kvs->sector_size;
+            return res;
+        }
+    }
+
+    for (unsigned i = 0; i < n; i++) {
+        res = _index_update(kvs, ops[i].key, strlen(ops[i].key), addrs[i],
+                            !ops[i].value);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+/* rebuilds the index from the log, oldest sector first */
+static int _replay(kvstore_t *kvs)
+{
+    uint32_t sector, seq = 0;
+    int res;
+
+    for (unsigned i = 0; i < kvs->index_size; i++) {
+        kvs->index[i].addr = NO_ADDR;
+    }
+    kvs->keys = 0;
+    kvs->txn = 0;
+    kvs->seq = 0;
+
+    while ((res = _find_next(kvs, seq, &sector, &seq)) > 0) {
+        kvs->head = sector;
+        kvs->seq = seq;
+        if ((res = _scan(kvs, sector, &kvs->offset)) < 0) {
+            return res;
+        }
+    }
+    return res;
+}
+
+int kvstore_format(kvstore_t *kvs)
+{
+    int res = mtd_init(kvs->dev);
+
+    if (res < 0) {
+        return res;
+    }
+    _geometry(kvs);
+    for (uint32_t i = 0; i < kvs->dev->sector_count; i++) {
+        sector_hdr_t hdr;
+        if ((res = _read_sector_hdr(kvs, i, &hdr)) < 0) {
+            return res;
+        }
+        uint32_t erase_count = (hdr.magic == MAGIC) ? hdr.erase_count + 1 : 0;
+        if ((res = _format_sector(kvs, i, erase_count)) < 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+int kvstore_mount(kvstore_t *kvs)
+{
+    uint32_t max_erase_count = 0;
+    bool formatted = false;
+    int res = mtd_init(kvs->dev);
+
+    if (res < 0) {
+        return res;
+    }
+    mutex_init(&kvs->lock);
+    _geometry(kvs);
+
+    for (uint32_t i = 0; i < kvs->dev->sector_count; i++) {
+        sector_hdr_t hdr;
+        if ((res = _read_sector_hdr(kvs, i, &hdr)) < 0) {
+            return res;
+        }
+        if (hdr.magic == MAGIC) {
+            formatted = true;
+            if (hdr.erase_count > max_erase_count) {
+                max_erase_count = hdr.erase_count;
+            }
+        }
+    }
+    if (!formatted) {
+        return -ENODEV;
+    }
+    /* repair interrupted erases and activations */
+    for (uint32_t i = 0; i < kvs->dev->sector_count; i++) {
+        sector_hdr_t hdr;
+        if ((res = _read_sector_hdr(kvs, i, &hdr)) < 0) {
+            return res;
+        }
+        if (hdr.magic != MAGIC) {
+            res = _format_sector(kvs, i, max_erase_count);
+        }
+        else if (!_is_free(&hdr) && !_is_used(&hdr)) {
+            res = _format_sector(kvs, i, hdr.erase_count + 1);
+        }
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    if ((res = _replay(kvs)) < 0) {
+        return res;
+    }
+
+    uint32_t sector, seq;
+    if (kvs->seq == 0) {
+        /* empty log */
+        res = _find_free(kvs, &sector);
+        if (res <= 0) {
+            return (res < 0) ? res : -ENOSPC;
+        }
+        return _activate(kvs, sector);
+    }
+    if ((res = _find_free(kvs, &sector)) == 0) {
+        /* Compaction was interrupted after it took the reserve, which may
+         * end in a torn copy and leave no room to finish. The head holds
+         * only copies of records of the oldest sector, which is still
+         * intact: drop the head, the next write compacts again. */
+        sector_hdr_t hdr;
+        if (((res = _find_next(kvs, 0, &sector, &seq)) <= 0) ||
+            (sector == kvs->head)) {
+            return (res < 0) ? res : -ENOSPC;
+        }
+        DEBUG("kvstore: drop interrupted compaction in sector %lu\n",
+              (unsigned long)kvs->head);
+        if (((res = _read_sector_hdr(kvs, kvs->head, &hdr)) < 0) ||
+            ((res = _format_sector(kvs, kvs->head, hdr.erase_count + 1)) < 0)) {
+            return res;
+        }
+        res = _replay(kvs);
+    }
+    return (res < 0) ? res : 0;
+}
+
+ssize_t kvstore_get(kvstore_t *kvs, const char *key, void *value, size_t len)
+{
+    size_t key_len = strlen(key);
+    unsigned slot;
+    rec_hdr_t hdr;
+
+    if ((key_len == 0) || (key_len > KVSTORE_KEY_MAX)) {
+        return -EINVAL;
+    }
+
+    mutex_lock(&kvs->lock);
+    int res = _index_find(kvs, key, key_len, _hash(key, key_len), &slot);
+    if (res == 0) {
+        res = -ENOENT;
+    }
+    else if (res > 0) {
+        uint32_t addr = kvs->index[slot].addr;
+        if ((res = _read(kvs, &hdr, addr, REC_HDR)) == 0) {
+            if (len > hdr.val_len) {
+                len = hdr.val_len;
+            }
+            if ((res = _read(kvs, value, addr + REC_HDR + key_len, len)) == 0) {
+                res = hdr.val_len;
+            }
+        }
+    }
+    mutex_unlock(&kvs->lock);
+
+    return res;
+}
+
+int kvstore_set(kvstore_t *kvs, const char *key, const void *value, size_t len)
+{
+    kvstore_op_t op = { .key = key, .value = value, .len = len };
+
+    if (!value) {
+        /* NULL would delete */
+        op.value = "";
+        op.len = 0;
+    }
+    return kvstore_commit(kvs, &op, 1);
+}
+
+int kvstore_delete(kvstore_t *kvs, const char *key)
+{
+    kvstore_op_t op = { .key = key };
+    size_t key_len = strlen(key);
+    unsigned slot;
+
+    if ((key_len == 0) || (key_len > KVSTORE_KEY_MAX)) {
+        return -EINVAL;
+    }
+
+    mutex_lock(&kvs->lock);
+    int res = _index_find(kvs, key, key_len, _hash(key, key_len), &slot);
+    if (res == 0) {
+        res = -ENOENT;
+    }
+    if (res > 0) {
+        res = _commit(kvs, &op, 1);
+    }
+    mutex_unlock(&kvs->lock);
+
+    return res;
+}
+
+int kvstore_commit(kvstore_t *kvs, const kvstore_op_t *ops, unsigned n)
+{
+    mutex_lock(&kvs->lock);
+    int res = _commit(kvs, ops, n);
+    mutex_unlock(&kvs->lock);
+
+    return res;
+}
+
+int kvstore_compact(kvstore_t *kvs)
+{
+    uint32_t sector;
+
+    mutex_lock(&kvs->lock);
+    int res = _find_free(kvs, &sector);
+    if ((res >= 0) && ((unsigned)res < KVSTORE_COMPACT_FREE)) {
+        res = _compact(kvs);
+    }
+    else if (res > 0) {
+        res = 0;
+    }
+    mutex_unlock(&kvs->lock);
+
+    return res;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_mempool
+ * @{
+ *
+ * @file
+ * @brief       Fixed-size block pool implementation
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "irq.h"
+#include "mempool.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static mempool_t *_pools;
+
+/* called with interrupts disabled */
+static void _list(mempool_t *pool)
+{
+    for (mempool_t *p = _pools; p != NULL; p = p->next) {
+        if (p == pool) {
+            pool->listed = true;
+            return;
+        }
+    }
+    pool->next = _pools;
+    _pools = pool;
+    pool->listed = true;
+}
+
+void mempool_init(mempool_t *pool, const char *name, void *buf,
+                  size_t block_size, unsigned num)
+{
+    assert((block_size >= sizeof(void *)) &&
+           ((block_size % sizeof(void *)) == 0));
+    assert(((uintptr_t)buf % sizeof(void *)) == 0);
+
+    unsigned state = irq_disable();
+    pool->name = name;
+    pool->free = NULL;
+    pool->unused = buf;
+    pool->end = pool->unused + (block_size * num);
+    pool->block_size = block_size;
+    pool->num = num;
+    pool->used = 0;
+    pool->high_water = 0;
+    pool->failed = 0;
+    _list(pool);
+    irq_restore(state);
+}
+
+void *mempool_alloc(mempool_t *pool)
+{
+    void *block;
+
+    if (!pool->listed) {
+        /* pool was set up with MEMPOOL_INIT(), register it on the first
+         * attempt so pools that never succeed still show up in ps */
+        unsigned state = irq_disable();
+        if (!pool->listed) {
+            _list(pool);
+        }
+        irq_restore(state);
+    }
+
+    if (pool->free != NULL) {
+        block = pool->free;
+        pool->free = *((void **)block);
+    }
+    else if (pool->unused < pool->end) {
+        block = pool->unused;
+        pool->unused += pool->block_size;
+    }
+    else {
+        pool->failed++;
+        DEBUG("mempool: %s exhausted\n", pool->name ? pool->name : "?");
+        return NULL;
+    }
+
+    if (++pool->used > pool->high_water) {
+        pool->high_water = pool->used;
+    }
+    return block;
+}
+
+void mempool_free(mempool_t *pool, void *block)
+{
+    if (block == NULL) {
+        return;
+    }
+    assert(mempool_contains(pool, block));
+    assert(pool->used > 0);
+
+    *((void **)block) = pool->free;
+    pool->free = block;
+    pool->used--;
+}
+
+void *mempool_alloc_irq(mempool_t *pool)
+{
+    unsigned state = irq_disable();
+    void *block = mempool_alloc(pool);
+    irq_restore(state);
+    return block;
+}
+
+void mempool_free_irq(mempool_t *pool, void *block)
+{
+    unsigned state = irq_disable();
+    mempool_free(pool, block);
+    irq_restore(state);
+}
+
+void mempool_print_all(void)
+{
+    printf("%-16s %6s %5s %5s %5s %6s\n",
+           "pool", "bsize", "num", "used", "max", "failed");
+    for (mempool_t *pool = _pools; pool != NULL; pool = pool->next) {
+        printf("%-16s %6u %5u %5u %5u %6u\n",
+               pool->name ? pool->name : "-", (unsigned)pool->block_size,
+               pool->num, pool->used, pool->high_water, pool->failed);
+    }
+}
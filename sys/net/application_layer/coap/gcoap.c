@@ -22,6 +22,7 @@
 #include "net/gcoap.h"
 #include "random.h"
 #include "thread.h"
+#include "thread_flags.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -85,23 +86,27 @@ static void *_event_loop(void *arg)
         return 0;
     }
 
-    while(1) {
-        res = msg_try_receive(&msg_rcvd);
+    mbox_t *mbox = &_sock.reg.mbox;
 
-        if (res > 0) {
-            switch (msg_rcvd.type) {
-                case GCOAP_MSG_TYPE_TIMEOUT:
-                    _expire_request((gcoap_request_memo_t *)msg_rcvd.content.ptr);
-                    break;
-                case GCOAP_MSG_TYPE_INTR:
-                    /* next _listen() timeout will account for open requests */
-                    break;
-                default:
-                    break;
+    while(1) {
+        /* sleep until a response timeout or a CoAP message arrives */
+        thread_flags_t mask = THREAD_FLAG_MSG_WAITING;
+        res = thread_flags_wait_ready(&mask, &mbox, 1);
+
+        if (res == THREAD_FLAGS_READY_MSG) {
+            if (msg_try_receive(&msg_rcvd) > 0) {
+                switch (msg_rcvd.type) {
+                    case GCOAP_MSG_TYPE_TIMEOUT:
+                        _expire_request((gcoap_request_memo_t *)msg_rcvd.content.ptr);
+                        break;
+                    default:
+                        break;
+                }
             }
         }
-
-        _listen(&_sock);
+        else {
+            _listen(&_sock);
+        }
     }
 
     return 0;
@@ -114,14 +119,12 @@ static void _listen(sock_udp_t *sock)
     uint8_t buf[GCOAP_PDU_BUF_SIZE];
     sock_udp_ep_t remote;
     gcoap_request_memo_t *memo = NULL;
-    uint8_t open_reqs = gcoap_op_state();
 
-    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf),
-                                open_reqs > 0 ? GCOAP_RECV_TIMEOUT : SOCK_NO_TIMEOUT,
-                                &remote);
+    /* only called when the sock's mbox holds a message, so don't block */
+    ssize_t res = sock_udp_recv(sock, buf, sizeof(buf), 0, &remote);
     if (res <= 0) {
 #if ENABLE_DEBUG
-        if (res < 0 && res != -ETIMEDOUT) {
+        if (res < 0 && res != -EAGAIN) {
             DEBUG("gcoap: udp recv failure: %d\n", res);
         }
 #endif
@@ -714,21 +717,12 @@ size_t gcoap_req_send2(const uint8_t *buf, size_t len,
         size_t res = sock_udp_send(&_sock, buf, len, remote);
 
         if (res && (GCOAP_NON_TIMEOUT > 0)) {
-            /* interrupt sock listening (to set a listen timeout) */
-            msg_t mbox_msg;
-            mbox_msg.type          = GCOAP_MSG_TYPE_INTR;
-            mbox_msg.content.value = 0;
-            if (mbox_try_put(&_sock.reg.mbox, &mbox_msg)) {
-                /* start response wait timer */
-                memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
-                memo->timeout_msg.content.ptr = (char *)memo;
-                xtimer_set_msg(&memo->response_timer, GCOAP_NON_TIMEOUT,
-                                                      &memo->timeout_msg, _pid);
-            }
-            else {
-                memo->state = GCOAP_MEMO_UNUSED;
-                DEBUG("gcoap: can't wake up mbox; no timeout for msg\n");
-            }
+            /* start response wait timer, its message wakes up the event
+             * loop directly */
+            memo->timeout_msg.type        = GCOAP_MSG_TYPE_TIMEOUT;
+            memo->timeout_msg.content.ptr = (char *)memo;
+            xtimer_set_msg(&memo->response_timer, GCOAP_NON_TIMEOUT,
+                                                  &memo->timeout_msg, _pid);
         }
         else if (!res) {
             memo->state = GCOAP_MEMO_UNUSED;
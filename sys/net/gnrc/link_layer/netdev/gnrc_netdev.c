@@ -19,6 +19,7 @@
  */
 
 #include <errno.h>
+#include <string.h>
 
 #include "msg.h"
 #include "thread.h"
@@ -29,6 +30,9 @@
 
 #include "net/gnrc/netdev.h"
 #include "net/ethernet/hdr.h"
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+#include "net/gnrc/ipv6/nc.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -41,6 +45,31 @@
 
 static void _pass_on_packet(gnrc_pktsnip_t *pkt);
 
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+static void _etx_update(gnrc_netdev_t *gnrc_netdev, bool acked)
+{
+    if (gnrc_netdev->tx_dst_len > 0) {
+        gnrc_ipv6_nc_etx_update(gnrc_netdev->pid, gnrc_netdev->tx_dst,
+                                gnrc_netdev->tx_dst_len, acked);
+    }
+}
+
+static void _etx_set_dst(gnrc_netdev_t *gnrc_netdev, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *hdr = pkt->data;
+
+    if ((pkt->type != GNRC_NETTYPE_NETIF) ||
+        (hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) ||
+        (hdr->dst_l2addr_len > sizeof(gnrc_netdev->tx_dst))) {
+        /* no acknowledgement expected */
+        gnrc_netdev->tx_dst_len = 0;
+        return;
+    }
+    memcpy(gnrc_netdev->tx_dst, gnrc_netif_hdr_get_dst_addr(hdr), hdr->dst_l2addr_len);
+    gnrc_netdev->tx_dst_len = hdr->dst_l2addr_len;
+}
+#endif
+
 /**
  * @brief   Function called by the device driver on device events
  *
@@ -77,8 +106,20 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
             case NETDEV_EVENT_TX_MEDIUM_BUSY:
                 dev->stats.tx_failed++;
                 break;
+#endif
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_GNRC_IPV6_NC_ETX)
             case NETDEV_EVENT_TX_COMPLETE:
+#ifdef MODULE_NETSTATS_L2
                 dev->stats.tx_success++;
+#endif
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+                _etx_update(gnrc_netdev, true);
+#endif
+                break;
+#endif
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+            case NETDEV_EVENT_TX_NOACK:
+                _etx_update(gnrc_netdev, false);
                 break;
 #endif
             default:
@@ -143,6 +184,9 @@ static void *_gnrc_netdev_thread(void *args)
             case GNRC_NETAPI_MSG_TYPE_SND:
                 DEBUG("gnrc_netdev: GNRC_NETAPI_MSG_TYPE_SND received\n");
                 gnrc_pktsnip_t *pkt = msg.content.ptr;
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+                _etx_set_dst(gnrc_netdev, pkt);
+#endif
                 gnrc_netdev->send(gnrc_netdev, pkt);
                 break;
             case GNRC_NETAPI_MSG_TYPE_SET:
@@ -29,7 +29,7 @@
 #include "net/gnrc.h"
 #include "periph/uart.h"
 #include "od.h"
-#include "ringbuffer.h"
+#include "tsrb.h"
 #include "thread.h"
 #include "net/ipv6/hdr.h"
 
@@ -49,35 +49,55 @@
 
 #define _SLIP_DEV(arg)    ((gnrc_slip_dev_t *)arg)
 
+/* add a byte to the packet currently received, it is only made visible to
+ * the SLIP thread once the packet is complete */
+static void _slip_rx_add(gnrc_slip_dev_t *dev, char c)
+{
+    char *pos;
+
+    if (dev->in_drop) {
+        return;
+    }
+    if (tsrb_reserve(&dev->in_buf, dev->in_bytes, &pos)) {
+        *pos = c;
+        dev->in_bytes++;
+    }
+    else {
+        DEBUG("slip: RX buffer full, dropping packet\n");
+        dev->in_drop = 1;
+    }
+}
+
 /* UART callbacks */
 static void _slip_rx_cb(void *arg, uint8_t data)
 {
     if (data == (uint8_t)_SLIP_END) {
-        msg_t msg;
+        if (!_SLIP_DEV(arg)->in_drop && _SLIP_DEV(arg)->in_bytes) {
+            msg_t msg;
 
-        msg.type = _SLIP_MSG_TYPE;
-        msg.content.value = _SLIP_DEV(arg)->in_bytes;
+            msg.type = _SLIP_MSG_TYPE;
+            msg.content.value = _SLIP_DEV(arg)->in_bytes;
 
-        msg_send_int(&msg, _SLIP_DEV(arg)->slip_pid);
+            /* the SLIP thread runs only after this ISR, so committing after
+             * the message was queued is fine */
+            if (msg_send_int(&msg, _SLIP_DEV(arg)->slip_pid) > 0) {
+                tsrb_commit(&_SLIP_DEV(arg)->in_buf, _SLIP_DEV(arg)->in_bytes);
+            }
+        }
 
         _SLIP_DEV(arg)->in_bytes = 0;
+        _SLIP_DEV(arg)->in_drop = 0;
     }
     else if (_SLIP_DEV(arg)->in_esc) {
         _SLIP_DEV(arg)->in_esc = 0;
 
         switch (data) {
             case ((uint8_t)_SLIP_END_ESC):
-                if (ringbuffer_add_one(&_SLIP_DEV(arg)->in_buf, _SLIP_END) < 0) {
-                    _SLIP_DEV(arg)->in_bytes++;
-                }
-
+                _slip_rx_add(_SLIP_DEV(arg), _SLIP_END);
                 break;
 
             case ((uint8_t)_SLIP_ESC_ESC):
-                if (ringbuffer_add_one(&_SLIP_DEV(arg)->in_buf, _SLIP_ESC) < 0) {
-                    _SLIP_DEV(arg)->in_bytes++;
-                }
-
+                _slip_rx_add(_SLIP_DEV(arg), _SLIP_ESC);
                 break;
 
             default:
@@ -88,9 +108,7 @@ static void _slip_rx_cb(void *arg, uint8_t data)
         _SLIP_DEV(arg)->in_esc = 1;
     }
     else {
-        if (ringbuffer_add_one(&_SLIP_DEV(arg)->in_buf, data) < 0) {
-            _SLIP_DEV(arg)->in_bytes++;
-        }
+        _slip_rx_add(_SLIP_DEV(arg), data);
     }
 }
 
@@ -102,6 +120,7 @@ static void _slip_receive(gnrc_slip_dev_t *dev, size_t bytes)
     hdr = gnrc_netif_hdr_build(NULL, 0, NULL, 0);
     if (hdr == NULL) {
         DEBUG("slip: no space left in packet buffer\n");
+        tsrb_drop(&dev->in_buf, bytes);
         return;
     }
 
@@ -112,10 +131,11 @@ static void _slip_receive(gnrc_slip_dev_t *dev, size_t bytes)
     if (pkt == NULL) {
         DEBUG("slip: no space left in packet buffer\n");
         gnrc_pktbuf_release(hdr);
+        tsrb_drop(&dev->in_buf, bytes);
         return;
     }
 
-    if (ringbuffer_get(&dev->in_buf, pkt->data, bytes) != bytes) {
+    if (tsrb_get(&dev->in_buf, pkt->data, bytes) != (int)bytes) {
         DEBUG("slip: could not read %u bytes from ringbuffer\n", (unsigned)bytes);
         gnrc_pktbuf_release(pkt);
         return;
@@ -251,10 +271,11 @@ kernel_pid_t gnrc_slip_init(gnrc_slip_dev_t *dev, uart_t uart, uint32_t baudrate
     dev->uart = uart;
     dev->in_bytes = 0;
     dev->in_esc = 0;
+    dev->in_drop = 0;
     dev->slip_pid = KERNEL_PID_UNDEF;
 
     /* initialize buffers */
-    ringbuffer_init(&dev->in_buf, dev->rx_mem, sizeof(dev->rx_mem));
+    tsrb_init(&dev->in_buf, dev->rx_mem, sizeof(dev->rx_mem));
 
     /* initialize UART */
     DEBUG("slip: initialize UART_%d with baudrate %" PRIu32 "\n", uart,
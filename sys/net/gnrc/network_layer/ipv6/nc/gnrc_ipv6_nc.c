@@ -86,6 +86,9 @@ void gnrc_ipv6_nc_init(void)
         _nc_remove(entry->iface, entry);
     }
     memset(ncache, 0, sizeof(ncache));
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+    gnrc_ipv6_nc_etx_init();
+#endif
 }
 
 gnrc_ipv6_nc_t *_find_free_entry(void)
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <string.h>
+
+#include "mutex.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/ieee802154.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+
+typedef struct {
+    uint8_t l2_addr[GNRC_IPV6_NC_L2_ADDR_MAX];  /**< link layer address */
+    kernel_pid_t iface;                         /**< interface of the neighbor */
+    uint8_t l2_addr_len;                        /**< length of l2_addr, 0 if unused */
+    uint16_t etx;                               /**< the estimate */
+    uint16_t updated;                           /**< _clock at the last update */
+} _etx_t;
+
+static _etx_t _etx[GNRC_IPV6_NC_ETX_NUMOF];
+static uint16_t _clock;
+/* updated by the interface threads, read by e.g. RPL */
+static mutex_t _lock = MUTEX_INIT;
+
+static _etx_t *_find(kernel_pid_t iface, const uint8_t *l2_addr, size_t l2_addr_len)
+{
+    for (unsigned i = 0; i < GNRC_IPV6_NC_ETX_NUMOF; i++) {
+        if ((_etx[i].l2_addr_len == l2_addr_len) &&
+            ((iface == KERNEL_PID_UNDEF) || (_etx[i].iface == iface)) &&
+            (memcmp(_etx[i].l2_addr, l2_addr, l2_addr_len) == 0)) {
+            return &_etx[i];
+        }
+    }
+    return NULL;
+}
+
+/* the unused entry or else the one updated least recently */
+static _etx_t *_oldest(void)
+{
+    _etx_t *oldest = &_etx[0];
+
+    for (unsigned i = 0; i < GNRC_IPV6_NC_ETX_NUMOF; i++) {
+        if (_etx[i].l2_addr_len == 0) {
+            return &_etx[i];
+        }
+        if ((uint16_t)(_clock - _etx[i].updated) >
+            (uint16_t)(_clock - oldest->updated)) {
+            oldest = &_etx[i];
+        }
+    }
+    return oldest;
+}
+
+void gnrc_ipv6_nc_etx_init(void)
+{
+    mutex_lock(&_lock);
+    memset(_etx, 0, sizeof(_etx));
+    _clock = 0;
+    mutex_unlock(&_lock);
+}
+
+uint16_t gnrc_ipv6_nc_etx_update(kernel_pid_t iface, const uint8_t *l2_addr,
+                                 size_t l2_addr_len, bool acked)
+{
+    uint16_t sample = acked ? GNRC_IPV6_NC_ETX_DIVISOR : GNRC_IPV6_NC_ETX_NOACK;
+    _etx_t *entry;
+    uint16_t etx;
+
+    if ((l2_addr_len == 0) || (l2_addr_len > GNRC_IPV6_NC_L2_ADDR_MAX)) {
+        return 0;
+    }
+
+    mutex_lock(&_lock);
+    if ((entry = _find(iface, l2_addr, l2_addr_len)) == NULL) {
+        entry = _oldest();
+        memcpy(entry->l2_addr, l2_addr, l2_addr_len);
+        entry->l2_addr_len = l2_addr_len;
+        entry->iface = iface;
+        entry->etx = GNRC_IPV6_NC_ETX_INIT;
+    }
+    entry->etx = entry->etx - (entry->etx >> GNRC_IPV6_NC_ETX_SHIFT) +
+                 (sample >> GNRC_IPV6_NC_ETX_SHIFT);
+    entry->updated = ++_clock;
+    etx = entry->etx;
+    mutex_unlock(&_lock);
+
+    DEBUG("ipv6_nc: ETX of neighbor %u on interface %d is %u/%u\n",
+          (unsigned)(entry - _etx), (int)iface, (unsigned)etx,
+          GNRC_IPV6_NC_ETX_DIVISOR);
+    return etx;
+}
+
+uint16_t gnrc_ipv6_nc_get_etx(kernel_pid_t iface, const ipv6_addr_t *ipv6_addr)
+{
+    uint16_t etx = GNRC_IPV6_NC_ETX_INIT;
+    _etx_t *entry = NULL;
+
+    mutex_lock(&_lock);
+    /* neighbors using link-local addresses only, e.g. RPL parents, are not
+     * necessarily known to neighbor discovery */
+    for (unsigned i = 0; i < GNRC_IPV6_NC_ETX_NUMOF; i++) {
+        eui64_t iid;
+
+        if ((_etx[i].l2_addr_len > 0) &&
+            ((iface == KERNEL_PID_UNDEF) || (_etx[i].iface == iface)) &&
+            (ieee802154_get_iid(&iid, _etx[i].l2_addr, _etx[i].l2_addr_len) != NULL) &&
+            (iid.uint64.u64 == ipv6_addr->u64[1].u64)) {
+            entry = &_etx[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        gnrc_ipv6_nc_t *nc = gnrc_ipv6_nc_get(iface, ipv6_addr);
+
+        if ((nc != NULL) && (nc->l2_addr_len > 0)) {
+            entry = _find(nc->iface, nc->l2_addr, nc->l2_addr_len);
+        }
+    }
+    if (entry != NULL) {
+        etx = entry->etx;
+    }
+    mutex_unlock(&_lock);
+    return etx;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GNRC_IPV6_NC_ETX */
+
+/** @} */
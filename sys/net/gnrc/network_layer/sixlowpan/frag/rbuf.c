@@ -24,6 +24,7 @@
 #include "net/sixlowpan.h"
 #include "thread.h"
 #include "xtimer.h"
+#include "mempool.h"
 #include "utlist.h"
 
 #define ENABLE_DEBUG    (0)
@@ -43,6 +44,7 @@
 #endif
 
 static rbuf_int_t rbuf_int[RBUF_INT_SIZE];
+static mempool_t rbuf_int_pool = MEMPOOL_INIT("6lo_rbuf_int", rbuf_int);
 
 static rbuf_t rbuf[RBUF_SIZE];
 
@@ -198,13 +200,7 @@ static inline bool _rbuf_int_overlap_partially(rbuf_int_t *i, uint16_t start, ui
 
 static rbuf_int_t *_rbuf_int_get_free(void)
 {
-    for (unsigned int i = 0; i < RBUF_INT_SIZE; i++) {
-        if (rbuf_int[i].end == 0) { /* start must be smaller than end anyways*/
-            return rbuf_int + i;
-        }
-    }
-
-    return NULL;
+    return mempool_alloc(&rbuf_int_pool);
 }
 
 static void _rbuf_rem(rbuf_t *entry)
@@ -212,9 +208,7 @@ static void _rbuf_rem(rbuf_t *entry)
     while (entry->ints != NULL) {
         rbuf_int_t *next = entry->ints->next;
 
-        entry->ints->start = 0;
-        entry->ints->end = 0;
-        entry->ints->next = NULL;
+        mempool_free(&rbuf_int_pool, entry->ints);
         entry->ints = next;
     }
 
@@ -32,9 +32,11 @@
 static char _stack[GNRC_RPL_STACK_SIZE];
 kernel_pid_t gnrc_rpl_pid = KERNEL_PID_UNDEF;
 const ipv6_addr_t ipv6_addr_all_rpl_nodes = GNRC_RPL_ALL_NODES_ADDR;
+#ifdef MODULE_GNRC_RPL_P2P
 static uint32_t _lt_time = GNRC_RPL_LIFETIME_UPDATE_STEP * US_PER_SEC;
 static xtimer_t _lt_timer;
 static msg_t _lt_msg = { .type = GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE };
+#endif
 static msg_t _msg_q[GNRC_RPL_MSG_QUEUE_SIZE];
 static gnrc_netreg_entry_t _me_reg;
 static mutex_t _inst_id_mutex = MUTEX_INIT;
@@ -42,12 +44,26 @@ static uint8_t _instance_id;
 
 gnrc_rpl_instance_t gnrc_rpl_instances[GNRC_RPL_INSTANCES_NUMOF];
 gnrc_rpl_parent_t gnrc_rpl_parents[GNRC_RPL_PARENTS_NUMOF];
+evtimer_msg_t gnrc_rpl_evtimer;
 
 #ifdef MODULE_NETSTATS_RPL
 netstats_rpl_t gnrc_rpl_netstats;
+static uint32_t _timer_start;
 #endif
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+static gnrc_rpl_sr_node_t _sr_nodes[GNRC_RPL_SR_TABLE_NUMOF];
+gnrc_rpl_sr_table_t gnrc_rpl_sr_table;
+static evtimer_msg_event_t _sr_event;
+static uint32_t _sr_expires;
+static void _sr_timeout(void);
+#endif
+
+#ifdef MODULE_GNRC_RPL_P2P
 static void _update_lifetime(void);
+#endif
+static void _parent_timeout(gnrc_rpl_parent_t *parent);
+static void _instance_cleanup(gnrc_rpl_instance_t *inst);
 static void _dao_handle_send(gnrc_rpl_dodag_t *dodag);
 static void _receive(gnrc_pktsnip_t *pkt);
 static void *_event_loop(void *args);
@@ -57,6 +73,7 @@ kernel_pid_t gnrc_rpl_init(kernel_pid_t if_pid)
     /* check if RPL was initialized before */
     if (gnrc_rpl_pid == KERNEL_PID_UNDEF) {
         _instance_id = 0;
+        evtimer_init_msg(&gnrc_rpl_evtimer);
         /* start the event loop */
         gnrc_rpl_pid = thread_create(_stack, sizeof(_stack), GNRC_RPL_PRIO,
                                      THREAD_CREATE_STACKTEST,
@@ -73,10 +90,13 @@ kernel_pid_t gnrc_rpl_init(kernel_pid_t if_pid)
         gnrc_netreg_register(GNRC_NETTYPE_ICMPV6, &_me_reg);
 
         gnrc_rpl_of_manager_init();
+#ifdef MODULE_GNRC_RPL_P2P
         xtimer_set_msg(&_lt_timer, _lt_time, &_lt_msg, gnrc_rpl_pid);
+#endif
 
 #ifdef MODULE_NETSTATS_RPL
         memset(&gnrc_rpl_netstats, 0, sizeof(gnrc_rpl_netstats));
+        _timer_start = gnrc_rpl_now();
 #endif
     }
 
@@ -119,6 +139,12 @@ gnrc_rpl_instance_t *gnrc_rpl_root_init(uint8_t instance_id, ipv6_addr_t *dodag_
 #ifndef GNRC_RPL_WITHOUT_PIO
     dodag->dio_opts |= GNRC_RPL_REQ_DIO_OPT_PREFIX_INFO;
 #endif
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        gnrc_rpl_sr_table_init(&gnrc_rpl_sr_table, _sr_nodes, GNRC_RPL_SR_TABLE_NUMOF,
+                               dodag_id);
+    }
+#endif
 
     trickle_start(gnrc_rpl_pid, &dodag->trickle, GNRC_RPL_MSG_TYPE_TRICKLE_MSG,
                   (1 << dodag->dio_min), dodag->dio_interval_doubl,
@@ -195,6 +221,19 @@ static void _receive(gnrc_pktsnip_t *icmpv6)
     gnrc_pktbuf_release(icmpv6);
 }
 
+static inline void _count_wakeup(void)
+{
+#ifdef MODULE_NETSTATS_RPL
+    /* an update every GNRC_RPL_LIFETIME_UPDATE_STEP would have woken up the
+     * thread this often */
+    uint32_t steps = (gnrc_rpl_now() - _timer_start) / GNRC_RPL_LIFETIME_UPDATE_STEP;
+
+    gnrc_rpl_netstats.timer_wakeups++;
+    gnrc_rpl_netstats.timer_wakeups_saved = (steps > gnrc_rpl_netstats.timer_wakeups) ?
+                                            (steps - gnrc_rpl_netstats.timer_wakeups) : 0;
+#endif
+}
+
 static void *_event_loop(void *args)
 {
     msg_t msg, reply;
@@ -212,10 +251,35 @@ static void *_event_loop(void *args)
         msg_receive(&msg);
 
         switch (msg.type) {
+#ifdef MODULE_GNRC_RPL_P2P
             case GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE:
                 DEBUG("RPL: GNRC_RPL_MSG_TYPE_LIFETIME_UPDATE received\n");
+                _count_wakeup();
                 _update_lifetime();
                 break;
+#endif
+            case GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT:
+                DEBUG("RPL: GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT received\n");
+                _count_wakeup();
+                _parent_timeout(msg.content.ptr);
+                break;
+            case GNRC_RPL_MSG_TYPE_DAO_HANDLE:
+                DEBUG("RPL: GNRC_RPL_MSG_TYPE_DAO_HANDLE received\n");
+                _count_wakeup();
+                _dao_handle_send(msg.content.ptr);
+                break;
+            case GNRC_RPL_MSG_TYPE_INSTANCE_CLEANUP:
+                DEBUG("RPL: GNRC_RPL_MSG_TYPE_INSTANCE_CLEANUP received\n");
+                _count_wakeup();
+                _instance_cleanup(msg.content.ptr);
+                break;
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+            case GNRC_RPL_MSG_TYPE_SR_TABLE_TIMEOUT:
+                DEBUG("RPL: GNRC_RPL_MSG_TYPE_SR_TABLE_TIMEOUT received\n");
+                _count_wakeup();
+                _sr_timeout();
+                break;
+#endif
             case GNRC_RPL_MSG_TYPE_TRICKLE_MSG:
                 DEBUG("RPL: GNRC_RPL_MSG_TYPE_TRICKLE_MSG received\n");
                 trickle = msg.content.ptr;
@@ -243,73 +307,117 @@ static void *_event_loop(void *args)
     return NULL;
 }
 
+void gnrc_rpl_evtimer_set(evtimer_msg_event_t *event, uint16_t type, void *ptr,
+                          uint32_t offset)
+{
+    evtimer_del(&gnrc_rpl_evtimer, &event->event);
+    event->event.offset = offset;
+    event->msg.type = type;
+    event->msg.content.ptr = ptr;
+    evtimer_add_msg(&gnrc_rpl_evtimer, event, gnrc_rpl_pid);
+}
+
+#ifdef MODULE_GNRC_RPL_P2P
 void _update_lifetime(void)
 {
-    gnrc_rpl_parent_t *parent;
-    gnrc_rpl_instance_t *inst;
-
-    for (uint8_t i = 0; i < GNRC_RPL_PARENTS_NUMOF; ++i) {
-        parent = &gnrc_rpl_parents[i];
-        if (parent->state != 0) {
-            if (parent->lifetime > GNRC_RPL_LIFETIME_UPDATE_STEP) {
-                if (parent->lifetime <= (2 * GNRC_RPL_LIFETIME_UPDATE_STEP)) {
-                    gnrc_rpl_send_DIS(parent->dodag->instance, &parent->addr);
-                }
-                parent->lifetime -= GNRC_RPL_LIFETIME_UPDATE_STEP;
-            }
-            else {
-                gnrc_rpl_dodag_t *dodag = parent->dodag;
-                gnrc_rpl_parent_remove(parent);
-                gnrc_rpl_parent_update(dodag, NULL);
-            }
-        }
+    gnrc_rpl_p2p_update();
+
+    xtimer_set_msg(&_lt_timer, _lt_time, &_lt_msg, gnrc_rpl_pid);
+}
+#endif
+
+void _parent_timeout(gnrc_rpl_parent_t *parent)
+{
+    uint32_t now = gnrc_rpl_now();
+
+    if (parent->state == 0) {
+        return;
     }
 
-    for (int i = 0; i < GNRC_RPL_INSTANCES_NUMOF; ++i) {
-        inst = &gnrc_rpl_instances[i];
-        if (inst->state != 0) {
-            if ((inst->cleanup > 0) && (inst->dodag.parents == NULL) &&
-                (inst->dodag.my_rank == GNRC_RPL_INFINITE_RANK)) {
-                inst->cleanup -= GNRC_RPL_LIFETIME_UPDATE_STEP;
-                if (inst->cleanup <= 0) {
-                    /* no parents - delete this instance and DODAG */
-                    gnrc_rpl_instance_remove(inst);
-                    continue;
-                }
-            }
+    if (parent->lifetime > now) {
+        /* probe the parent before it expires */
+        gnrc_rpl_send_DIS(parent->dodag->instance, &parent->addr);
+        gnrc_rpl_evtimer_set(&parent->timeout_event, GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT,
+                             parent, (parent->lifetime - now) * MS_PER_SEC);
+    }
+    else {
+        gnrc_rpl_dodag_t *dodag = parent->dodag;
+        gnrc_rpl_parent_remove(parent);
+        gnrc_rpl_parent_update(dodag, NULL);
+    }
+}
 
-            if (inst->dodag.dao_time > GNRC_RPL_LIFETIME_UPDATE_STEP) {
-                inst->dodag.dao_time -= GNRC_RPL_LIFETIME_UPDATE_STEP;
-            }
-            else {
-                _dao_handle_send(&inst->dodag);
-            }
-        }
+void _instance_cleanup(gnrc_rpl_instance_t *inst)
+{
+    if (inst->state == 0) {
+        return;
     }
 
-#ifdef MODULE_GNRC_RPL_P2P
-    gnrc_rpl_p2p_update();
-#endif
+    inst->cleanup = 0;
+    if ((inst->dodag.parents == NULL) &&
+        (inst->dodag.my_rank == GNRC_RPL_INFINITE_RANK)) {
+        /* no parents - delete this instance and DODAG */
+        gnrc_rpl_instance_remove(inst);
+    }
+}
 
-    xtimer_set_msg(&_lt_timer, _lt_time, &_lt_msg, gnrc_rpl_pid);
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+static void _sr_schedule(uint32_t expires)
+{
+    uint32_t now = gnrc_rpl_now();
+
+    _sr_expires = expires;
+    gnrc_rpl_evtimer_set(&_sr_event, GNRC_RPL_MSG_TYPE_SR_TABLE_TIMEOUT, NULL,
+                         (expires > now) ? (expires - now) * MS_PER_SEC : 0);
 }
 
+void _sr_timeout(void)
+{
+    uint32_t next = gnrc_rpl_sr_table_update(&gnrc_rpl_sr_table, gnrc_rpl_now());
+
+    _sr_expires = 0;
+    if (next) {
+        _sr_schedule(next);
+    }
+}
+
+int gnrc_rpl_sr_dao(const ipv6_addr_t *target, const ipv6_addr_t *parent,
+                    uint8_t path_seq, uint32_t lifetime)
+{
+    uint32_t expires = lifetime ? (gnrc_rpl_now() + lifetime) : 0;
+    int res = gnrc_rpl_sr_table_dao(&gnrc_rpl_sr_table, target, parent, path_seq,
+                                    expires);
+
+    /* routes usually expire in the order of their DAOs, so the timeout only
+     * moves when the table was empty */
+    if ((res == 0) && expires && ((_sr_expires == 0) || (expires < _sr_expires))) {
+        _sr_schedule(expires);
+    }
+    return res;
+}
+#endif
+
 void gnrc_rpl_delay_dao(gnrc_rpl_dodag_t *dodag)
 {
-    dodag->dao_time = GNRC_RPL_DEFAULT_DAO_DELAY;
+    gnrc_rpl_evtimer_set(&dodag->dao_event, GNRC_RPL_MSG_TYPE_DAO_HANDLE, dodag,
+                         GNRC_RPL_DEFAULT_DAO_DELAY * MS_PER_SEC);
     dodag->dao_counter = 0;
     dodag->dao_ack_received = false;
 }
 
 void gnrc_rpl_long_delay_dao(gnrc_rpl_dodag_t *dodag)
 {
-    dodag->dao_time = GNRC_RPL_REGULAR_DAO_INTERVAL;
+    gnrc_rpl_evtimer_set(&dodag->dao_event, GNRC_RPL_MSG_TYPE_DAO_HANDLE, dodag,
+                         GNRC_RPL_REGULAR_DAO_INTERVAL * MS_PER_SEC);
     dodag->dao_counter = 0;
     dodag->dao_ack_received = false;
 }
 
 void _dao_handle_send(gnrc_rpl_dodag_t *dodag)
 {
+    if ((dodag->instance == NULL) || (dodag->instance->state == 0)) {
+        return;
+    }
 #ifdef MODULE_GNRC_RPL_P2P
     if (dodag->instance->mop == GNRC_RPL_P2P_MOP) {
         return;
@@ -318,7 +426,8 @@ void _dao_handle_send(gnrc_rpl_dodag_t *dodag)
     if ((dodag->dao_ack_received == false) && (dodag->dao_counter < GNRC_RPL_DAO_SEND_RETRIES)) {
         dodag->dao_counter++;
         gnrc_rpl_send_DAO(dodag->instance, NULL, dodag->default_lifetime);
-        dodag->dao_time = GNRC_RPL_DEFAULT_WAIT_FOR_DAO_ACK;
+        gnrc_rpl_evtimer_set(&dodag->dao_event, GNRC_RPL_MSG_TYPE_DAO_HANDLE, dodag,
+                             GNRC_RPL_DEFAULT_WAIT_FOR_DAO_ACK * MS_PER_SEC);
     }
     else if (dodag->dao_ack_received == false) {
         gnrc_rpl_long_delay_dao(dodag);
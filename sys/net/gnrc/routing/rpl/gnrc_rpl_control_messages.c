@@ -306,6 +306,34 @@ void gnrc_rpl_recv_DIS(gnrc_rpl_dis_t *dis, kernel_pid_t iface, ipv6_addr_t *src
     }
 }
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+/* applies the transit information to the targets preceding it */
+static void _sr_table_dao(gnrc_rpl_dodag_t *dodag, gnrc_rpl_opt_transit_t *transit,
+                          gnrc_rpl_opt_target_t *target)
+{
+    ipv6_addr_t parent;
+
+    /* in non-storing mode the parent address follows the transit
+     * information, but it is optional */
+    if (transit->length < (sizeof(*transit) - sizeof(gnrc_rpl_opt_t) + sizeof(parent))) {
+        DEBUG("RPL: RPL TRANSIT INFO DAO option without parent address\n");
+        return;
+    }
+    memcpy(&parent, transit + 1, sizeof(parent));
+    do {
+        DEBUG("RPL: updating source route of %s\n",
+              ipv6_addr_to_str(addr_str, &(target->target), sizeof(addr_str)));
+        if (gnrc_rpl_sr_dao(&target->target, &parent, transit->path_sequence,
+                            transit->path_lifetime * dodag->lifetime_unit) < 0) {
+            DEBUG("RPL: source routing table full\n");
+        }
+        target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (target)) +
+                 sizeof(gnrc_rpl_opt_t) + target->length);
+    }
+    while (target->type == GNRC_RPL_OPT_TARGET);
+}
+#endif
+
 /** @todo allow target prefixes in target options to be of variable length */
 bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt, uint16_t len,
                     ipv6_addr_t *src, uint32_t *included_opts)
@@ -421,6 +449,15 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     break;
                 }
 
+#ifdef MODULE_GNRC_RPL_SR_TABLE
+                /* the FIB below still provides the routes of the root until
+                 * source routing headers are inserted by the IPv6 layer */
+                if ((inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+                    (dodag->node_status == GNRC_RPL_ROOT_NODE)) {
+                    _sr_table_dao(dodag, transit, first_target);
+                }
+#endif
+
                 do {
                     DEBUG("RPL: updating fib entry %s/%d\n",
                           ipv6_addr_to_str(addr_str, &(first_target->target), sizeof(addr_str)),
@@ -115,6 +115,8 @@ bool gnrc_rpl_instance_remove(gnrc_rpl_instance_t *inst)
 #endif
     gnrc_rpl_dodag_remove_all_parents(dodag);
     trickle_stop(&dodag->trickle);
+    evtimer_del(&gnrc_rpl_evtimer, &dodag->dao_event.event);
+    evtimer_del(&gnrc_rpl_evtimer, &inst->cleanup_event.event);
     memset(inst, 0, sizeof(gnrc_rpl_instance_t));
     return true;
 }
@@ -224,7 +226,7 @@ bool gnrc_rpl_parent_remove(gnrc_rpl_parent_t *parent)
 
         /* set the default route to the next parent for now */
         if (parent->next) {
-            uint32_t now = xtimer_now_usec() / US_PER_SEC;
+            uint32_t now = gnrc_rpl_now();
             fib_add_entry(&gnrc_ipv6_fib_table,
                           dodag->iface,
                           (uint8_t *) ipv6_addr_unspecified.u8,
@@ -237,6 +239,7 @@ bool gnrc_rpl_parent_remove(gnrc_rpl_parent_t *parent)
         }
     }
     LL_DELETE(dodag->parents, parent);
+    evtimer_del(&gnrc_rpl_evtimer, &parent->timeout_event.event);
     memset(parent, 0, sizeof(gnrc_rpl_parent_t));
     return true;
 }
@@ -257,15 +260,30 @@ void gnrc_rpl_local_repair(gnrc_rpl_dodag_t *dodag)
     if (dodag->my_rank != GNRC_RPL_INFINITE_RANK) {
         dodag->my_rank = GNRC_RPL_INFINITE_RANK;
         trickle_reset_timer(&dodag->trickle);
-        dodag->instance->cleanup = GNRC_RPL_CLEANUP_TIME;
+        gnrc_rpl_cleanup_start(dodag);
     }
 }
 
+void gnrc_rpl_cleanup_start(gnrc_rpl_dodag_t *dodag)
+{
+    gnrc_rpl_instance_t *inst = dodag->instance;
+
+    inst->cleanup = gnrc_rpl_now() + GNRC_RPL_CLEANUP_TIME;
+    gnrc_rpl_evtimer_set(&inst->cleanup_event, GNRC_RPL_MSG_TYPE_INSTANCE_CLEANUP, inst,
+                         GNRC_RPL_CLEANUP_TIME * MS_PER_SEC);
+}
+
 void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
 {
     /* update Parent lifetime */
     if (parent != NULL) {
-        parent->lifetime = dodag->default_lifetime * dodag->lifetime_unit;
+        uint32_t lifetime = dodag->default_lifetime * dodag->lifetime_unit;
+
+        parent->lifetime = gnrc_rpl_now() + lifetime;
+        /* wake up in time to probe the parent before it expires */
+        gnrc_rpl_evtimer_set(&parent->timeout_event, GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT, parent,
+                             ((lifetime > GNRC_RPL_PARENT_PROBE_TIME) ?
+                              (lifetime - GNRC_RPL_PARENT_PROBE_TIME) : lifetime) * MS_PER_SEC);
 #ifdef MODULE_GNRC_RPL_P2P
         if (dodag->instance->mop != GNRC_RPL_P2P_MOP) {
 #endif
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl
+ * @{
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function.
+ *
+ * Implementation of MRHOF with the ETX metric estimated by the neighbor cache.
+ * @}
+ */
+
+#ifdef MODULE_GNRC_RPL_MRHOF
+
+#include "mrhof.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/structs.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+static uint16_t calc_rank(gnrc_rpl_parent_t *, uint16_t);
+static gnrc_rpl_parent_t *which_parent(gnrc_rpl_parent_t *, gnrc_rpl_parent_t *);
+static gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *, gnrc_rpl_dodag_t *);
+static void reset(gnrc_rpl_dodag_t *);
+
+static gnrc_rpl_of_t gnrc_rpl_mrhof = {
+    GNRC_RPL_MRHOF_OCP,
+    calc_rank,
+    which_parent,
+    which_dodag,
+    reset,
+    NULL,
+    NULL,
+    NULL
+};
+
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void)
+{
+    return &gnrc_rpl_mrhof;
+}
+
+void reset(gnrc_rpl_dodag_t *dodag)
+{
+    /* the link estimates belong to the neighbor cache */
+    (void) dodag;
+}
+
+/* converts an ETX to rank units */
+static uint32_t _etx_to_rank(gnrc_rpl_dodag_t *dodag, uint32_t etx)
+{
+    return (etx * dodag->instance->min_hop_rank_inc) / GNRC_IPV6_NC_ETX_DIVISOR;
+}
+
+/* rank of this node via parent, GNRC_RPL_INFINITE_RANK if the parent is not
+ * acceptable */
+static uint16_t _path_cost(gnrc_rpl_parent_t *parent)
+{
+    gnrc_rpl_dodag_t *dodag = parent->dodag;
+    uint16_t etx = gnrc_ipv6_nc_get_etx(dodag->iface, &parent->addr);
+    uint32_t cost;
+
+    if ((parent->rank == GNRC_RPL_INFINITE_RANK) ||
+        (etx > GNRC_RPL_MRHOF_MAX_LINK_METRIC)) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+
+    cost = parent->rank + _etx_to_rank(dodag, etx);
+    DEBUG("RPL MRHOF: ETX %u/%u, path cost %u\n", (unsigned)etx,
+          GNRC_IPV6_NC_ETX_DIVISOR, (unsigned)cost);
+    return (cost < GNRC_RPL_INFINITE_RANK) ? cost : GNRC_RPL_INFINITE_RANK;
+}
+
+uint16_t calc_rank(gnrc_rpl_parent_t *parent, uint16_t base_rank)
+{
+    if (base_rank == 0) {
+        if (parent == NULL) {
+            return GNRC_RPL_INFINITE_RANK;
+        }
+
+        return _path_cost(parent);
+    }
+
+    uint32_t add;
+
+    if (parent != NULL) {
+        add = _etx_to_rank(parent->dodag,
+                           gnrc_ipv6_nc_get_etx(parent->dodag->iface, &parent->addr));
+    }
+    else {
+        add = GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
+    }
+
+    if ((base_rank + add) >= GNRC_RPL_INFINITE_RANK) {
+        return GNRC_RPL_INFINITE_RANK;
+    }
+
+    return base_rank + add;
+}
+
+/* The parent with the lower path cost, the preferred parent is only replaced
+ * if the other one is better by more than the switch threshold */
+gnrc_rpl_parent_t *which_parent(gnrc_rpl_parent_t *p1, gnrc_rpl_parent_t *p2)
+{
+    gnrc_rpl_dodag_t *dodag = p1->dodag;
+    uint32_t c1 = _path_cost(p1);
+    uint32_t c2 = _path_cost(p2);
+    uint32_t threshold = _etx_to_rank(dodag, GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD);
+
+    if (p1 == p2) {
+        return p1;
+    }
+    if (p1 == dodag->parents) {
+        return ((c2 + threshold) < c1) ? p2 : p1;
+    }
+    if (p2 == dodag->parents) {
+        return ((c1 + threshold) < c2) ? p1 : p2;
+    }
+
+    return (c1 <= c2) ? p1 : p2;
+}
+
+/* Not used yet */
+gnrc_rpl_dodag_t *which_dodag(gnrc_rpl_dodag_t *d1, gnrc_rpl_dodag_t *d2)
+{
+    (void) d2;
+    return d1;
+}
+
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GNRC_RPL_MRHOF */
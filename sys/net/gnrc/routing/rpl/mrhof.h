@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     net_gnrc_rpl
+ * @{
+ * @file
+ * @brief       Minimum Rank with Hysteresis Objective Function.
+ *
+ * Header-file, which defines all functions for the implementation of the
+ * Minimum Rank with Hysteresis Objective Function with the ETX metric.
+ *
+ * The ETX of the link to a parent is taken from the neighbor cache, see
+ * @ref GNRC_IPV6_NC_ETX_DIVISOR. Without a metric container the path cost is
+ * the rank of the parent plus the link ETX in units of the minimum hop rank
+ * increase, so a perfect link adds the same rank as with OF0.
+ *
+ * @see <a href="https://tools.ietf.org/html/rfc6719">
+ *          RFC 6719
+ *      </a>
+ */
+
+#ifndef MRHOF_H
+#define MRHOF_H
+
+#include "net/gnrc/rpl/structs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Objective Code Point of MRHOF
+ */
+#define GNRC_RPL_MRHOF_OCP                      (1)
+
+/**
+ * @brief   Maximum ETX of the link to a parent, in units of
+ *          1 / @ref GNRC_IPV6_NC_ETX_DIVISOR
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_LINK_METRIC
+#define GNRC_RPL_MRHOF_MAX_LINK_METRIC          (512)
+#endif
+
+/**
+ * @brief   Path cost difference in ETX, in units of
+ *          1 / @ref GNRC_IPV6_NC_ETX_DIVISOR, needed to switch the preferred
+ *          parent
+ */
+#ifndef GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD
+#define GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD  (192)
+#endif
+
+/**
+ * @brief   Return the address to the MRHOF objective function
+ *
+ * @return  Address of the MRHOF objective function
+ */
+gnrc_rpl_of_t *gnrc_rpl_get_of_mrhof(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MRHOF_H */
+/**
+ * @}
+ */
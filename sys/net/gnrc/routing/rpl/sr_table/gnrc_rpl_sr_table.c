@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/sr_table.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if ENABLE_DEBUG
+static char addr_str[IPV6_ADDR_MAX_STR_LEN];
+#endif
+
+#define NODE_USED       (0x01)  /**< node is in use */
+#define NODE_DAO        (0x02)  /**< a DAO was received, path_seq is valid */
+#define NODE_REF        (0x04)  /**< node is a parent, valid during cleanup */
+
+/* maximum number of prefix octets a SRH can elide */
+#define SRH_COMPR_MAX   (15U)
+
+static uint16_t _hash(const gnrc_rpl_sr_table_t *table, const ipv6_addr_t *addr)
+{
+    /* the interface identifiers of the nodes differ, the prefixes do not */
+    uint32_t h = addr->u32[2].u32 ^ addr->u32[3].u32;
+
+    h *= 2654435761U;
+    return (h >> 16) % table->numof;
+}
+
+static uint16_t _find(const gnrc_rpl_sr_table_t *table, const ipv6_addr_t *addr)
+{
+    uint16_t id = table->nodes[_hash(table, addr)].bucket;
+
+    while ((id != GNRC_RPL_SR_TABLE_NONE) &&
+           !ipv6_addr_equal(&table->nodes[id].addr, addr)) {
+        id = table->nodes[id].next;
+    }
+    return id;
+}
+
+static uint16_t _alloc(gnrc_rpl_sr_table_t *table, const ipv6_addr_t *addr)
+{
+    uint16_t id = table->free;
+
+    if (id != GNRC_RPL_SR_TABLE_NONE) {
+        gnrc_rpl_sr_node_t *node = &table->nodes[id];
+        uint16_t *bucket = &table->nodes[_hash(table, addr)].bucket;
+
+        table->free = node->next;
+        node->addr = *addr;
+        node->expires = 0;
+        node->parent = GNRC_RPL_SR_TABLE_NONE;
+        node->path_seq = 0;
+        node->flags = NODE_USED;
+        node->next = *bucket;
+        *bucket = id;
+    }
+    return id;
+}
+
+static void _free(gnrc_rpl_sr_table_t *table, uint16_t id)
+{
+    gnrc_rpl_sr_node_t *node = &table->nodes[id];
+    uint16_t *ptr = &table->nodes[_hash(table, &node->addr)].bucket;
+
+    DEBUG("RPL SR: free %s\n",
+          ipv6_addr_to_str(addr_str, &node->addr, sizeof(addr_str)));
+    while (*ptr != id) {
+        ptr = &table->nodes[*ptr].next;
+    }
+    *ptr = node->next;
+    node->flags = 0;
+    node->next = table->free;
+    table->free = id;
+}
+
+/* frees all nodes without parent which are no parent themselves */
+static void _cleanup(gnrc_rpl_sr_table_t *table)
+{
+    gnrc_rpl_sr_node_t *nodes = table->nodes;
+
+    table->pending = 0;
+    for (uint16_t i = 0; i < table->numof; i++) {
+        nodes[i].flags &= ~NODE_REF;
+    }
+    for (uint16_t i = 0; i < table->numof; i++) {
+        if ((nodes[i].flags & NODE_USED) && (nodes[i].parent < table->numof)) {
+            nodes[nodes[i].parent].flags |= NODE_REF;
+        }
+    }
+    for (uint16_t i = 0; i < table->numof; i++) {
+        if (((nodes[i].flags & (NODE_USED | NODE_REF)) == NODE_USED) &&
+            (nodes[i].parent == GNRC_RPL_SR_TABLE_NONE)) {
+            _free(table, i);
+        }
+    }
+}
+
+void gnrc_rpl_sr_table_init(gnrc_rpl_sr_table_t *table, gnrc_rpl_sr_node_t *nodes,
+                            uint16_t numof, const ipv6_addr_t *root)
+{
+    table->nodes = nodes;
+    mutex_init(&table->lock);
+    table->root = *root;
+    table->numof = numof;
+    table->free = 0;
+    table->pending = 0;
+    for (uint16_t i = 0; i < numof; i++) {
+        nodes[i].flags = 0;
+        nodes[i].bucket = GNRC_RPL_SR_TABLE_NONE;
+        nodes[i].next = (i + 1 < numof) ? (i + 1) : GNRC_RPL_SR_TABLE_NONE;
+    }
+}
+
+int gnrc_rpl_sr_table_dao(gnrc_rpl_sr_table_t *table, const ipv6_addr_t *target,
+                          const ipv6_addr_t *parent, uint8_t path_seq,
+                          uint32_t expires)
+{
+    uint16_t id, parent_id = GNRC_RPL_SR_TABLE_ROOT;
+    int res = 0;
+
+    mutex_lock(&table->lock);
+    /* nodes are only freed here, so the IDs below stay valid */
+    if ((table->pending >= GNRC_RPL_SR_TABLE_BATCH) ||
+        (table->free == GNRC_RPL_SR_TABLE_NONE)) {
+        _cleanup(table);
+    }
+
+    id = _find(table, target);
+    if ((id != GNRC_RPL_SR_TABLE_NONE) && (table->nodes[id].flags & NODE_DAO) &&
+        GNRC_RPL_COUNTER_GREATER_THAN(table->nodes[id].path_seq, path_seq)) {
+        DEBUG("RPL SR: outdated path sequence %u for %s\n", path_seq,
+              ipv6_addr_to_str(addr_str, target, sizeof(addr_str)));
+        goto out;
+    }
+
+    if (expires == 0) {
+        /* No-Path DAO, the node is freed once it is no parent anymore */
+        if (id != GNRC_RPL_SR_TABLE_NONE) {
+            table->nodes[id].parent = GNRC_RPL_SR_TABLE_NONE;
+            table->nodes[id].expires = 0;
+            table->nodes[id].path_seq = path_seq;
+            table->pending++;
+        }
+        goto out;
+    }
+
+    /* unknown parents are added without a parent of their own until their
+     * DAO arrives */
+    if (!ipv6_addr_equal(parent, &table->root) &&
+        ((parent_id = _find(table, parent)) == GNRC_RPL_SR_TABLE_NONE) &&
+        ((parent_id = _alloc(table, parent)) == GNRC_RPL_SR_TABLE_NONE)) {
+        res = -ENOMEM;
+        goto out;
+    }
+    if ((id == GNRC_RPL_SR_TABLE_NONE) &&
+        ((id = _alloc(table, target)) == GNRC_RPL_SR_TABLE_NONE)) {
+        res = -ENOMEM;
+        goto out;
+    }
+
+    DEBUG("RPL SR: %s via node %u\n",
+          ipv6_addr_to_str(addr_str, target, sizeof(addr_str)), parent_id);
+    table->nodes[id].parent = parent_id;
+    table->nodes[id].expires = expires;
+    table->nodes[id].path_seq = path_seq;
+    table->nodes[id].flags |= NODE_DAO;
+    table->pending++;
+
+out:
+    mutex_unlock(&table->lock);
+    return res;
+}
+
+uint32_t gnrc_rpl_sr_table_update(gnrc_rpl_sr_table_t *table, uint32_t now)
+{
+    uint32_t next = 0;
+
+    mutex_lock(&table->lock);
+    for (uint16_t i = 0; i < table->numof; i++) {
+        gnrc_rpl_sr_node_t *node = &table->nodes[i];
+
+        if (!(node->flags & NODE_USED) || (node->expires == 0)) {
+            continue;
+        }
+        if (node->expires <= now) {
+            node->expires = 0;
+            node->parent = GNRC_RPL_SR_TABLE_NONE;
+        }
+        else if ((next == 0) || (node->expires < next)) {
+            next = node->expires;
+        }
+    }
+    _cleanup(table);
+    mutex_unlock(&table->lock);
+    return next;
+}
+
+static unsigned _compr(const ipv6_addr_t *a, const ipv6_addr_t *b, unsigned max)
+{
+    unsigned octets = ipv6_addr_match_prefix(a, b) / 8;
+
+    return (octets < max) ? octets : max;
+}
+
+int gnrc_rpl_sr_table_route(gnrc_rpl_sr_table_t *table, const ipv6_addr_t *dst,
+                            ipv6_addr_t *next_hop, gnrc_rpl_srh_t *srh, size_t len)
+{
+    /* the route from the destination up to the first hop */
+    uint16_t path[GNRC_RPL_SR_TABLE_DEPTH_MAX];
+    unsigned hops = 0, compri, compre, size;
+    uint16_t id;
+    int res;
+
+    mutex_lock(&table->lock);
+    id = _find(table, dst);
+    while (id != GNRC_RPL_SR_TABLE_ROOT) {
+        if (id == GNRC_RPL_SR_TABLE_NONE) {
+            res = -EHOSTUNREACH;
+            goto out;
+        }
+        if (hops == GNRC_RPL_SR_TABLE_DEPTH_MAX) {
+            res = -ELOOP;
+            goto out;
+        }
+        path[hops++] = id;
+        id = table->nodes[id].parent;
+    }
+
+    const ipv6_addr_t *first = &table->nodes[path[hops - 1]].addr;
+    *next_hop = *first;
+    if (hops == 1) {
+        res = 0;
+        goto out;
+    }
+
+    /* every address shares the elided prefix with the one before it, which
+     * is the destination of the IPv6 header when the address is used */
+    compri = SRH_COMPR_MAX;
+    for (unsigned i = 1; i < hops - 1; i++) {
+        compri = _compr(first, &table->nodes[path[i]].addr, compri);
+    }
+    compre = _compr(first, dst, compri);
+    size = (hops - 2) * (sizeof(ipv6_addr_t) - compri) +
+           (sizeof(ipv6_addr_t) - compre);
+    unsigned pad = (8 - (size & 0x7)) & 0x7;
+    size += pad;
+    if (sizeof(gnrc_rpl_srh_t) + size > len) {
+        res = -ENOBUFS;
+        goto out;
+    }
+
+    srh->len = size / 8;
+    srh->type = GNRC_RPL_SRH_TYPE;
+    srh->seg_left = hops - 1;
+    srh->compr = (compri << 4) | compre;
+    srh->pad_resv = pad << 4;
+    srh->resv = 0;
+
+    uint8_t *vec = (uint8_t *)(srh + 1);
+    for (unsigned i = hops - 1; i-- > 1;) {
+        memcpy(vec, &table->nodes[path[i]].addr.u8[compri],
+               sizeof(ipv6_addr_t) - compri);
+        vec += sizeof(ipv6_addr_t) - compri;
+    }
+    memcpy(vec, &dst->u8[compre], sizeof(ipv6_addr_t) - compre);
+    memset(vec + sizeof(ipv6_addr_t) - compre, 0, pad);
+    res = sizeof(gnrc_rpl_srh_t) + size;
+
+out:
+    mutex_unlock(&table->lock);
+    return res;
+}
+
+/** @} */
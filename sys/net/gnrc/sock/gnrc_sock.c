@@ -21,6 +21,7 @@
 #include "net/gnrc/ipv6/netif.h"
 #include "net/gnrc/netreg.h"
 #include "net/udp.h"
+#include "thread_flags.h"
 #include "utlist.h"
 #include "xtimer.h"
 
@@ -28,19 +29,9 @@
 #include "gnrc_sock_internal.h"
 
 #ifdef MODULE_XTIMER
-#define _TIMEOUT_MAGIC      (0xF38A0B63U)
-#define _TIMEOUT_MSG_TYPE   (0x8474)
-
-static void _callback_put(void *arg)
+static void _callback_timeout(void *arg)
 {
-    msg_t timeout_msg = { .sender_pid = KERNEL_PID_UNDEF,
-                          .type = _TIMEOUT_MSG_TYPE,
-                          .content = { .value = _TIMEOUT_MAGIC } };
-    gnrc_sock_reg_t *reg = arg;
-
-    /* should be safe, because otherwise if mbox were filled this callback is
-     * senseless */
-    mbox_try_put(&reg->mbox, &timeout_msg);
+    thread_flags_set(arg, THREAD_FLAG_TIMEOUT);
 }
 #endif
 
@@ -57,37 +48,39 @@ ssize_t gnrc_sock_recv(gnrc_sock_reg_t *reg, gnrc_pktsnip_t **pkt_out,
     gnrc_pktsnip_t *pkt, *ip, *netif;
     msg_t msg;
 
+    if (timeout != 0) {
+        mbox_t *mbox = &reg->mbox;
+        thread_flags_t mask = 0;
 #ifdef MODULE_XTIMER
-    xtimer_t timeout_timer;
+        xtimer_t timeout_timer;
 
-    if ((timeout != SOCK_NO_TIMEOUT) && (timeout != 0)) {
-        timeout_timer.callback = _callback_put;
-        timeout_timer.arg = reg;
-        xtimer_set(&timeout_timer, timeout);
-    }
-#endif
-    if (timeout != 0) {
-        mbox_get(&reg->mbox, &msg);
-    }
-    else {
-        if (!mbox_try_get(&reg->mbox, &msg)) {
-            return -EAGAIN;
+        if (timeout != SOCK_NO_TIMEOUT) {
+            timeout_timer.callback = _callback_timeout;
+            timeout_timer.arg = (void *)sched_active_thread;
+            xtimer_set(&timeout_timer, timeout);
+            mask = THREAD_FLAG_TIMEOUT;
         }
-    }
+#endif
+        int ready = thread_flags_wait_ready(&mask, &mbox, 1);
 #ifdef MODULE_XTIMER
-    xtimer_remove(&timeout_timer);
+        if (timeout != SOCK_NO_TIMEOUT) {
+            xtimer_remove(&timeout_timer);
+            /* the timer may have fired after a message won the race, the
+             * flag would end the next wait early */
+            thread_flags_clear(THREAD_FLAG_TIMEOUT);
+        }
 #endif
+        if (ready == THREAD_FLAGS_READY_FLAGS) {
+            return -ETIMEDOUT;
+        }
+    }
+    if (!mbox_try_get(&reg->mbox, &msg)) {
+        return -EAGAIN;
+    }
     switch (msg.type) {
         case GNRC_NETAPI_MSG_TYPE_RCV:
             pkt = msg.content.ptr;
             break;
-#ifdef MODULE_XTIMER
-        case _TIMEOUT_MSG_TYPE:
-            if (msg.content.value == _TIMEOUT_MAGIC) {
-                return -ETIMEDOUT;
-            }
-#endif
-            /* Falls Through. */
         default:
             return -EINTR;
     }
@@ -75,6 +75,27 @@ struct sock_udp {
     uint16_t flags;                     /**< option flags */
 };
 
+/**
+ * @brief   Sends a UDP message already in the packet buffer to remote end
+ *          point
+ *
+ * Same as sock_udp_send(), but without copying the payload. Lets callers
+ * which produce the payload piecewise write it directly into the packet
+ * buffer.
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object. May be NULL, see
+ *                      sock_udp_send().
+ * @param[in] payload   Payload, allocated with gnrc_pktbuf_add() with type
+ *                      @ref GNRC_NETTYPE_UNDEF. Released by this function,
+ *                      also on error.
+ * @param[in] remote    Remote end point, see sock_udp_send().
+ *
+ * @return  The number of bytes sent on success.
+ * @return  < 0, on error, see sock_udp_send().
+ */
+ssize_t gnrc_sock_udp_send_pkt(sock_udp_t *sock, gnrc_pktsnip_t *payload,
+                               const sock_udp_ep_t *remote);
+
 #ifdef __cplusplus
 }
 #endif
@@ -209,18 +209,11 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
     return (int)pkt->size;
 }
 
-ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
-                      const sock_udp_ep_t *remote)
+/* checks the end points and binds sock implicitly, local is zeroed if unbound */
+static int _udp_prepare(sock_udp_t *sock, const sock_udp_ep_t *remote,
+                        sock_ip_ep_t *local, sock_ip_ep_t **rem,
+                        uint16_t *src_port, uint16_t *dst_port)
 {
-    int res;
-    gnrc_pktsnip_t *payload, *pkt;
-    uint16_t src_port = 0, dst_port;
-    sock_ip_ep_t local;
-    sock_ip_ep_t *rem;
-
-    assert((sock != NULL) || (remote != NULL));
-    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
-
     if (remote != NULL) {
         if (remote->port == 0) {
             return -EINVAL;
@@ -247,20 +240,20 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
     /* cppcheck-suppress nullPointer */
     if ((sock == NULL) || (sock->local.family == AF_UNSPEC)) {
         /* no sock or sock currently unbound */
-        memset(&local, 0, sizeof(local));
-        if ((src_port = _get_dyn_port(sock)) == GNRC_SOCK_DYN_PORTRANGE_ERR) {
+        memset(local, 0, sizeof(*local));
+        if ((*src_port = _get_dyn_port(sock)) == GNRC_SOCK_DYN_PORTRANGE_ERR) {
             return -EINVAL;
         }
         if (sock != NULL) {
             /* bind sock object implicitly */
-            sock->local.port = src_port;
+            sock->local.port = *src_port;
             if (remote == NULL) {
                 sock->local.family = sock->remote.family;
             }
             else {
                 sock->local.family = remote->family;
             }
-            gnrc_sock_create(&sock->reg, GNRC_NETTYPE_UDP, src_port);
+            gnrc_sock_create(&sock->reg, GNRC_NETTYPE_UDP, *src_port);
 #ifdef MODULE_GNRC_SOCK_CHECK_REUSE
             /* prepend to current socks */
             sock->reg.next = (gnrc_sock_reg_t *)_udp_socks;
@@ -269,40 +262,87 @@ ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
         }
     }
     else {
-        src_port = sock->local.port;
-        memcpy(&local, &sock->local, sizeof(local));
+        *src_port = sock->local.port;
+        memcpy(local, &sock->local, sizeof(*local));
     }
     /* sock can't be NULL at this point */
     if (remote == NULL) {
-        rem = (sock_ip_ep_t *)&sock->remote;
-        dst_port = sock->remote.port;
+        *rem = (sock_ip_ep_t *)&sock->remote;
+        *dst_port = sock->remote.port;
     }
     else {
-        rem = (sock_ip_ep_t *)remote;
-        dst_port = remote->port;
+        *rem = (sock_ip_ep_t *)remote;
+        *dst_port = remote->port;
     }
     /* check for matching address families in local and remote */
-    if (local.family == AF_UNSPEC) {
-        local.family = rem->family;
+    if (local->family == AF_UNSPEC) {
+        local->family = (*rem)->family;
     }
-    else if (local.family != rem->family) {
+    else if (local->family != (*rem)->family) {
         return -EINVAL;
     }
-    /* generate payload and header snips */
-    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
-    if (payload == NULL) {
-        return -ENOMEM;
-    }
-    pkt = gnrc_udp_hdr_build(payload, src_port, dst_port);
+    return 0;
+}
+
+/* sends payload, releases it on error */
+static ssize_t _udp_send(gnrc_pktsnip_t *payload, sock_ip_ep_t *local,
+                         sock_ip_ep_t *rem, uint16_t src_port, uint16_t dst_port)
+{
+    int res;
+    gnrc_pktsnip_t *pkt = gnrc_udp_hdr_build(payload, src_port, dst_port);
+
     if (pkt == NULL) {
         gnrc_pktbuf_release(payload);
         return -ENOMEM;
     }
-    res = gnrc_sock_send(pkt, &local, rem, PROTNUM_UDP);
+    res = gnrc_sock_send(pkt, local, rem, PROTNUM_UDP);
     if (res > 0) {
         res -= sizeof(udp_hdr_t);
     }
     return res;
 }
 
+ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
+                      const sock_udp_ep_t *remote)
+{
+    int res;
+    gnrc_pktsnip_t *payload;
+    uint16_t src_port = 0, dst_port;
+    sock_ip_ep_t local;
+    sock_ip_ep_t *rem;
+
+    assert((sock != NULL) || (remote != NULL));
+    assert((len == 0) || (data != NULL)); /* (len != 0) => (data != NULL) */
+
+    res = _udp_prepare(sock, remote, &local, &rem, &src_port, &dst_port);
+    if (res < 0) {
+        return res;
+    }
+    /* generate payload and header snips */
+    payload = gnrc_pktbuf_add(NULL, (void *)data, len, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+    return _udp_send(payload, &local, rem, src_port, dst_port);
+}
+
+ssize_t gnrc_sock_udp_send_pkt(sock_udp_t *sock, gnrc_pktsnip_t *payload,
+                               const sock_udp_ep_t *remote)
+{
+    int res;
+    uint16_t src_port = 0, dst_port;
+    sock_ip_ep_t local;
+    sock_ip_ep_t *rem;
+
+    assert((sock != NULL) || (remote != NULL));
+    assert(payload != NULL);
+
+    res = _udp_prepare(sock, remote, &local, &rem, &src_port, &dst_port);
+    if (res < 0) {
+        gnrc_pktbuf_release(payload);
+        return res;
+    }
+    return _udp_send(payload, &local, rem, src_port, dst_port);
+}
+
 /** @} */
@@ -33,9 +33,8 @@ void _rcvbuf_init(void)
 {
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_init() : entry\n");
     mutex_init(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        _static_buf.entries[i].used = 0;
-    }
+    mempool_init(&(_static_buf.pool), "tcp_rcvbuf", _static_buf.entries,
+                 sizeof(_static_buf.entries[0]), GNRC_TCP_RCV_BUFFERS);
 }
 
 /**
@@ -46,16 +45,10 @@ void _rcvbuf_init(void)
  */
 static void* _rcvbuf_alloc(void)
 {
-    void *result = NULL;
+    void *result;
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_alloc() : Entry\n");
     mutex_lock(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        if (_static_buf.entries[i].used == 0) {
-            _static_buf.entries[i].used = 1;
-            result = (void *)(_static_buf.entries[i].buffer);
-            break;
-        }
-    }
+    result = mempool_alloc(&(_static_buf.pool));
     mutex_unlock(&(_static_buf.lock));
     return result;
 }
@@ -69,11 +62,7 @@ static void _rcvbuf_free(void * const buf)
 {
     DEBUG("gnrc_tcp_rcvbuf.c : _rcvbuf_free() : Entry\n");
     mutex_lock(&(_static_buf.lock));
-    for (size_t i = 0; i < GNRC_TCP_RCV_BUFFERS; ++i) {
-        if ((_static_buf.entries[i].used == 1) && (buf == _static_buf.entries[i].buffer)) {
-            _static_buf.entries[i].used = 0;
-        }
-    }
+    mempool_free(&(_static_buf.pool), buf);
     mutex_unlock(&(_static_buf.lock));
 }
 
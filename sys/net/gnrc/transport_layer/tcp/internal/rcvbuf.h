@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include "mutex.h"
+#include "mempool.h"
 #include "net/gnrc/tcp/config.h"
 #include "net/gnrc/tcp/tcb.h"
 
@@ -33,9 +34,11 @@ extern "C" {
 
 /**
  * @brief Receive buffer entry.
+ *
+ * @note  The pointer member keeps the entries aligned for @ref sys_mempool.
  */
-typedef struct rcvbuf_entry {
-    uint8_t used;                          /**< Flag: Is buffer in use? */
+typedef union rcvbuf_entry {
+    void *next;                            /**< Free list link, used by mempool */
     uint8_t buffer[GNRC_TCP_RCV_BUF_SIZE]; /**< Receive buffer storage */
 } rcvbuf_entry_t;
 
@@ -44,6 +47,7 @@ typedef struct rcvbuf_entry {
  */
 typedef struct rcvbuf {
     mutex_t lock;                                 /**< Lock for allocation synchronization */
+    mempool_t pool;                               /**< Pool of free entries */
     rcvbuf_entry_t entries[GNRC_TCP_RCV_BUFFERS]; /**< Maintained receive buffers */
 } rcvbuf_t;
 
@@ -35,6 +35,9 @@
 #include "net/sock/ip.h"
 #include "net/sock/udp.h"
 #include "net/sock/tcp.h"
+#ifdef MODULE_GNRC_SOCK_UDP
+#include "net/gnrc/pktbuf.h"
+#endif
 
 /* enough to create sockets both with socket() and accept() */
 #define _ACTUAL_SOCKET_POOL_SIZE   (SOCKET_POOL_SIZE + \
@@ -98,6 +101,8 @@ static ssize_t socket_recvfrom(socket_t *s, void *restrict buffer,
 static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
                              int flags, const struct sockaddr *address,
                              socklen_t address_len);
+static int _bind_connect(socket_t *s, const struct sockaddr *address,
+                         socklen_t address_len);
 
 static socket_t *_get_free_socket(void)
 {
@@ -315,6 +320,92 @@ static inline ssize_t socket_write(vfs_file_t *filp, const void *buf, size_t n)
     return socket_sendto(filp->private_data.ptr, buf, n, 0, NULL, 0);
 }
 
+static ssize_t socket_writev(vfs_file_t *filp, const struct iovec *iov, int iovcnt)
+{
+    socket_t *s = filp->private_data.ptr;
+    ssize_t res = 0;
+    int used = 0;
+
+    for (int i = 0; i < iovcnt; i++) {
+        used += (iov[i].iov_len > 0);
+    }
+#ifdef MODULE_GNRC_SOCK_UDP
+    if ((s->type == SOCK_DGRAM) && (used > 1)) {
+        /* the buffers form one datagram, gather them in the packet buffer */
+        gnrc_pktsnip_t *payload;
+        size_t len = 0;
+
+        for (int i = 0; i < iovcnt; i++) {
+            len += iov[i].iov_len;
+        }
+        if ((s->sock == NULL) && (_bind_connect(s, NULL, 0) < 0)) {
+            return -errno;
+        }
+        payload = gnrc_pktbuf_add(NULL, NULL, len, GNRC_NETTYPE_UNDEF);
+        if (payload == NULL) {
+            return -ENOMEM;
+        }
+        uint8_t *data = payload->data;
+        for (int i = 0; i < iovcnt; i++) {
+            memcpy(data, iov[i].iov_base, iov[i].iov_len);
+            data += iov[i].iov_len;
+        }
+        return gnrc_sock_udp_send_pkt(&s->sock->udp, payload, NULL);
+    }
+#endif
+    if ((s->type != SOCK_STREAM) && (used > 1)) {
+        /* would split the datagram */
+        return -EOPNOTSUPP;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        ssize_t n = socket_sendto(s, iov[i].iov_base, iov[i].iov_len, 0, NULL, 0);
+        if (n < 0) {
+            return (res > 0) ? res : -errno;
+        }
+        res += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return res;
+}
+
+#ifdef MODULE_GNRC_SOCK_UDP
+static ssize_t socket_sendfile(vfs_file_t *filp, vfs_file_t *in, size_t n)
+{
+    socket_t *s = filp->private_data.ptr;
+    gnrc_pktsnip_t *payload;
+    ssize_t res;
+
+    if ((s->type != SOCK_DGRAM) || (in->f_op->read == NULL)) {
+        return -ENOTSUP;
+    }
+    if ((s->sock == NULL) && (_bind_connect(s, NULL, 0) < 0)) {
+        return -errno;
+    }
+    /* one datagram per block, read directly into the packet buffer */
+    if (n > SOCKET_BLKSIZE) {
+        n = SOCKET_BLKSIZE;
+    }
+    payload = gnrc_pktbuf_add(NULL, NULL, n, GNRC_NETTYPE_UNDEF);
+    if (payload == NULL) {
+        return -ENOMEM;
+    }
+    res = in->f_op->read(in, payload->data, n);
+    if (res <= 0) {
+        gnrc_pktbuf_release(payload);
+        return res;
+    }
+    if ((size_t)res < n) {
+        gnrc_pktbuf_realloc_data(payload, res);
+    }
+    return gnrc_sock_udp_send_pkt(&s->sock->udp, payload, NULL);
+}
+#endif
+
 static const vfs_file_ops_t socket_ops = {
     .close = socket_close,
     .fcntl = NULL,          /* TODO: provide when needed */
@@ -322,6 +413,10 @@ static const vfs_file_ops_t socket_ops = {
     .lseek = socket_lseek,
     .read = socket_read,
     .write = socket_write,
+    .writev = socket_writev,
+#ifdef MODULE_GNRC_SOCK_UDP
+    .sendfile = socket_sendfile,
+#endif
 };
 
 int socket(int domain, int type, int protocol)
@@ -908,6 +1003,8 @@ static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
     int res = 0;
 #if defined(MODULE_SOCK_IP) || defined(MODULE_SOCK_UDP)
     struct _sock_tl_ep ep = { .port = 0 };
+    /* connected sockets send to their remote */
+    struct _sock_tl_ep *remote = NULL;
 #endif
 
     (void)flags;
@@ -928,14 +1025,17 @@ static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
         }
     }
 #if defined(MODULE_SOCK_IP) || defined(MODULE_SOCK_UDP)
-    if ((res = _sockaddr_to_ep(address, address_len, &ep)) < 0)
-        return res;
+    if (address != NULL) {
+        if ((res = _sockaddr_to_ep(address, address_len, &ep)) < 0)
+            return res;
+        remote = &ep;
+    }
 #endif
     switch (s->type) {
 #ifdef MODULE_SOCK_IP
         case SOCK_RAW:
             if ((res = sock_ip_send(&s->sock->raw, buffer, length,
-                               s->protocol, (sock_ip_ep_t *)&ep)) < 0) {
+                               s->protocol, (sock_ip_ep_t *)remote)) < 0) {
                 errno = -res;
                 res = -1;
             }
@@ -958,7 +1058,7 @@ static ssize_t socket_sendto(socket_t *s, const void *buffer, size_t length,
 #endif
 #ifdef MODULE_SOCK_UDP
         case SOCK_DGRAM:
-            if ((res = sock_udp_send(&s->sock->udp, buffer, length, &ep)) < 0) {
+            if ((res = sock_udp_send(&s->sock->udp, buffer, length, remote)) < 0) {
                 errno = -res;
                 res = -1;
             }
@@ -30,6 +30,10 @@
 #include "tlsf.h"
 #endif
 
+#ifdef MODULE_MEMPOOL
+#include "mempool.h"
+#endif
+
 /* list of states copied from tcb.h */
 static const char *state_names[] = {
     [STATUS_RUNNING] = "running",
@@ -137,4 +141,8 @@ void ps(void)
     tlsf_walk_pool(NULL);
 #   endif
 #endif
+#ifdef MODULE_MEMPOOL
+    puts("\nMemory pools:");
+    mempool_print_all();
+#endif
 }
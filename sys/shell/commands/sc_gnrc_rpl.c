@@ -208,6 +208,8 @@ int _stats(void)
     printf("DAO-ACK   #bytes: %10" PRIu32 " / %-10" PRIu32 "  %10" PRIu32 " / %-10" PRIu32 "\n",
            gnrc_rpl_netstats.dao_ack_rx_ucast_bytes, gnrc_rpl_netstats.dao_ack_tx_ucast_bytes,
            gnrc_rpl_netstats.dao_ack_rx_mcast_bytes, gnrc_rpl_netstats.dao_ack_tx_mcast_bytes);
+    printf("Timer    #wakeups: %10" PRIu32 " (%" PRIu32 " saved)\n",
+           gnrc_rpl_netstats.timer_wakeups, gnrc_rpl_netstats.timer_wakeups_saved);
     return 0;
 }
 #endif
@@ -257,7 +259,7 @@ int _gnrc_rpl_dodag_show(void)
 
     gnrc_rpl_dodag_t *dodag = NULL;
     char addr_str[IPV6_ADDR_MAX_STR_LEN];
-    int8_t cleanup;
+    uint32_t cleanup, now = gnrc_rpl_now();
     uint64_t tc, xnow = xtimer_now_usec64();
 
     for (uint8_t i = 0; i < GNRC_RPL_INSTANCES_NUMOF; ++i) {
@@ -276,7 +278,7 @@ int _gnrc_rpl_dodag_show(void)
                 | dodag->trickle.msg_timer.target) - xnow;
         tc = (int64_t) tc < 0 ? 0 : tc / US_PER_SEC;
 
-        cleanup = dodag->instance->cleanup < 0 ? 0 : dodag->instance->cleanup;
+        cleanup = dodag->instance->cleanup > now ? dodag->instance->cleanup - now : 0;
 
         printf("\tdodag [%s | R: %d | OP: %s | PIO: %s | CL: %ds | "
                "TR(I=[%d,%d], k=%d, c=%d, TC=%" PRIu32 "s)]\n",
@@ -300,7 +302,7 @@ int _gnrc_rpl_dodag_show(void)
         LL_FOREACH(gnrc_rpl_instances[i].dodag.parents, parent) {
             printf("\t\tparent [addr: %s | rank: %d | lifetime: %" PRIu32 "s]\n",
                     ipv6_addr_to_str(addr_str, &parent->addr, sizeof(addr_str)),
-                    parent->rank, parent->lifetime);
+                    parent->rank, parent->lifetime > now ? parent->lifetime - now : 0);
         }
     }
     return 0;
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_shell_commands
+ * @{
+ *
+ * @file
+ * @brief       Shell commands to hash files on the VFS
+ *
+ * @}
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hashes/stream.h"
+
+/**
+ * @brief   Amount of a file read per vfs_read()
+ */
+#ifndef SHELL_HASHSUM_BUFSIZE
+#define SHELL_HASHSUM_BUFSIZE   (64U)
+#endif
+
+static uint8_t _buf[SHELL_HASHSUM_BUFSIZE];
+
+static void _print(const char *path, const uint8_t *digest, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        printf("%02x", digest[i]);
+    }
+    printf("  %s\n", path);
+}
+
+static int _error(const char *cmd, const char *path, ssize_t res)
+{
+    printf("%s: %s: error %d\n", cmd, path, (int)res);
+    return 1;
+}
+
+int _md5sum_handler(int argc, char **argv)
+{
+    int ret = 0;
+
+    if (argc < 2) {
+        printf("usage: %s <file> [<file> ...]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        md5_ctx_t ctx;
+        uint8_t digest[MD5_DIGEST_LENGTH];
+
+        md5_init(&ctx);
+        ssize_t res = hashes_update_file(hashes_md5_update, &ctx, argv[i],
+                                         _buf, sizeof(_buf));
+        if (res < 0) {
+            ret = _error(argv[0], argv[i], res);
+            continue;
+        }
+        md5_final(&ctx, digest);
+        _print(argv[i], digest, sizeof(digest));
+    }
+    return ret;
+}
+
+int _sha256sum_handler(int argc, char **argv)
+{
+    int ret = 0;
+
+    if (argc < 2) {
+        printf("usage: %s <file> [<file> ...]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        sha256_context_t ctx;
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+
+        sha256_init(&ctx);
+        ssize_t res = hashes_update_file(hashes_sha256_update, &ctx, argv[i],
+                                         _buf, sizeof(_buf));
+        if (res < 0) {
+            ret = _error(argv[0], argv[i], res);
+            continue;
+        }
+        sha256_final(&ctx, digest);
+        _print(argv[i], digest, sizeof(digest));
+    }
+    return ret;
+}
@@ -130,6 +130,10 @@ extern int _ntpdate(int argc, char **argv);
 #ifdef MODULE_VFS
 extern int _vfs_handler(int argc, char **argv);
 extern int _ls_handler(int argc, char **argv);
+#ifdef MODULE_HASHES
+extern int _md5sum_handler(int argc, char **argv);
+extern int _sha256sum_handler(int argc, char **argv);
+#endif
 #endif
 
 #ifdef MODULE_CONN_CAN
@@ -224,6 +228,10 @@ const shell_command_t _shell_command_list[] = {
 #ifdef MODULE_VFS
     {"vfs", "virtual file system operations", _vfs_handler},
     {"ls", "list files", _ls_handler},
+#ifdef MODULE_HASHES
+    {"md5sum", "print the MD5 digest of files", _md5sum_handler},
+    {"sha256sum", "print the SHA-256 digest of files", _sha256sum_handler},
+#endif
 #endif
 #ifdef MODULE_CONN_CAN
     {"can", "CAN commands", _can_handler},
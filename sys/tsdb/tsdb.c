@@ -0,0 +1,656 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_tsdb
+ * @{
+ *
+ * @file
+ * @brief       Time-series store implementation
+ *
+ * The page buffer holds the page of the head sector containing @p offset.
+ * Bytes from @p flushed to @p offset exist only there, reads of the head
+ * sector take them from the buffer.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "tsdb.h"
+
+#define ENABLE_DEBUG (0)
+#include "debug.h"
+
+#define MAGIC           (0x31445354UL)  /* "TSD1" */
+
+#define CTL_DIM_MASK    (0x03)
+#define CTL_UNIT        (0x04)
+#define CTL_RESERVED    (0xf8)
+#define CTL_END         (0xff)          /* erased flash */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t time;          /* of the first sample */
+} sector_hdr_t;
+
+#define SECTOR_HDR      (sizeof(sector_hdr_t))
+
+static inline uint32_t _sector_addr(const tsdb_t *db, uint32_t sector)
+{
+    return sector * db->sector_size;
+}
+
+static void _reset(tsdb_sample_t *sample, uint32_t time)
+{
+    memset(sample, 0, sizeof(*sample));
+    sample->time = time;
+    sample->data.unit = UNIT_UNDEF;
+}
+
+static uint8_t *_put_varint(uint8_t *buf, uint32_t val)
+{
+    while (val >= 0x80) {
+        *buf++ = (val & 0x7f) | 0x80;
+        val >>= 7;
+    }
+    *buf++ = val;
+    return buf;
+}
+
+static int _get_varint(const uint8_t *buf, size_t len, size_t *pos, uint32_t *val)
+{
+    uint32_t res = 0;
+
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) {
+            return -EILSEQ;
+        }
+        uint8_t byte = buf[(*pos)++];
+        res |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *val = res;
+            return 0;
+        }
+    }
+    return -EILSEQ;
+}
+
+static inline uint32_t _zigzag(int32_t val)
+{
+    return ((uint32_t)val << 1) ^ ((val < 0) ? UINT32_MAX : 0);
+}
+
+static inline int32_t _unzigzag(uint32_t val)
+{
+    return (int32_t)((val >> 1) ^ (0 - (val & 1)));
+}
+
+static size_t _encode(uint8_t *buf, const tsdb_sample_t *prev,
+                      const tsdb_sample_t *sample)
+{
+    uint8_t *pos = buf + 1;
+
+    buf[0] = sample->dim;
+    if ((sample->data.unit != prev->data.unit) ||
+        (sample->data.scale != prev->data.scale)) {
+        buf[0] |= CTL_UNIT;
+        *pos++ = sample->data.unit;
+        *pos++ = (uint8_t)sample->data.scale;
+    }
+    pos = _put_varint(pos, sample->time - prev->time);
+    for (unsigned i = 0; i < sample->dim; i++) {
+        pos = _put_varint(pos, _zigzag((int32_t)sample->data.val[i] -
+                                       prev->data.val[i]));
+    }
+    return pos - buf;
+}
+
+/**
+ * @brief   Decode a record, @p sample is the previous sample on entry
+ *
+ * @return  length of the record
+ * @return  0 at the end of the data
+ * @return  -EILSEQ if the record is damaged
+ */
+static int _decode(const uint8_t *buf, size_t len, tsdb_sample_t *sample)
+{
+    tsdb_sample_t next = *sample;
+    size_t pos = 1;
+    uint32_t val;
+
+    if (!len || (buf[0] == CTL_END)) {
+        return 0;
+    }
+    next.dim = buf[0] & CTL_DIM_MASK;
+    if ((buf[0] & CTL_RESERVED) || !next.dim) {
+        return -EILSEQ;
+    }
+    if (buf[0] & CTL_UNIT) {
+        if (len < 3) {
+            return -EILSEQ;
+        }
+        next.data.unit = buf[1];
+        next.data.scale = (int8_t)buf[2];
+        pos = 3;
+    }
+    if ((_get_varint(buf, len, &pos, &val) < 0) ||
+        (val > UINT32_MAX - next.time)) {
+        return -EILSEQ;
+    }
+    next.time += val;
+    for (unsigned i = 0; i < next.dim; i++) {
+        if (_get_varint(buf, len, &pos, &val) < 0) {
+            return -EILSEQ;
+        }
+        int32_t res = next.data.val[i] + _unzigzag(val);
+        if ((res < INT16_MIN) || (res > INT16_MAX)) {
+            return -EILSEQ;
+        }
+        next.data.val[i] = res;
+    }
+    *sample = next;
+    return pos;
+}
+
+static int _read(const tsdb_t *db, uint32_t sector, uint32_t offset,
+                 void *buf, uint32_t len)
+{
+    int res = mtd_read(db->dev, buf, _sector_addr(db, sector) + offset, len);
+    if (res < 0) {
+        return res;
+    }
+    if (db->used && (sector == db->head)) {
+        uint32_t start = (offset > db->flushed) ? offset : db->flushed;
+        uint32_t end = (offset + len < db->offset) ? offset + len : db->offset;
+        if (start < end) {
+            memcpy((uint8_t *)buf + (start - offset),
+                   db->page + (start % db->dev->page_size), end - start);
+        }
+    }
+    return 0;
+}
+
+static int _read_hdr(const tsdb_t *db, uint32_t sector, sector_hdr_t *hdr)
+{
+    int res = mtd_read(db->dev, hdr, _sector_addr(db, sector), SECTOR_HDR);
+    return (res < 0) ? res : 0;
+}
+
+static int _read_record(const tsdb_t *db, uint32_t sector, uint32_t offset,
+                        tsdb_sample_t *sample)
+{
+    uint8_t buf[TSDB_RECORD_MAX];
+    uint32_t len = db->sector_size - offset;
+
+    if (len > sizeof(buf)) {
+        len = sizeof(buf);
+    }
+    int res = _read(db, sector, offset, buf, len);
+    if (res < 0) {
+        return res;
+    }
+    return _decode(buf, len, sample);
+}
+
+static int _flush(tsdb_t *db)
+{
+    if (db->flushed < db->offset) {
+        int res = mtd_write(db->dev, db->page + (db->flushed % db->dev->page_size),
+                            _sector_addr(db, db->head) + db->flushed,
+                            db->offset - db->flushed);
+        if (res < 0) {
+            return res;
+        }
+        db->flushed = db->offset;
+    }
+    return 0;
+}
+
+static int _open_sector(tsdb_t *db, uint32_t time)
+{
+    uint32_t count = db->dev->sector_count;
+    uint32_t next = 0;
+    sector_hdr_t hdr = {
+        .magic = MAGIC,
+        .seq = 0,
+        .time = time,
+    };
+    int res;
+
+    if (db->used) {
+        next = (db->head + 1) % count;
+        hdr.seq = db->seq + 1;
+    }
+    else {
+        db->tail = 0;
+    }
+    if (db->used == count) {
+        /* drop the oldest sector */
+        db->tail = (db->tail + 1) % count;
+        db->used--;
+    }
+    DEBUG("tsdb: open sector %" PRIu32 " seq %" PRIu32 "\n", next, hdr.seq);
+
+    res = mtd_erase(db->dev, _sector_addr(db, next), db->sector_size);
+    if (res < 0) {
+        return res;
+    }
+    /* the magic last, a sector is valid only with a complete header */
+    memcpy(db->page, &hdr, SECTOR_HDR);
+    res = mtd_write(db->dev, db->page + sizeof(hdr.magic),
+                    _sector_addr(db, next) + sizeof(hdr.magic),
+                    SECTOR_HDR - sizeof(hdr.magic));
+    if (res >= 0) {
+        res = mtd_write(db->dev, db->page, _sector_addr(db, next),
+                        sizeof(hdr.magic));
+    }
+    if (res < 0) {
+        return res;
+    }
+
+    db->head = next;
+    db->seq = hdr.seq;
+    db->used++;
+    db->offset = SECTOR_HDR;
+    db->flushed = SECTOR_HDR;
+    _reset(&db->last, time);
+    return 0;
+}
+
+int tsdb_init(tsdb_t *db)
+{
+    mtd_dev_t *dev = db->dev;
+    uint32_t min_seq = 0;
+    sector_hdr_t hdr;
+    int res;
+
+    mutex_init(&db->lock);
+    res = mtd_init(dev);
+    if (res < 0) {
+        return res;
+    }
+    db->sector_size = dev->pages_per_sector * dev->page_size;
+    if ((dev->sector_count < 2) || (dev->page_size < SECTOR_HDR) ||
+        (db->sector_size < SECTOR_HDR + TSDB_RECORD_MAX)) {
+        return -EINVAL;
+    }
+
+    db->used = 0;
+    db->offset = 0;
+    db->flushed = 0;
+    for (uint32_t sector = 0; sector < dev->sector_count; sector++) {
+        res = _read_hdr(db, sector, &hdr);
+        if (res < 0) {
+            return res;
+        }
+        if (hdr.magic != MAGIC) {
+            continue;
+        }
+        if (!db->used || (hdr.seq > db->seq)) {
+            db->seq = hdr.seq;
+            db->head = sector;
+        }
+        if (!db->used || (hdr.seq < min_seq)) {
+            min_seq = hdr.seq;
+            db->tail = sector;
+        }
+        db->used = 1;
+    }
+    if (!db->used) {
+        return 0;
+    }
+    db->used = (db->head + dev->sector_count - db->tail) % dev->sector_count + 1;
+
+    /* find the end of the head sector, restoring the last sample */
+    res = _read_hdr(db, db->head, &hdr);
+    if (res < 0) {
+        return res;
+    }
+    _reset(&db->last, hdr.time);
+    uint32_t offset = SECTOR_HDR;
+    while (offset < db->sector_size) {
+        res = _read_record(db, db->head, offset, &db->last);
+        if (res <= 0) {
+            break;
+        }
+        offset += res;
+    }
+    if (res == -EILSEQ) {
+        /* interrupted sample, continue in the next sector */
+        DEBUG("tsdb: damaged record at %" PRIu32 "\n", offset);
+        offset = db->sector_size;
+    }
+    else if (res < 0) {
+        return res;
+    }
+    if (offset < db->sector_size) {
+        uint32_t page = offset - (offset % dev->page_size);
+        res = mtd_read(dev, db->page, _sector_addr(db, db->head) + page,
+                       dev->page_size);
+        if (res < 0) {
+            return res;
+        }
+    }
+    db->offset = offset;
+    db->flushed = offset;
+    return 0;
+}
+
+int tsdb_clear(tsdb_t *db)
+{
+    int res;
+
+    mutex_lock(&db->lock);
+    res = mtd_erase(db->dev, 0, db->dev->sector_count * db->sector_size);
+    if (res >= 0) {
+        res = 0;
+        db->used = 0;
+        db->offset = 0;
+        db->flushed = 0;
+    }
+    mutex_unlock(&db->lock);
+    return res;
+}
+
+static int _append(tsdb_t *db, const tsdb_sample_t *sample)
+{
+    uint32_t page_size = db->dev->page_size;
+    uint8_t rec[TSDB_RECORD_MAX];
+    size_t len = 0;
+    int res;
+
+    if (db->used) {
+        if (sample->time < db->last.time) {
+            return -EINVAL;
+        }
+        len = _encode(rec, &db->last, sample);
+    }
+    if (!db->used || (db->offset + len > db->sector_size)) {
+        if (db->used) {
+            res = _flush(db);
+            if (res < 0) {
+                return res;
+            }
+        }
+        res = _open_sector(db, sample->time);
+        if (res < 0) {
+            return res;
+        }
+        len = _encode(rec, &db->last, sample);
+    }
+
+    for (size_t done = 0; done < len;) {
+        uint32_t pos = db->offset % page_size;
+        size_t n = page_size - pos;
+        if (n > len - done) {
+            n = len - done;
+        }
+        memcpy(db->page + pos, rec + done, n);
+        db->offset += n;
+        done += n;
+        if (pos + n == page_size) {
+            res = _flush(db);
+            if (res < 0) {
+                /* give up on the sector, the record is incomplete */
+                db->offset = db->sector_size;
+                db->flushed = db->sector_size;
+                return res;
+            }
+        }
+    }
+    /* like _decode(), keep the values beyond the dimension of the sample,
+     * the ones passed in there are undefined */
+    db->last.time = sample->time;
+    db->last.dim = sample->dim;
+    db->last.data.unit = sample->data.unit;
+    db->last.data.scale = sample->data.scale;
+    memcpy(db->last.data.val, sample->data.val,
+           sample->dim * sizeof(sample->data.val[0]));
+    return 0;
+}
+
+int tsdb_append(tsdb_t *db, uint32_t time, const phydat_t *data, uint8_t dim)
+{
+    tsdb_sample_t sample = {
+        .time = time,
+        .data = *data,
+        .dim = dim,
+    };
+    int res;
+
+    if (!dim || (dim > PHYDAT_DIM)) {
+        return -EINVAL;
+    }
+    mutex_lock(&db->lock);
+    res = _append(db, &sample);
+    mutex_unlock(&db->lock);
+    return res;
+}
+
+#ifdef MODULE_SAUL_REG
+int tsdb_append_saul(tsdb_t *db, uint32_t time, saul_reg_t *dev)
+{
+    phydat_t data;
+
+    int dim = saul_reg_read(dev, &data);
+    if (dim < 0) {
+        return dim;
+    }
+    if (dim == 0) {
+        return -EINVAL;
+    }
+    return tsdb_append(db, time, &data, dim);
+}
+#endif
+
+int tsdb_flush(tsdb_t *db)
+{
+    int res = 0;
+
+    mutex_lock(&db->lock);
+    if (db->used) {
+        res = _flush(db);
+    }
+    mutex_unlock(&db->lock);
+    return res;
+}
+
+static int _iter_seek(tsdb_iter_t *it, uint32_t sector)
+{
+    sector_hdr_t hdr;
+
+    int res = _read_hdr(it->db, sector, &hdr);
+    if (res < 0) {
+        return res;
+    }
+    it->sector = sector;
+    it->seq = hdr.seq;
+    it->offset = SECTOR_HDR;
+    _reset(&it->last, hdr.time);
+    return 0;
+}
+
+int tsdb_iter_init(tsdb_t *db, tsdb_iter_t *it, uint32_t from, uint32_t to)
+{
+    uint32_t count = db->dev->sector_count;
+    sector_hdr_t hdr;
+    int res = 0;
+
+    it->db = db;
+    it->from = from;
+    it->to = to;
+    /* positioned at the oldest sample on the first call */
+    it->offset = 0;
+
+    mutex_lock(&db->lock);
+    if (db->used) {
+        /* last sector starting before from, samples with the same time
+         * may span several sectors */
+        uint32_t lo = 0;
+        uint32_t hi = db->used - 1;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo + 1) / 2;
+            res = _read_hdr(db, (db->tail + mid) % count, &hdr);
+            if (res < 0) {
+                goto out;
+            }
+            if (hdr.time < from) {
+                lo = mid;
+            }
+            else {
+                hi = mid - 1;
+            }
+        }
+        res = _iter_seek(it, (db->tail + lo) % count);
+    }
+
+out:
+    mutex_unlock(&db->lock);
+    return res;
+}
+
+static int _iter_next(tsdb_iter_t *it, tsdb_sample_t *sample)
+{
+    tsdb_t *db = it->db;
+    sector_hdr_t hdr;
+    int res;
+
+    if (!db->used) {
+        return 0;
+    }
+    if (it->offset) {
+        res = _read_hdr(db, it->sector, &hdr);
+        if (res < 0) {
+            return res;
+        }
+    }
+    if (!it->offset || (hdr.magic != MAGIC) || (hdr.seq != it->seq)) {
+        /* empty at init or overwritten since */
+        res = _iter_seek(it, db->tail);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    while (1) {
+        tsdb_sample_t next = it->last;
+
+        res = 0;
+        if (it->offset < db->sector_size) {
+            res = _read_record(db, it->sector, it->offset, &next);
+        }
+        if (res > 0) {
+            if (next.time > it->to) {
+                return 0;
+            }
+            it->offset += res;
+            it->last = next;
+            if (next.time >= it->from) {
+                *sample = next;
+                return 1;
+            }
+            continue;
+        }
+        if (res != -EILSEQ && res < 0) {
+            return res;
+        }
+
+        /* end of the sector */
+        if (it->sector == db->head) {
+            return 0;
+        }
+        uint32_t sector = (it->sector + 1) % db->dev->sector_count;
+        res = _read_hdr(db, sector, &hdr);
+        if (res < 0) {
+            return res;
+        }
+        if ((hdr.magic != MAGIC) || (hdr.seq <= it->seq)) {
+            return 0;
+        }
+        res = _iter_seek(it, sector);
+        if (res < 0) {
+            return res;
+        }
+    }
+}
+
+int tsdb_iter_next(tsdb_iter_t *it, tsdb_sample_t *sample)
+{
+    int res;
+
+    mutex_lock(&it->db->lock);
+    res = _iter_next(it, sample);
+    mutex_unlock(&it->db->lock);
+    return res;
+}
+
+static bool _serialize(cbor_stream_t *stream, const tsdb_sample_t *sample)
+{
+    if (!cbor_serialize_array(stream, 3 + sample->dim) ||
+        !cbor_serialize_uint64_t(stream, sample->time) ||
+        !cbor_serialize_int(stream, sample->data.unit) ||
+        !cbor_serialize_int(stream, sample->data.scale)) {
+        return false;
+    }
+    for (unsigned i = 0; i < sample->dim; i++) {
+        if (!cbor_serialize_int(stream, sample->data.val[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int tsdb_export_cbor(tsdb_iter_t *it, cbor_stream_t *stream)
+{
+    size_t start = stream->pos;
+    tsdb_sample_t sample;
+    bool full = false;
+    int count = 0;
+    int res;
+
+    if (stream->size - stream->pos < 2) {
+        return -ENOSPC;
+    }
+    /* keep one byte for the break */
+    stream->size--;
+    if (!cbor_serialize_array_indefinite(stream)) {
+        stream->size++;
+        return -ENOSPC;
+    }
+
+    mutex_lock(&it->db->lock);
+    while (1) {
+        tsdb_iter_t prev = *it;
+        size_t pos = stream->pos;
+
+        res = _iter_next(it, &sample);
+        if (res <= 0) {
+            break;
+        }
+        if (!_serialize(stream, &sample)) {
+            stream->pos = pos;
+            *it = prev;
+            full = true;
+            break;
+        }
+        count++;
+    }
+    mutex_unlock(&it->db->lock);
+
+    stream->size++;
+    if (!count) {
+        stream->pos = start;
+        return full ? -ENOSPC : res;
+    }
+    cbor_write_break(stream);
+    return count;
+}
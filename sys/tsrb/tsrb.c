@@ -17,22 +17,62 @@
  * @}
  */
 
+#include <string.h>
+
 #include "tsrb.h"
 
-static void _push(tsrb_t *rb, char c)
+/* Each counter is only ever written by one side: `writes` by the producer,
+ * `reads` by the consumer. A side may thus read its own counter relaxed, but
+ * has to acquire the other side's counter before touching the buffer and
+ * release its own counter after being done with it. */
+
+static inline unsigned _own(atomic_uint *cnt)
+{
+    return atomic_load_explicit(cnt, memory_order_relaxed);
+}
+
+static inline unsigned _other(const atomic_uint *cnt)
+{
+    return atomic_load_explicit(cnt, memory_order_acquire);
+}
+
+static inline void _publish(atomic_uint *cnt, unsigned val)
+{
+    atomic_store_explicit(cnt, val, memory_order_release);
+}
+
+static void _copy_out(const tsrb_t *rb, unsigned pos, char *dst, size_t n)
 {
-    rb->buf[rb->writes++ & (rb->size - 1)] = c;
+    size_t idx = pos & (rb->size - 1);
+    size_t first = rb->size - idx;
+
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, rb->buf + idx, first);
+    memcpy(dst + first, rb->buf, n - first);
 }
 
-static char _pop(tsrb_t *rb)
+static void _copy_in(tsrb_t *rb, unsigned pos, const char *src, size_t n)
 {
-    return rb->buf[rb->reads++ & (rb->size - 1)];
+    size_t idx = pos & (rb->size - 1);
+    size_t first = rb->size - idx;
+
+    if (first > n) {
+        first = n;
+    }
+    memcpy(rb->buf + idx, src, first);
+    memcpy(rb->buf, src + first, n - first);
 }
 
 int tsrb_get_one(tsrb_t *rb)
 {
-    if (!tsrb_empty(rb)) {
-        return _pop(rb);
+    unsigned reads = _own(&rb->reads);
+
+    if (_other(&rb->writes) != reads) {
+        int c = (unsigned char)rb->buf[reads & (rb->size - 1)];
+        _publish(&rb->reads, reads + 1);
+        return c;
     }
     else {
         return -1;
@@ -41,18 +81,38 @@ int tsrb_get_one(tsrb_t *rb)
 
 int tsrb_get(tsrb_t *rb, char *dst, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_empty(rb)) {
-        *dst++ = _pop(rb);
-        tmp--;
+    unsigned reads = _own(&rb->reads);
+    size_t avail = _other(&rb->writes) - reads;
+
+    if (n > avail) {
+        n = avail;
     }
-    return (n - tmp);
+    _copy_out(rb, reads, dst, n);
+    _publish(&rb->reads, reads + n);
+
+    return n;
+}
+
+int tsrb_drop(tsrb_t *rb, size_t n)
+{
+    unsigned reads = _own(&rb->reads);
+    size_t avail = _other(&rb->writes) - reads;
+
+    if (n > avail) {
+        n = avail;
+    }
+    _publish(&rb->reads, reads + n);
+
+    return n;
 }
 
 int tsrb_add_one(tsrb_t *rb, char c)
 {
-    if (!tsrb_full(rb)) {
-        _push(rb, c);
+    unsigned writes = _own(&rb->writes);
+
+    if ((writes - _other(&rb->reads)) != rb->size) {
+        rb->buf[writes & (rb->size - 1)] = c;
+        _publish(&rb->writes, writes + 1);
         return 0;
     }
     else {
@@ -62,10 +122,38 @@ int tsrb_add_one(tsrb_t *rb, char c)
 
 int tsrb_add(tsrb_t *rb, const char *src, size_t n)
 {
-    size_t tmp = n;
-    while (tmp && !tsrb_full(rb)) {
-        _push(rb, *src++);
-        tmp--;
+    unsigned writes = _own(&rb->writes);
+    size_t free = rb->size - (writes - _other(&rb->reads));
+
+    if (n > free) {
+        n = free;
     }
-    return (n - tmp);
+    _copy_in(rb, writes, src, n);
+    _publish(&rb->writes, writes + n);
+
+    return n;
+}
+
+size_t tsrb_reserve(const tsrb_t *rb, size_t offset, char **dst)
+{
+    unsigned writes = atomic_load_explicit(&rb->writes, memory_order_relaxed);
+    size_t free = rb->size - (writes - _other(&rb->reads));
+
+    if (offset >= free) {
+        return 0;
+    }
+
+    size_t idx = (writes + offset) & (rb->size - 1);
+    size_t n = rb->size - idx;
+    if (n > (free - offset)) {
+        n = free - offset;
+    }
+    *dst = rb->buf + idx;
+
+    return n;
+}
+
+void tsrb_commit(tsrb_t *rb, size_t n)
+{
+    _publish(&rb->writes, _own(&rb->writes) + n);
 }
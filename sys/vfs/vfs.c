@@ -17,6 +17,8 @@
 #include <errno.h> /* for error codes */
 #include <string.h> /* for strncmp */
 #include <stddef.h> /* for NULL */
+#include <stdbool.h> /* for bool */
+#include <stdint.h> /* for uint32_t */
 #include <sys/types.h> /* for off_t etc */
 #include <sys/stat.h> /* for struct stat */
 #include <sys/statvfs.h> /* for struct statvfs */
@@ -27,6 +29,7 @@
 #include "thread.h"
 #include "kernel_types.h"
 #include "clist.h"
+#include "bitarithm.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
@@ -58,6 +61,45 @@ static vfs_file_t _vfs_open_files[VFS_MAX_OPEN_FILES];
  */
 static clist_node_t _vfs_mounts_list;
 
+/**
+ * @internal
+ * @brief First mount at the top level of the mount tree
+ *
+ * Each mount is a child of the closest mount whose mount point contains its
+ * own, so a path lookup only compares the path with the mounts along one
+ * branch of the tree and their siblings.
+ */
+static vfs_mount_t *_vfs_mount_tree;
+
+/**
+ * @internal
+ * @brief Number of fds tracked by one word of _vfs_fds_used
+ */
+#define FD_BITS (sizeof(unsigned) * 8)
+
+/**
+ * @internal
+ * @brief Bitmap of the used entries in the _vfs_open_files array
+ */
+static unsigned _vfs_fds_used[(VFS_MAX_OPEN_FILES + FD_BITS - 1) / FD_BITS];
+
+#if VFS_LOOKUP_CACHE_SIZE
+/**
+ * @internal
+ * @brief Mount found for a directory by a recent lookup
+ */
+typedef struct {
+    uint32_t dir_hash;          /**< hash of the directory part of the path */
+    vfs_mount_t *mountp;        /**< mount found for the path */
+} _lookup_cache_t;
+
+/**
+ * @internal
+ * @brief Recent lookups, indexed by the hash of the directory
+ */
+static _lookup_cache_t _vfs_lookup_cache[VFS_LOOKUP_CACHE_SIZE];
+#endif
+
 /**
  * @internal
  * @brief Find an unused entry in the _vfs_open_files array and mark it as used
@@ -117,6 +159,46 @@ inline static int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *moun
  */
 inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path);
 
+/**
+ * @internal
+ * @brief Check whether the mount point of @p mountp contains @p path
+ *
+ * @param[in]  mountp    mount to check
+ * @param[in]  path      absolute path
+ *
+ * @return true if @p path is below or equal to the mount point
+ */
+inline static bool _mount_contains(const vfs_mount_t *mountp, const char *path);
+
+/**
+ * @internal
+ * @brief Find the deepest mount containing @p path in the mount tree
+ *
+ * @param[in]  start     mount containing @p path to start at, NULL for the
+ *                       top level of the tree
+ * @param[in]  path      absolute path
+ *
+ * @return the mount on success
+ * @return NULL if no mount contains @p path
+ */
+static vfs_mount_t *_lookup(vfs_mount_t *start, const char *path);
+
+/**
+ * @internal
+ * @brief Insert a mount into the mount tree
+ *
+ * @param[in]  mountp    mount to insert
+ */
+static void _mount_tree_insert(vfs_mount_t *mountp);
+
+/**
+ * @internal
+ * @brief Remove a mount from the mount tree, its children take its place
+ *
+ * @param[in]  mountp    mount to remove
+ */
+static void _mount_tree_remove(vfs_mount_t *mountp);
+
 /**
  * @internal
  * @brief Check that a given fd number is valid
@@ -128,6 +210,20 @@ inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
  */
 inline static int _fd_is_valid(int fd);
 
+/**
+ * @internal
+ * @brief Move data from @p in to @p out once, used by vfs_sendfile
+ *
+ * @param[in]  in_fd    fd number of @p in
+ * @param[in]  out      file to write to
+ * @param[in]  in       file to read from
+ * @param[in]  count    maximum number of bytes to move
+ *
+ * @return number of bytes written to @p out
+ * @return <0 on error
+ */
+static ssize_t _sendfile_chunk(int in_fd, vfs_file_t *out, vfs_file_t *in, size_t count);
+
 static mutex_t _mount_mutex = MUTEX_INIT;
 static mutex_t _open_mutex = MUTEX_INIT;
 
@@ -332,6 +428,201 @@ ssize_t vfs_write(int fd, const void *src, size_t count)
     return filp->f_op->write(filp, src, count);
 }
 
+ssize_t vfs_readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    DEBUG("vfs_readv: %d, %p, %d\n", fd, (void *)iov, iovcnt);
+    if ((iov == NULL) || (iovcnt < 0)) {
+        return -EINVAL;
+    }
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_RDONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for reading */
+        return -EBADF;
+    }
+    if (filp->f_op->readv != NULL) {
+        return filp->f_op->readv(filp, iov, iovcnt);
+    }
+    if (filp->f_op->read == NULL) {
+        /* driver does not implement read() */
+        return -EINVAL;
+    }
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        ssize_t n = filp->f_op->read(filp, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            /* report the data read so far, the error is seen again next time */
+            return (total > 0) ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t vfs_writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    DEBUG_NOT_STDOUT(fd, "vfs_writev: %d, %p, %d\n", fd, (void *)iov, iovcnt);
+    if ((iov == NULL) || (iovcnt < 0)) {
+        return -EINVAL;
+    }
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_WRONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for writing */
+        return -EBADF;
+    }
+    if (filp->f_op->writev != NULL) {
+        return filp->f_op->writev(filp, iov, iovcnt);
+    }
+    if (filp->f_op->write == NULL) {
+        /* driver does not implement write() */
+        return -EINVAL;
+    }
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+        ssize_t n = filp->f_op->write(filp, iov[i].iov_base, iov[i].iov_len);
+        if (n < 0) {
+            return (total > 0) ? total : n;
+        }
+        total += n;
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+
+static ssize_t _sendfile_chunk(int in_fd, vfs_file_t *out, vfs_file_t *in, size_t count)
+{
+    if (out->f_op->sendfile != NULL) {
+        /* destination reads into its own buffers */
+        off_t pos = vfs_lseek(in_fd, 0, SEEK_CUR);
+        if (pos < 0) {
+            return pos;
+        }
+        ssize_t res = out->f_op->sendfile(out, in, count);
+        if (res != -ENOTSUP) {
+            /* the driver may have read more than it managed to send, only
+             * what was sent is consumed */
+            off_t res_off = vfs_lseek(in_fd, pos + ((res > 0) ? res : 0), SEEK_SET);
+            if ((res_off < 0) && (res >= 0)) {
+                return res_off;
+            }
+            return res;
+        }
+        vfs_lseek(in_fd, pos, SEEK_SET);
+    }
+    if (out->f_op->write == NULL) {
+        return -EINVAL;
+    }
+
+    const void *data;
+    ssize_t n;
+    uint8_t buf[VFS_SENDFILE_BUFFER_SIZE];
+    if (in->f_op->map != NULL) {
+        /* source is in memory */
+        n = in->f_op->map(in, &data, count);
+        if (n <= 0) {
+            return n;
+        }
+    }
+    else {
+        if (in->f_op->read == NULL) {
+            return -EINVAL;
+        }
+        n = in->f_op->read(in, buf, (count < sizeof(buf)) ? count : sizeof(buf));
+        if (n <= 0) {
+            return n;
+        }
+        data = buf;
+    }
+
+    ssize_t written = out->f_op->write(out, data, n);
+    /* mapped data is consumed by advancing the file position, data read but
+     * not written is given back */
+    off_t seek = (written < 0) ? 0 : written;
+    if (data == buf) {
+        seek -= n;
+    }
+    if (seek != 0) {
+        off_t res = vfs_lseek(in_fd, seek, SEEK_CUR);
+        if ((res < 0) && (written >= 0)) {
+            return res;
+        }
+    }
+    return written;
+}
+
+ssize_t vfs_sendfile(int out_fd, int in_fd, off_t *offset, size_t count)
+{
+    DEBUG("vfs_sendfile: %d, %d, %p, %lu\n", out_fd, in_fd, (void *)offset,
+          (unsigned long)count);
+    int res = _fd_is_valid(out_fd);
+    if (res < 0) {
+        return res;
+    }
+    res = _fd_is_valid(in_fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *out = &_vfs_open_files[out_fd];
+    vfs_file_t *in = &_vfs_open_files[in_fd];
+    if ((((out->flags & O_ACCMODE) != O_WRONLY) & ((out->flags & O_ACCMODE) != O_RDWR)) ||
+        (((in->flags & O_ACCMODE) != O_RDONLY) & ((in->flags & O_ACCMODE) != O_RDWR))) {
+        return -EBADF;
+    }
+
+    off_t pos = 0;
+    if (offset != NULL) {
+        pos = vfs_lseek(in_fd, 0, SEEK_CUR);
+        if (pos < 0) {
+            return pos;
+        }
+        off_t res_off = vfs_lseek(in_fd, *offset, SEEK_SET);
+        if (res_off < 0) {
+            return res_off;
+        }
+    }
+
+    ssize_t total = 0;
+    while ((size_t)total < count) {
+        ssize_t n = _sendfile_chunk(in_fd, out, in, count - total);
+        if (n < 0) {
+            if (total == 0) {
+                total = n;
+            }
+            break;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+
+    if (offset != NULL) {
+        if (total > 0) {
+            *offset += total;
+        }
+        vfs_lseek(in_fd, pos, SEEK_SET);
+    }
+    return total;
+}
+
 int vfs_opendir(vfs_DIR *dirp, const char *dirname)
 {
     DEBUG("vfs_opendir: %p, \"%s\"\n", (void *)dirp, dirname);
@@ -440,6 +731,7 @@ int vfs_mount(vfs_mount_t *mountp)
     }
     /* insert last in list */
     clist_rpush(&_vfs_mounts_list, &mountp->list_entry);
+    _mount_tree_insert(mountp);
     mutex_unlock(&_mount_mutex);
     DEBUG("vfs_mount: mount done\n");
     return 0;
@@ -477,6 +769,11 @@ int vfs_umount(vfs_mount_t *mountp)
         mutex_unlock(&_mount_mutex);
         return -EINVAL;
     }
+    _mount_tree_remove(mountp);
+#if VFS_LOOKUP_CACHE_SIZE
+    /* forget lookups that might start at the removed mount */
+    memset(_vfs_lookup_cache, 0, sizeof(_vfs_lookup_cache));
+#endif
     mutex_unlock(&_mount_mutex);
     return 0;
 }
@@ -813,16 +1110,20 @@ const vfs_mount_t *vfs_iterate_mounts(const vfs_mount_t *cur)
 inline static int _allocate_fd(int fd)
 {
     if (fd < 0) {
-        for (fd = 0; fd < VFS_MAX_OPEN_FILES; ++fd) {
-            if (_vfs_open_files[fd].pid == KERNEL_PID_UNDEF) {
+        for (unsigned i = 0; i < sizeof(_vfs_fds_used) / sizeof(_vfs_fds_used[0]); ++i) {
+            if (~_vfs_fds_used[i]) {
+                fd = i * FD_BITS + bitarithm_lsb(~_vfs_fds_used[i]);
                 break;
             }
         }
-        if (fd >= VFS_MAX_OPEN_FILES) {
+        if ((fd < 0) || (fd >= VFS_MAX_OPEN_FILES)) {
             /* The _vfs_open_files array is full */
             return -ENFILE;
         }
     }
+    else if (fd >= VFS_MAX_OPEN_FILES) {
+        return -EBADF;
+    }
     else if (_vfs_open_files[fd].pid != KERNEL_PID_UNDEF) {
         /* The desired fd is already in use */
         return -EEXIST;
@@ -834,6 +1135,7 @@ inline static int _allocate_fd(int fd)
         pid = -1;
     }
     _vfs_open_files[fd].pid = pid;
+    _vfs_fds_used[fd / FD_BITS] |= (1u << (fd % FD_BITS));
     return fd;
 }
 
@@ -843,7 +1145,10 @@ inline static void _free_fd(int fd)
     if (_vfs_open_files[fd].mp != NULL) {
         atomic_fetch_sub(&_vfs_open_files[fd].mp->open_files, 1);
     }
+    mutex_lock(&_open_mutex);
     _vfs_open_files[fd].pid = KERNEL_PID_UNDEF;
+    _vfs_fds_used[fd / FD_BITS] &= ~(1u << (fd % FD_BITS));
+    mutex_unlock(&_open_mutex);
 }
 
 inline static int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *mountp, int flags, void *private_data)
@@ -861,44 +1166,120 @@ inline static int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *moun
     return fd;
 }
 
-inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path)
+inline static bool _mount_contains(const vfs_mount_t *mountp, const char *path)
 {
-    size_t longest_match = 0;
-    size_t name_len = strlen(name);
-    mutex_lock(&_mount_mutex);
+    /* mount points differ from each other in the first few characters
+     * usually, this is cheaper than calling strncmp */
+    for (const char *m = mountp->mount_point; *m != '\0'; ++m, ++path) {
+        if (*path != *m) {
+            return false;
+        }
+    }
+    /* "/" contains everything, other mount points need a directory separator
+     * where they end */
+    return (mountp->mount_point_len == 1) || (*path == '/') || (*path == '\0');
+}
 
-    clist_node_t *node = _vfs_mounts_list.next;
-    if (node == NULL) {
-        /* list empty */
-        mutex_unlock(&_mount_mutex);
-        return -ENOENT;
+static vfs_mount_t *_lookup(vfs_mount_t *start, const char *path)
+{
+    vfs_mount_t *mountp = start;
+    vfs_mount_t *it = (start != NULL) ? start->children : _vfs_mount_tree;
+    /* siblings don't contain each other, so at most one of them matches */
+    while (it != NULL) {
+        if (_mount_contains(it, path)) {
+            mountp = it;
+            it = it->children;
+        }
+        else {
+            it = it->sibling;
+        }
     }
-    vfs_mount_t *mountp = NULL;
-    do {
-        node = node->next;
-        vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
-        size_t len = it->mount_point_len;
-        if (len < longest_match) {
-            /* Already found a longer prefix */
-            continue;
+    return mountp;
+}
+
+static void _mount_tree_insert(vfs_mount_t *mountp)
+{
+    /* the same mount point mounted twice ends up below the first one, so the
+     * last mount shadows the others like before */
+    vfs_mount_t *parent = _lookup(NULL, mountp->mount_point);
+    vfs_mount_t **list = (parent != NULL) ? &parent->children : &_vfs_mount_tree;
+    mountp->parent = parent;
+    mountp->children = NULL;
+    /* siblings contained in the new mount become its children */
+    vfs_mount_t **it = list;
+    while (*it != NULL) {
+        vfs_mount_t *sibling = *it;
+        if (_mount_contains(mountp, sibling->mount_point)) {
+            *it = sibling->sibling;
+            sibling->parent = mountp;
+            sibling->sibling = mountp->children;
+            mountp->children = sibling;
         }
-        if (len > name_len) {
-            /* path name is shorter than the mount point name */
-            continue;
+        else {
+            it = &sibling->sibling;
         }
-        if ((len > 1) && (name[len] != '/') && (name[len] != '\0')) {
-            /* name does not have a directory separator where mount point name ends */
-            continue;
+    }
+    mountp->sibling = *list;
+    *list = mountp;
+}
+
+static void _mount_tree_remove(vfs_mount_t *mountp)
+{
+    vfs_mount_t **list = (mountp->parent != NULL) ? &mountp->parent->children : &_vfs_mount_tree;
+    for (vfs_mount_t **it = list; *it != NULL; it = &(*it)->sibling) {
+        if (*it == mountp) {
+            *it = mountp->sibling;
+            break;
         }
-        if (strncmp(name, it->mount_point, len) == 0) {
-            /* mount_point is a prefix of name */
-            /* special check for mount_point == "/" */
-            if (len > 1) {
-                longest_match = len;
-            }
-            mountp = it;
+    }
+    while (mountp->children != NULL) {
+        vfs_mount_t *child = mountp->children;
+        mountp->children = child->sibling;
+        child->parent = mountp->parent;
+        child->sibling = *list;
+        *list = child;
+    }
+    mountp->parent = NULL;
+    mountp->sibling = NULL;
+}
+
+#if VFS_LOOKUP_CACHE_SIZE
+/* FNV-1a of the path up to its last directory separator */
+static uint32_t _dir_hash(const char *path)
+{
+    uint32_t hash = 2166136261u;
+    uint32_t dir_hash = hash;
+    for (; *path != '\0'; ++path) {
+        if (*path == '/') {
+            dir_hash = hash;
         }
-    } while (node != _vfs_mounts_list.next);
+        hash = (hash ^ (uint8_t)*path) * 16777619u;
+    }
+    return dir_hash;
+}
+#endif
+
+inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path)
+{
+    vfs_mount_t *mountp = NULL;
+    mutex_lock(&_mount_mutex);
+
+#if VFS_LOOKUP_CACHE_SIZE
+    uint32_t dir_hash = _dir_hash(name);
+    _lookup_cache_t *entry = &_vfs_lookup_cache[dir_hash % VFS_LOOKUP_CACHE_SIZE];
+    if ((entry->mountp != NULL) && (entry->dir_hash == dir_hash) &&
+        _mount_contains(entry->mountp, name)) {
+        /* all deeper mounts containing name are below this one in the tree,
+         * so the lookup is right even if another directory has the same hash */
+        mountp = entry->mountp;
+    }
+    mountp = _lookup(mountp, name);
+    entry->dir_hash = dir_hash;
+    entry->mountp = mountp;
+#else
+    mountp = _lookup(NULL, name);
+#endif
+
     if (mountp == NULL) {
         /* not found */
         mutex_unlock(&_mount_mutex);
@@ -909,7 +1290,8 @@ inline static int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
     mutex_unlock(&_mount_mutex);
     *mountpp = mountp;
     if (rel_path != NULL) {
-        *rel_path = name + longest_match;
+        /* special case for mount_point == "/" */
+        *rel_path = name + ((mountp->mount_point_len > 1) ? mountp->mount_point_len : 0);
     }
     return 0;
 }
@@ -24,6 +24,10 @@
 #include "xtimer.h"
 #include "irq.h"
 
+#ifdef MODULE_XTIMER_TICKLESS
+#include "periph/rtt.h"
+#endif
+
 /* WARNING! enabling this will have side effects and can lead to timer underflows. */
 #define ENABLE_DEBUG 0
 #include "debug.h"
@@ -41,6 +45,31 @@ static xtimer_t *timer_list_head = NULL;
 static xtimer_t *overflow_list_head = NULL;
 static xtimer_t *long_list_head = NULL;
 
+#ifdef MODULE_XTIMER_STATS
+static xtimer_stats_t _stats;
+#endif
+
+#ifdef MODULE_XTIMER_TICKLESS
+/**
+ * @brief length of one low-level timer period in ticks
+ */
+#define XTIMER_PERIOD       ((uint64_t)1 << XTIMER_WIDTH)
+
+volatile int _xtimer_tickless_suspended = 0;
+
+/* set if the low-level timer is still armed for an already removed timer */
+static int _lltimer_deferred = 0;
+/* (masked) value the low-level timer was last armed with */
+static uint32_t _lltimer_armed;
+/* 64bit time and RTT counter at the last (re)synchronization */
+static uint64_t _sync_ticks;
+static uint32_t _sync_rtt;
+
+static void _overflow_or_suspend(void);
+static void _tickless_resume(void);
+static void _rtt_callback(void *arg);
+#endif
+
 static void _add_timer_to_list(xtimer_t **list_head, xtimer_t *timer);
 static void _add_timer_to_long_list(xtimer_t **list_head, xtimer_t *timer);
 static void _shoot(xtimer_t *timer);
@@ -71,10 +100,30 @@ void xtimer_init(void)
     /* initialize low-level timer */
     timer_init(XTIMER_DEV, XTIMER_HZ, _periph_timer_callback, NULL);
 
+#ifdef MODULE_XTIMER_TICKLESS
+    rtt_init();
+#endif
+
     /* register initial overflow tick */
     _lltimer_set(0xFFFFFFFF);
 }
 
+#ifdef MODULE_XTIMER_STATS
+void xtimer_get_stats(xtimer_stats_t *stats)
+{
+    unsigned state = irq_disable();
+    *stats = _stats;
+    irq_restore(state);
+}
+
+void xtimer_reset_stats(void)
+{
+    unsigned state = irq_disable();
+    memset(&_stats, 0, sizeof(_stats));
+    irq_restore(state);
+}
+#endif
+
 static void _xtimer_now_internal(uint32_t *short_term, uint32_t *long_term)
 {
     uint32_t before, after, long_value;
@@ -112,6 +161,12 @@ void _xtimer_set64(xtimer_t *timer, uint32_t offset, uint32_t long_offset)
             _remove(timer);
         }
 
+#ifdef MODULE_XTIMER_TICKLESS
+        if (_xtimer_tickless_suspended) {
+            _tickless_resume();
+        }
+#endif
+
         _xtimer_now_internal(&timer->target, &timer->long_target);
         timer->target += offset;
         timer->long_target += long_offset;
@@ -164,6 +219,10 @@ static inline void _lltimer_set(uint32_t target)
     if (_in_handler) {
         return;
     }
+#ifdef MODULE_XTIMER_TICKLESS
+    _lltimer_deferred = 0;
+    _lltimer_armed = _xtimer_lltimer_mask(target);
+#endif
     DEBUG("_lltimer_set(): setting %" PRIu32 "\n", _xtimer_lltimer_mask(target));
     timer_set_absolute(XTIMER_DEV, XTIMER_CHAN, _xtimer_lltimer_mask(target));
 }
@@ -188,6 +247,15 @@ int _xtimer_set_absolute(xtimer_t *timer, uint32_t target)
         _remove(timer);
     }
 
+#ifdef MODULE_XTIMER_TICKLESS
+    if (_xtimer_tickless_suspended) {
+        /* the overflow tick is needed to track the new timer, so resume it
+         * before the timer lists are touched */
+        _tickless_resume();
+        now = _xtimer_now();
+    }
+#endif
+
     timer->target = target;
     timer->long_target = _long_cnt;
     if (target < now) {
@@ -257,8 +325,14 @@ static int _remove_timer_from_list(xtimer_t **list_head, xtimer_t *timer)
 static void _remove(xtimer_t *timer)
 {
     if (timer_list_head == timer) {
-        uint32_t next;
         timer_list_head = timer->next;
+#ifdef MODULE_XTIMER_TICKLESS
+        /* Leave the low-level timer armed. It fires a little early, but
+         * reprogramming it right away is often not worth it, as a new first
+         * timer may be set before. xtimer_idle() catches up on this. */
+        _lltimer_deferred = 1;
+#else
+        uint32_t next;
         if (timer_list_head) {
             /* schedule callback on next timer target time */
             next = timer_list_head->target - XTIMER_OVERHEAD;
@@ -267,6 +341,7 @@ static void _remove(xtimer_t *timer)
             next = _xtimer_lltimer_mask(0xFFFFFFFF);
         }
         _lltimer_set(next);
+#endif
     }
     else {
         if (!_remove_timer_from_list(&timer_list_head, timer)) {
@@ -432,6 +507,20 @@ static void _timer_callback(void)
 {
     uint32_t next_target;
     uint32_t reference;
+#ifdef MODULE_XTIMER_STATS
+    int overflow = 0;
+    int fired = 0;
+#endif
+
+#ifdef MODULE_XTIMER_TICKLESS
+    if (_xtimer_tickless_suspended) {
+        /* stale interrupt of the low-level timer cleared when suspending */
+#ifdef MODULE_XTIMER_STATS
+        _stats.spurious++;
+#endif
+        return;
+    }
+#endif
 
     _in_handler = 1;
 
@@ -439,8 +528,21 @@ static void _timer_callback(void)
           xtimer_now().ticks32, _xtimer_lltimer_mask(xtimer_now().ticks32),
           _xtimer_lltimer_mask(0xffffffff - xtimer_now().ticks32));
 
+#ifdef MODULE_XTIMER_TICKLESS
+    if (_lltimer_deferred) {
+        /* The low-level timer was left armed for a removed timer, so this is
+         * no overflow. Using the compare value as reference makes sure a
+         * wrap-around since is detected below. */
+        _lltimer_deferred = 0;
+        reference = _lltimer_armed;
+    }
+    else
+#endif
     if (!timer_list_head) {
         DEBUG("_timer_callback(): tick\n");
+#ifdef MODULE_XTIMER_STATS
+        overflow = 1;
+#endif
         /* there's no timer for this timer period,
          * so this was a timer overflow callback.
          *
@@ -480,6 +582,9 @@ overflow:
 
         /* fire timer */
         _shoot(timer);
+#ifdef MODULE_XTIMER_STATS
+        fired = 1;
+#endif
     }
 
     /* possibly executing all callbacks took enough
@@ -527,8 +632,200 @@ overflow:
         }
     }
 
+#ifdef MODULE_XTIMER_STATS
+    if (overflow) {
+        _stats.overflow++;
+    }
+    else if (fired) {
+        _stats.timer++;
+    }
+    else {
+        _stats.spurious++;
+    }
+#endif
+
     _in_handler = 0;
 
+#ifdef MODULE_XTIMER_TICKLESS
+    if (!timer_list_head) {
+        /* schedule callback on next overflow, unless it is not needed */
+        _overflow_or_suspend();
+        return;
+    }
+#endif
+
     /* set low level timer */
     _lltimer_set(next_target);
 }
+
+#ifdef MODULE_XTIMER_TICKLESS
+static inline uint64_t _ticks_from_rtt(uint32_t rtt)
+{
+    return ((uint64_t)rtt * XTIMER_HZ) / RTT_FREQUENCY;
+}
+
+static inline uint64_t _rtt_from_ticks(uint64_t ticks)
+{
+    return (ticks * RTT_FREQUENCY) / XTIMER_HZ;
+}
+
+/**
+ * @brief check if the low-level timer counter is about to wrap around
+ */
+static inline int _period_ends_soon(uint32_t now)
+{
+    return (_xtimer_lltimer_mask(now + XTIMER_ISR_BACKOFF) < now);
+}
+
+void _xtimer_tickless_sync(void)
+{
+    unsigned state = irq_disable();
+
+    if (_xtimer_tickless_suspended) {
+        uint32_t rtt_now = rtt_get_counter();
+        uint32_t lltimer_now = _xtimer_lltimer_now();
+        uint64_t estimate = _sync_ticks +
+                            _ticks_from_rtt((rtt_now - _sync_rtt) & RTT_MAX_VALUE);
+
+        /* The RTT is too coarse to yield the exact time, but good enough to
+         * tell the current low-level timer period. Pick the time with the
+         * current counter value that is closest to the estimate. */
+        uint64_t now = (estimate & ~(XTIMER_PERIOD - 1)) | lltimer_now;
+        if (now > estimate + (XTIMER_PERIOD / 2)) {
+            now -= XTIMER_PERIOD;
+        }
+        else if (now + (XTIMER_PERIOD / 2) < estimate) {
+            now += XTIMER_PERIOD;
+        }
+
+        _long_cnt = (uint32_t)(now >> 32);
+#if XTIMER_MASK
+        _xtimer_high_cnt = (uint32_t)now & XTIMER_MASK;
+#endif
+        _sync_ticks = now;
+        _sync_rtt = rtt_now;
+    }
+
+    irq_restore(state);
+}
+
+/**
+ * @brief arm the low-level timer for the next overflow or, if no timer
+ *        expires for a while, stop tracking overflows and sleep on the RTT
+ *
+ * Must be called with interrupts disabled.
+ */
+static void _overflow_or_suspend(void)
+{
+    if (!overflow_list_head) {
+        uint64_t now = _xtimer_now64();
+        uint64_t sleep = XTIMER_TICKLESS_MAX_PERIODS * XTIMER_PERIOD;
+
+        if (long_list_head) {
+            uint64_t target = ((uint64_t)long_list_head->long_target << 32) |
+                              long_list_head->target;
+            /* wake up a period early, the next long timer is picked up by
+             * the regular overflow handling from there */
+            if (target > (now + XTIMER_PERIOD)) {
+                if ((target - now - XTIMER_PERIOD) < sleep) {
+                    sleep = target - now - XTIMER_PERIOD;
+                }
+            }
+            else {
+                sleep = 0;
+            }
+        }
+
+        if (sleep >= (XTIMER_TICKLESS_MIN_PERIODS * XTIMER_PERIOD)) {
+            uint64_t rtt_sleep = _rtt_from_ticks(sleep);
+
+            /* keep the RTT difference unambiguous */
+            if (rtt_sleep > (RTT_MAX_VALUE >> 1)) {
+                rtt_sleep = (RTT_MAX_VALUE >> 1);
+            }
+
+            DEBUG("xtimer: suspending overflow tick for %" PRIu32 " RTT ticks\n",
+                  (uint32_t)rtt_sleep);
+
+            timer_clear(XTIMER_DEV, XTIMER_CHAN);
+            _lltimer_deferred = 0;
+            _sync_ticks = now;
+            _sync_rtt = rtt_get_counter();
+            _xtimer_tickless_suspended = 1;
+            rtt_set_alarm((_sync_rtt + (uint32_t)rtt_sleep) & RTT_MAX_VALUE,
+                          _rtt_callback, NULL);
+#ifdef MODULE_XTIMER_STATS
+            _stats.suspended++;
+#endif
+            return;
+        }
+    }
+
+    _lltimer_set(_xtimer_lltimer_mask(0xFFFFFFFF));
+}
+
+/**
+ * @brief resynchronize and resume the overflow tick
+ *
+ * Must be called with interrupts disabled.
+ */
+static void _tickless_resume(void)
+{
+    /* make sure the overflow is not missed while arming the timer for it */
+    uint32_t now = _xtimer_lltimer_now();
+    if (_period_ends_soon(now)) {
+        while (_xtimer_lltimer_now() >= now) {}
+    }
+
+    _xtimer_tickless_sync();
+    _xtimer_tickless_suspended = 0;
+    rtt_clear_alarm();
+    _lltimer_set(_xtimer_lltimer_mask(0xFFFFFFFF));
+}
+
+static void _rtt_callback(void *arg)
+{
+    (void)arg;
+
+    unsigned state = irq_disable();
+
+#ifdef MODULE_XTIMER_STATS
+    _stats.rtt++;
+#endif
+
+    if (_xtimer_tickless_suspended) {
+        _tickless_resume();
+
+        /* the RTT may be off a little, so the next long timer may already
+         * belong to the current period */
+        _select_long_timers();
+        if (timer_list_head) {
+            _lltimer_set(timer_list_head->target - XTIMER_OVERHEAD);
+        }
+    }
+
+    irq_restore(state);
+}
+
+void xtimer_idle(void)
+{
+    unsigned state = irq_disable();
+
+    if (_lltimer_deferred) {
+        uint32_t now = _xtimer_lltimer_now();
+
+        /* only touch the low-level timer if the stale compare value is not
+         * about to fire (or has fired already) */
+        if (!_period_ends_soon(now) && (_lltimer_armed > (now + XTIMER_ISR_BACKOFF))) {
+            if (timer_list_head) {
+                _lltimer_set(timer_list_head->target - XTIMER_OVERHEAD);
+            }
+            else {
+                _overflow_or_suspend();
+            }
+        }
+    }
+
+    irq_restore(state);
+}
+#endif
@@ -25,12 +25,14 @@
 #include "xtimer.h"
 
 #include "hashes.h"
+#include "hashes/xxhash.h"
 #include "bloom.h"
 #include "random.h"
 #include "bitfield.h"
 
 #define BLOOM_BITS (1UL << 12)
 #define BLOOM_HASHF (8)
+#define BLOOM_BLOCKS (BLOOM_BITS / (8 * BLOOM_BLOCK_SIZE))
 #define lenB 512
 #define lenA (10 * 1000)
 
@@ -49,6 +51,13 @@ hashfp_t hashes[BLOOM_HASHF] = {
     (hashfp_t) rotating_hash, (hashfp_t) one_at_a_time_hash,
 };
 
+static bloom_blocked_t blocked;
+static bloom_counting_t counting;
+/* same number of bits, the counting filter needs 4 bits per cell */
+static bloom_block_t blocks[BLOOM_BLOCKS];
+static bloom_block_t counters[4 * BLOOM_BLOCKS];
+static const uint64_t xxh_seed = myseed;
+
 static void buf_fill(uint32_t *buf, int len)
 {
     for (int k = 0; k < len; k++) {
@@ -56,26 +65,79 @@ static void buf_fill(uint32_t *buf, int len)
     }
 }
 
-int main(void)
+static void _bloom_add(const uint8_t *data, size_t len)
 {
-    xtimer_init();
+    bloom_add(&bloom, data, len);
+}
 
-    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+static bool _bloom_check(const uint8_t *data, size_t len)
+{
+    return bloom_check(&bloom, data, len);
+}
 
-    printf("Testing Bloom filter.\n\n");
-    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) bloom.m,
-           (uint32_t) bloom.k);
+static void _blocked_add(const uint8_t *data, size_t len)
+{
+    bloom_blocked_add(&blocked, data, len);
+}
+
+static bool _blocked_check(const uint8_t *data, size_t len)
+{
+    return bloom_blocked_check(&blocked, data, len);
+}
+
+static void _counting_add(const uint8_t *data, size_t len)
+{
+    bloom_counting_add(&counting, data, len);
+}
+
+static bool _counting_check(const uint8_t *data, size_t len)
+{
+    return bloom_counting_check(&counting, data, len);
+}
+
+static uint32_t _ops_per_sec(unsigned ops, uint32_t usec)
+{
+    return (uint32_t)(((uint64_t)ops * US_PER_SEC) / (usec ? usec : 1));
+}
+
+/* timed separately, so that the time spent in random_uint32() is not counted;
+ * changing one word per operation gives a new element */
+static void _bench(void (*add)(const uint8_t *, size_t),
+                   bool (*check)(const uint8_t *, size_t))
+{
+    unsigned hits = 0;
 
+    uint32_t t1 = xtimer_now_usec();
+    for (uint32_t i = 0; i < lenA; i++) {
+        buf[1] = i;
+        hits += check((uint8_t *) buf, BUF_SIZE * sizeof(uint32_t));
+    }
+    uint32_t t2 = xtimer_now_usec();
+    for (uint32_t i = 0; i < lenB; i++) {
+        buf[1] = i;
+        add((uint8_t *) buf, BUF_SIZE * sizeof(uint32_t));
+    }
+    uint32_t t3 = xtimer_now_usec();
+
+    printf("add: %" PRIu32 " ops/s, check: %" PRIu32 " ops/s (%u hits)\n",
+           _ops_per_sec(lenB, t3 - t2), _ops_per_sec(lenA, t2 - t1), hits);
+}
+
+static void _run(const char *name,
+                 void (*add)(const uint8_t *, size_t),
+                 bool (*check)(const uint8_t *, size_t))
+{
+    /* the same elements for every filter */
     random_init(myseed);
 
+    printf("%s\n", name);
+
     unsigned long t1 = xtimer_now_usec();
 
     for (int i = 0; i < lenB; i++) {
         buf_fill(buf, BUF_SIZE);
         buf[0] = MAGIC_B;
-        bloom_add(&bloom,
-                  (uint8_t *) buf,
-                  BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
+        add((uint8_t *) buf, BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t));
     }
 
     unsigned long t2 = xtimer_now_usec();
@@ -91,9 +153,8 @@ int main(void)
         buf_fill(buf, BUF_SIZE);
         buf[0] = MAGIC_A;
 
-        if (bloom_check(&bloom,
-                        (uint8_t *) buf,
-                        BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
+        if (check((uint8_t *) buf,
+                  BUF_SIZE * sizeof(uint32_t) / sizeof(uint8_t))) {
             in++;
         }
         else {
@@ -105,13 +166,42 @@ int main(void)
     printf("checking %d elements took %" PRIu32 "ms\n", lenA,
            (uint32_t) (t4 - t3) / 1000);
 
-    printf("\n");
     printf("%d elements probably in the filter.\n", in);
     printf("%d elements not in the filter.\n", not_in);
     double false_positive_rate = (double) in / (double) lenA;
     printf("%f false positive rate.\n", false_positive_rate);
 
+    /* adds more elements, so after the false positive rate */
+    _bench(add, check);
+    printf("\n");
+}
+
+int main(void)
+{
+    xtimer_init();
+
+    printf("Testing Bloom filter.\n\n");
+    printf("m: %" PRIu32 " k: %" PRIu32 "\n\n", (uint32_t) BLOOM_BITS,
+           (uint32_t) BLOOM_HASHF);
+
+    bloom_init(&bloom, BLOOM_BITS, bf, hashes, BLOOM_HASHF);
+    _run("bloom_t, k hash functions", _bloom_add, _bloom_check);
     bloom_del(&bloom);
-    printf("\nAll done!\n");
+
+    memset(bf, 0, sizeof(bf));
+    bloom_init_hash64(&bloom, BLOOM_BITS, bf, xxh64_hash64, &xxh_seed,
+                      BLOOM_HASHF);
+    _run("bloom_t, one 64 bit hash", _bloom_add, _bloom_check);
+    bloom_del(&bloom);
+
+    bloom_blocked_init(&blocked, blocks, BLOOM_BLOCKS, xxh64_hash64,
+                       &xxh_seed, BLOOM_HASHF);
+    _run("bloom_blocked_t", _blocked_add, _blocked_check);
+
+    bloom_counting_init(&counting, counters, 4 * BLOOM_BLOCKS, xxh64_hash64,
+                        &xxh_seed, BLOOM_HASHF);
+    _run("bloom_counting_t", _counting_add, _counting_check);
+
+    printf("All done!\n");
     return 0;
 }
@@ -31,6 +31,8 @@
 #include "can/conn/raw.h"
 #include "can/conn/isotp.h"
 #include "can/device.h"
+#include "can/raw.h"
+#include "xtimer.h"
 
 #define THREAD_STACKSIZE   (THREAD_STACKSIZE_MAIN)
 #define RECEIVE_THREAD_MSG_QUEUE_SIZE   (8)
@@ -47,6 +49,10 @@
 #define CAN_MSG_RECV_ISOTP  0x402
 #define CAN_MSG_CLOSE_ISOTP 0x403
 #define CAN_MSG_SEND_ISOTP  0x404
+#define CAN_MSG_BENCH       0x405
+
+#define BENCH_SUBSCRIBERS_MAX   (48)
+#define BENCH_MSG_QUEUE_SIZE    (32)
 
 static char thread_stack[RCV_THREAD_NUMOF][THREAD_STACKSIZE];
 static kernel_pid_t receive_pid[RCV_THREAD_NUMOF];
@@ -63,6 +69,17 @@ static conn_can_isotp_t conn_isotp[RCV_THREAD_NUMOF];
 
 static int thread_busy[RCV_THREAD_NUMOF];
 
+static char bench_stack[THREAD_STACKSIZE];
+static kernel_pid_t bench_pid;
+
+typedef struct {
+    int ifnum;
+    unsigned subscribers;
+    unsigned frames;
+    uint32_t timeout;
+    struct can_filter filter;
+} bench_t;
+
 static void print_usage(void)
 {
     puts("test_can list");
@@ -81,6 +98,8 @@ static void print_usage(void)
     puts("test_can get_counter ifnum");
     puts("test_can power_up ifnum");
     puts("test_can power_down ifnum");
+    printf("test_can bench ifnum subscribers(1..%d) frames timeout can_id [mask]\n",
+           BENCH_SUBSCRIBERS_MAX);
 }
 
 static int _list(int argc, char **argv) {
@@ -488,6 +507,37 @@ static int _power_down(int argc, char **argv)
     return res;
 }
 
+static int _bench(int argc, char **argv)
+{
+    if (argc < 7) {
+        print_usage();
+        return 1;
+    }
+
+    bench_t bench;
+    msg_t msg, reply;
+    bench.ifnum = strtol(argv[2], NULL, 0);
+    if (bench.ifnum >= CAN_DLL_NUMOF) {
+        puts("Invalid interface number");
+        return 1;
+    }
+    bench.subscribers = strtoul(argv[3], NULL, 0);
+    if ((bench.subscribers < 1) || (bench.subscribers > BENCH_SUBSCRIBERS_MAX)) {
+        printf("Invalid number of subscribers, range=1..%d\n", BENCH_SUBSCRIBERS_MAX);
+        return 1;
+    }
+    bench.frames = strtoul(argv[4], NULL, 0);
+    bench.timeout = strtoul(argv[5], NULL, 0);
+    bench.filter.can_id = strtoul(argv[6], NULL, 16);
+    bench.filter.can_mask = (argc > 7) ? strtoul(argv[7], NULL, 16) : 0xffffffff;
+
+    msg.type = CAN_MSG_BENCH;
+    msg.content.ptr = &bench;
+    msg_send_receive(&msg, &reply, bench_pid);
+
+    return (int)reply.content.value;
+}
+
 static int _can_handler(int argc, char **argv)
 {
     if (argc < 2) {
@@ -538,6 +588,9 @@ static int _can_handler(int argc, char **argv)
     else if (strncmp(argv[1], "power_down", 11) == 0) {
         return _power_down(argc, argv);
     }
+    else if (strncmp(argv[1], "bench", 6) == 0) {
+        return _bench(argc, argv);
+    }
     else {
         printf("unknown command: %s\n", argv[1]);
         return 1;
@@ -613,6 +666,90 @@ static void *_receive_thread(void *args)
     return NULL;
 }
 
+/* all subscribers of a bench are served by this thread: it measures the
+ * fan-out of the router, not the scheduling of the subscribers */
+static int _run_bench(bench_t *bench)
+{
+    unsigned expected = bench->frames * bench->subscribers;
+    unsigned subscribed = 0, received = 0, failed = 0;
+    uint32_t start = 0, end = 0;
+    msg_t msg;
+    int res = 0;
+
+    for (; subscribed < bench->subscribers; subscribed++) {
+        if (raw_can_subscribe_rx(bench->ifnum, &bench->filter, bench_pid,
+                                 (void *)(uintptr_t)subscribed) < 0) {
+            printf("bench: cannot subscribe more than %u times\n", subscribed);
+            res = 1;
+            goto out;
+        }
+    }
+
+    printf("bench: waiting for %u frames %" PRIx32 "/%" PRIx32 " on %s\n",
+           bench->frames, bench->filter.can_id, bench->filter.can_mask,
+           raw_can_get_name_by_ifnum(bench->ifnum));
+    while (received < expected) {
+        if (xtimer_msg_receive_timeout(&msg, bench->timeout) < 0) {
+            break;
+        }
+        if (msg.type != CAN_MSG_RX_INDICATION) {
+            continue;
+        }
+        if (received == 0) {
+            start = xtimer_now_usec();
+        }
+        end = xtimer_now_usec();
+        if (raw_can_free_frame(msg.content.ptr) < 0) {
+            failed++;
+        }
+        received++;
+    }
+
+    uint32_t elapsed = end - start;
+    printf("bench: %u subscribers, %u/%u deliveries in %" PRIu32 " us",
+           bench->subscribers, received, expected, elapsed);
+    if (elapsed) {
+        printf(", %" PRIu32 " deliveries/s",
+               (uint32_t)(((uint64_t)received * US_PER_SEC) / elapsed));
+    }
+    printf(", %u free errors\n", failed);
+    res = ((received == expected) && !failed) ? 0 : 1;
+
+out:
+    while (subscribed--) {
+        raw_can_unsubscribe_rx(bench->ifnum, &bench->filter, bench_pid,
+                               (void *)(uintptr_t)subscribed);
+    }
+    /* frames received after the timeout */
+    while (msg_try_receive(&msg) == 1) {
+        if (msg.type == CAN_MSG_RX_INDICATION) {
+            raw_can_free_frame(msg.content.ptr);
+        }
+    }
+    return res;
+}
+
+static void *_bench_thread(void *args)
+{
+    (void)args;
+    msg_t msg, reply, msg_queue[BENCH_MSG_QUEUE_SIZE];
+
+    msg_init_queue(msg_queue, BENCH_MSG_QUEUE_SIZE);
+
+    while (1) {
+        msg_receive(&msg);
+        if (msg.type == CAN_MSG_BENCH) {
+            reply.content.value = _run_bench(msg.content.ptr);
+            msg_reply(&msg, &reply);
+        }
+        else if (msg.type == CAN_MSG_RX_INDICATION) {
+            raw_can_free_frame(msg.content.ptr);
+        }
+    }
+
+    return NULL;
+}
+
 static const shell_command_t _commands[] = {
     {"test_can", "Test CAN functions", _can_handler},
     { NULL, NULL, NULL},
@@ -627,6 +764,11 @@ int main(void)
                                        (void*)i, "receive_thread");
     }
 
+    bench_pid = thread_create(bench_stack, THREAD_STACKSIZE,
+                              THREAD_PRIORITY_MAIN - 2,
+                              THREAD_CREATE_STACKTEST, _bench_thread,
+                              NULL, "bench_thread");
+
     char line_buf[SHELL_DEFAULT_BUFSIZE];
     shell_run(_commands, line_buf, SHELL_DEFAULT_BUFSIZE);
 
@@ -22,9 +22,12 @@
 #include "sdcard_spi_internal.h"
 #include "sdcard_spi_params.h"
 #include "fmt.h"
+#include "thread.h"
+#include "xtimer.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <inttypes.h>
 
 /* independent of what you specify in a r/w cmd this is the maximum number of blocks read at once.
    If you call read with a bigger blockcount the read is performed in chunks*/
@@ -40,6 +43,8 @@ sdcard_spi_t *card = &sdcard_spi_devs[0];
 
 char buffer[SD_HC_BLOCK_SIZE * MAX_BLOCKS_IN_BUFFER];
 
+static char async_stack[THREAD_STACKSIZE_DEFAULT];
+
 static int _init(int argc, char **argv)
 {
     printf("Initializing SD-card at SPI_%i...", sdcard_spi_params[0].spi_dev);
@@ -333,6 +338,100 @@ static int _copy(int argc, char **argv)
     return 0;
 }
 
+static void _print_rate(const char *what, int blocks, uint32_t usec)
+{
+    if (usec == 0) {
+        usec = 1;
+    }
+    printf("%s %d blocks: %" PRIu32 " us (%" PRIu32 " KiB/s)\n", what, blocks, usec,
+           (uint32_t)(((uint64_t)blocks * SD_HC_BLOCK_SIZE * US_PER_SEC) / usec / 1024));
+}
+
+/* returns the number of bytes that differ from what _bench() wrote */
+static int _check_async(sdcard_spi_req_t *req, int offset)
+{
+    sd_rw_response_t state;
+    int errors = 0;
+
+    if (sdcard_spi_wait(req, &state) != req->nblocks) {
+        printf("async read error %d\n", state);
+        return req->nblocks * SD_HC_BLOCK_SIZE;
+    }
+    for (int j = 0; j < req->nblocks * SD_HC_BLOCK_SIZE; j++) {
+        errors += (req->data[j] != (char)(offset + j));
+    }
+    return errors;
+}
+
+static int _bench(int argc, char **argv)
+{
+    if (argc != 3) {
+        printf("usage: %s blockaddr cnt\n", argv[0]);
+        return -1;
+    }
+
+    int bladdr = atoi(argv[1]);
+    int cnt = atoi(argv[2]);
+    sd_rw_response_t state;
+
+    for (unsigned i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = i;
+    }
+
+    uint32_t start = xtimer_now_usec();
+    for (int done = 0; done < cnt; done += MAX_BLOCKS_IN_BUFFER) {
+        int n = (cnt - done < MAX_BLOCKS_IN_BUFFER) ? cnt - done : MAX_BLOCKS_IN_BUFFER;
+        if (sdcard_spi_write_blocks(card, bladdr + done, buffer, SD_HC_BLOCK_SIZE,
+                                    n, &state) != n) {
+            printf("write error %d\n", state);
+            return -1;
+        }
+    }
+    sdcard_spi_sync(card);
+    _print_rate("write", cnt, xtimer_now_usec() - start);
+
+    start = xtimer_now_usec();
+    for (int done = 0; done < cnt; done += MAX_BLOCKS_IN_BUFFER) {
+        int n = (cnt - done < MAX_BLOCKS_IN_BUFFER) ? cnt - done : MAX_BLOCKS_IN_BUFFER;
+        if (sdcard_spi_read_blocks(card, bladdr + done, buffer, SD_HC_BLOCK_SIZE,
+                                   n, &state) != n) {
+            printf("read error %d\n", state);
+            return -1;
+        }
+    }
+    _print_rate("read", cnt, xtimer_now_usec() - start);
+
+    /* double buffered: check one half of the buffer while the other one is read */
+    const int half = MAX_BLOCKS_IN_BUFFER / 2;
+    sdcard_spi_req_t req[2];
+    int errors = 0;
+    int i = 0;
+
+    start = xtimer_now_usec();
+    for (int done = 0; done < cnt + half; done += half, i ^= 1) {
+        if (done < cnt) {
+            req[i] = (sdcard_spi_req_t){
+                .card = card,
+                .blockaddr = bladdr + done,
+                .data = &buffer[i * half * SD_HC_BLOCK_SIZE],
+                .nblocks = (cnt - done < half) ? cnt - done : half,
+            };
+            sdcard_spi_submit(&req[i]);
+        }
+        if (done > 0) {
+            errors += _check_async(&req[i ^ 1], (i ^ 1) * half * SD_HC_BLOCK_SIZE);
+        }
+    }
+    _print_rate("async read", cnt, xtimer_now_usec() - start);
+
+    if (errors) {
+        printf("%d bytes differ from the written data\n", errors);
+        return -1;
+    }
+    puts("bench [OK]");
+    return 0;
+}
+
 static int _sector_count(int argc, char **argv)
 {
     printf("available sectors on card: %li\n", sdcard_spi_get_sector_count(card));
@@ -351,6 +450,8 @@ static const shell_command_t shell_commands[] = {
     { "write", "'write n data' writes data to block n. Append -r option to "
                "repeatedly write data to coplete block", _write },
     { "copy", "'copy src dst' copies block src to block dst", _copy },
+    { "bench", "'bench n m' writes, reads and asynchronously reads m blocks beginning at "
+               "block n and prints the data rates", _bench },
     { NULL, NULL, NULL }
 };
 
@@ -359,6 +460,7 @@ int main(void)
     puts("SD-card spi driver test application");
 
     card->init_done = false;
+    sdcard_spi_async_init(async_stack, sizeof(async_stack), THREAD_PRIORITY_MAIN - 1);
 
     puts("insert SD-card and use 'init' command to set card to spi mode");
     puts("WARNING: using 'write' or 'copy' commands WILL overwrite data on your sd-card and");
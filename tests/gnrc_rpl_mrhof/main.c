@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Tests the ETX estimation and the parent selection of MRHOF
+ *              over a lossy channel
+ *
+ * The neighbors are simulated by a @ref sys_netdev_test device: each of them
+ * loses a fixed share of the unicast frames sent to it and the device reports
+ * NETDEV_EVENT_TX_NOACK for those, like a radio after its retransmissions.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nc.h"
+#include "net/gnrc/netdev.h"
+#include "net/gnrc/netif/hdr.h"
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/of_manager.h"
+#include "net/ieee802154.h"
+#include "net/netdev_test.h"
+#include "thread.h"
+#include "utlist.h"
+
+#define _MAC_STACKSIZE  (THREAD_STACKSIZE_DEFAULT + THREAD_EXTRA_STACKSIZE_PRINTF)
+#define _MAC_PRIO       (THREAD_PRIORITY_MAIN - 4)
+
+#define _FRAMES_NUMOF   (200U)
+#define _MRHOF_OCP      (1U)
+
+#define EXECUTE(test) \
+    puts("Executing " # test "()"); \
+    if (!test()) { \
+        puts(" + failed."); \
+        return 1; \
+    } \
+    else { \
+        puts(" + succeeded."); \
+    }
+
+typedef struct {
+    const char *name;
+    uint8_t l2_addr[IEEE802154_LONG_ADDRESS_LEN];
+    unsigned lose_every;    /**< every n-th frame is lost, 0 for none */
+    unsigned frames;        /**< frames sent to the neighbor */
+    gnrc_rpl_parent_t parent;
+} _neighbor_t;
+
+enum {
+    _A = 0,     /* perfect link */
+    _B,         /* loses a quarter of the frames */
+    _C,         /* loses half of the frames */
+    _D,         /* perfect link */
+    _NEIGHBORS_NUMOF,
+};
+
+static _neighbor_t _neighbors[] = {
+    { .name = "A", .l2_addr = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e, 0x6f, 0x0a } },
+    { .name = "B", .l2_addr = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e, 0x6f, 0x0b },
+      .lose_every = 4 },
+    { .name = "C", .l2_addr = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e, 0x6f, 0x0c },
+      .lose_every = 2 },
+    { .name = "D", .l2_addr = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e, 0x6f, 0x0d } },
+};
+
+static char _mac_stack[_MAC_STACKSIZE];
+static gnrc_netdev_t _gnrc_dev;
+static netdev_test_t _dev;
+static kernel_pid_t _mac_pid;
+static gnrc_rpl_instance_t _inst;
+
+/* the lossy channel, the first vector entry is the destination */
+static int _dev_send(netdev_t *dev, const struct iovec *vector, int count)
+{
+    int len = 0;
+
+    for (int i = 0; i < count; i++) {
+        len += vector[i].iov_len;
+    }
+    for (unsigned i = 0; i < _NEIGHBORS_NUMOF; i++) {
+        _neighbor_t *n = &_neighbors[i];
+
+        if ((vector[0].iov_len == sizeof(n->l2_addr)) &&
+            (memcmp(vector[0].iov_base, n->l2_addr, sizeof(n->l2_addr)) == 0)) {
+            n->frames++;
+            if (n->lose_every && ((n->frames % n->lose_every) == 0)) {
+                dev->event_callback(dev, NETDEV_EVENT_TX_NOACK);
+            }
+            else {
+                dev->event_callback(dev, NETDEV_EVENT_TX_COMPLETE);
+            }
+            return len;
+        }
+    }
+    return -EHOSTUNREACH;
+}
+
+static int _gnrc_send(gnrc_netdev_t *gnrc_netdev, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *hdr = pkt->data;
+    struct iovec vector[] = {
+        { .iov_base = gnrc_netif_hdr_get_dst_addr(hdr), .iov_len = hdr->dst_l2addr_len },
+        { .iov_base = pkt->next->data, .iov_len = pkt->next->size },
+    };
+    int res = gnrc_netdev->dev->driver->send(gnrc_netdev->dev, vector, 2);
+
+    gnrc_pktbuf_release(pkt);
+    return res;
+}
+
+static bool _send_frame(_neighbor_t *n)
+{
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, "ping", sizeof("ping"),
+                                          GNRC_NETTYPE_UNDEF);
+    gnrc_pktsnip_t *netif;
+
+    if (pkt == NULL) {
+        return false;
+    }
+    if ((netif = gnrc_netif_hdr_build(NULL, 0, n->l2_addr, sizeof(n->l2_addr))) == NULL) {
+        gnrc_pktbuf_release(pkt);
+        return false;
+    }
+    LL_PREPEND(pkt, netif);
+    /* the MAC thread has a higher priority, the frame is sent on return */
+    return gnrc_netapi_send(_mac_pid, pkt) == 1;
+}
+
+static uint16_t _etx(_neighbor_t *n)
+{
+    return gnrc_ipv6_nc_get_etx(_mac_pid, &n->parent.addr);
+}
+
+/* the parent selection of gnrc_rpl: each parent is compared with the best
+ * one so far, starting with the preferred parent */
+static gnrc_rpl_parent_t *_select(int preferred, const int *others, unsigned numof)
+{
+    gnrc_rpl_dodag_t *dodag = &_inst.dodag;
+    gnrc_rpl_parent_t *best, *elt;
+
+    dodag->parents = NULL;
+    for (unsigned i = numof; i-- > 0;) {
+        LL_PREPEND(dodag->parents, &_neighbors[others[i]].parent);
+    }
+    LL_PREPEND(dodag->parents, &_neighbors[preferred].parent);
+
+    best = dodag->parents;
+    LL_FOREACH(dodag->parents, elt) {
+        best = _inst.of->which_parent(best, elt);
+    }
+    return best;
+}
+
+static int _test_etx(void)
+{
+    for (unsigned f = 0; f < _FRAMES_NUMOF; f++) {
+        for (unsigned i = 0; i < _NEIGHBORS_NUMOF; i++) {
+            if (!_send_frame(&_neighbors[i])) {
+                puts("Could not send frame");
+                return 0;
+            }
+        }
+    }
+    for (unsigned i = 0; i < _NEIGHBORS_NUMOF; i++) {
+        printf("ETX of %s: %u/%u after %u frames\n", _neighbors[i].name,
+               (unsigned)_etx(&_neighbors[i]), GNRC_IPV6_NC_ETX_DIVISOR,
+               _neighbors[i].frames);
+        if (_neighbors[i].frames != _FRAMES_NUMOF) {
+            return 0;
+        }
+    }
+    return (_etx(&_neighbors[_A]) < (GNRC_IPV6_NC_ETX_DIVISOR * 9 / 8)) &&
+           (_etx(&_neighbors[_D]) < (GNRC_IPV6_NC_ETX_DIVISOR * 9 / 8)) &&
+           (_etx(&_neighbors[_B]) > (GNRC_IPV6_NC_ETX_DIVISOR * 2)) &&
+           (_etx(&_neighbors[_C]) > _etx(&_neighbors[_B]));
+}
+
+/* a parent with a lower rank behind a link with too many losses is not
+ * chosen */
+static int _test_unacceptable(void)
+{
+    static const int others[] = { _A };
+
+    _neighbors[_A].parent.rank = 2 * GNRC_RPL_ROOT_RANK;
+    _neighbors[_C].parent.rank = GNRC_RPL_ROOT_RANK;
+    return _select(_C, others, 1) == &_neighbors[_A].parent;
+}
+
+/* the preferred parent is kept if the other one is only slightly better */
+static int _test_hysteresis(void)
+{
+    static const int others_a[] = { _A };
+    static const int others_b[] = { _B };
+
+    _neighbors[_A].parent.rank = 2 * GNRC_RPL_ROOT_RANK;
+    _neighbors[_B].parent.rank = GNRC_RPL_ROOT_RANK;
+    return (_select(_B, others_a, 1) == &_neighbors[_B].parent) &&
+           (_select(_A, others_b, 1) == &_neighbors[_A].parent);
+}
+
+static int _test_switch(void)
+{
+    static const int others[] = { _A, _D };
+
+    _neighbors[_A].parent.rank = 2 * GNRC_RPL_ROOT_RANK;
+    _neighbors[_B].parent.rank = GNRC_RPL_ROOT_RANK;
+    _neighbors[_D].parent.rank = GNRC_RPL_ROOT_RANK;
+    return _select(_B, others, 2) == &_neighbors[_D].parent;
+}
+
+static int _test_rank(void)
+{
+    gnrc_rpl_parent_t *parent = &_neighbors[_D].parent;
+    uint16_t rank;
+
+    parent->rank = GNRC_RPL_ROOT_RANK;
+    rank = _inst.of->calc_rank(parent, 0);
+    printf("rank via D: %u\n", rank);
+    if (rank != (GNRC_RPL_ROOT_RANK + (_etx(&_neighbors[_D]) * _inst.min_hop_rank_inc) /
+                 GNRC_IPV6_NC_ETX_DIVISOR)) {
+        return 0;
+    }
+    parent->rank = GNRC_RPL_INFINITE_RANK;
+    return _inst.of->calc_rank(parent, 0) == GNRC_RPL_INFINITE_RANK;
+}
+
+int main(void)
+{
+    /* initialization */
+    gnrc_pktbuf_init();
+    gnrc_ipv6_nc_init();
+    netdev_test_setup(&_dev, NULL);
+    netdev_test_set_send_cb(&_dev, _dev_send);
+    _gnrc_dev.send = _gnrc_send;
+    _gnrc_dev.dev = (netdev_t *)&_dev;
+    _mac_pid = gnrc_netdev_init(_mac_stack, _MAC_STACKSIZE, _MAC_PRIO,
+                                "gnrc_netdev_lossy", &_gnrc_dev);
+    if (_mac_pid <= KERNEL_PID_UNDEF) {
+        puts("Could not start MAC thread\n");
+        return 1;
+    }
+
+    gnrc_rpl_of_manager_init();
+    _inst.of = gnrc_rpl_get_of_for_ocp(_MRHOF_OCP);
+    if ((_inst.of == NULL) || (_inst.of->ocp != _MRHOF_OCP)) {
+        puts("MRHOF not available");
+        return 1;
+    }
+    _inst.min_hop_rank_inc = GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
+    _inst.dodag.instance = &_inst;
+    _inst.dodag.iface = _mac_pid;
+    for (unsigned i = 0; i < _NEIGHBORS_NUMOF; i++) {
+        _neighbor_t *n = &_neighbors[i];
+
+        /* the link-local address of the neighbor */
+        ipv6_addr_set_link_local_prefix(&n->parent.addr);
+        ieee802154_get_iid((eui64_t *)&n->parent.addr.u64[1], n->l2_addr,
+                           sizeof(n->l2_addr));
+        n->parent.state = 1;
+        n->parent.dodag = &_inst.dodag;
+    }
+
+    /* test execution */
+    EXECUTE(_test_etx);
+    EXECUTE(_test_unacceptable);
+    EXECUTE(_test_hysteresis);
+    EXECUTE(_test_switch);
+    EXECUTE(_test_rank);
+    puts("ALL TESTS SUCCESSFUL");
+
+    return 0;
+}
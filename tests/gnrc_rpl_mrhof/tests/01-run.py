@@ -0,0 +1,25 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+import testrunner
+
+
+def testfunc(child):
+    for test in ("_test_etx", "_test_unacceptable", "_test_hysteresis",
+                 "_test_switch", "_test_rank"):
+        child.expect_exact("Executing {}()".format(test))
+        child.expect_exact(" + succeeded.")
+    child.expect_exact("ALL TESTS SUCCESSFUL")
+
+
+if __name__ == "__main__":
+    sys.exit(testrunner.run(testfunc))
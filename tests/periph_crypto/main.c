@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief       Test for crypto accelerator drivers
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "periph_conf.h"
+#include "periph/crypto.h"
+#include "thread.h"
+#include "thread_flags.h"
+#include "xtimer.h"
+
+#define FLAG_CRYPTO         (0x1)
+#define CHAIN_LEN           (100U)
+#define RESUBMITS           (5U)
+#define OVERLAP_LEN         (4096U)
+/* stands in for e.g. sending a frame while the job is in flight */
+#define OTHER_WORK_US       (100U)
+
+/* FIPS-197, appendix C.1 */
+static const uint8_t aes_key[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t aes_plain[] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t aes_cipher[] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+/* FIPS 180-2, appendix B.1 */
+static const uint8_t sha_digest[] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+static uint8_t buf[OVERLAP_LEN];
+static uint8_t ref[CHAIN_LEN];
+static crypto_hw_job_t job;
+
+/* lengths of the jobs a CTR stream is split into, not all whole blocks */
+static const size_t chain[] = { 48, 32, 20 };
+#define CHAIN_PARTS         (sizeof(chain) / sizeof(chain[0]))
+static unsigned chain_pos;
+
+static int _run(crypto_hw_op_t op, const uint8_t *in, size_t len, uint8_t *out)
+{
+    memset(&job, 0, sizeof(job));
+    job.op = op;
+    job.key = aes_key;
+    job.key_len = sizeof(aes_key);
+    job.in = in;
+    job.out = out;
+    job.len = len;
+
+    int res = crypto_hw_submit(&job);
+    if (res != CRYPTO_HW_OK) {
+        return res;
+    }
+    return crypto_hw_wait(&job);
+}
+
+static void _chain_cb(crypto_hw_job_t *j, void *arg)
+{
+    (void)arg;
+
+    if ((j->status != CRYPTO_HW_OK) || (++chain_pos == CHAIN_PARTS)) {
+        return;
+    }
+    /* submit the next part from interrupt context, the counter block has
+     * been advanced by the previous part */
+    j->in += chain[chain_pos - 1];
+    j->out += chain[chain_pos - 1];
+    j->len = chain[chain_pos];
+    crypto_hw_submit(j);
+}
+
+static int _test_chain(void)
+{
+    uint8_t ctr[CRYPTO_HW_AES_BLOCK_SIZE] = { 0 };
+    crypto_hw_job_t *j = &job;
+
+    for (unsigned i = 0; i < CHAIN_LEN; i++) {
+        buf[i] = i;
+    }
+
+    memset(j, 0, sizeof(*j));
+    j->op = CRYPTO_HW_AES_CTR;
+    j->key = aes_key;
+    j->key_len = sizeof(aes_key);
+    j->ctr = ctr;
+    j->in = buf;
+    j->out = ref;
+    j->len = CHAIN_LEN;
+    if ((crypto_hw_submit(j) != CRYPTO_HW_OK) ||
+        (crypto_hw_wait(j) != CRYPTO_HW_OK)) {
+        return -1;
+    }
+
+    /* CTR is its own inverse: decrypt ref in place, one part at a time */
+    memset(ctr, 0, sizeof(ctr));
+    chain_pos = 0;
+    j->in = ref;
+    j->out = ref;
+    j->len = chain[0];
+    j->cb = _chain_cb;
+    if (crypto_hw_submit(j) != CRYPTO_HW_OK) {
+        return -1;
+    }
+    if ((crypto_hw_wait(j) != CRYPTO_HW_OK) ||
+        (chain_pos != CHAIN_PARTS)) {
+        return -1;
+    }
+    return memcmp(buf, ref, CHAIN_LEN) ? -1 : 0;
+}
+
+static unsigned resubmits;
+
+static void _resubmit_cb(crypto_hw_job_t *j, void *arg)
+{
+    (void)arg;
+
+    if ((j->status == CRYPTO_HW_OK) && (++resubmits < RESUBMITS)) {
+        crypto_hw_submit(j);
+    }
+}
+
+/* the submitter is blocked in crypto_hw_wait() long before the callback
+ * submits the job again, and must still be woken up in the end */
+static int _test_resubmit_wait(void)
+{
+    uint8_t out[CRYPTO_HW_SHA256_DIGEST_SIZE];
+
+    memset(&job, 0, sizeof(job));
+    job.op = CRYPTO_HW_SHA256;
+    job.in = (const uint8_t *)"abc";
+    job.len = 3;
+    job.out = out;
+    job.cb = _resubmit_cb;
+    resubmits = 0;
+    if ((crypto_hw_submit(&job) != CRYPTO_HW_OK) ||
+        (crypto_hw_wait(&job) != CRYPTO_HW_OK) ||
+        (resubmits != RESUBMITS)) {
+        return -1;
+    }
+    return memcmp(out, sha_digest, sizeof(sha_digest)) ? -1 : 0;
+}
+
+static int _test_overlap(void)
+{
+    uint8_t ctr[CRYPTO_HW_AES_BLOCK_SIZE] = { 0 };
+    unsigned rounds = 0;
+
+    memset(&job, 0, sizeof(job));
+    job.op = CRYPTO_HW_AES_CTR;
+    job.key = aes_key;
+    job.key_len = sizeof(aes_key);
+    job.ctr = ctr;
+    job.in = buf;
+    job.out = buf;
+    job.len = OVERLAP_LEN;
+    job.thread = (thread_t *)sched_active_thread;
+    job.flags = FLAG_CRYPTO;
+
+    uint32_t start = xtimer_now_usec();
+    if (crypto_hw_submit(&job) != CRYPTO_HW_OK) {
+        return -1;
+    }
+    while (!(thread_flags_clear(FLAG_CRYPTO) & FLAG_CRYPTO)) {
+        xtimer_usleep(OTHER_WORK_US);
+        rounds++;
+    }
+    uint32_t duration = xtimer_now_usec() - start;
+
+    printf("overlap: %u us for the job, %u rounds of other work\n",
+           (unsigned)duration, rounds);
+    return job.status;
+}
+
+int main(void)
+{
+    uint8_t out[CRYPTO_HW_SHA256_DIGEST_SIZE];
+    int failed = 0;
+
+    puts("\nRIOT crypto accelerator test");
+    crypto_hw_init();
+
+    if ((_run(CRYPTO_HW_AES_ECB_ENCRYPT, aes_plain, sizeof(aes_plain),
+              out) == CRYPTO_HW_OK) &&
+        (memcmp(out, aes_cipher, sizeof(aes_cipher)) == 0) &&
+        (_run(CRYPTO_HW_AES_ECB_DECRYPT, out, sizeof(aes_cipher),
+              out) == CRYPTO_HW_OK) &&
+        (memcmp(out, aes_plain, sizeof(aes_plain)) == 0)) {
+        puts("AES-128-ECB: OK");
+    }
+    else {
+        puts("AES-128-ECB: FAILED");
+        failed++;
+    }
+
+    if ((_run(CRYPTO_HW_SHA256, (const uint8_t *)"abc", 3,
+              out) == CRYPTO_HW_OK) &&
+        (memcmp(out, sha_digest, sizeof(sha_digest)) == 0)) {
+        puts("SHA-256: OK");
+    }
+    else {
+        puts("SHA-256: FAILED");
+        failed++;
+    }
+
+    if (_test_chain() == 0) {
+        puts("AES-128-CTR chained: OK");
+    }
+    else {
+        puts("AES-128-CTR chained: FAILED");
+        failed++;
+    }
+
+    if (_test_resubmit_wait() == 0) {
+        puts("resubmitted while waiting: OK");
+    }
+    else {
+        puts("resubmitted while waiting: FAILED");
+        failed++;
+    }
+
+    if (_test_overlap() != CRYPTO_HW_OK) {
+        puts("overlap: FAILED");
+        failed++;
+    }
+
+    puts(failed ? "FAILED" : "SUCCESS");
+    return 0;
+}
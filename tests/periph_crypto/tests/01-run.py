@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2017 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import os
+import sys
+
+sys.path.append(os.path.join(os.environ['RIOTBASE'], 'dist/tools/testrunner'))
+import testrunner
+
+
+def testfunc(child):
+    child.expect_exact('AES-128-ECB: OK')
+    child.expect_exact('SHA-256: OK')
+    child.expect_exact('AES-128-CTR chained: OK')
+    child.expect_exact('resubmitted while waiting: OK')
+    child.expect(r'overlap: \d+ us for the job, \d+ rounds of other work')
+    child.expect_exact('SUCCESS')
+
+
+if __name__ == "__main__":
+    sys.exit(testrunner.run(testfunc))
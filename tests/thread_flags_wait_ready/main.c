@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup tests
+ * @{
+ *
+ * @file
+ * @brief   test application for waiting on messages, mailboxes and thread
+ *          flags at the same time
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include "mbox.h"
+#include "msg.h"
+#include "thread.h"
+
+#define MBOX_NUMOF      (2U)
+#define QUEUE_SIZE      (4U)
+#define EVENTS_NUMOF    (5U)
+
+static char stack[THREAD_STACKSIZE_MAIN];
+
+static msg_t _mbox_queues[MBOX_NUMOF][QUEUE_SIZE];
+static mbox_t _mboxes[MBOX_NUMOF];
+static mbox_t *const _mbox_ptrs[MBOX_NUMOF] = { &_mboxes[0], &_mboxes[1] };
+
+volatile unsigned done;
+
+static void *_thread(void *arg)
+{
+    (void) arg;
+    msg_t queue[QUEUE_SIZE];
+    msg_t msg;
+
+    msg_init_queue(queue, QUEUE_SIZE);
+
+    for (unsigned i = 0; i < EVENTS_NUMOF; i++) {
+        thread_flags_t mask = THREAD_FLAG_MSG_WAITING | 0x1;
+        int res = thread_flags_wait_ready(&mask, _mbox_ptrs, MBOX_NUMOF);
+
+        switch (res) {
+            case THREAD_FLAGS_READY_FLAGS:
+                printf("thread(): flags 0x%04x\n", (unsigned)mask & 0xFFFF);
+                break;
+            case THREAD_FLAGS_READY_MSG:
+                msg_receive(&msg);
+                printf("thread(): msg 0x%04x\n", msg.type);
+                break;
+            default:
+                mbox_get(&_mboxes[res], &msg);
+                printf("thread(): mbox %d: 0x%04x\n", res, msg.type);
+                break;
+        }
+    }
+
+    done = 1;
+
+    return NULL;
+}
+
+int main(void)
+{
+    msg_t msg;
+
+    puts("main starting");
+
+    for (unsigned i = 0; i < MBOX_NUMOF; i++) {
+        mbox_init(&_mboxes[i], _mbox_queues[i], QUEUE_SIZE);
+    }
+
+    kernel_pid_t pid = thread_create(stack,
+                  sizeof(stack),
+                  THREAD_PRIORITY_MAIN - 1,
+                  THREAD_CREATE_SLEEPING | THREAD_CREATE_STACKTEST,
+                  _thread,
+                  NULL,
+                  "second_thread");
+
+    thread_t *thread = (thread_t*) thread_get(pid);
+
+    /* both are ready when the thread starts, the message must come first */
+    puts("main(): message to mbox 1");
+    msg.type = 0x11;
+    mbox_put(&_mboxes[1], &msg);
+
+    puts("main(): setting flag 0x0001");
+    thread_flags_set(thread, 0x1);
+
+    puts("main(): starting thread");
+    thread_wakeup(pid);
+
+    puts("main(): message to thread");
+    msg.type = 0x22;
+    msg_send(&msg, pid);
+
+    puts("main(): message to mbox 0");
+    msg.type = 0x33;
+    mbox_put(&_mboxes[0], &msg);
+
+    puts("main(): setting flag 0x0002 (not waited for)");
+    thread_flags_set(thread, 0x2);
+
+    puts("main(): message to thread");
+    msg.type = 0x44;
+    msg_send(&msg, pid);
+
+    while(!done) {};
+
+    puts("test finished.");
+
+    return 0;
+}
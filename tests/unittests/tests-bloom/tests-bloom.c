@@ -12,6 +12,8 @@
 #include "tests-bloom.h"
 
 #include "hashes.h"
+#include "hashes/siphash.h"
+#include "hashes/xxhash.h"
 #include "bloom.h"
 #include "bitfield.h"
 
@@ -22,6 +24,8 @@
 #define TESTS_BLOOM_PROB_IN_FILTER (4)
 #define TESTS_BLOOM_NOT_IN_FILTER (996)
 #define TESTS_BLOOM_FALSE_POS_RATE_THR (0.005)
+/* 0.5 % expected, the exact count depends on the hash */
+#define TESTS_BLOOM_HASH64_FP_RATE_THR (0.01)
 
 static bloom_t bloom;
 BITFIELD(bf, TESTS_BLOOM_BITS);
@@ -85,11 +89,129 @@ static void test_bloom_based_on_dictionary_fixture(void)
     TEST_ASSERT(false_positive_rate < TESTS_BLOOM_FALSE_POS_RATE_THR);
 }
 
+static int _false_positives(void)
+{
+    int in = 0;
+
+    load_dictionary_fixture();
+    for (int i = 0; i < lenB; i++) {
+        if (!bloom_check(&bloom, (const uint8_t *) B[i], strlen(B[i]))) {
+            /* false negatives must not happen */
+            return lenA;
+        }
+    }
+    for (int i = 0; i < lenA; i++) {
+        if (bloom_check(&bloom, (const uint8_t *) A[i], strlen(A[i]))) {
+            in++;
+        }
+    }
+    return in;
+}
+
+static void test_bloom_hash64_xxhash(void)
+{
+    static const uint64_t seed = 42;
+
+    bloom_del(&bloom);
+    bloom_init_hash64(&bloom, TESTS_BLOOM_BITS, bf, xxh64_hash64, &seed,
+                      TESTS_BLOOM_HASHF);
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_BITS, bloom.m);
+    TEST_ASSERT_EQUAL_INT(TESTS_BLOOM_HASHF, bloom.k);
+
+    int in = _false_positives();
+    TEST_ASSERT(((double) in / (double) lenA) < TESTS_BLOOM_HASH64_FP_RATE_THR);
+}
+
+static void test_bloom_hash64_siphash(void)
+{
+    static const uint8_t key[SIPHASH_KEY_SIZE] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+
+    bloom_del(&bloom);
+    bloom_init_hash64(&bloom, TESTS_BLOOM_BITS, bf, siphash24, key,
+                      TESTS_BLOOM_HASHF);
+
+    int in = _false_positives();
+    TEST_ASSERT(((double) in / (double) lenA) < TESTS_BLOOM_HASH64_FP_RATE_THR);
+}
+
+static void test_bloom_blocked(void)
+{
+    static bloom_block_t blocks[2];
+    static const uint64_t seed = 7;
+    bloom_blocked_t filter;
+    int in = 0;
+
+    bloom_blocked_init(&filter, blocks, 2, xxh64_hash64, &seed,
+                       TESTS_BLOOM_HASHF);
+    for (int i = 0; i < lenB; i++) {
+        TEST_ASSERT(!bloom_blocked_check_add(&filter, (const uint8_t *) B[i],
+                                             strlen(B[i])));
+        /* now it is in */
+        TEST_ASSERT(bloom_blocked_check_add(&filter, (const uint8_t *) B[i],
+                                            strlen(B[i])));
+    }
+    for (int i = 0; i < lenB; i++) {
+        TEST_ASSERT(bloom_blocked_check(&filter, (const uint8_t *) B[i],
+                                        strlen(B[i])));
+    }
+    for (int i = 0; i < lenA; i++) {
+        if (bloom_blocked_check(&filter, (const uint8_t *) A[i],
+                                strlen(A[i]))) {
+            in++;
+        }
+    }
+    TEST_ASSERT(((double) in / (double) lenA) < TESTS_BLOOM_FALSE_POS_RATE_THR);
+
+    bloom_blocked_clear(&filter);
+    TEST_ASSERT(!bloom_blocked_check(&filter, (const uint8_t *) B[0],
+                                     strlen(B[0])));
+}
+
+static void test_bloom_counting(void)
+{
+    static bloom_block_t blocks[2];
+    static const uint64_t seed = 7;
+    bloom_counting_t filter;
+
+    bloom_counting_init(&filter, blocks, 2, xxh64_hash64, &seed,
+                        TESTS_BLOOM_HASHF);
+    for (int i = 0; i < lenB; i++) {
+        bloom_counting_add(&filter, (const uint8_t *) B[i], strlen(B[i]));
+    }
+    /* remove half, the other half must stay */
+    for (int i = 0; i < lenB / 2; i++) {
+        TEST_ASSERT(bloom_counting_remove(&filter, (const uint8_t *) B[i],
+                                          strlen(B[i])));
+    }
+    for (int i = lenB / 2; i < lenB; i++) {
+        TEST_ASSERT(bloom_counting_check(&filter, (const uint8_t *) B[i],
+                                         strlen(B[i])));
+    }
+    for (int i = lenB / 2; i < lenB; i++) {
+        TEST_ASSERT(bloom_counting_remove(&filter, (const uint8_t *) B[i],
+                                          strlen(B[i])));
+    }
+    /* all counters are back to zero */
+    for (int i = 0; i < lenB; i++) {
+        TEST_ASSERT(!bloom_counting_check(&filter, (const uint8_t *) B[i],
+                                          strlen(B[i])));
+        TEST_ASSERT(!bloom_counting_remove(&filter, (const uint8_t *) B[i],
+                                           strlen(B[i])));
+    }
+}
+
 Test *tests_bloom_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_bloom_parameters_bytes_hashf),
         new_TestFixture(test_bloom_based_on_dictionary_fixture),
+        new_TestFixture(test_bloom_hash64_xxhash),
+        new_TestFixture(test_bloom_hash64_siphash),
+        new_TestFixture(test_bloom_blocked),
+        new_TestFixture(test_bloom_counting),
     };
 
     EMB_UNIT_TESTCALLER(bloom_tests, set_up_bloom, tear_down_bloom, fixtures);
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+#include "crypto/aead.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/ccm.h"
+#include "net/gnrc/pkt.h"
+#include "tests-crypto.h"
+
+/* RFC 8439, section 2.8.2 */
+static const uint8_t CHACHA_KEY[] = {
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+    0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+
+static const uint8_t CHACHA_NONCE[] = {
+    0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43,
+    0x44, 0x45, 0x46, 0x47
+};
+
+static const uint8_t CHACHA_AD[] = {
+    0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7
+};
+
+static const char CHACHA_PLAIN[] =
+    "Ladies and Gentlemen of the class of '99: If I could offer you only "
+    "one tip for the future, sunscreen would be it.";
+
+#define CHACHA_PLAIN_LEN    (sizeof(CHACHA_PLAIN) - 1)
+
+static const uint8_t CHACHA_CIPHER[] = {
+    0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb,
+    0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+    0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+    0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+    0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12,
+    0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+    0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29,
+    0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+    0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+    0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+    0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94,
+    0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+    0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d,
+    0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+    0x61, 0x16
+};
+
+static const uint8_t CHACHA_TAG[] = {
+    0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+    0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+};
+
+/* PACKET VECTOR #1 (RFC 3610 - Page 10) */
+static const uint8_t CCM_KEY[] = {
+    0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7,
+    0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF
+};
+
+static const uint8_t CCM_NONCE[] = {
+    0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xA0,
+    0xA1, 0xA2, 0xA3, 0xA4, 0xA5
+};
+
+static const uint8_t CCM_AD[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+};
+
+static const uint8_t CCM_PLAIN[] = {
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E
+};
+
+static const uint8_t CCM_CIPHER[] = {
+    0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2,
+    0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+    0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84
+};
+
+static const uint8_t CCM_TAG[] = {
+    0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26, 0xE0
+};
+
+static aead_t aead;
+static uint8_t buf[128];
+static uint8_t tag[AEAD_MAX_TAG_SIZE];
+
+static void test_crypto_aead_chacha20poly1305_encrypt(void)
+{
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_init(&aead, AEAD_CHACHA20_POLY1305,
+                                             CHACHA_KEY, sizeof(CHACHA_KEY)));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_start(&aead, AEAD_ENCRYPT,
+                                              CHACHA_NONCE, sizeof(CHACHA_NONCE),
+                                              sizeof(CHACHA_AD),
+                                              CHACHA_PLAIN_LEN, 16));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_update_ad(&aead, CHACHA_AD,
+                                                  sizeof(CHACHA_AD)));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_update(&aead, CHACHA_PLAIN, buf,
+                                               CHACHA_PLAIN_LEN));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+
+    TEST_ASSERT(compare((uint8_t *)CHACHA_CIPHER, buf, CHACHA_PLAIN_LEN));
+    TEST_ASSERT(compare((uint8_t *)CHACHA_TAG, tag, sizeof(CHACHA_TAG)));
+}
+
+static void test_crypto_aead_chacha20poly1305_decrypt(void)
+{
+    aead_init(&aead, AEAD_CHACHA20_POLY1305, CHACHA_KEY, sizeof(CHACHA_KEY));
+    aead_start(&aead, AEAD_DECRYPT, CHACHA_NONCE, sizeof(CHACHA_NONCE),
+               sizeof(CHACHA_AD), CHACHA_PLAIN_LEN, 16);
+    aead_update_ad(&aead, CHACHA_AD, sizeof(CHACHA_AD));
+    memcpy(buf, CHACHA_CIPHER, CHACHA_PLAIN_LEN);
+    aead_update(&aead, buf, buf, CHACHA_PLAIN_LEN);
+    memcpy(tag, CHACHA_TAG, sizeof(CHACHA_TAG));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+    TEST_ASSERT(compare((uint8_t *)CHACHA_PLAIN, buf, CHACHA_PLAIN_LEN));
+
+    /* same message with one bit of the tag flipped */
+    aead_start(&aead, AEAD_DECRYPT, CHACHA_NONCE, sizeof(CHACHA_NONCE),
+               sizeof(CHACHA_AD), CHACHA_PLAIN_LEN, 16);
+    aead_update_ad(&aead, CHACHA_AD, sizeof(CHACHA_AD));
+    aead_update(&aead, CHACHA_CIPHER, buf, CHACHA_PLAIN_LEN);
+    tag[15] ^= 0x80;
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_AUTH, aead_finish(&aead, tag));
+}
+
+static void test_crypto_aead_chacha20poly1305_chunked(void)
+{
+    /* odd sizes, so that neither the key stream nor Poly1305 is aligned */
+    static const size_t chunks[] = { 1, 7, 64, 13, 29 };
+    const uint8_t *in = (const uint8_t *)CHACHA_PLAIN;
+
+    aead_init(&aead, AEAD_CHACHA20_POLY1305, CHACHA_KEY, sizeof(CHACHA_KEY));
+    aead_start(&aead, AEAD_ENCRYPT, CHACHA_NONCE, sizeof(CHACHA_NONCE),
+               sizeof(CHACHA_AD), CHACHA_PLAIN_LEN, 16);
+    aead_update_ad(&aead, CHACHA_AD, 5);
+    aead_update_ad(&aead, CHACHA_AD + 5, sizeof(CHACHA_AD) - 5);
+
+    size_t pos = 0;
+    for (unsigned i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_update(&aead, in + pos, buf + pos,
+                                                   chunks[i]));
+        pos += chunks[i];
+    }
+    TEST_ASSERT_EQUAL_INT(CHACHA_PLAIN_LEN, pos);
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+
+    TEST_ASSERT(compare((uint8_t *)CHACHA_CIPHER, buf, CHACHA_PLAIN_LEN));
+    TEST_ASSERT(compare((uint8_t *)CHACHA_TAG, tag, sizeof(CHACHA_TAG)));
+}
+
+static void test_crypto_aead_pkt(void)
+{
+    gnrc_pktsnip_t snips[3];
+
+    /* packet split into three snips, processed in place */
+    memcpy(buf, CHACHA_PLAIN, CHACHA_PLAIN_LEN);
+    memset(snips, 0, sizeof(snips));
+    snips[0].data = buf;
+    snips[0].size = 40;
+    snips[0].next = &snips[1];
+    snips[1].data = buf + 40;
+    snips[1].size = 3;
+    snips[1].next = &snips[2];
+    snips[2].data = buf + 43;
+    snips[2].size = CHACHA_PLAIN_LEN - 43;
+
+    aead_init(&aead, AEAD_CHACHA20_POLY1305, CHACHA_KEY, sizeof(CHACHA_KEY));
+    aead_start(&aead, AEAD_ENCRYPT, CHACHA_NONCE, sizeof(CHACHA_NONCE),
+               sizeof(CHACHA_AD), CHACHA_PLAIN_LEN, 16);
+    aead_update_ad(&aead, CHACHA_AD, sizeof(CHACHA_AD));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_update_pkt(&aead, snips));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+
+    TEST_ASSERT(compare((uint8_t *)CHACHA_CIPHER, buf, CHACHA_PLAIN_LEN));
+    TEST_ASSERT(compare((uint8_t *)CHACHA_TAG, tag, sizeof(CHACHA_TAG)));
+}
+
+static void test_crypto_aead_ccm(void)
+{
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_init(&aead, AEAD_AES_128_CCM,
+                                             CCM_KEY, sizeof(CCM_KEY)));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_start(&aead, AEAD_ENCRYPT,
+                                              CCM_NONCE, sizeof(CCM_NONCE),
+                                              sizeof(CCM_AD), sizeof(CCM_PLAIN),
+                                              sizeof(CCM_TAG)));
+    aead_update_ad(&aead, CCM_AD, sizeof(CCM_AD));
+    aead_update(&aead, CCM_PLAIN, buf, 10);
+    aead_update(&aead, CCM_PLAIN + 10, buf + 10, sizeof(CCM_PLAIN) - 10);
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+
+    TEST_ASSERT(compare((uint8_t *)CCM_CIPHER, buf, sizeof(CCM_CIPHER)));
+    TEST_ASSERT(compare((uint8_t *)CCM_TAG, tag, sizeof(CCM_TAG)));
+
+    aead_start(&aead, AEAD_DECRYPT, CCM_NONCE, sizeof(CCM_NONCE),
+               sizeof(CCM_AD), sizeof(CCM_PLAIN), sizeof(CCM_TAG));
+    aead_update_ad(&aead, CCM_AD, sizeof(CCM_AD));
+    aead_update(&aead, buf, buf, sizeof(CCM_CIPHER));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+    TEST_ASSERT(compare((uint8_t *)CCM_PLAIN, buf, sizeof(CCM_PLAIN)));
+}
+
+static void test_crypto_aead_ccm_vs_modes(void)
+{
+    /* compare against cipher_encrypt_ccm() for other tag sizes */
+    static const uint8_t tag_sizes[] = { 4, 10, 16 };
+    cipher_t cipher;
+    uint8_t plain[50];
+    uint8_t expected[sizeof(plain) + AEAD_MAX_TAG_SIZE];
+
+    for (unsigned i = 0; i < sizeof(plain); i++) {
+        plain[i] = i * 7;
+    }
+    cipher_init(&cipher, CIPHER_AES_128, CCM_KEY, sizeof(CCM_KEY));
+    aead_init(&aead, AEAD_AES_128_CCM, CCM_KEY, sizeof(CCM_KEY));
+
+    for (unsigned i = 0; i < sizeof(tag_sizes); i++) {
+        uint8_t tag_len = tag_sizes[i];
+
+        TEST_ASSERT_EQUAL_INT(sizeof(plain) + tag_len,
+                              cipher_encrypt_ccm(&cipher, (uint8_t *)CCM_AD,
+                                                 sizeof(CCM_AD), tag_len, 2,
+                                                 (uint8_t *)CCM_NONCE,
+                                                 sizeof(CCM_NONCE), plain,
+                                                 sizeof(plain), expected));
+
+        aead_start(&aead, AEAD_ENCRYPT, CCM_NONCE, sizeof(CCM_NONCE),
+                   sizeof(CCM_AD), sizeof(plain), tag_len);
+        aead_update_ad(&aead, CCM_AD, 3);
+        aead_update_ad(&aead, CCM_AD + 3, sizeof(CCM_AD) - 3);
+        aead_update(&aead, plain, buf, 17);
+        aead_update(&aead, plain + 17, buf + 17, sizeof(plain) - 17);
+        TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+
+        TEST_ASSERT(compare(expected, buf, sizeof(plain)));
+        TEST_ASSERT(compare(expected + sizeof(plain), tag, tag_len));
+    }
+}
+
+static void test_crypto_aead_invalid(void)
+{
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_INVALID_KEY_SIZE,
+                          aead_init(&aead, AEAD_CHACHA20_POLY1305, CHACHA_KEY,
+                                    16));
+    aead_init(&aead, AEAD_CHACHA20_POLY1305, CHACHA_KEY, sizeof(CHACHA_KEY));
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_INVALID_NONCE,
+                          aead_start(&aead, AEAD_ENCRYPT, CHACHA_NONCE, 8,
+                                     0, 0, 16));
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_INVALID_TAG_SIZE,
+                          aead_start(&aead, AEAD_ENCRYPT, CHACHA_NONCE,
+                                     sizeof(CHACHA_NONCE), 0, 0, 8));
+
+    aead_init(&aead, AEAD_AES_128_CCM, CCM_KEY, sizeof(CCM_KEY));
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_INVALID_TAG_SIZE,
+                          aead_start(&aead, AEAD_ENCRYPT, CCM_NONCE,
+                                     sizeof(CCM_NONCE), 0, 0, 5));
+
+    /* more data than announced, or less */
+    aead_start(&aead, AEAD_ENCRYPT, CCM_NONCE, sizeof(CCM_NONCE), 4, 8, 8);
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_INVALID_LENGTH,
+                          aead_update_ad(&aead, CCM_AD, 5));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_update_ad(&aead, CCM_AD, 4));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_update(&aead, CCM_PLAIN, buf, 4));
+    TEST_ASSERT_EQUAL_INT(AEAD_ERR_INVALID_LENGTH, aead_finish(&aead, tag));
+}
+
+Test *tests_crypto_aead_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_crypto_aead_chacha20poly1305_encrypt),
+        new_TestFixture(test_crypto_aead_chacha20poly1305_decrypt),
+        new_TestFixture(test_crypto_aead_chacha20poly1305_chunked),
+        new_TestFixture(test_crypto_aead_pkt),
+        new_TestFixture(test_crypto_aead_ccm),
+        new_TestFixture(test_crypto_aead_ccm_vs_modes),
+        new_TestFixture(test_crypto_aead_invalid),
+    };
+
+    EMB_UNIT_TESTCALLER(crypto_aead_tests, NULL, NULL, fixtures);
+
+    return (Test *)&crypto_aead_tests;
+}
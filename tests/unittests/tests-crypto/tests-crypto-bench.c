@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+#include "xtimer.h"
+#include "crypto/aead.h"
+#include "crypto/ciphers.h"
+#include "crypto/modes/cbc.h"
+#include "crypto/modes/ccm.h"
+#include "crypto/modes/ctr.h"
+#include "crypto/modes/ecb.h"
+#include "tests-crypto.h"
+
+#define BENCH_LEN       (2048U)
+#define BENCH_ROUNDS    (8U)
+#define BENCH_CCM_LEN   (128U)     /**< CCM is used per packet */
+
+static uint8_t _key[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+static uint8_t _nonce[13];
+static uint8_t _in[BENCH_LEN];
+static uint8_t _out[BENCH_LEN + 16];
+static cipher_t _cipher;
+
+static void _print(const char *mode, uint32_t usec)
+{
+    uint32_t bytes = BENCH_LEN * BENCH_ROUNDS;
+
+    if (usec == 0) {
+        usec = 1;
+    }
+    /* bytes per microsecond equals MB/s */
+    uint32_t kbps = (uint32_t)(((uint64_t)bytes * 1000) / usec);
+    printf("\n%-8s %2u x %4u bytes: %6lu us, %lu.%03lu MB/s", mode,
+           BENCH_ROUNDS, BENCH_LEN, (unsigned long)usec,
+           (unsigned long)(kbps / 1000), (unsigned long)(kbps % 1000));
+}
+
+static void set_up(void)
+{
+    memset(_in, 0xa5, sizeof(_in));
+    cipher_init(&_cipher, CIPHER_AES_128, _key, sizeof(_key));
+}
+
+static void test_crypto_bench_ecb(void)
+{
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        TEST_ASSERT_EQUAL_INT(BENCH_LEN,
+                              cipher_encrypt_ecb(&_cipher, _in, BENCH_LEN, _out));
+    }
+    _print("ECB", xtimer_now_usec() - start);
+}
+
+static void test_crypto_bench_cbc(void)
+{
+    uint8_t iv[16] = { 0 };
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        TEST_ASSERT_EQUAL_INT(BENCH_LEN,
+                              cipher_encrypt_cbc(&_cipher, iv, _in, BENCH_LEN, _out));
+    }
+    _print("CBC", xtimer_now_usec() - start);
+}
+
+static void test_crypto_bench_ctr(void)
+{
+    uint8_t ctr[16] = { 0 };
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        TEST_ASSERT_EQUAL_INT(BENCH_LEN,
+                              cipher_encrypt_ctr(&_cipher, ctr, 8, _in, BENCH_LEN, _out));
+    }
+    _print("CTR", xtimer_now_usec() - start);
+}
+
+static void test_crypto_bench_ccm(void)
+{
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        for (unsigned pos = 0; pos < BENCH_LEN; pos += BENCH_CCM_LEN) {
+            TEST_ASSERT_EQUAL_INT(BENCH_CCM_LEN + 8,
+                                  cipher_encrypt_ccm(&_cipher, NULL, 0, 8, 2,
+                                                     _nonce, sizeof(_nonce),
+                                                     &_in[pos], BENCH_CCM_LEN,
+                                                     _out));
+        }
+    }
+    _print("CCM", xtimer_now_usec() - start);
+}
+
+static void _bench_aead(const char *name, aead_id_t id, size_t key_len)
+{
+    static aead_t aead;
+    uint8_t key[32] = { 0 };
+    uint8_t tag[AEAD_MAX_TAG_SIZE];
+    size_t nonce_len = (id == AEAD_AES_128_CCM) ? sizeof(_nonce) : 12;
+    size_t tag_len = (id == AEAD_AES_128_CCM) ? 8 : 16;
+
+    memcpy(key, _key, sizeof(_key));
+    TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_init(&aead, id, key, key_len));
+
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_ROUNDS; i++) {
+        for (unsigned pos = 0; pos < BENCH_LEN; pos += BENCH_CCM_LEN) {
+            aead_start(&aead, AEAD_ENCRYPT, _nonce, nonce_len, 0,
+                       BENCH_CCM_LEN, tag_len);
+            aead_update(&aead, &_in[pos], _out, BENCH_CCM_LEN);
+            TEST_ASSERT_EQUAL_INT(AEAD_OK, aead_finish(&aead, tag));
+        }
+    }
+    _print(name, xtimer_now_usec() - start);
+}
+
+static void test_crypto_bench_aead_ccm(void)
+{
+    _bench_aead("AEAD-CCM", AEAD_AES_128_CCM, 16);
+}
+
+static void test_crypto_bench_aead_chacha20poly1305(void)
+{
+    _bench_aead("C20P1305", AEAD_CHACHA20_POLY1305, 32);
+}
+
+Test *tests_crypto_bench_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_crypto_bench_ecb),
+        new_TestFixture(test_crypto_bench_cbc),
+        new_TestFixture(test_crypto_bench_ctr),
+        new_TestFixture(test_crypto_bench_ccm),
+        new_TestFixture(test_crypto_bench_aead_ccm),
+        new_TestFixture(test_crypto_bench_aead_chacha20poly1305),
+    };
+
+    EMB_UNIT_TESTCALLER(crypto_bench_tests, set_up, NULL, fixtures);
+
+    return (Test *)&crypto_bench_tests;
+}
@@ -119,12 +119,24 @@ static void test_crypto_modes_ctr_decrypt(void)
                     TEST_1_CIPHER_LEN, TEST_1_PLAIN, TEST_1_PLAIN_LEN);
 }
 
+static void test_crypto_modes_ctr_encrypt_partial(void)
+{
+    uint8_t ctr[16];
+
+    /* the last block is only partially used */
+    memcpy(ctr, TEST_1_COUNTER, 16);
+    test_encrypt_op(TEST_1_KEY, TEST_1_KEY_LEN, ctr, TEST_1_PLAIN,
+                    40, TEST_1_CIPHER, 40);
+    TEST_ASSERT_EQUAL_INT(0x02, ctr[15]);
+}
+
 
 Test* tests_crypto_modes_ctr_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_crypto_modes_ctr_encrypt),
-                        new_TestFixture(test_crypto_modes_ctr_decrypt)
+                        new_TestFixture(test_crypto_modes_ctr_decrypt),
+                        new_TestFixture(test_crypto_modes_ctr_encrypt_partial)
     };
 
     EMB_UNIT_TESTCALLER(crypto_modes_ctr_tests, NULL, NULL, fixtures);
@@ -18,4 +18,6 @@ void tests_crypto(void)
     TESTS_RUN(tests_crypto_modes_ecb_tests());
     TESTS_RUN(tests_crypto_modes_cbc_tests());
     TESTS_RUN(tests_crypto_modes_ctr_tests());
+    TESTS_RUN(tests_crypto_aead_tests());
+    TESTS_RUN(tests_crypto_bench_tests());
 }
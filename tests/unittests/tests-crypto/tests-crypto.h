@@ -58,6 +58,23 @@ Test* tests_crypto_modes_ecb_tests(void);
 Test* tests_crypto_modes_cbc_tests(void);
 Test* tests_crypto_modes_ctr_tests(void);
 
+/**
+ * @brief   Generates tests for crypto/aead.h
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_crypto_aead_tests(void);
+
+/**
+ * @brief   Generates the cipher mode throughput benchmark
+ *
+ * Prints the throughput of each mode and AEAD algorithm in MB/s. The
+ * fixtures only fail if an operation returns an error.
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_crypto_bench_tests(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     unittests
+ * @{
+ *
+ * @file
+ * @brief       Throughput of the hash functions for several input sizes
+ *
+ * Prints cycles per byte if the board defines CLOCK_CORECLOCK and
+ * nanoseconds per byte otherwise (e.g. on native).
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+#include "periph_conf.h"
+#include "xtimer.h"
+
+#include "hashes.h"
+#include "hashes/md5.h"
+#include "hashes/sha1.h"
+#include "hashes/sha256.h"
+#include "hashes/siphash.h"
+#include "hashes/xxhash.h"
+
+#include "tests-hashes.h"
+
+/* amount of data hashed per input size */
+#define BENCH_TOTAL     (16384U)
+/* the same for the much faster non-cryptographic hashes */
+#define BENCH_FAST_TOTAL    (16U * BENCH_TOTAL)
+
+static const size_t _sizes[] = { 16, 64, 256, 1024, 4096 };
+static uint8_t _buf[4096];
+
+static void _print_total(const char *name, size_t size, uint32_t usec,
+                         uint32_t total)
+{
+#ifdef CLOCK_CORECLOCK
+    /* hundredths of a cycle per byte */
+    uint64_t val = ((uint64_t)usec * (CLOCK_CORECLOCK / 10000U)) / total;
+    const char *unit = "cycles/B";
+#else
+    uint64_t val = ((uint64_t)usec * 100000U) / total;
+    const char *unit = "ns/B";
+#endif
+    printf("\n%-6s %4u bytes: %4lu.%02lu %s", name, (unsigned)size,
+           (unsigned long)(val / 100), (unsigned long)(val % 100), unit);
+}
+
+static void _print(const char *name, size_t size, uint32_t usec)
+{
+    _print_total(name, size, usec, BENCH_TOTAL);
+}
+
+static void test_hashes_bench_md5(void)
+{
+    for (unsigned i = 0; i < sizeof(_sizes) / sizeof(_sizes[0]); i++) {
+        uint8_t digest[MD5_DIGEST_LENGTH];
+        uint32_t start = xtimer_now_usec();
+        for (unsigned n = 0; n < BENCH_TOTAL / _sizes[i]; n++) {
+            md5(digest, _buf, _sizes[i]);
+        }
+        _print("MD5", _sizes[i], xtimer_now_usec() - start);
+    }
+}
+
+static void test_hashes_bench_sha1(void)
+{
+    for (unsigned i = 0; i < sizeof(_sizes) / sizeof(_sizes[0]); i++) {
+        uint8_t digest[SHA1_DIGEST_LENGTH];
+        uint32_t start = xtimer_now_usec();
+        for (unsigned n = 0; n < BENCH_TOTAL / _sizes[i]; n++) {
+            sha1(digest, _buf, _sizes[i]);
+        }
+        _print("SHA1", _sizes[i], xtimer_now_usec() - start);
+    }
+}
+
+static void test_hashes_bench_sha256(void)
+{
+    for (unsigned i = 0; i < sizeof(_sizes) / sizeof(_sizes[0]); i++) {
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+        uint32_t start = xtimer_now_usec();
+        for (unsigned n = 0; n < BENCH_TOTAL / _sizes[i]; n++) {
+            sha256(_buf, _sizes[i], digest);
+        }
+        _print("SHA256", _sizes[i], xtimer_now_usec() - start);
+    }
+}
+
+/* keeps the compiler from dropping the calls */
+static volatile uint64_t _sink;
+
+static const uint8_t _sip_key[SIPHASH_KEY_SIZE];
+
+static uint64_t _djb2(const uint8_t *buf, size_t len)
+{
+    return djb2_hash(buf, len);
+}
+
+static uint64_t _fnv(const uint8_t *buf, size_t len)
+{
+    return fnv_hash(buf, len);
+}
+
+static uint64_t _one_at_a_time(const uint8_t *buf, size_t len)
+{
+    return one_at_a_time_hash(buf, len);
+}
+
+static uint64_t _xxh32(const uint8_t *buf, size_t len)
+{
+    return xxh32(buf, len, 0);
+}
+
+static uint64_t _xxh64(const uint8_t *buf, size_t len)
+{
+    return xxh64(buf, len, 0);
+}
+
+static uint64_t _siphash24(const uint8_t *buf, size_t len)
+{
+    return siphash24(_sip_key, buf, len);
+}
+
+static void _bench_fast(const char *name,
+                        uint64_t (*hash)(const uint8_t *, size_t))
+{
+    for (unsigned i = 0; i < sizeof(_sizes) / sizeof(_sizes[0]); i++) {
+        uint32_t start = xtimer_now_usec();
+        for (unsigned n = 0; n < BENCH_FAST_TOTAL / _sizes[i]; n++) {
+            _sink = hash(_buf, _sizes[i]);
+        }
+        _print_total(name, _sizes[i], xtimer_now_usec() - start,
+                     BENCH_FAST_TOTAL);
+    }
+}
+
+static void test_hashes_bench_djb2(void)
+{
+    _bench_fast("DJB2", _djb2);
+}
+
+static void test_hashes_bench_fnv(void)
+{
+    _bench_fast("FNV", _fnv);
+}
+
+static void test_hashes_bench_one_at_a_time(void)
+{
+    _bench_fast("OAAT", _one_at_a_time);
+}
+
+static void test_hashes_bench_xxh32(void)
+{
+    _bench_fast("XXH32", _xxh32);
+}
+
+static void test_hashes_bench_xxh64(void)
+{
+    _bench_fast("XXH64", _xxh64);
+}
+
+static void test_hashes_bench_siphash24(void)
+{
+    _bench_fast("SIP24", _siphash24);
+}
+
+Test *tests_hashes_bench_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_hashes_bench_md5),
+        new_TestFixture(test_hashes_bench_sha1),
+        new_TestFixture(test_hashes_bench_sha256),
+        new_TestFixture(test_hashes_bench_djb2),
+        new_TestFixture(test_hashes_bench_fnv),
+        new_TestFixture(test_hashes_bench_one_at_a_time),
+        new_TestFixture(test_hashes_bench_xxh32),
+        new_TestFixture(test_hashes_bench_xxh64),
+        new_TestFixture(test_hashes_bench_siphash24),
+    };
+
+    EMB_UNIT_TESTCALLER(hashes_bench_tests, NULL, NULL, fixtures);
+
+    return (Test *)&hashes_bench_tests;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     unittests
+ * @{
+ *
+ * @file
+ * @brief       Test cases for the SipHash implementation
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+
+#include "hashes/siphash.h"
+
+#include "tests-hashes.h"
+
+static uint8_t _key[SIPHASH_KEY_SIZE];
+static uint8_t _msg[64 + 1];
+
+static void set_up(void)
+{
+    for (unsigned i = 0; i < sizeof(_key); i++) {
+        _key[i] = i;
+    }
+    for (unsigned i = 0; i < sizeof(_msg); i++) {
+        _msg[i] = i;
+    }
+}
+
+/* key 00 01 .. 0f, message 00 01 .. (len - 1), from the reference vectors */
+static void test_hashes_siphash24(void)
+{
+    TEST_ASSERT(siphash24(_key, _msg, 0) == 0x726fdb47dd0e0e31ULL);
+    TEST_ASSERT(siphash24(_key, _msg, 1) == 0x74f839c593dc67fdULL);
+    TEST_ASSERT(siphash24(_key, _msg, 7) == 0xab0200f58b01d137ULL);
+    TEST_ASSERT(siphash24(_key, _msg, 8) == 0x93f5f5799a932462ULL);
+    TEST_ASSERT(siphash24(_key, _msg, 15) == 0xa129ca6149be45e5ULL);
+    TEST_ASSERT(siphash24(_key, _msg, 63) == 0x958a324ceb064572ULL);
+}
+
+static void test_hashes_siphash24_unaligned(void)
+{
+    /* message at an odd address */
+    memmove(&_msg[1], &_msg[0], 63);
+    TEST_ASSERT(siphash24(_key, &_msg[1], 15) == 0xa129ca6149be45e5ULL);
+}
+
+static void test_hashes_siphash24_key(void)
+{
+    uint64_t h = siphash24(_key, _msg, 15);
+
+    _key[15] ^= 1;
+    TEST_ASSERT(siphash24(_key, _msg, 15) != h);
+}
+
+Test *tests_hashes_siphash_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_hashes_siphash24),
+        new_TestFixture(test_hashes_siphash24_unaligned),
+        new_TestFixture(test_hashes_siphash24_key),
+    };
+
+    EMB_UNIT_TESTCALLER(hashes_siphash_tests, set_up, NULL, fixtures);
+
+    return (Test *)&hashes_siphash_tests;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "embUnit/embUnit.h"
+
+#include "fs/constfs.h"
+#include "hashes/stream.h"
+#include "net/gnrc/pkt.h"
+#include "vfs.h"
+
+#include "tests-hashes.h"
+
+static uint8_t _data[300];
+
+static const constfs_file_t _files[] = {
+    {
+        .path = "/data.bin",
+        .data = _data,
+        .size = sizeof(_data),
+    },
+};
+
+static const constfs_t _fs = {
+    .files = _files,
+    .nfiles = sizeof(_files) / sizeof(_files[0]),
+};
+
+static vfs_mount_t _mount = {
+    .mount_point = "/hashes",
+    .fs = &constfs_file_system,
+    .private_data = (void *)&_fs,
+};
+
+static void set_up(void)
+{
+    for (unsigned i = 0; i < sizeof(_data); i++) {
+        _data[i] = i * 13;
+    }
+    vfs_mount(&_mount);
+}
+
+static void tear_down(void)
+{
+    vfs_umount(&_mount);
+}
+
+static void test_hashes_stream_pkt(void)
+{
+    gnrc_pktsnip_t snips[4];
+    sha256_context_t ctx;
+    uint8_t expected[SHA256_DIGEST_LENGTH];
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    /* an empty snip and snips not aligned to the block size */
+    memset(snips, 0, sizeof(snips));
+    snips[0].data = _data;
+    snips[0].size = 13;
+    snips[0].next = &snips[1];
+    snips[1].data = NULL;
+    snips[1].size = 0;
+    snips[1].next = &snips[2];
+    snips[2].data = _data + 13;
+    snips[2].size = 100;
+    snips[2].next = &snips[3];
+    snips[3].data = _data + 113;
+    snips[3].size = sizeof(_data) - 113;
+
+    sha256(_data, sizeof(_data), expected);
+
+    sha256_init(&ctx);
+    TEST_ASSERT_EQUAL_INT(sizeof(_data),
+                          hashes_update_pkt(hashes_sha256_update, &ctx, snips));
+    sha256_final(&ctx, digest);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected, digest, sizeof(digest)));
+}
+
+static void test_hashes_stream_pkt_hmac(void)
+{
+    static const uint8_t key[] = "key";
+    gnrc_pktsnip_t snips[2];
+    hmac_context_t ctx;
+    uint8_t expected[SHA256_DIGEST_LENGTH];
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    memset(snips, 0, sizeof(snips));
+    snips[0].data = _data;
+    snips[0].size = 70;
+    snips[0].next = &snips[1];
+    snips[1].data = _data + 70;
+    snips[1].size = 30;
+
+    hmac_sha256(key, sizeof(key), _data, 100, expected);
+
+    hmac_sha256_init(&ctx, key, sizeof(key));
+    hashes_update_pkt(hashes_hmac_sha256_update, &ctx, snips);
+    hmac_sha256_final(&ctx, digest);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected, digest, sizeof(digest)));
+}
+
+static void test_hashes_stream_file(void)
+{
+    /* chunk sizes below, at and above the block size */
+    static const size_t chunks[] = { 1, 7, 64, 200 };
+    uint8_t buf[200];
+    uint8_t expected[MD5_DIGEST_LENGTH];
+    uint8_t digest[MD5_DIGEST_LENGTH];
+
+    md5(expected, _data, sizeof(_data));
+
+    for (unsigned i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        md5_ctx_t ctx;
+
+        md5_init(&ctx);
+        TEST_ASSERT_EQUAL_INT(sizeof(_data),
+                              hashes_update_file(hashes_md5_update, &ctx,
+                                                 "/hashes/data.bin",
+                                                 buf, chunks[i]));
+        md5_final(&ctx, digest);
+        TEST_ASSERT_EQUAL_INT(0, memcmp(expected, digest, sizeof(digest)));
+    }
+}
+
+static void test_hashes_stream_fd(void)
+{
+    uint8_t buf[32];
+    uint8_t expected[SHA256_DIGEST_LENGTH];
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    sha256_context_t ctx;
+
+    /* hash from the current position on */
+    int fd = vfs_open("/hashes/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(100, vfs_lseek(fd, 100, SEEK_SET));
+
+    sha256_init(&ctx);
+    TEST_ASSERT_EQUAL_INT(sizeof(_data) - 100,
+                          hashes_update_fd(hashes_sha256_update, &ctx, fd,
+                                           buf, sizeof(buf)));
+    sha256_final(&ctx, digest);
+    vfs_close(fd);
+
+    sha256(_data + 100, sizeof(_data) - 100, expected);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected, digest, sizeof(digest)));
+}
+
+static void test_hashes_stream_file_missing(void)
+{
+    uint8_t buf[16];
+    sha256_context_t ctx;
+
+    sha256_init(&ctx);
+    TEST_ASSERT_EQUAL_INT(-ENOENT,
+                          hashes_update_file(hashes_sha256_update, &ctx,
+                                             "/hashes/missing", buf,
+                                             sizeof(buf)));
+}
+
+Test *tests_hashes_stream_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_hashes_stream_pkt),
+        new_TestFixture(test_hashes_stream_pkt_hmac),
+        new_TestFixture(test_hashes_stream_file),
+        new_TestFixture(test_hashes_stream_fd),
+        new_TestFixture(test_hashes_stream_file_missing),
+    };
+
+    EMB_UNIT_TESTCALLER(hashes_stream_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&hashes_stream_tests;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     unittests
+ * @{
+ *
+ * @file
+ * @brief       Test cases for the xxHash implementation
+ *
+ * @}
+ */
+
+#include <string.h>
+
+#include "embUnit/embUnit.h"
+
+#include "hashes/xxhash.h"
+
+#include "tests-hashes.h"
+
+/* results of the reference implementation */
+static const char _str[] = "Nobody inspects the spammish repetition";
+
+static void test_hashes_xxh32(void)
+{
+    TEST_ASSERT(xxh32(_str, 0, 0) == 0x02cc5d05);
+    TEST_ASSERT(xxh32(_str, 3, 0) == 0x08e99f85);
+    TEST_ASSERT(xxh32(_str, 16, 0) == 0xfd55f482);
+    TEST_ASSERT(xxh32(_str, 39, 0) == 0xe2293b2f);
+    TEST_ASSERT(xxh32(_str, 0, 0x9e3779b1) == 0x36b78ae7);
+    TEST_ASSERT(xxh32(_str, 39, 0x9e3779b1) == 0xc9e89e68);
+}
+
+static void test_hashes_xxh64(void)
+{
+    TEST_ASSERT(xxh64(_str, 0, 0) == 0xef46db3751d8e999ULL);
+    TEST_ASSERT(xxh64(_str, 3, 0) == 0xc9836c0b0560ccbaULL);
+    TEST_ASSERT(xxh64(_str, 16, 0) == 0xc9af09f9668b54faULL);
+    TEST_ASSERT(xxh64(_str, 39, 0) == 0xfbcea83c8a378bf1ULL);
+    TEST_ASSERT(xxh64(_str, 16, 0x9e3779b185ebca87ULL) == 0xe391ea9110904785ULL);
+    TEST_ASSERT(xxh64(_str, 39, 0x9e3779b185ebca87ULL) == 0x9d24e6a5798d51e1ULL);
+}
+
+static void test_hashes_xxh64_hash64(void)
+{
+    uint64_t seed = 0x9e3779b185ebca87ULL;
+
+    TEST_ASSERT(xxh64_hash64(NULL, _str, 39) == 0xfbcea83c8a378bf1ULL);
+    TEST_ASSERT(xxh64_hash64(&seed, _str, 39) == 0x9d24e6a5798d51e1ULL);
+}
+
+static void test_hashes_xxhash_unaligned(void)
+{
+    char buf[sizeof(_str) + 3];
+
+    for (unsigned off = 1; off < 4; off++) {
+        memcpy(&buf[off], _str, sizeof(_str));
+        TEST_ASSERT(xxh32(&buf[off], 39, 0) == 0xe2293b2f);
+        TEST_ASSERT(xxh64(&buf[off], 39, 0) == 0xfbcea83c8a378bf1ULL);
+    }
+}
+
+Test *tests_hashes_xxhash_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_hashes_xxh32),
+        new_TestFixture(test_hashes_xxh64),
+        new_TestFixture(test_hashes_xxh64_hash64),
+        new_TestFixture(test_hashes_xxhash_unaligned),
+    };
+
+    EMB_UNIT_TESTCALLER(hashes_xxhash_tests, NULL, NULL, fixtures);
+
+    return (Test *)&hashes_xxhash_tests;
+}
@@ -28,4 +28,8 @@ void tests_hashes(void)
     TESTS_RUN(tests_hashes_sha256_tests());
     TESTS_RUN(tests_hashes_sha256_hmac_tests());
     TESTS_RUN(tests_hashes_sha256_chain_tests());
+    TESTS_RUN(tests_hashes_xxhash_tests());
+    TESTS_RUN(tests_hashes_siphash_tests());
+    TESTS_RUN(tests_hashes_stream_tests());
+    TESTS_RUN(tests_hashes_bench_tests());
 }
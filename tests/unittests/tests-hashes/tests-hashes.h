@@ -72,6 +72,29 @@ Test *tests_hashes_sha256_hmac_tests(void);
  */
 Test *tests_hashes_sha256_chain_tests(void);
 
+/**
+ * @brief   Generates tests for hashes/xxhash.h
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_hashes_xxhash_tests(void);
+
+/**
+ * @brief   Generates tests for hashes/siphash.h
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_hashes_siphash_tests(void);
+
+/**
+ * @brief   Generates tests for hashes/stream.h
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_hashes_stream_tests(void);
+
+Test *tests_hashes_bench_tests(void);
+
 #ifdef __cplusplus
 }
 #endif
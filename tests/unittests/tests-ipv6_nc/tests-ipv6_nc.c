@@ -13,6 +13,7 @@
  */
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "embUnit.h"
 
@@ -440,6 +441,95 @@ static void test_ipv6_nc_get_l2_addr__reachable(void)
     TEST_ASSERT_EQUAL_INT(sizeof(TEST_STRING4), l2_addr_len);
 }
 
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+static void _set_ll(ipv6_addr_t *ll, const uint8_t *l2_addr)
+{
+    ipv6_addr_set_link_local_prefix(ll);
+    memcpy(&ll->u8[8], l2_addr, 8);
+    ll->u8[8] ^= 0x02;
+}
+
+static void test_ipv6_nc_etx_update__unknown(void)
+{
+    static const uint8_t l2_addr[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+    ipv6_addr_t ll;
+
+    _set_ll(&ll, l2_addr);
+    TEST_ASSERT_EQUAL_INT(GNRC_IPV6_NC_ETX_INIT,
+                          gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &ll));
+    TEST_ASSERT(gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, l2_addr,
+                                        sizeof(l2_addr), true) > 0);
+    /* one sample moves the estimate from the initial value towards 1 */
+    TEST_ASSERT(gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &ll) < GNRC_IPV6_NC_ETX_INIT);
+    TEST_ASSERT(gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &ll) > GNRC_IPV6_NC_ETX_DIVISOR);
+    /* the neighbor cache is left to neighbor discovery */
+    TEST_ASSERT_NULL(gnrc_ipv6_nc_get_next(NULL));
+}
+
+static void test_ipv6_nc_etx_update__l2_addr_too_long(void)
+{
+    static const uint8_t l2_addr[GNRC_IPV6_NC_L2_ADDR_MAX + 1] = { 0 };
+
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, l2_addr,
+                                                     sizeof(l2_addr), true));
+}
+
+static void test_ipv6_nc_etx_update__known(void)
+{
+    ipv6_addr_t addr = DEFAULT_TEST_IPV6_ADDR;
+
+    test_ipv6_nc_add__success(); /* adds DEFAULT_TEST_IPV6_ADDR to DEFAULT_TEST_NETIF */
+
+    /* found by the link layer address of the neighbor cache entry */
+    for (int i = 0; i < 64; i++) {
+        gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, (uint8_t *)TEST_STRING4,
+                                sizeof(TEST_STRING4), true);
+    }
+    /* converges to a perfect link */
+    TEST_ASSERT(gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &addr) <=
+                GNRC_IPV6_NC_ETX_DIVISOR + (1 << GNRC_IPV6_NC_ETX_SHIFT));
+
+    /* every other frame is lost */
+    for (int i = 0; i < 64; i++) {
+        gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, (uint8_t *)TEST_STRING4,
+                                sizeof(TEST_STRING4), i & 1);
+    }
+    TEST_ASSERT(gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &addr) >
+                3 * GNRC_IPV6_NC_ETX_DIVISOR);
+    TEST_ASSERT(gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &addr) <
+                GNRC_IPV6_NC_ETX_NOACK);
+}
+
+static void test_ipv6_nc_etx_update__evict(void)
+{
+    uint8_t l2_addr[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x00 };
+    ipv6_addr_t ll;
+
+    for (unsigned i = 0; i < GNRC_IPV6_NC_ETX_NUMOF; i++) {
+        l2_addr[7] = i;
+        gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, l2_addr, sizeof(l2_addr), true);
+    }
+    /* the first neighbor is used again, the second one becomes the oldest */
+    l2_addr[7] = 0;
+    gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, l2_addr, sizeof(l2_addr), true);
+    l2_addr[7] = GNRC_IPV6_NC_ETX_NUMOF;
+    gnrc_ipv6_nc_etx_update(DEFAULT_TEST_NETIF, l2_addr, sizeof(l2_addr), true);
+
+    for (unsigned i = 0; i <= GNRC_IPV6_NC_ETX_NUMOF; i++) {
+        l2_addr[7] = i;
+        _set_ll(&ll, l2_addr);
+        if (i == 1) {
+            TEST_ASSERT_EQUAL_INT(GNRC_IPV6_NC_ETX_INIT,
+                                  gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &ll));
+        }
+        else {
+            TEST_ASSERT(gnrc_ipv6_nc_get_etx(DEFAULT_TEST_NETIF, &ll) <
+                        GNRC_IPV6_NC_ETX_INIT);
+        }
+    }
+}
+#endif
+
 Test *tests_ipv6_nc_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -475,6 +565,12 @@ Test *tests_ipv6_nc_tests(void)
         new_TestFixture(test_ipv6_nc_get_l2_addr__NULL_entry),
         new_TestFixture(test_ipv6_nc_get_l2_addr__unreachable),
         new_TestFixture(test_ipv6_nc_get_l2_addr__reachable),
+#ifdef MODULE_GNRC_IPV6_NC_ETX
+        new_TestFixture(test_ipv6_nc_etx_update__unknown),
+        new_TestFixture(test_ipv6_nc_etx_update__l2_addr_too_long),
+        new_TestFixture(test_ipv6_nc_etx_update__known),
+        new_TestFixture(test_ipv6_nc_etx_update__evict),
+#endif
     };
 
     EMB_UNIT_TESTCALLER(ipv6_nc_tests, set_up, tear_down, fixtures);
@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "kvstore.h"
+#include "tests-kvstore.h"
+
+#ifdef MODULE_MTD_NATIVE
+#include "mtd_native.h"
+
+#define SECTORS         (8U)
+#define INDEX_SIZE      (16U)
+
+static uint32_t _wear[SECTORS];
+
+static mtd_native_dev_t _dev = {
+    .dev = {
+        .driver = &native_flash_driver,
+        .sector_count = SECTORS,
+        .pages_per_sector = 4,
+        .page_size = 128,
+    },
+    .fname = "kvstore_test.bin",
+    .wear = _wear,
+};
+
+/* smallest store, all sectors are in use while compacting */
+#define SMALL_SECTORS   (3U)
+#define SMALL_SIZE      (256U)
+
+static uint32_t _small_wear[SMALL_SECTORS];
+
+static mtd_native_dev_t _small = {
+    .dev = {
+        .driver = &native_flash_driver,
+        .sector_count = SMALL_SECTORS,
+        .pages_per_sector = 2,
+        .page_size = SMALL_SIZE / 2,
+    },
+    .fname = "kvstore_test_small.bin",
+    .wear = _small_wear,
+};
+
+static kvstore_entry_t _index[INDEX_SIZE];
+
+static kvstore_t _kvs = {
+    .dev = (mtd_dev_t *)&_dev,
+    .index = _index,
+    .index_size = INDEX_SIZE,
+};
+
+static void set_up(void)
+{
+    _kvs.dev = (mtd_dev_t *)&_dev;
+    _dev.power_cut = 0;
+    memset(_wear, 0, sizeof(_wear));
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(&_dev.dev, 0, SECTORS * 512));
+    TEST_ASSERT_EQUAL_INT(-ENODEV, kvstore_mount(&_kvs));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_format(&_kvs));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+}
+
+static uint32_t _get_u32(const char *key)
+{
+    uint32_t val;
+
+    if (kvstore_get(&_kvs, key, &val, sizeof(val)) != sizeof(val)) {
+        return UINT32_MAX;
+    }
+    return val;
+}
+
+static void _set_u32(const char *key, uint32_t val)
+{
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kvs, key, &val, sizeof(val)));
+}
+
+static void test_kvstore_set_get(void)
+{
+    char buf[16];
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kvs, "name", "riot", 4));
+    _set_u32("count", 1);
+    TEST_ASSERT_EQUAL_INT(4, kvstore_get(&_kvs, "name", buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, "riot", 4));
+    TEST_ASSERT_EQUAL_INT(1, _get_u32("count"));
+
+    _set_u32("count", 2);
+    TEST_ASSERT_EQUAL_INT(2, _get_u32("count"));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kvs, "name", "RIOT-OS", 7));
+    /* truncated, the full length is returned */
+    TEST_ASSERT_EQUAL_INT(7, kvstore_get(&_kvs, "name", buf, 2));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, "RI", 2));
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_delete(&_kvs, "name"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_get(&_kvs, "name", buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_delete(&_kvs, "name"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_get(&_kvs, "other", buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kvs, "empty", NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_get(&_kvs, "empty", buf, sizeof(buf)));
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_set(&_kvs, "", "x", 1));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_set(&_kvs,
+                                               "0123456789abcdef0123456789abcdefX",
+                                               "x", 1));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_get(&_kvs, "", buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_get(&_kvs,
+                                               "0123456789abcdef0123456789abcdefX",
+                                               buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_delete(&_kvs, ""));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_delete(&_kvs,
+                                                  "0123456789abcdef0123456789abcdefX"));
+}
+
+static void test_kvstore_remount(void)
+{
+    _set_u32("a", 1);
+    _set_u32("b", 2);
+    _set_u32("a", 3);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_delete(&_kvs, "b"));
+    _set_u32("c", 4);
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+    TEST_ASSERT_EQUAL_INT(2, _kvs.keys);
+    TEST_ASSERT_EQUAL_INT(3, _get_u32("a"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_get(&_kvs, "b", NULL, 0));
+    TEST_ASSERT_EQUAL_INT(4, _get_u32("c"));
+}
+
+static void test_kvstore_commit(void)
+{
+    uint32_t one = 1, two = 2;
+    const kvstore_op_t ops[] = {
+        { .key = "x", .value = &one, .len = sizeof(one) },
+        { .key = "y", .value = &two, .len = sizeof(two) },
+        { .key = "z" },
+    };
+    kvstore_op_t many[KVSTORE_TXN_MAX + 1];
+
+    _set_u32("z", 9);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_commit(&_kvs, ops, 3));
+    TEST_ASSERT_EQUAL_INT(1, _get_u32("x"));
+    TEST_ASSERT_EQUAL_INT(2, _get_u32("y"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_get(&_kvs, "z", NULL, 0));
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+    TEST_ASSERT_EQUAL_INT(2, _get_u32("y"));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_get(&_kvs, "z", NULL, 0));
+
+    for (unsigned i = 0; i < KVSTORE_TXN_MAX + 1; i++) {
+        many[i] = ops[0];
+    }
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_commit(&_kvs, many, KVSTORE_TXN_MAX + 1));
+}
+
+static void test_kvstore_full(void)
+{
+    static const char *keys[] = {
+        "k0", "k1", "k2", "k3", "k4", "k5", "k6", "k7",
+        "k8", "k9", "ka", "kb", "kc", "kd", "ke", "kf",
+    };
+    uint8_t big[400];
+    unsigned i;
+    int res = 0;
+
+    /* the index holds one key less than its size */
+    for (i = 0; i < INDEX_SIZE - 1; i++) {
+        _set_u32(keys[i], i);
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, kvstore_set(&_kvs, keys[i], &i, sizeof(i)));
+    /* replacing a value needs no new entry */
+    _set_u32(keys[0], 100);
+    for (i = 1; i < INDEX_SIZE - 1; i++) {
+        TEST_ASSERT_EQUAL_INT(0, kvstore_delete(&_kvs, keys[i]));
+    }
+
+    /* one value per sector, one sector is the reserve */
+    memset(big, 0x5a, sizeof(big));
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, kvstore_set(&_kvs, "huge", big, 600));
+    for (i = 1; i < INDEX_SIZE - 1; i++) {
+        res = kvstore_set(&_kvs, keys[i], big, sizeof(big));
+        if (res) {
+            break;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, res);
+    TEST_ASSERT(i >= SECTORS - 2);
+    /* nothing was lost */
+    TEST_ASSERT_EQUAL_INT(100, _get_u32(keys[0]));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+    TEST_ASSERT_EQUAL_INT(100, _get_u32(keys[0]));
+    for (unsigned j = 1; j < i; j++) {
+        TEST_ASSERT_EQUAL_INT(sizeof(big), kvstore_get(&_kvs, keys[j], NULL, 0));
+    }
+
+    /* space is available again after deleting */
+    TEST_ASSERT_EQUAL_INT(0, kvstore_delete(&_kvs, keys[1]));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kvs, keys[i], big, sizeof(big)));
+}
+
+static void test_kvstore_wear(void)
+{
+    uint32_t min = UINT32_MAX, max = 0;
+
+    _set_u32("static", 42);
+    for (uint32_t i = 0; i < 2000; i++) {
+        _set_u32((i & 1) ? "odd" : "even", i);
+        if ((i % 16) == 0) {
+            /* what a low priority thread would do */
+            TEST_ASSERT(kvstore_compact(&_kvs) >= 0);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1999, _get_u32("odd"));
+    TEST_ASSERT_EQUAL_INT(1998, _get_u32("even"));
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+    TEST_ASSERT_EQUAL_INT(42, _get_u32("static"));
+    TEST_ASSERT_EQUAL_INT(1999, _get_u32("odd"));
+
+    for (unsigned i = 0; i < SECTORS; i++) {
+        if (_wear[i] < min) {
+            min = _wear[i];
+        }
+        if (_wear[i] > max) {
+            max = _wear[i];
+        }
+    }
+    TEST_ASSERT(min > 0);
+    TEST_ASSERT(max - min <= 2);
+}
+
+static void test_kvstore_power_cut(void)
+{
+    uint32_t old[3] = { 1, 2, 3 };
+    uint32_t new[3] = { 10, 20, 30 };
+    const kvstore_op_t ops[] = {
+        { .key = "a", .value = &new[0], .len = sizeof(uint32_t) },
+        { .key = "b", .value = &new[1], .len = sizeof(uint32_t) },
+        { .key = "c", .value = &new[2], .len = sizeof(uint32_t) },
+    };
+    unsigned cut;
+
+    for (cut = 1; ; cut++) {
+        set_up();
+        _set_u32("a", old[0]);
+        _set_u32("b", old[1]);
+        _set_u32("c", old[2]);
+
+        _dev.power_cut = cut;
+        int res = kvstore_commit(&_kvs, ops, 3);
+        if (_dev.power_cut) {
+            /* done before the power failed */
+            TEST_ASSERT_EQUAL_INT(0, res);
+            break;
+        }
+        TEST_ASSERT_EQUAL_INT(-EIO, res);
+
+        TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+        uint32_t *expect = (_get_u32("a") == old[0]) ? old : new;
+        TEST_ASSERT_EQUAL_INT(expect[0], _get_u32("a"));
+        TEST_ASSERT_EQUAL_INT(expect[1], _get_u32("b"));
+        TEST_ASSERT_EQUAL_INT(expect[2], _get_u32("c"));
+
+        /* the store stays usable */
+        _set_u32("b", 5);
+        TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+        TEST_ASSERT_EQUAL_INT(5, _get_u32("b"));
+        TEST_ASSERT_EQUAL_INT(expect[2], _get_u32("c"));
+    }
+    /* header and data of three records */
+    TEST_ASSERT(cut > 3 * 12);
+}
+
+static void test_kvstore_power_cut_activate(void)
+{
+    unsigned cut;
+
+    for (cut = 1; ; cut++) {
+        set_up();
+        _set_u32("s", 42);
+        /* the next record needs a new sector */
+        for (uint32_t i = 0; _kvs.offset + 16 <= _kvs.sector_size; i++) {
+            _set_u32("a", i);
+        }
+        uint32_t seq = _kvs.seq;
+
+        _dev.power_cut = cut;
+        uint32_t val = 1000;
+        int res = kvstore_set(&_kvs, "a", &val, sizeof(val));
+        if (_dev.power_cut) {
+            TEST_ASSERT_EQUAL_INT(0, res);
+            break;
+        }
+        TEST_ASSERT_EQUAL_INT(-EIO, res);
+
+        TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+        TEST_ASSERT_EQUAL_INT(42, _get_u32("s"));
+        /* a torn sequence number is not taken for a valid one */
+        TEST_ASSERT(_kvs.seq <= seq + 1);
+        for (unsigned i = 0; i < 3 * SECTORS; i++) {
+            _set_u32("b", i);
+            TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+            TEST_ASSERT_EQUAL_INT(i, _get_u32("b"));
+            TEST_ASSERT_EQUAL_INT(42, _get_u32("s"));
+        }
+    }
+    /* sequence number and its complement */
+    TEST_ASSERT(cut > 8);
+}
+
+static void test_kvstore_power_cut_compact(void)
+{
+    static const char *keys[] = { "k0", "k1", "k2", "k3" };
+    uint32_t val[] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+    uint32_t rnd = 1;
+    unsigned cuts = 0;
+
+    _kvs.dev = (mtd_dev_t *)&_small;
+    _small.power_cut = 0;
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_small.dev));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(&_small.dev, 0, SMALL_SECTORS * SMALL_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_format(&_kvs));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+
+    _set_u32("s0", 100);
+    _set_u32("s1", 101);
+    for (uint32_t i = 1; i < 600; i++) {
+        rnd = rnd * 1103515245 + 12345;
+        unsigned k = (rnd >> 8) % 4;
+        /* somewhere in the next writes or a compaction */
+        _small.power_cut = 1 + (rnd >> 16) % 400;
+        int res = kvstore_set(&_kvs, keys[k], &i, sizeof(i));
+        if (_small.power_cut) {
+            _small.power_cut = 0;
+            TEST_ASSERT_EQUAL_INT(0, res);
+            val[k] = i;
+            continue;
+        }
+        cuts++;
+        TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kvs));
+        if (_get_u32(keys[k]) == i) {
+            val[k] = i;
+        }
+        for (unsigned j = 0; j < 4; j++) {
+            TEST_ASSERT_EQUAL_INT(val[j], _get_u32(keys[j]));
+        }
+        TEST_ASSERT_EQUAL_INT(100, _get_u32("s0"));
+        TEST_ASSERT_EQUAL_INT(101, _get_u32("s1"));
+    }
+    TEST_ASSERT(cuts > 10);
+    TEST_ASSERT(_small_wear[0] + _small_wear[1] + _small_wear[2] > 3 * SMALL_SECTORS);
+}
+
+Test *tests_kvstore_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_kvstore_set_get),
+        new_TestFixture(test_kvstore_remount),
+        new_TestFixture(test_kvstore_commit),
+        new_TestFixture(test_kvstore_full),
+        new_TestFixture(test_kvstore_wear),
+        new_TestFixture(test_kvstore_power_cut),
+        new_TestFixture(test_kvstore_power_cut_activate),
+        new_TestFixture(test_kvstore_power_cut_compact),
+    };
+
+    EMB_UNIT_TESTCALLER(kvstore_tests, set_up, NULL, fixtures);
+
+    return (Test *)&kvstore_tests;
+}
+#endif /* MODULE_MTD_NATIVE */
+
+void tests_kvstore(void)
+{
+#ifdef MODULE_MTD_NATIVE
+    TESTS_RUN(tests_kvstore_tests());
+#endif
+}
+/** @} */
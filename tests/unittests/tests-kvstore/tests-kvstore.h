@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  unittests
+ * @{
+ *
+ * @file
+ * @brief       Unittests for the ``kvstore`` module
+ */
+#ifndef TESTS_KVSTORE_H
+#define TESTS_KVSTORE_H
+
+#include "embUnit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   The entry point of this test suite.
+ */
+void tests_kvstore(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TESTS_KVSTORE_H */
+/** @} */
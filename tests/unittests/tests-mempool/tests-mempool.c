@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "mempool.h"
+
+#define BLOCK_NUMOF (4U)
+
+typedef struct {
+    void *ptr;
+    unsigned val;
+} block_t;
+
+static block_t _blocks[BLOCK_NUMOF];
+static mempool_t _static_pool = MEMPOOL_INIT("test_static", _blocks);
+static mempool_t _empty_pool = {
+    .name = "test_empty",
+    .unused = (uint8_t *)_blocks,
+    .end = (uint8_t *)_blocks,
+    .block_size = sizeof(block_t),
+};
+static mempool_t _pool;
+
+static void set_up(void)
+{
+    mempool_init(&_pool, "test", _blocks, sizeof(_blocks[0]), BLOCK_NUMOF);
+}
+
+static void test_mempool_exhaust(void)
+{
+    block_t *b[BLOCK_NUMOF];
+
+    for (unsigned i = 0; i < BLOCK_NUMOF; i++) {
+        b[i] = mempool_alloc(&_pool);
+        TEST_ASSERT_NOT_NULL(b[i]);
+        TEST_ASSERT(mempool_contains(&_pool, b[i]));
+        for (unsigned j = 0; j < i; j++) {
+            TEST_ASSERT(b[i] != b[j]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, mempool_avail(&_pool));
+    TEST_ASSERT_NULL(mempool_alloc(&_pool));
+    TEST_ASSERT_NULL(mempool_alloc_irq(&_pool));
+    TEST_ASSERT_EQUAL_INT(2, _pool.failed);
+}
+
+static void test_mempool_reuse(void)
+{
+    block_t *a = mempool_alloc(&_pool);
+    block_t *b = mempool_alloc(&_pool);
+
+    mempool_free(&_pool, a);
+    mempool_free(&_pool, NULL);
+    TEST_ASSERT_EQUAL_INT(BLOCK_NUMOF - 1, mempool_avail(&_pool));
+    /* released blocks are handed out again first */
+    TEST_ASSERT(mempool_alloc(&_pool) == a);
+    mempool_free_irq(&_pool, b);
+    mempool_free(&_pool, a);
+    TEST_ASSERT_EQUAL_INT(BLOCK_NUMOF, mempool_avail(&_pool));
+    TEST_ASSERT_EQUAL_INT(2, _pool.high_water);
+    TEST_ASSERT_EQUAL_INT(0, _pool.failed);
+}
+
+static void test_mempool_static(void)
+{
+    TEST_ASSERT_EQUAL_INT(BLOCK_NUMOF, mempool_avail(&_static_pool));
+    TEST_ASSERT_EQUAL_INT(sizeof(block_t), _static_pool.block_size);
+    block_t *a = mempool_alloc(&_static_pool);
+    TEST_ASSERT(a == &_blocks[0]);
+    mempool_free(&_static_pool, a);
+    TEST_ASSERT_EQUAL_INT(1, _static_pool.high_water);
+}
+
+static void test_mempool_listed_on_failure(void)
+{
+    /* a pool that never hands out a block still shows up in ps */
+    TEST_ASSERT(!_empty_pool.listed);
+    TEST_ASSERT_NULL(mempool_alloc(&_empty_pool));
+    TEST_ASSERT(_empty_pool.listed);
+    TEST_ASSERT_EQUAL_INT(1, _empty_pool.failed);
+}
+
+Test *tests_mempool_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mempool_exhaust),
+        new_TestFixture(test_mempool_reuse),
+        new_TestFixture(test_mempool_static),
+        new_TestFixture(test_mempool_listed_on_failure),
+    };
+
+    EMB_UNIT_TESTCALLER(mempool_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mempool_tests;
+}
+
+void tests_mempool(void)
+{
+    TESTS_RUN(tests_mempool_tests());
+}
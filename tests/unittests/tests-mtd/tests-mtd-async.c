@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "mtd.h"
+#include "thread.h"
+#include "tests-mtd.h"
+
+#ifdef MODULE_MTD_ASYNC
+
+#define SECTOR_COUNT    (2U)
+#define PAGES_PER_SECTOR (4U)
+#define PAGE_SIZE       (32U)
+#define SECTOR_SIZE     (PAGES_PER_SECTOR * PAGE_SIZE)
+#define BUSY_US         (100U)
+
+/* RAM backed NOR flash, busy for a while after each program and erase */
+static uint8_t _flash[SECTOR_COUNT * SECTOR_SIZE];
+static unsigned _programs, _erases, _busy, _polls;
+
+static int _flash_read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    if (addr + size > sizeof(_flash)) {
+        return -EOVERFLOW;
+    }
+    memcpy(buff, _flash + addr, size);
+    return size;
+}
+
+static int _flash_write(mtd_dev_t *dev, const void *buff, uint32_t addr,
+                        uint32_t size)
+{
+    const uint8_t *src = buff;
+
+    (void)dev;
+    if ((addr + size > sizeof(_flash)) ||
+        ((addr % PAGE_SIZE) + size > PAGE_SIZE)) {
+        return -EOVERFLOW;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        _flash[addr + i] &= src[i];
+    }
+    _programs++;
+    return size;
+}
+
+static int _flash_erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    if ((addr + size > sizeof(_flash)) || (addr % SECTOR_SIZE) ||
+        (size % SECTOR_SIZE)) {
+        return -EOVERFLOW;
+    }
+    memset(_flash + addr, 0xff, size);
+    _erases += size / SECTOR_SIZE;
+    return 0;
+}
+
+static int _flash_async(mtd_dev_t *dev, mtd_req_t *req)
+{
+    int res = 0;
+
+    if (_busy) {
+        _busy--;
+        _polls++;
+        return BUSY_US;
+    }
+    if (req->pos == req->count) {
+        return 0;
+    }
+    switch (req->op) {
+        case MTD_REQ_READ:
+            res = _flash_read(dev, (uint8_t *)req->buf + req->pos,
+                              req->addr + req->pos, req->count - req->pos);
+            break;
+        case MTD_REQ_WRITE: {
+            uint32_t addr = req->addr + req->pos;
+            uint32_t size = req->count - req->pos;
+            if (size > PAGE_SIZE - (addr % PAGE_SIZE)) {
+                size = PAGE_SIZE - (addr % PAGE_SIZE);
+            }
+            res = _flash_write(dev, (uint8_t *)req->buf + req->pos, addr, size);
+            break;
+        }
+        case MTD_REQ_ERASE:
+            if (req->addr + req->count > sizeof(_flash)) {
+                return -EOVERFLOW;
+            }
+            res = _flash_erase(dev, req->addr + req->pos, SECTOR_SIZE);
+            if (res == 0) {
+                res = SECTOR_SIZE;
+            }
+            break;
+    }
+    if (res < 0) {
+        return res;
+    }
+    req->pos += res;
+    if (req->op == MTD_REQ_READ) {
+        return 0;
+    }
+    _busy = 2;
+    return BUSY_US;
+}
+
+static const mtd_desc_t _blocking_driver = {
+    .read = _flash_read,
+    .write = _flash_write,
+    .erase = _flash_erase,
+};
+
+static const mtd_desc_t _async_driver = {
+    .read = _flash_read,
+    .write = _flash_write,
+    .erase = _flash_erase,
+    .async = _flash_async,
+};
+
+static mtd_dev_t _dev = {
+    .sector_count = SECTOR_COUNT,
+    .pages_per_sector = PAGES_PER_SECTOR,
+    .page_size = PAGE_SIZE,
+};
+
+static char _stack[THREAD_STACKSIZE_DEFAULT];
+static kernel_pid_t _worker = KERNEL_PID_UNDEF;
+
+static unsigned _completed, _cb_errors;
+static mtd_req_t *_reqs;
+
+/* runs in the worker thread, the test thread checks _cb_errors */
+static void _cb(mtd_req_t *req, void *arg)
+{
+    /* in order of submission */
+    if ((arg != &_completed) || (req != &_reqs[_completed])) {
+        _cb_errors++;
+    }
+    _completed++;
+}
+
+static void set_up(void)
+{
+    if (_worker == KERNEL_PID_UNDEF) {
+        _worker = mtd_async_init(_stack, sizeof(_stack), THREAD_PRIORITY_MAIN - 1);
+    }
+    memset(_flash, 0, sizeof(_flash));
+    _programs = 0;
+    _erases = 0;
+    _busy = 0;
+    _polls = 0;
+    _completed = 0;
+    _cb_errors = 0;
+}
+
+static void _erase_write_read(void)
+{
+    uint8_t data[PAGE_SIZE + 8];
+    uint8_t buf[sizeof(data)];
+    mtd_req_t reqs[] = {
+        { .mtd = &_dev, .op = MTD_REQ_ERASE, .count = SECTOR_COUNT * SECTOR_SIZE },
+        /* spans two pages */
+        { .mtd = &_dev, .op = MTD_REQ_WRITE, .addr = PAGE_SIZE - 4,
+          .buf = data, .count = sizeof(data) },
+        { .mtd = &_dev, .op = MTD_REQ_READ, .addr = PAGE_SIZE - 4,
+          .buf = buf, .count = sizeof(buf) },
+        /* out of range */
+        { .mtd = &_dev, .op = MTD_REQ_ERASE, .addr = SECTOR_SIZE,
+          .count = SECTOR_COUNT * SECTOR_SIZE },
+    };
+
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+    _reqs = reqs;
+    for (unsigned i = 0; i < 4; i++) {
+        reqs[i].cb = _cb;
+        reqs[i].arg = &_completed;
+        mtd_submit(&reqs[i]);
+    }
+
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_wait(&reqs[3]));
+    TEST_ASSERT_EQUAL_INT(4, _completed);
+    TEST_ASSERT_EQUAL_INT(0, _cb_errors);
+    TEST_ASSERT_EQUAL_INT(0, mtd_wait(&reqs[0]));
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_wait(&reqs[1]));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_wait(&reqs[2]));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(data, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0xff, _flash[PAGE_SIZE - 5]);
+    TEST_ASSERT_EQUAL_INT(3, _programs);
+    TEST_ASSERT_EQUAL_INT(SECTOR_COUNT, _erases);
+}
+
+static void test_mtd_async_blocking(void)
+{
+    _dev.driver = &_blocking_driver;
+    _erase_write_read();
+    TEST_ASSERT_EQUAL_INT(0, _polls);
+}
+
+static void test_mtd_async_driver(void)
+{
+    _dev.driver = &_async_driver;
+    _erase_write_read();
+    /* two polls after each program and sector erase */
+    TEST_ASSERT_EQUAL_INT(2 * (3 + SECTOR_COUNT), _polls);
+}
+
+#ifdef MODULE_CORE_THREAD_FLAGS
+static void test_mtd_async_thread_flags(void)
+{
+    uint8_t buf[4];
+    mtd_req_t req = {
+        .mtd = &_dev,
+        .op = MTD_REQ_READ,
+        .buf = buf,
+        .count = sizeof(buf),
+        .thread = (thread_t *)sched_active_thread,
+        .flags = 0x1,
+    };
+
+    _dev.driver = &_async_driver;
+    memset(_flash, 0xa5, sizeof(buf));
+    mtd_submit(&req);
+    TEST_ASSERT_EQUAL_INT(0x1, thread_flags_wait_any(0x1));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), req.res);
+    TEST_ASSERT_EQUAL_INT(0xa5, buf[3]);
+}
+#endif
+
+Test *tests_mtd_async_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_async_blocking),
+        new_TestFixture(test_mtd_async_driver),
+#ifdef MODULE_CORE_THREAD_FLAGS
+        new_TestFixture(test_mtd_async_thread_flags),
+#endif
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_async_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mtd_async_tests;
+}
+
+#endif /* MODULE_MTD_ASYNC */
+/** @} */
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "board.h"
+#include "mtd.h"
+#include "mtd_cache.h"
+#include "tests-mtd.h"
+
+#ifdef MODULE_MTD_NATIVE
+#include "mtd_native.h"
+#include "xtimer.h"
+#endif
+
+#define SECTOR_COUNT    (8U)
+#define PAGES_PER_SECTOR (4U)
+#define PAGE_SIZE       (64U)
+#define SECTOR_SIZE     (PAGES_PER_SECTOR * PAGE_SIZE)
+#define LINES           (4U)
+
+/* RAM backed NOR flash counting the operations reaching it */
+static uint8_t _flash[SECTOR_COUNT * SECTOR_SIZE];
+static unsigned _reads, _writes, _erases;
+
+static int _flash_init(mtd_dev_t *dev)
+{
+    (void)dev;
+    memset(_flash, 0xff, sizeof(_flash));
+    return 0;
+}
+
+static int _flash_read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    if (addr + size > sizeof(_flash)) {
+        return -EOVERFLOW;
+    }
+    memcpy(buff, _flash + addr, size);
+    _reads++;
+    return size;
+}
+
+static int _flash_write(mtd_dev_t *dev, const void *buff, uint32_t addr,
+                        uint32_t size)
+{
+    (void)dev;
+    if (addr + size > sizeof(_flash)) {
+        return -EOVERFLOW;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        _flash[addr + i] &= ((const uint8_t *)buff)[i];
+    }
+    _writes++;
+    return size;
+}
+
+static int _flash_erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    memset(_flash + addr, 0xff, size);
+    _erases++;
+    return 0;
+}
+
+static const mtd_desc_t _flash_driver = {
+    .init = _flash_init,
+    .read = _flash_read,
+    .write = _flash_write,
+    .erase = _flash_erase,
+};
+
+static mtd_dev_t _flash_dev = {
+    .driver = &_flash_driver,
+    .sector_count = SECTOR_COUNT,
+    .pages_per_sector = PAGES_PER_SECTOR,
+    .page_size = PAGE_SIZE,
+};
+
+static mtd_cache_line_t _lines[LINES];
+static uint8_t _data[LINES * PAGE_SIZE];
+static mtd_cache_t _cache = {
+    .base = { .driver = &mtd_cache_driver },
+    .parent = &_flash_dev,
+    .lines = _lines,
+    .data = _data,
+    .nlines = LINES,
+};
+static mtd_dev_t *cache = &_cache.base;
+
+static void set_up(void)
+{
+    _cache.readahead = 0;
+    mtd_init(cache);
+    _reads = 0;
+    _writes = 0;
+    _erases = 0;
+}
+
+static void test_mtd_cache_init(void)
+{
+    TEST_ASSERT_EQUAL_INT(SECTOR_COUNT, cache->sector_count);
+    TEST_ASSERT_EQUAL_INT(PAGES_PER_SECTOR, cache->pages_per_sector);
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, cache->page_size);
+}
+
+static void test_mtd_cache_write_back(void)
+{
+    const uint8_t a[] = { 0xf0, 0x0f, 0x55 };
+    const uint8_t b[] = { 0x3c, 0x3c, 0xff };
+    const uint8_t expected[] = { 0x30, 0x0c, 0x55 };
+    uint8_t buf[sizeof(a)];
+
+    TEST_ASSERT_EQUAL_INT(sizeof(a), mtd_write(cache, a, 10, sizeof(a)));
+    TEST_ASSERT_EQUAL_INT(sizeof(b), mtd_write(cache, b, 10, sizeof(b)));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(cache, buf, 10, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected, buf, sizeof(buf)));
+    /* one page loaded, nothing written yet */
+    TEST_ASSERT_EQUAL_INT(1, _reads);
+    TEST_ASSERT_EQUAL_INT(0, _writes);
+    TEST_ASSERT_EQUAL_INT(0xff, _flash[10]);
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_sync(cache));
+    TEST_ASSERT_EQUAL_INT(1, _writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(expected, _flash + 10, sizeof(expected)));
+    TEST_ASSERT_EQUAL_INT(0, mtd_sync(cache));
+    TEST_ASSERT_EQUAL_INT(1, _writes);
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.writebacks);
+}
+
+static void test_mtd_cache_lru(void)
+{
+    uint8_t buf[4];
+    const uint8_t zero[1] = { 0 };
+
+    /* fill all lines, page 0 dirty */
+    TEST_ASSERT_EQUAL_INT(1, mtd_write(cache, zero, 0, 1));
+    for (unsigned page = 1; page < LINES; page++) {
+        TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(cache, buf, page * PAGE_SIZE,
+                                                    sizeof(buf)));
+    }
+    /* touch page 0 and 1 again, page 2 is now least recently used */
+    mtd_read(cache, buf, 0, sizeof(buf));
+    mtd_read(cache, buf, PAGE_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(LINES, _cache.stats.misses);
+    TEST_ASSERT_EQUAL_INT(2, _cache.stats.hits);
+
+    mtd_read(cache, buf, LINES * PAGE_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(LINES + 1, _reads);
+    mtd_read(cache, buf, 0, sizeof(buf));
+    mtd_read(cache, buf, 3 * PAGE_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(LINES + 1, _reads);
+    mtd_read(cache, buf, 2 * PAGE_SIZE, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(LINES + 2, _reads);
+    /* the dirty page survived, nothing was written back */
+    TEST_ASSERT_EQUAL_INT(0, _writes);
+
+    /* evicting the dirty page writes it back */
+    for (unsigned page = 5; page < 5 + LINES; page++) {
+        mtd_read(cache, buf, page * PAGE_SIZE, sizeof(buf));
+    }
+    TEST_ASSERT_EQUAL_INT(1, _writes);
+    TEST_ASSERT_EQUAL_INT(0, _flash[0]);
+}
+
+static void test_mtd_cache_readahead(void)
+{
+    uint8_t buf[16];
+
+    _cache.readahead = 2;
+    for (uint32_t addr = 0; addr < 6 * PAGE_SIZE; addr += sizeof(buf)) {
+        TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(cache, buf, addr, sizeof(buf)));
+    }
+    /* page 0 alone, then pages 1-3 and 4-6 with one read each */
+    TEST_ASSERT_EQUAL_INT(3, _reads);
+    TEST_ASSERT_EQUAL_INT(4, _cache.stats.prefetched);
+}
+
+static void test_mtd_cache_bypass(void)
+{
+    uint8_t buf[3 * PAGE_SIZE];
+    const uint8_t zero[1] = { 0 };
+
+    /* dirty cached page in the middle of the range */
+    TEST_ASSERT_EQUAL_INT(1, mtd_write(cache, zero, 3 * PAGE_SIZE, 1));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(cache, buf, PAGE_SIZE, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(2, _cache.stats.bypassed);
+    TEST_ASSERT_EQUAL_INT(0, buf[2 * PAGE_SIZE]);
+    TEST_ASSERT_EQUAL_INT(0xff, buf[2 * PAGE_SIZE - 1]);
+}
+
+static void test_mtd_cache_erase(void)
+{
+    const uint8_t zero[4] = { 0 };
+    uint8_t buf[4];
+
+    TEST_ASSERT_EQUAL_INT(sizeof(zero), mtd_write(cache, zero, SECTOR_SIZE,
+                                                  sizeof(zero)));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(cache, PAGE_SIZE, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_write(cache, zero, SECTOR_SIZE - 2,
+                                                sizeof(zero)));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(cache, SECTOR_SIZE, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(cache, buf, SECTOR_SIZE, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0xff, buf[0]);
+    TEST_ASSERT_EQUAL_INT(0, mtd_sync(cache));
+    TEST_ASSERT_EQUAL_INT(0, _writes);
+    TEST_ASSERT_EQUAL_INT(1, _erases);
+}
+
+#ifdef MODULE_MTD_NATIVE
+#define BENCH_OPS       (2000U)
+#define BENCH_HOT_PAGES (8U)
+#define BENCH_LINES     (16U)
+#define BENCH_PAGE_SIZE (256U)
+
+static mtd_cache_line_t _bench_lines[BENCH_LINES];
+static uint8_t _bench_data[BENCH_LINES * BENCH_PAGE_SIZE];
+static mtd_cache_t _bench_cache = {
+    .base = { .driver = &mtd_cache_driver },
+    .lines = _bench_lines,
+    .data = _bench_data,
+    .nlines = BENCH_LINES,
+    .readahead = 3,
+};
+
+/* small reads of a few hot pages and appends to a log, like SPIFFS does */
+static uint32_t _bench_run(mtd_dev_t *dev)
+{
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+    uint32_t log = 2 * sector_size;
+    uint32_t rnd = 1;
+    uint8_t buf[16];
+
+    mtd_erase(dev, log, 2 * sector_size);
+    uint32_t start = xtimer_now_usec();
+    for (unsigned i = 0; i < BENCH_OPS; i++) {
+        rnd = rnd * 1103515245 + 12345;
+        if ((rnd >> 16) % 8 == 0) {
+            /* a log entry must not cross a sector */
+            if ((log % sector_size) + sizeof(buf) > sector_size) {
+                log += sector_size - (log % sector_size);
+            }
+            memset(buf, i, sizeof(buf));
+            mtd_write(dev, buf, log, sizeof(buf));
+            log += sizeof(buf);
+        }
+        else {
+            uint32_t addr = (rnd >> 8) % (BENCH_HOT_PAGES * dev->page_size);
+            mtd_read(dev, buf, addr & ~(sizeof(buf) - 1), sizeof(buf));
+        }
+    }
+    mtd_sync(dev);
+    return xtimer_now_usec() - start;
+}
+
+static void test_mtd_cache_bench(void)
+{
+    static const mtd_native_timing_t timing = {
+        .read_us = 20,
+        .write_us = 100,
+    };
+    mtd_native_dev_t *native = (mtd_native_dev_t *)MTD_0;
+    mtd_dev_t *dev = &_bench_cache.base;
+
+    TEST_ASSERT(MTD_0->page_size <= BENCH_PAGE_SIZE);
+    _bench_cache.parent = MTD_0;
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(dev));
+    native->timing = &timing;
+
+    mtd_native_stats_t before = native->stats;
+    uint32_t direct = _bench_run(MTD_0);
+    unsigned direct_ops = (native->stats.reads - before.reads) +
+                          (native->stats.writes - before.writes);
+
+    before = native->stats;
+    uint32_t cached = _bench_run(dev);
+    unsigned cached_ops = (native->stats.reads - before.reads) +
+                          (native->stats.writes - before.writes);
+    native->timing = NULL;
+
+    const mtd_cache_stats_t *s = &_bench_cache.stats;
+    printf("\nmtd direct: %4u device ops, %7lu us", direct_ops,
+           (unsigned long)direct);
+    printf("\nmtd cache:  %4u device ops, %7lu us, %lu%% hits, "
+           "%lu prefetched, %lu written back", cached_ops,
+           (unsigned long)cached,
+           (unsigned long)((100 * s->hits) / (s->hits + s->misses)),
+           (unsigned long)s->prefetched, (unsigned long)s->writebacks);
+    TEST_ASSERT(cached_ops < direct_ops);
+}
+#endif
+
+Test *tests_mtd_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_cache_init),
+        new_TestFixture(test_mtd_cache_write_back),
+        new_TestFixture(test_mtd_cache_lru),
+        new_TestFixture(test_mtd_cache_readahead),
+        new_TestFixture(test_mtd_cache_bypass),
+        new_TestFixture(test_mtd_cache_erase),
+#ifdef MODULE_MTD_NATIVE
+        new_TestFixture(test_mtd_cache_bench),
+#endif
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_cache_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mtd_cache_tests;
+}
+/** @} */
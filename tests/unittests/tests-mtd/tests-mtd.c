@@ -18,6 +18,11 @@
 
 #include "mtd.h"
 #include "board.h"
+#include "tests-mtd.h"
+
+#ifdef MODULE_MTD_NATIVE
+#include "mtd_native.h"
+#endif
 
 #if MODULE_VFS
 #include <fcntl.h>
@@ -239,6 +244,72 @@ static void test_mtd_write_read_flash(void)
 }
 #endif
 
+#ifdef MODULE_MTD_NATIVE
+static void test_mtd_native_wear(void)
+{
+    mtd_native_dev_t *ndev = (mtd_native_dev_t *)dev;
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+    uint32_t wear[2] = { 0 };
+    mtd_native_stats_t before = ndev->stats;
+    uint8_t buf[3] = { 0x12, 0x34, 0x56 };
+
+    /* only sector 1 is erased while the counters are attached */
+    ndev->wear = wear;
+    ndev->erase_limit = 2;
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, sector_size, sector_size));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, sector_size, sector_size));
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_erase(dev, sector_size, sector_size));
+    ndev->wear = NULL;
+    ndev->erase_limit = 0;
+    TEST_ASSERT_EQUAL_INT(0, wear[0]);
+    TEST_ASSERT_EQUAL_INT(2, wear[1]);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_write(dev, buf, sector_size, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, sector_size, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(before.erases + 2, ndev->stats.erases);
+    TEST_ASSERT_EQUAL_INT(before.writes + 1, ndev->stats.writes);
+    TEST_ASSERT_EQUAL_INT(before.reads + 1, ndev->stats.reads);
+    TEST_ASSERT(ndev->stats.write_bytes == before.write_bytes + sizeof(buf));
+
+    /* nothing to copy, no buffer needed */
+    TEST_ASSERT_EQUAL_INT(0, mtd_read(dev, NULL, sector_size, 0));
+    TEST_ASSERT_EQUAL_INT(before.reads + 1, ndev->stats.reads);
+}
+
+static void test_mtd_native_power_cut(void)
+{
+    mtd_native_dev_t *ndev = (mtd_native_dev_t *)dev;
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+    const uint8_t buf[4] = { 0x12, 0x34, 0x56, 0x78 };
+    uint8_t buf_read[4];
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, 0, sector_size));
+
+    /* power fails at the third byte of the second write */
+    ndev->power_cut = 7;
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_write(dev, buf, 0, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_write(dev, buf, sizeof(buf), sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_read(dev, buf_read, 0, sizeof(buf_read)));
+    TEST_ASSERT_EQUAL_INT(0, ndev->power_cut);
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(dev));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read),
+                          mtd_read(dev, buf_read, sizeof(buf), sizeof(buf_read)));
+    TEST_ASSERT_EQUAL_INT(0x12, buf_read[0]);
+    TEST_ASSERT_EQUAL_INT(0x34, buf_read[1]);
+    TEST_ASSERT_EQUAL_INT(0xff, buf_read[2]);
+    TEST_ASSERT_EQUAL_INT(0xff, buf_read[3]);
+
+    /* and in the middle of an erase */
+    ndev->power_cut = 3;
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_erase(dev, 0, sector_size));
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(dev));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf_read), mtd_read(dev, buf_read, 0, sizeof(buf_read)));
+    TEST_ASSERT_EQUAL_INT(0xff, buf_read[1]);
+    TEST_ASSERT_EQUAL_INT(0x56, buf_read[2]);
+}
+#endif
+
 #if MODULE_VFS
 static void test_mtd_vfs(void)
 {
@@ -278,6 +349,10 @@ Test *tests_mtd_tests(void)
 #ifdef MTD_0
         new_TestFixture(test_mtd_write_read_flash),
 #endif
+#ifdef MODULE_MTD_NATIVE
+        new_TestFixture(test_mtd_native_wear),
+        new_TestFixture(test_mtd_native_power_cut),
+#endif
 #if MODULE_VFS
         new_TestFixture(test_mtd_vfs),
 #endif
@@ -291,5 +366,9 @@ Test *tests_mtd_tests(void)
 void tests_mtd(void)
 {
     TESTS_RUN(tests_mtd_tests());
+    TESTS_RUN(tests_mtd_cache_tests());
+#ifdef MODULE_MTD_ASYNC
+    TESTS_RUN(tests_mtd_async_tests());
+#endif
 }
 /** @} */
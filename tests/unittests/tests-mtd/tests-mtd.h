@@ -29,6 +29,22 @@ extern "C" {
     */
 void tests_mtd(void);
 
+/**
+ * @brief   Generates tests for mtd_cache
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_mtd_cache_tests(void);
+
+#if defined(MODULE_MTD_ASYNC) || defined(DOXYGEN)
+/**
+ * @brief   Generates tests for mtd_async
+ *
+ * @return  embUnit tests if successful, NULL if not.
+ */
+Test *tests_mtd_async_tests(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
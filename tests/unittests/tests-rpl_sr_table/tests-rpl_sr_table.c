@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include "embUnit.h"
+
+#include "net/ipv6/addr.h"
+#include "net/ipv6/ext/rh.h"
+#include "net/ipv6/hdr.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/gnrc/rpl/sr_table.h"
+#include "xtimer.h"
+
+#include "tests-rpl_sr_table.h"
+
+#define NUMOF           (8U)
+#define BENCH_NODES     (500U)
+#define BENCH_ROUNDS    (20U)
+#define EXPIRES         (300U)
+
+static gnrc_rpl_sr_node_t _nodes[BENCH_NODES];
+static gnrc_rpl_sr_table_t _table;
+static uint8_t _buf[GNRC_RPL_SR_TABLE_SRH_MAX];
+static gnrc_rpl_srh_t *_srh = (gnrc_rpl_srh_t *)_buf;
+
+/* root is node 0, the others are 2001:db8::<id + 1> */
+static ipv6_addr_t _addr(unsigned id)
+{
+    ipv6_addr_t addr = {{ 0x20, 0x01, 0x0d, 0xb8 }};
+
+    addr.u8[14] = (id + 1) >> 8;
+    addr.u8[15] = (id + 1);
+    return addr;
+}
+
+static int _dao(unsigned target, unsigned parent, uint8_t seq, uint32_t expires)
+{
+    ipv6_addr_t t = _addr(target), p = _addr(parent);
+
+    return gnrc_rpl_sr_table_dao(&_table, &t, &p, seq, expires);
+}
+
+static int _route(unsigned dst, ipv6_addr_t *next_hop)
+{
+    ipv6_addr_t d = _addr(dst), tmp;
+
+    return gnrc_rpl_sr_table_route(&_table, &d, next_hop ? next_hop : &tmp,
+                                   _srh, sizeof(_buf));
+}
+
+/* forwards along the route to @p dst, compares the hops with @p path and
+ * returns the number of hops, 0 on mismatch */
+static unsigned _follow(unsigned dst, const unsigned *path)
+{
+    ipv6_hdr_t hdr;
+    ipv6_addr_t expected;
+    unsigned hops = 1;
+    int res = _route(dst, &hdr.dst);
+
+    if (res < 0) {
+        return 0;
+    }
+    expected = _addr(path[0]);
+    if (!ipv6_addr_equal(&hdr.dst, &expected)) {
+        return 0;
+    }
+    /* no header for children of the root */
+    while ((res > 0) && ((res = gnrc_rpl_srh_process(&hdr, _srh)) != EXT_RH_CODE_OK)) {
+        expected = _addr(path[hops++]);
+        if ((res != EXT_RH_CODE_FORWARD) || !ipv6_addr_equal(&hdr.dst, &expected)) {
+            return 0;
+        }
+        res = 1;
+    }
+    expected = _addr(dst);
+    return ipv6_addr_equal(&hdr.dst, &expected) ? hops : 0;
+}
+
+static void set_up(void)
+{
+    ipv6_addr_t root = _addr(0);
+
+    gnrc_rpl_sr_table_init(&_table, _nodes, NUMOF, &root);
+}
+
+static void test_rpl_sr_table_child(void)
+{
+    ipv6_addr_t next_hop, expected = _addr(1);
+
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _route(1, &next_hop));
+    TEST_ASSERT(ipv6_addr_equal(&next_hop, &expected));
+}
+
+static void test_rpl_sr_table_chain(void)
+{
+    static const unsigned path[] = { 1, 2, 3, 4 };
+
+    /* children report before their parents */
+    TEST_ASSERT_EQUAL_INT(0, _dao(4, 3, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(3, 2, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, _route(4, NULL));
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 1, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 0, EXPIRES));
+
+    /* three addresses of one octet each, padded to eight octets */
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, _route(4, NULL));
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_TYPE, _srh->type);
+    TEST_ASSERT_EQUAL_INT(0xff, _srh->compr);
+    TEST_ASSERT_EQUAL_INT(4, _follow(4, path));
+    TEST_ASSERT_EQUAL_INT(2, _follow(2, path));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, _route(5, NULL));
+}
+
+static void test_rpl_sr_table_compression(void)
+{
+    static const unsigned path[] = { 1, 2 };
+    ipv6_addr_t root = _addr(0), t = _addr(2), p = _addr(1);
+    ipv6_addr_t next_hop;
+
+    /* different prefix of the destination */
+    t.u8[7] = 1;
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_dao(&_table, &t, &p, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 16,
+                          gnrc_rpl_sr_table_route(&_table, &t, &next_hop, _srh,
+                                                  sizeof(_buf)));
+    TEST_ASSERT_EQUAL_INT((15 << 4) | 7, _srh->compr);
+    TEST_ASSERT_EQUAL_INT(7 << 4, _srh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&t.u8[7], _srh + 1, 9));
+
+    /* too small for the header */
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          gnrc_rpl_sr_table_route(&_table, &t, &next_hop, _srh, 16));
+
+    /* a single route with the common prefix */
+    gnrc_rpl_sr_table_init(&_table, _nodes, NUMOF, &root);
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 1, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(2, _follow(2, path));
+    TEST_ASSERT_EQUAL_INT(1, _srh->len);
+}
+
+static void test_rpl_sr_table_loop(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 2, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 1, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(-ELOOP, _route(1, NULL));
+    /* resolved by a newer DAO */
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 0, 1, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, _route(1, NULL));
+}
+
+static void test_rpl_sr_table_path_seq(void)
+{
+    static const unsigned path[] = { 1, 3 };
+
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(3, 1, 5, EXPIRES));
+    /* outdated */
+    TEST_ASSERT_EQUAL_INT(0, _dao(3, 2, 4, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(2, _follow(3, path));
+    /* same sequence refreshes */
+    TEST_ASSERT_EQUAL_INT(0, _dao(3, 1, 5, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(2, _follow(3, path));
+}
+
+static void test_rpl_sr_table_expire(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 1, 0, 2 * EXPIRES));
+    TEST_ASSERT_EQUAL_INT(EXPIRES, gnrc_rpl_sr_table_update(&_table, EXPIRES - 1));
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, _route(2, NULL));
+    TEST_ASSERT_EQUAL_INT(2 * EXPIRES, gnrc_rpl_sr_table_update(&_table, EXPIRES));
+    /* node 1 is kept as parent of node 2 */
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, _route(2, NULL));
+    TEST_ASSERT_EQUAL_INT(0, _dao(1, 0, 1, 2 * EXPIRES));
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, _route(2, NULL));
+
+    /* No-Path */
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 0, 1, 0));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, _route(2, NULL));
+    TEST_ASSERT_EQUAL_INT(0, _dao(2, 1, 2, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, _route(2, NULL));
+}
+
+static void test_rpl_sr_table_full(void)
+{
+    for (unsigned i = 1; i <= NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(0, _dao(i, 0, 0, EXPIRES));
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, _dao(NUMOF + 1, 0, 0, EXPIRES));
+    /* a No-Path frees its node with the next cleanup */
+    TEST_ASSERT_EQUAL_INT(0, _dao(NUMOF, 0, 0, 0));
+    TEST_ASSERT_EQUAL_INT(0, _dao(NUMOF + 1, 0, 0, EXPIRES));
+    TEST_ASSERT_EQUAL_INT(0, _route(NUMOF + 1, NULL));
+    TEST_ASSERT_EQUAL_INT(-EHOSTUNREACH, _route(NUMOF, NULL));
+    /* all nodes expire */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_sr_table_update(&_table, EXPIRES));
+    for (unsigned i = 1; i <= NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(0, _dao(NUMOF + i, 0, 0, EXPIRES));
+    }
+}
+
+static uint32_t _rand(void)
+{
+    static uint32_t state = 12345;
+
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+/* random tree with BENCH_NODES nodes besides the root, every node reports
+ * its parent in random order */
+static void test_rpl_sr_table_bench(void)
+{
+    static unsigned parents[BENCH_NODES + 1], depths[BENCH_NODES + 1];
+    static unsigned order[BENCH_NODES];
+    unsigned path[GNRC_RPL_SR_TABLE_DEPTH_MAX];
+    ipv6_addr_t root = _addr(0), next_hop;
+    unsigned hops = 0;
+
+    gnrc_rpl_sr_table_init(&_table, _nodes, BENCH_NODES, &root);
+    depths[0] = 0;
+    for (unsigned i = 1; i <= BENCH_NODES; i++) {
+        unsigned p = _rand() % i;
+
+        if (depths[p] == GNRC_RPL_SR_TABLE_DEPTH_MAX) {
+            p = 0;
+        }
+        parents[i] = p;
+        depths[i] = depths[p] + 1;
+        order[i - 1] = i;
+    }
+    for (unsigned i = BENCH_NODES - 1; i > 0; i--) {
+        unsigned j = _rand() % (i + 1), tmp = order[i];
+
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+#ifdef MODULE_XTIMER
+    uint32_t start = xtimer_now_usec();
+#endif
+    for (unsigned i = 0; i < BENCH_NODES; i++) {
+        TEST_ASSERT_EQUAL_INT(0, _dao(order[i], parents[order[i]], 0, EXPIRES));
+    }
+#ifdef MODULE_XTIMER
+    uint32_t dao_usec = xtimer_now_usec() - start;
+    start = xtimer_now_usec();
+#endif
+    for (unsigned round = 0; round < BENCH_ROUNDS; round++) {
+        for (unsigned i = 1; i <= BENCH_NODES; i++) {
+            TEST_ASSERT(_route(i, &next_hop) >= 0);
+        }
+    }
+#ifdef MODULE_XTIMER
+    uint32_t route_usec = xtimer_now_usec() - start;
+#endif
+
+    for (unsigned i = 1; i <= BENCH_NODES; i++) {
+        unsigned id = i;
+
+        for (unsigned j = depths[i]; j-- > 0;) {
+            path[j] = id;
+            id = parents[id];
+        }
+        TEST_ASSERT_EQUAL_INT(depths[i], _follow(i, path));
+        hops += depths[i];
+    }
+
+#ifdef MODULE_XTIMER
+    printf("\nrpl sr table: %u nodes, %u hops average: %u DAOs %lu us, "
+           "%u routes %lu us\n", BENCH_NODES, hops / BENCH_NODES, BENCH_NODES,
+           (unsigned long)dao_usec, BENCH_NODES * BENCH_ROUNDS,
+           (unsigned long)route_usec);
+#else
+    (void)hops;
+#endif
+}
+
+Test *tests_rpl_sr_table_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_rpl_sr_table_child),
+        new_TestFixture(test_rpl_sr_table_chain),
+        new_TestFixture(test_rpl_sr_table_compression),
+        new_TestFixture(test_rpl_sr_table_loop),
+        new_TestFixture(test_rpl_sr_table_path_seq),
+        new_TestFixture(test_rpl_sr_table_expire),
+        new_TestFixture(test_rpl_sr_table_full),
+        new_TestFixture(test_rpl_sr_table_bench),
+    };
+
+    EMB_UNIT_TESTCALLER(rpl_sr_table_tests, set_up, NULL, fixtures);
+
+    return (Test *)&rpl_sr_table_tests;
+}
+
+void tests_rpl_sr_table(void)
+{
+    TESTS_RUN(tests_rpl_sr_table_tests());
+}
+/** @} */
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "tsdb.h"
+#include "tests-tsdb.h"
+
+#ifdef MODULE_MTD_NATIVE
+#include "mtd_native.h"
+
+#define SECTORS         (8U)
+#define PAGE_SIZE       (64U)
+#define SECTOR_SIZE     (4U * PAGE_SIZE)
+
+static mtd_native_dev_t _dev = {
+    .dev = {
+        .driver = &native_flash_driver,
+        .sector_count = SECTORS,
+        .pages_per_sector = SECTOR_SIZE / PAGE_SIZE,
+        .page_size = PAGE_SIZE,
+    },
+    .fname = "tsdb_test.bin",
+};
+
+static uint8_t _page[PAGE_SIZE];
+
+static tsdb_t _db = {
+    .dev = (mtd_dev_t *)&_dev,
+    .page = _page,
+};
+
+static void set_up(void)
+{
+    _dev.power_cut = 0;
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(&_dev.dev, 0, SECTORS * SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_init(&_db));
+    TEST_ASSERT_EQUAL_INT(0, _db.used);
+}
+
+/* slowly changing temperature, sample i at time 10 * i */
+static void _expect(tsdb_sample_t *sample, uint32_t i)
+{
+    memset(sample, 0, sizeof(*sample));
+    sample->time = 10 * i;
+    sample->data.val[0] = (int16_t)((i / 3) % 100) - 50;
+    sample->data.unit = UNIT_TEMP_C;
+    sample->data.scale = -2;
+    sample->dim = 1;
+}
+
+static void _fill(uint32_t first, uint32_t n)
+{
+    tsdb_sample_t sample;
+
+    for (uint32_t i = first; i < first + n; i++) {
+        _expect(&sample, i);
+        TEST_ASSERT_EQUAL_INT(0, tsdb_append(&_db, sample.time, &sample.data,
+                                             sample.dim));
+    }
+}
+
+/* returns the number of samples, which must be consecutive */
+static unsigned _check(tsdb_iter_t *it, uint32_t *first, uint32_t *last)
+{
+    tsdb_sample_t sample, expect;
+    unsigned n = 0;
+
+    while (tsdb_iter_next(it, &sample) == 1) {
+        uint32_t i = sample.time / 10;
+        _expect(&expect, i);
+        if ((n && (i != *last + 1)) || (sample.time != expect.time) ||
+            (sample.dim != expect.dim) ||
+            memcmp(&sample.data, &expect.data, sizeof(expect.data))) {
+            return UINT_MAX;
+        }
+        if (!n) {
+            *first = i;
+        }
+        *last = i;
+        n++;
+    }
+    return n;
+}
+
+static void test_tsdb_append_iter(void)
+{
+    phydat_t acc = { .val = { -1000, 0, 981 }, .unit = UNIT_G, .scale = -3 };
+    tsdb_sample_t sample;
+    tsdb_iter_t it;
+    uint32_t first = 0, last = 0;
+
+    _fill(10, 10);
+    TEST_ASSERT_EQUAL_INT(0, tsdb_append(&_db, 200, &acc, 3));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, tsdb_append(&_db, 199, &acc, 3));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, tsdb_append(&_db, 200, &acc, 0));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, tsdb_append(&_db, 200, &acc, PHYDAT_DIM + 1));
+
+    /* still in the page buffer */
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, 199));
+    TEST_ASSERT_EQUAL_INT(10, _check(&it, &first, &last));
+    TEST_ASSERT_EQUAL_INT(10, first);
+    TEST_ASSERT_EQUAL_INT(19, last);
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 200, 200));
+    TEST_ASSERT_EQUAL_INT(1, tsdb_iter_next(&it, &sample));
+    TEST_ASSERT_EQUAL_INT(3, sample.dim);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&acc, &sample.data, sizeof(acc)));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_next(&it, &sample));
+
+    /* kept after flushing */
+    TEST_ASSERT_EQUAL_INT(0, tsdb_flush(&_db));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_append(&_db, 210, &acc, 2));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_init(&_db));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, 199));
+    TEST_ASSERT_EQUAL_INT(10, _check(&it, &first, &last));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 150, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(1, tsdb_iter_next(&it, &sample));
+    TEST_ASSERT_EQUAL_INT(150, sample.time);
+    /* the last sample was lost with the page buffer */
+    TEST_ASSERT_EQUAL_INT(200, _db.last.time);
+
+    TEST_ASSERT_EQUAL_INT(0, tsdb_clear(&_db));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_next(&it, &sample));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_init(&_db));
+    TEST_ASSERT_EQUAL_INT(0, _db.used);
+}
+
+static void test_tsdb_wrap(void)
+{
+    tsdb_iter_t it;
+    uint32_t first = 0, last = 0;
+
+    _fill(0, 2000);
+    TEST_ASSERT_EQUAL_INT(SECTORS, _db.used);
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+    unsigned n = _check(&it, &first, &last);
+    TEST_ASSERT_EQUAL_INT(1999, last);
+    TEST_ASSERT_EQUAL_INT(2000, first + n);
+    /* a sample takes three bytes */
+    TEST_ASSERT(n > (SECTORS - 1) * (SECTOR_SIZE - 12) / 3);
+
+    TEST_ASSERT_EQUAL_INT(0, tsdb_flush(&_db));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_init(&_db));
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(n, _check(&it, &first, &last));
+    TEST_ASSERT_EQUAL_INT(1999, last);
+
+    /* continues after init */
+    _fill(2000, 500);
+    TEST_ASSERT_EQUAL_INT(500, _check(&it, &first, &last));
+    TEST_ASSERT_EQUAL_INT(2499, last);
+}
+
+static void test_tsdb_range(void)
+{
+    tsdb_iter_t it;
+    uint32_t first = 0, last = 0;
+
+    _fill(0, 2000);
+    uint32_t reads = _dev.stats.reads;
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 10 * 1900 + 5, 10 * 1950));
+    /* a binary search over the sector headers */
+    TEST_ASSERT(_dev.stats.reads - reads <= 4);
+    TEST_ASSERT_EQUAL_INT(50, _check(&it, &first, &last));
+    TEST_ASSERT_EQUAL_INT(1901, first);
+    TEST_ASSERT_EQUAL_INT(1950, last);
+
+    /* before the oldest sample */
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, 5));
+    TEST_ASSERT_EQUAL_INT(0, _check(&it, &first, &last));
+}
+
+static void test_tsdb_range_same_time(void)
+{
+    phydat_t data = { .unit = UNIT_TEMP_C, .scale = -2 };
+    tsdb_sample_t sample;
+    tsdb_iter_t it;
+    unsigned n = 0;
+
+    _fill(0, 3);
+    for (unsigned i = 0; i < 200; i++) {
+        data.val[0] = i;
+        TEST_ASSERT_EQUAL_INT(0, tsdb_append(&_db, 50, &data, 1));
+    }
+    /* the samples at time 50 span sector boundaries */
+    TEST_ASSERT(_db.used > 2);
+
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 50, 50));
+    while (tsdb_iter_next(&it, &sample) == 1) {
+        TEST_ASSERT_EQUAL_INT(50, sample.time);
+        TEST_ASSERT_EQUAL_INT(n, sample.data.val[0]);
+        n++;
+    }
+    TEST_ASSERT_EQUAL_INT(200, n);
+}
+
+static void test_tsdb_iter_overwritten(void)
+{
+    tsdb_sample_t sample, oldest;
+    tsdb_iter_t it;
+
+    _fill(0, 100);
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(1, tsdb_iter_next(&it, &sample));
+    TEST_ASSERT_EQUAL_INT(0, sample.time);
+
+    _fill(100, 2000);
+    TEST_ASSERT_EQUAL_INT(1, tsdb_iter_next(&it, &sample));
+    tsdb_iter_t check;
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &check, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(1, tsdb_iter_next(&check, &oldest));
+    TEST_ASSERT(oldest.time > 10 * 100);
+    TEST_ASSERT_EQUAL_INT(oldest.time, sample.time);
+}
+
+static void test_tsdb_export_cbor(void)
+{
+    unsigned char buf[48];
+    cbor_stream_t stream;
+    tsdb_iter_t it;
+    unsigned total = 0;
+    int n;
+
+    _fill(0, 300);
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+
+    cbor_init(&stream, buf, 3);
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, tsdb_export_cbor(&it, &stream));
+    TEST_ASSERT_EQUAL_INT(0, stream.pos);
+
+    cbor_init(&stream, buf, sizeof(buf));
+    while ((n = tsdb_export_cbor(&it, &stream)) > 0) {
+        size_t offset = cbor_deserialize_array_indefinite(&stream, 0);
+        TEST_ASSERT(offset > 0);
+        for (int i = 0; i < n; i++) {
+            tsdb_sample_t expect;
+            uint64_t time;
+            size_t len;
+            int val;
+
+            _expect(&expect, total++);
+            offset += cbor_deserialize_array(&stream, offset, &len);
+            TEST_ASSERT_EQUAL_INT(4, len);
+            offset += cbor_deserialize_uint64_t(&stream, offset, &time);
+            TEST_ASSERT_EQUAL_INT(expect.time, time);
+            offset += cbor_deserialize_int(&stream, offset, &val);
+            TEST_ASSERT_EQUAL_INT(expect.data.unit, val);
+            offset += cbor_deserialize_int(&stream, offset, &val);
+            TEST_ASSERT_EQUAL_INT(expect.data.scale, val);
+            offset += cbor_deserialize_int(&stream, offset, &val);
+            TEST_ASSERT_EQUAL_INT(expect.data.val[0], val);
+        }
+        TEST_ASSERT(cbor_at_break(&stream, offset));
+        TEST_ASSERT_EQUAL_INT(offset + 1, stream.pos);
+        cbor_clear(&stream);
+    }
+    TEST_ASSERT_EQUAL_INT(0, n);
+    TEST_ASSERT_EQUAL_INT(300, total);
+}
+
+/* values beyond the dimension of a sample must not leak into the next one */
+static void test_tsdb_mixed_dim(void)
+{
+    phydat_t data[] = {
+        { .val = { 1, 2, 3 }, .unit = UNIT_G, .scale = -3 },
+        { .val = { 5, 4, 6 }, .unit = UNIT_G, .scale = -3 },
+        { .val = { 6, 2, 3 }, .unit = UNIT_G, .scale = -3 },
+    };
+    uint8_t dim[] = { 3, 1, 3 };
+    tsdb_sample_t sample;
+    tsdb_iter_t it;
+
+    for (unsigned i = 0; i < sizeof(dim); i++) {
+        TEST_ASSERT_EQUAL_INT(0, tsdb_append(&_db, 10 * i, &data[i], dim[i]));
+    }
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+    for (unsigned i = 0; i < sizeof(dim); i++) {
+        TEST_ASSERT_EQUAL_INT(1, tsdb_iter_next(&it, &sample));
+        TEST_ASSERT_EQUAL_INT(10 * i, sample.time);
+        TEST_ASSERT_EQUAL_INT(dim[i], sample.dim);
+        for (unsigned j = 0; j < dim[i]; j++) {
+            TEST_ASSERT_EQUAL_INT(data[i].val[j], sample.data.val[j]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, tsdb_iter_next(&it, &sample));
+}
+
+static void test_tsdb_power_cut(void)
+{
+    tsdb_iter_t it;
+    uint32_t first = 0, last = 0;
+
+    for (unsigned cut = 1; cut < 40; cut++) {
+        set_up();
+        _fill(0, 50);
+        TEST_ASSERT_EQUAL_INT(0, tsdb_flush(&_db));
+        _fill(50, 20);
+        _dev.power_cut = cut;
+        int res = tsdb_flush(&_db);
+        if (_dev.power_cut) {
+            TEST_ASSERT_EQUAL_INT(0, res);
+            break;
+        }
+        TEST_ASSERT_EQUAL_INT(-EIO, res);
+
+        TEST_ASSERT_EQUAL_INT(0, tsdb_init(&_db));
+        TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+        _check(&it, &first, &last);
+        TEST_ASSERT_EQUAL_INT(0, first);
+        TEST_ASSERT(last >= 49);
+
+        /* appending continues after the last sample found */
+        uint32_t n = last + 101;
+        _fill(last + 1, 100);
+        TEST_ASSERT_EQUAL_INT(0, tsdb_flush(&_db));
+        TEST_ASSERT_EQUAL_INT(0, tsdb_init(&_db));
+        TEST_ASSERT_EQUAL_INT(0, tsdb_iter_init(&_db, &it, 0, UINT32_MAX));
+        TEST_ASSERT_EQUAL_INT(n, _check(&it, &first, &last));
+    }
+}
+
+Test *tests_tsdb_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tsdb_append_iter),
+        new_TestFixture(test_tsdb_wrap),
+        new_TestFixture(test_tsdb_range),
+        new_TestFixture(test_tsdb_range_same_time),
+        new_TestFixture(test_tsdb_iter_overwritten),
+        new_TestFixture(test_tsdb_export_cbor),
+        new_TestFixture(test_tsdb_mixed_dim),
+        new_TestFixture(test_tsdb_power_cut),
+    };
+
+    EMB_UNIT_TESTCALLER(tsdb_tests, set_up, NULL, fixtures);
+
+    return (Test *)&tsdb_tests;
+}
+#endif /* MODULE_MTD_NATIVE */
+
+void tests_tsdb(void)
+{
+#ifdef MODULE_MTD_NATIVE
+    TESTS_RUN(tests_tsdb_tests());
+#endif
+}
+/** @} */
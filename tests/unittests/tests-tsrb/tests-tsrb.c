@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "tsrb.h"
+
+#define BUF_SIZE    (16U)
+
+static char _mem[BUF_SIZE];
+static tsrb_t _rb;
+
+static void set_up(void)
+{
+    memset(_mem, 0, sizeof(_mem));
+    tsrb_init(&_rb, _mem, sizeof(_mem));
+}
+
+static void test_tsrb_one(void)
+{
+    TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_rb));
+    TEST_ASSERT_EQUAL_INT(-1, tsrb_get_one(&_rb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_add_one(&_rb, 'a'));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_add_one(&_rb, (char)0xff));
+    TEST_ASSERT_EQUAL_INT(2, tsrb_avail(&_rb));
+    TEST_ASSERT_EQUAL_INT('a', tsrb_get_one(&_rb));
+    /* bytes >= 0x80 must not be mistaken for an error */
+    TEST_ASSERT_EQUAL_INT(0xff, tsrb_get_one(&_rb));
+    TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_rb));
+}
+
+static void test_tsrb_full(void)
+{
+    for (unsigned i = 0; i < BUF_SIZE; i++) {
+        TEST_ASSERT_EQUAL_INT(0, tsrb_add_one(&_rb, (char)i));
+    }
+    TEST_ASSERT_EQUAL_INT(1, tsrb_full(&_rb));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_free(&_rb));
+    TEST_ASSERT_EQUAL_INT(-1, tsrb_add_one(&_rb, 'x'));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_add(&_rb, "xyz", 3));
+}
+
+static void test_tsrb_bulk_wrap(void)
+{
+    char out[BUF_SIZE];
+
+    /* move the counters close to the end of the buffer */
+    TEST_ASSERT_EQUAL_INT(12, tsrb_add(&_rb, "0123456789ab", 12));
+    TEST_ASSERT_EQUAL_INT(12, tsrb_drop(&_rb, 20));
+    TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_rb));
+
+    /* the next write spans the end of the buffer */
+    TEST_ASSERT_EQUAL_INT(10, tsrb_add(&_rb, "ABCDEFGHIJ", 10));
+    TEST_ASSERT_EQUAL_INT(3, tsrb_get(&_rb, out, 3));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, "ABC", 3));
+    TEST_ASSERT_EQUAL_INT(7, tsrb_get(&_rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, "DEFGHIJ", 7));
+
+    /* writes are truncated to the free space */
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_add(&_rb, "0123456789abcdefXYZ", 19));
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_get(&_rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, "0123456789abcdef", BUF_SIZE));
+}
+
+static void test_tsrb_reserve_commit(void)
+{
+    char out[BUF_SIZE];
+    char *pos;
+    size_t n;
+
+    TEST_ASSERT_EQUAL_INT(10, tsrb_add(&_rb, "0123456789", 10));
+    TEST_ASSERT_EQUAL_INT(10, tsrb_drop(&_rb, 10));
+
+    /* contiguous space ends at the end of the buffer */
+    n = tsrb_reserve(&_rb, 0, &pos);
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE - 10, n);
+    TEST_ASSERT(pos == &_mem[10]);
+    memcpy(pos, "abcdef", n);
+
+    /* further space after the uncommitted bytes starts at the beginning */
+    n = tsrb_reserve(&_rb, 6, &pos);
+    TEST_ASSERT_EQUAL_INT(10, n);
+    TEST_ASSERT(pos == &_mem[0]);
+    memcpy(pos, "gh", 2);
+
+    /* nothing is visible before the commit */
+    TEST_ASSERT_EQUAL_INT(1, tsrb_empty(&_rb));
+    tsrb_commit(&_rb, 8);
+    TEST_ASSERT_EQUAL_INT(8, tsrb_avail(&_rb));
+    TEST_ASSERT_EQUAL_INT(8, tsrb_get(&_rb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(out, "abcdefgh", 8));
+
+    /* no space after the free space is used up */
+    TEST_ASSERT_EQUAL_INT(BUF_SIZE, tsrb_add(&_rb, "0123456789abcdef", BUF_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, tsrb_reserve(&_rb, 0, &pos));
+}
+
+Test *tests_tsrb_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tsrb_one),
+        new_TestFixture(test_tsrb_full),
+        new_TestFixture(test_tsrb_bulk_wrap),
+        new_TestFixture(test_tsrb_reserve_commit),
+    };
+
+    EMB_UNIT_TESTCALLER(tsrb_tests, set_up, NULL, fixtures);
+
+    return (Test *)&tsrb_tests;
+}
+
+void tests_tsrb(void)
+{
+    TESTS_RUN(tests_tsrb_tests());
+}
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Unittests for vfs_readv, vfs_writev and vfs_sendfile
+ */
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "embUnit/embUnit.h"
+
+#include "vfs.h"
+#include "fs/constfs.h"
+
+#include "tests-vfs.h"
+
+static const uint8_t _data[] = "0123456789abcdefghijklmnopqrstuvwxyz"
+                               "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+                               "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static const constfs_file_t _files[] = {
+    {
+        .path = "/data.txt",
+        .data = _data,
+        .size = sizeof(_data) - 1,
+    },
+};
+
+static const constfs_t _constfs = {
+    .files = _files,
+    .nfiles = sizeof(_files) / sizeof(_files[0]),
+};
+
+static vfs_mount_t _constfs_mount = {
+    .mount_point = "/const",
+    .fs = &constfs_file_system,
+    .private_data = (void *)&_constfs,
+};
+
+/* sink recording what is written, and a source without map */
+static uint8_t _sink[sizeof(_data)];
+static size_t _sink_len;
+static size_t _sink_max;
+static unsigned _writes;
+static unsigned _writevs;
+static unsigned _sendfiles;
+static int _sendfile_err;
+
+static ssize_t _sink_write(vfs_file_t *filp, const void *src, size_t nbytes)
+{
+    (void)filp;
+    _writes++;
+    if (nbytes > _sink_max - _sink_len) {
+        nbytes = _sink_max - _sink_len;
+    }
+    memcpy(_sink + _sink_len, src, nbytes);
+    _sink_len += nbytes;
+    return nbytes;
+}
+
+static ssize_t _sink_writev(vfs_file_t *filp, const struct iovec *iov, int iovcnt)
+{
+    ssize_t res = 0;
+
+    _writevs++;
+    for (int i = 0; i < iovcnt; i++) {
+        res += _sink_write(filp, iov[i].iov_base, iov[i].iov_len);
+    }
+    return res;
+}
+
+static ssize_t _sink_sendfile(vfs_file_t *filp, vfs_file_t *in, size_t nbytes)
+{
+    uint8_t buf[sizeof(_data)];
+
+    (void)filp;
+    _sendfiles++;
+    /* reads everything it is offered, but keeps only what fits */
+    if (nbytes > sizeof(buf)) {
+        nbytes = sizeof(buf);
+    }
+    ssize_t res = in->f_op->read(in, buf, nbytes);
+    if ((res <= 0) || (_sendfile_err < 0)) {
+        return (res < 0) ? res : _sendfile_err;
+    }
+    if ((size_t)res > _sink_max - _sink_len) {
+        res = _sink_max - _sink_len;
+    }
+    memcpy(_sink + _sink_len, buf, res);
+    _sink_len += res;
+    return res;
+}
+
+static ssize_t _src_read(vfs_file_t *filp, void *dest, size_t nbytes)
+{
+    if ((size_t)filp->pos >= sizeof(_data) - 1) {
+        return 0;
+    }
+    if (nbytes > sizeof(_data) - 1 - filp->pos) {
+        nbytes = sizeof(_data) - 1 - filp->pos;
+    }
+    memcpy(dest, _data + filp->pos, nbytes);
+    filp->pos += nbytes;
+    return nbytes;
+}
+
+static const vfs_file_ops_t _sink_ops = {
+    .write = _sink_write,
+};
+
+static const vfs_file_ops_t _sink_vec_ops = {
+    .write = _sink_write,
+    .writev = _sink_writev,
+    .sendfile = _sink_sendfile,
+};
+
+static const vfs_file_ops_t _src_ops = {
+    .read = _src_read,
+};
+
+static int _const_fd;
+
+static void set_up(void)
+{
+    memset(_sink, 0, sizeof(_sink));
+    _sink_len = 0;
+    _sink_max = sizeof(_sink);
+    _writes = 0;
+    _writevs = 0;
+    _sendfiles = 0;
+    _sendfile_err = 0;
+    TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_constfs_mount));
+    _const_fd = vfs_open("/const/data.txt", O_RDONLY, 0);
+    TEST_ASSERT(_const_fd >= 0);
+}
+
+static void tear_down(void)
+{
+    vfs_close(_const_fd);
+    vfs_umount(&_constfs_mount);
+}
+
+static void test_vfs_readv__fallback(void)
+{
+    char a[5], b[1], c[20];
+    struct iovec iov[] = {
+        { .iov_base = a, .iov_len = sizeof(a) },
+        { .iov_base = NULL, .iov_len = 0 },
+        { .iov_base = b, .iov_len = sizeof(b) },
+        { .iov_base = c, .iov_len = sizeof(c) },
+    };
+
+    TEST_ASSERT_EQUAL_INT(26, vfs_readv(_const_fd, iov, 4));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(a, "01234", sizeof(a)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(b, "5", sizeof(b)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(c, "6789abcdefghijklmnop", sizeof(c)));
+
+    /* short read at the end of the file ends the transfer */
+    TEST_ASSERT_EQUAL_INT(88, vfs_lseek(_const_fd, -20, SEEK_END));
+    TEST_ASSERT_EQUAL_INT(20, vfs_readv(_const_fd, iov, 4));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(c, "mnopqrstuvwxyz", 14));
+    TEST_ASSERT_EQUAL_INT(0, vfs_readv(_const_fd, iov, 4));
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, vfs_readv(_const_fd, iov, -1));
+    TEST_ASSERT_EQUAL_INT(-EBADF, vfs_writev(_const_fd, iov, 4));
+}
+
+static void test_vfs_writev(void)
+{
+    struct iovec iov[] = {
+        { .iov_base = "Hello", .iov_len = 5 },
+        { .iov_base = ", ", .iov_len = 2 },
+        { .iov_base = "world", .iov_len = 5 },
+    };
+
+    int fd = vfs_bind(VFS_ANY_FD, O_WRONLY, &_sink_ops, NULL);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(12, vfs_writev(fd, iov, 3));
+    TEST_ASSERT_EQUAL_INT(3, _writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, "Hello, world", 12));
+
+    /* a full file ends the transfer */
+    _sink_max = 14;
+    TEST_ASSERT_EQUAL_INT(2, vfs_writev(fd, iov, 3));
+    TEST_ASSERT_EQUAL_INT(4, _writes);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+
+    /* the driver's op takes precedence */
+    fd = vfs_bind(VFS_ANY_FD, O_WRONLY, &_sink_vec_ops, NULL);
+    TEST_ASSERT(fd >= 0);
+    _sink_len = 0;
+    _sink_max = sizeof(_sink);
+    TEST_ASSERT_EQUAL_INT(12, vfs_writev(fd, iov, 3));
+    TEST_ASSERT_EQUAL_INT(1, _writevs);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+}
+
+static void test_vfs_sendfile__map(void)
+{
+    int fd = vfs_bind(VFS_ANY_FD, O_WRONLY, &_sink_ops, NULL);
+    TEST_ASSERT(fd >= 0);
+
+    /* the data is passed from the constfs file to write as one piece */
+    TEST_ASSERT_EQUAL_INT(40, vfs_sendfile(fd, _const_fd, NULL, 40));
+    TEST_ASSERT_EQUAL_INT(1, _writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, _data, 40));
+    TEST_ASSERT_EQUAL_INT(40, vfs_lseek(_const_fd, 0, SEEK_CUR));
+
+    /* only the bytes written are consumed */
+    _sink_max = 50;
+    TEST_ASSERT_EQUAL_INT(10, vfs_sendfile(fd, _const_fd, NULL, 100));
+    TEST_ASSERT_EQUAL_INT(50, vfs_lseek(_const_fd, 0, SEEK_CUR));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, _data, 50));
+
+    /* with offset, the file position stays */
+    _sink_len = 0;
+    _sink_max = sizeof(_sink);
+    off_t off = 100;
+    TEST_ASSERT_EQUAL_INT(8, vfs_sendfile(fd, _const_fd, &off, 20));
+    TEST_ASSERT_EQUAL_INT(108, off);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, _data + 100, 8));
+    TEST_ASSERT_EQUAL_INT(50, vfs_lseek(_const_fd, 0, SEEK_CUR));
+
+    TEST_ASSERT_EQUAL_INT(-EBADF, vfs_sendfile(_const_fd, fd, NULL, 1));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+}
+
+static void test_vfs_sendfile__buffer(void)
+{
+    int out = vfs_bind(VFS_ANY_FD, O_WRONLY, &_sink_ops, NULL);
+    int in = vfs_bind(VFS_ANY_FD, O_RDONLY, &_src_ops, NULL);
+    TEST_ASSERT(out >= 0);
+    TEST_ASSERT(in >= 0);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(_data) - 1,
+                          vfs_sendfile(out, in, NULL, sizeof(_data)));
+    TEST_ASSERT_EQUAL_INT((sizeof(_data) - 1 + VFS_SENDFILE_BUFFER_SIZE - 1) /
+                          VFS_SENDFILE_BUFFER_SIZE, _writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, _data, sizeof(_data) - 1));
+
+    /* bytes read but not written are given back to the source */
+    _sink_len = 0;
+    _sink_max = 3;
+    TEST_ASSERT_EQUAL_INT(0, vfs_lseek(in, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL_INT(3, vfs_sendfile(out, in, NULL, 10));
+    TEST_ASSERT_EQUAL_INT(3, vfs_lseek(in, 0, SEEK_CUR));
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(in));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(out));
+}
+
+static void test_vfs_sendfile__driver(void)
+{
+    int fd = vfs_bind(VFS_ANY_FD, O_WRONLY, &_sink_vec_ops, NULL);
+    TEST_ASSERT(fd >= 0);
+
+    /* the destination reads directly into its buffer */
+    TEST_ASSERT_EQUAL_INT(sizeof(_data) - 1,
+                          vfs_sendfile(fd, _const_fd, NULL, sizeof(_data)));
+    TEST_ASSERT_EQUAL_INT(0, _writes);
+    TEST_ASSERT_EQUAL_INT(2, _sendfiles);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, _data, sizeof(_data) - 1));
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+}
+
+static void test_vfs_sendfile__driver_partial(void)
+{
+    int fd = vfs_bind(VFS_ANY_FD, O_WRONLY, &_sink_vec_ops, NULL);
+    TEST_ASSERT(fd >= 0);
+
+    /* only the bytes sent are consumed from the source */
+    _sink_max = 5;
+    TEST_ASSERT_EQUAL_INT(5, vfs_sendfile(fd, _const_fd, NULL, 20));
+    TEST_ASSERT_EQUAL_INT(5, vfs_lseek(_const_fd, 0, SEEK_CUR));
+
+    off_t off = 2;
+    _sink_len = 0;
+    TEST_ASSERT_EQUAL_INT(5, vfs_sendfile(fd, _const_fd, &off, 20));
+    TEST_ASSERT_EQUAL_INT(7, off);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_sink, _data + 2, 5));
+
+    /* nothing is consumed when sending fails */
+    _sendfile_err = -EIO;
+    TEST_ASSERT_EQUAL_INT(-EIO, vfs_sendfile(fd, _const_fd, NULL, 20));
+    TEST_ASSERT_EQUAL_INT(5, vfs_lseek(_const_fd, 0, SEEK_CUR));
+    TEST_ASSERT_EQUAL_INT(-EIO, vfs_sendfile(fd, _const_fd, &off, 20));
+    TEST_ASSERT_EQUAL_INT(7, off);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fd));
+}
+
+Test *tests_vfs_iovec_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vfs_readv__fallback),
+        new_TestFixture(test_vfs_writev),
+        new_TestFixture(test_vfs_sendfile__map),
+        new_TestFixture(test_vfs_sendfile__buffer),
+        new_TestFixture(test_vfs_sendfile__driver),
+        new_TestFixture(test_vfs_sendfile__driver_partial),
+    };
+
+    EMB_UNIT_TESTCALLER(vfs_iovec_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&vfs_iovec_tests;
+}
+/** @} */
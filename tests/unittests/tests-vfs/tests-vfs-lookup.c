@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief       Unittests for mount point lookup and fd allocation
+ */
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "embUnit/embUnit.h"
+
+#include "vfs.h"
+#ifdef MODULE_XTIMER
+#include "xtimer.h"
+#endif
+
+#include "tests-vfs.h"
+
+#define BENCH_PATHS     (4096U)
+#define BENCH_ROUNDS    (2U)
+#define BENCH_MOUNTS    (12U)
+
+static vfs_mount_t *_last_mount;
+static const char *_last_path;
+
+static int _stat(vfs_mount_t *mountp, const char *restrict path, struct stat *restrict buf)
+{
+    (void)buf;
+    _last_mount = mountp;
+    _last_path = path;
+    return 0;
+}
+
+static int _open(vfs_file_t *filp, const char *name, int flags, mode_t mode,
+                 const char *abs_path)
+{
+    (void)flags;
+    (void)mode;
+    (void)abs_path;
+    _last_mount = filp->mp;
+    _last_path = name;
+    return 0;
+}
+
+static const vfs_file_system_ops_t _fs_ops = {
+    .stat = _stat,
+};
+
+static const vfs_file_ops_t _file_ops = {
+    .open = _open,
+};
+
+static const vfs_file_system_t _fs = {
+    .f_op = &_file_ops,
+    .fs_op = &_fs_ops,
+};
+
+static vfs_mount_t _mounts[] = {
+    { .fs = &_fs, .mount_point = "/" },
+    { .fs = &_fs, .mount_point = "/a" },
+    { .fs = &_fs, .mount_point = "/a/b" },
+    { .fs = &_fs, .mount_point = "/ab" },
+    { .fs = &_fs, .mount_point = "/sd/log" },
+    { .fs = &_fs, .mount_point = "/sd" },
+};
+
+#define MOUNTS  (sizeof(_mounts) / sizeof(_mounts[0]))
+
+static void set_up(void)
+{
+    for (unsigned i = 0; i < MOUNTS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_mount(&_mounts[i]));
+    }
+}
+
+static void tear_down(void)
+{
+    for (unsigned i = 0; i < MOUNTS; i++) {
+        vfs_umount(&_mounts[i]);
+    }
+}
+
+static void _check(const char *path, vfs_mount_t *mountp, const char *rel_path)
+{
+    struct stat buf;
+
+    _last_mount = NULL;
+    TEST_ASSERT_EQUAL_INT(0, vfs_stat(path, &buf));
+    TEST_ASSERT(_last_mount == mountp);
+    TEST_ASSERT_EQUAL_STRING(rel_path, _last_path);
+}
+
+static void test_vfs_lookup__longest_prefix(void)
+{
+    _check("/a/b/c", &_mounts[2], "/c");
+    _check("/a/b", &_mounts[2], "");
+    _check("/a/bc", &_mounts[1], "/bc");
+    _check("/ab/c", &_mounts[3], "/c");
+    _check("/abc", &_mounts[0], "/abc");
+    _check("/sd/log/1", &_mounts[4], "/1");
+    _check("/sd/lo", &_mounts[5], "/lo");
+    _check("/x/y", &_mounts[0], "/x/y");
+    /* again, now served starting at the remembered mounts */
+    _check("/a/b/d", &_mounts[2], "/d");
+    _check("/sd/log/2", &_mounts[4], "/2");
+    _check("/sd/lo", &_mounts[5], "/lo");
+}
+
+static void test_vfs_lookup__umount(void)
+{
+    _check("/a/b/c", &_mounts[2], "/c");
+    _check("/a/c", &_mounts[1], "/c");
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mounts[1]));
+    _check("/a/b/c", &_mounts[2], "/c");
+    _check("/a/c", &_mounts[0], "/a/c");
+
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&_mounts[0]));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, vfs_open("/a/c", O_RDONLY, 0));
+
+    /* a mount point mounted again shadows the first mount */
+    static vfs_mount_t again = { .fs = &_fs, .mount_point = "/sd" };
+    TEST_ASSERT_EQUAL_INT(0, vfs_mount(&again));
+    _check("/sd/x", &again, "/x");
+    _check("/sd/log/x", &_mounts[4], "/x");
+    TEST_ASSERT_EQUAL_INT(0, vfs_umount(&again));
+    _check("/sd/x", &_mounts[5], "/x");
+}
+
+static void test_vfs_open__fd_reuse(void)
+{
+    int fds[VFS_MAX_OPEN_FILES];
+    unsigned n = 0;
+
+    for (; n < VFS_MAX_OPEN_FILES; n++) {
+        fds[n] = vfs_open("/ab/file", O_RDONLY, 0);
+        if (fds[n] < 0) {
+            break;
+        }
+    }
+    TEST_ASSERT(n > 2);
+    TEST_ASSERT_EQUAL_INT(-ENFILE, fds[n]);
+    TEST_ASSERT_EQUAL_INT(0, vfs_close(fds[1]));
+    TEST_ASSERT_EQUAL_INT(fds[1], vfs_open("/ab/file", O_RDONLY, 0));
+    for (unsigned i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_close(fds[i]));
+    }
+}
+
+static void test_vfs_lookup__bench(void)
+{
+    static const char *prefixes[] = {
+        "/a/b", "/a", "/sd/log", "/sd", "/ab", "/tmp",
+    };
+    static const char *mount_points[BENCH_MOUNTS] = {
+        "/mnt0", "/mnt1", "/mnt2", "/mnt3", "/mnt4", "/mnt5",
+        "/mnt6", "/mnt7", "/mnt8", "/mnt9", "/usb", "/nvram",
+    };
+    static vfs_mount_t mounts[BENCH_MOUNTS];
+    const unsigned num_prefixes = sizeof(prefixes) / sizeof(prefixes[0]);
+    struct stat buf;
+    char path[32];
+    unsigned ops = 0;
+
+    for (unsigned i = 0; i < BENCH_MOUNTS; i++) {
+        mounts[i] = (vfs_mount_t){ .fs = &_fs, .mount_point = mount_points[i] };
+        TEST_ASSERT_EQUAL_INT(0, vfs_mount(&mounts[i]));
+    }
+
+#ifdef MODULE_XTIMER
+    uint32_t start = xtimer_now_usec();
+#endif
+    /* distinct paths spread over all mounts, generated on the fly to keep
+     * the test's RAM use small */
+    for (unsigned round = 0; round < BENCH_ROUNDS; round++) {
+        for (unsigned i = 0; i < BENCH_PATHS; i++) {
+            unsigned m = i % (num_prefixes + BENCH_MOUNTS);
+            const char *prefix = (m < num_prefixes) ? prefixes[m]
+                                 : mount_points[m - num_prefixes];
+            snprintf(path, sizeof(path), "%s/d%u/f%u", prefix, i % 64, i);
+            int fd = vfs_open(path, O_RDONLY, 0);
+            TEST_ASSERT(fd >= 0);
+            vfs_close(fd);
+            TEST_ASSERT_EQUAL_INT(0, vfs_stat(path, &buf));
+            ops += 2;
+        }
+    }
+#ifdef MODULE_XTIMER
+    uint32_t usec = xtimer_now_usec() - start;
+    printf("\nvfs lookup: %u ops on %u paths across %u mounts: %lu us\n",
+           ops, BENCH_PATHS, (unsigned)(MOUNTS + BENCH_MOUNTS),
+           (unsigned long)usec);
+#else
+    (void)ops;
+#endif
+
+    for (unsigned i = 0; i < BENCH_MOUNTS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, vfs_umount(&mounts[i]));
+    }
+}
+
+Test *tests_vfs_lookup_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_vfs_lookup__longest_prefix),
+        new_TestFixture(test_vfs_lookup__umount),
+        new_TestFixture(test_vfs_open__fd_reuse),
+        new_TestFixture(test_vfs_lookup__bench),
+    };
+
+    EMB_UNIT_TESTCALLER(vfs_lookup_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&vfs_lookup_tests;
+}
+/** @} */
@@ -26,6 +26,8 @@ Test *tests_vfs_normalize_path_tests(void);
 Test *tests_vfs_null_file_ops_tests(void);
 Test *tests_vfs_null_file_system_ops_tests(void);
 Test *tests_vfs_null_dir_ops_tests(void);
+Test *tests_vfs_lookup_tests(void);
+Test *tests_vfs_iovec_tests(void);
 
 void tests_vfs(void)
 {
@@ -36,5 +38,7 @@ void tests_vfs(void)
     TESTS_RUN(tests_vfs_null_file_ops_tests());
     TESTS_RUN(tests_vfs_null_file_system_ops_tests());
     TESTS_RUN(tests_vfs_null_dir_ops_tests());
+    TESTS_RUN(tests_vfs_lookup_tests());
+    TESTS_RUN(tests_vfs_iovec_tests());
 }
 /** @} */
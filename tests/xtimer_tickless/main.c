@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2017 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Test application measuring the xtimer wakeups of a mostly
+ *              sleeping node
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "xtimer.h"
+#include "timex.h"
+
+#ifndef TEST_DURATION
+#define TEST_DURATION       (60U)               /* in seconds */
+#endif
+#define LONG_SLEEP          (10U * US_PER_SEC)
+#define SHORT_SLEEP         (2U * US_PER_MS)
+#define SEC_PER_HOUR        (3600U)
+
+static uint32_t _per_hour(uint32_t count, uint32_t seconds)
+{
+    return (uint32_t)(((uint64_t)count * SEC_PER_HOUR) / seconds);
+}
+
+int main(void)
+{
+    xtimer_stats_t stats;
+    uint32_t start, elapsed, drift = 0;
+
+    puts("xtimer wakeup test");
+#ifdef MODULE_XTIMER_TICKLESS
+    puts("tickless mode: enabled");
+#else
+    puts("tickless mode: disabled");
+#endif
+    printf("low-level timer width: %u bit\n", (unsigned)XTIMER_WIDTH);
+
+    xtimer_reset_stats();
+    start = xtimer_now_usec();
+
+    for (unsigned i = 0; i < (TEST_DURATION * US_PER_SEC) / LONG_SLEEP; i++) {
+        uint32_t before = xtimer_now_usec();
+        /* a long sleep followed by a short burst of activity */
+        xtimer_usleep(LONG_SLEEP);
+        uint32_t slept = xtimer_now_usec() - before;
+        if ((slept - LONG_SLEEP) > drift) {
+            drift = slept - LONG_SLEEP;
+        }
+        xtimer_usleep(SHORT_SLEEP);
+    }
+
+    elapsed = (xtimer_now_usec() - start) / US_PER_SEC;
+    xtimer_get_stats(&stats);
+
+    printf("elapsed: %" PRIu32 " s, max. lateness: %" PRIu32 " us\n",
+           elapsed, drift);
+    printf("wakeups per hour: timer %" PRIu32 ", overflow %" PRIu32
+           ", spurious %" PRIu32 ", rtt %" PRIu32 "\n",
+           _per_hour(stats.timer, elapsed), _per_hour(stats.overflow, elapsed),
+           _per_hour(stats.spurious, elapsed), _per_hour(stats.rtt, elapsed));
+    printf("total: %" PRIu32 " wakeups per hour\n",
+           _per_hour(stats.timer + stats.overflow + stats.spurious + stats.rtt,
+                     elapsed));
+
+    puts("[SUCCESS]");
+
+    return 0;
+}